@@ -139,6 +139,18 @@ void arch_sched_ipi(void)
 	}
 }
 
+/* arch implementation of sched_directed_ipi */
+void arch_sched_directed_ipi(u32_t cpu_bitmap)
+{
+	u32_t i;
+
+	for (i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		if ((cpu_bitmap & BIT(i)) != 0U) {
+			z_arc_connect_ici_generate(i);
+		}
+	}
+}
+
 static int arc_smp_init(struct device *dev)
 {
 	ARG_UNUSED(dev);
@@ -36,8 +36,10 @@ static const char *e1000_reg_to_string(enum e1000_reg_t r)
 	switch (r) {
 	_(CTRL);
 	_(ICR);
+	_(ITR);
 	_(ICS);
 	_(IMS);
+	_(IMC);
 	_(RCTL);
 	_(TCTL);
 	_(RDBAL);
@@ -62,27 +64,120 @@ static const char *e1000_reg_to_string(enum e1000_reg_t r)
 static enum ethernet_hw_caps e1000_caps(struct device *dev)
 {
 	return  ETHERNET_LINK_10BASE_T | ETHERNET_LINK_100BASE_T | \
-		ETHERNET_LINK_1000BASE_T;
+		ETHERNET_LINK_1000BASE_T
+#if defined(CONFIG_ETH_E1000_TSO)
+		| ETHERNET_HW_TSO
+#endif
+		;
+}
+
+/* Hands count descriptors from the tail of the TX ring to the device
+ * and waits until it has processed the last one.
+ */
+static int e1000_tx_submit(struct e1000_dev *dev, unsigned int count)
+{
+	volatile union e1000_tx_desc *last;
+
+	last = &dev->tx[(dev->tx_tail + count - 1) % E1000_TX_DESC_NUM];
+	dev->tx_tail = (dev->tx_tail + count) % E1000_TX_DESC_NUM;
+
+	iow32(dev, TDT, dev->tx_tail);
+
+	while (!(last->legacy.sta)) {
+		k_yield();
+	}
+
+	LOG_DBG("tx.sta: 0x%02hx", last->legacy.sta);
+
+	return (last->legacy.sta & TDESC_STA_DD) ? 0 : -EIO;
 }
 
 static int e1000_tx(struct e1000_dev *dev, void *buf, size_t len)
 {
+	volatile struct e1000_tx *tx = &dev->tx[dev->tx_tail].legacy;
+
 	hexdump(buf, len, "%zu byte(s)", len);
 
-	dev->tx.addr = POINTER_TO_INT(buf);
-	dev->tx.len = len;
-	dev->tx.cmd = TDESC_EOP | TDESC_RS;
+	tx->addr = POINTER_TO_INT(buf);
+	tx->len = len;
+	tx->cmd = TDESC_EOP | TDESC_RS;
+	tx->sta = 0U;
 
-	iow32(dev, TDT, 1);
+	return e1000_tx_submit(dev, 1);
+}
 
-	while (!(dev->tx.sta)) {
-		k_yield();
+#if defined(CONFIG_ETH_E1000_TSO)
+static u32_t pseudo_hdr_sum(const u8_t *addrs, size_t len)
+{
+	u32_t sum = IPPROTO_TCP;
+
+	for (; len; addrs += 2, len -= 2) {
+		sum += (addrs[0] << 8) + addrs[1];
 	}
 
-	LOG_DBG("tx.sta: 0x%02hx", dev->tx.sta);
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+
+	return sum;
+}
+
+/* Sends a TCP packet larger than the MTU with a context descriptor that
+ * has the device split it into segments of net_pkt_gso_size() bytes.
+ */
+static int e1000_tso(struct e1000_dev *dev, struct net_pkt *pkt, size_t len)
+{
+	unsigned int next = (dev->tx_tail + 1) % E1000_TX_DESC_NUM;
+	volatile struct e1000_tx_ctx *ctx = &dev->tx[dev->tx_tail].ctx;
+	volatile struct e1000_tx_data *data = &dev->tx[next].data;
+	const u16_t l2_len = sizeof(struct net_eth_hdr);
+	bool ipv4 = net_pkt_family(pkt) == AF_INET;
+	u8_t *frame = dev->txb;
+	u16_t tcp_off, hdr_len;
+	u16_t sum;
+
+	tcp_off = l2_len + net_pkt_ip_hdr_len(pkt) + net_pkt_ip_opts_len(pkt);
+	hdr_len = tcp_off + 4 * (frame[tcp_off + 12] >> 4);
+
+	/* The device computes the IPv4 header checksum of each segment
+	 * and adds its length to the pseudo header sum.
+	 */
+	if (ipv4) {
+		sys_put_be16(0, frame + l2_len + 10);
+		sum = pseudo_hdr_sum(frame + l2_len + 12,
+				     2 * sizeof(struct in_addr));
+	} else {
+		sum = pseudo_hdr_sum(frame + l2_len + 8,
+				     2 * sizeof(struct in6_addr));
+	}
 
-	return (dev->tx.sta & TDESC_STA_DD) ? 0 : -EIO;
+	sys_put_be16(sum, frame + tcp_off + 16);
+
+	hexdump(frame, hdr_len, "%zu byte(s), mss %hu", len,
+		net_pkt_gso_size(pkt));
+
+	ctx->ipcss = l2_len;
+	ctx->ipcso = ipv4 ? l2_len + 10 : 0;
+	ctx->ipcse = ipv4 ? tcp_off - 1 : 0;
+	ctx->tucss = tcp_off;
+	ctx->tucso = tcp_off + 16;
+	ctx->tucse = 0U;
+	ctx->paylen = (len - hdr_len) |
+		TDESC_CMD(TDESC_DEXT | TDESC_TSE | TDESC_TUCMD_TCP |
+			  (ipv4 ? TDESC_TUCMD_IP : 0));
+	ctx->sta = 0U;
+	ctx->hdrlen = hdr_len;
+	ctx->mss = net_pkt_gso_size(pkt);
+
+	data->addr = POINTER_TO_INT(frame);
+	data->len = len | TDESC_DTYP_D |
+		TDESC_CMD(TDESC_DEXT | TDESC_TSE | TDESC_EOP | TDESC_RS);
+	data->sta = 0U;
+	data->popts = TDESC_POPTS_TXSM | (ipv4 ? TDESC_POPTS_IXSM : 0);
+	data->special = 0U;
+
+	return e1000_tx_submit(dev, 2);
 }
+#endif /* CONFIG_ETH_E1000_TSO */
 
 static int e1000_send(struct device *device, struct net_pkt *pkt)
 {
@@ -93,27 +188,29 @@ static int e1000_send(struct device *device, struct net_pkt *pkt)
 		return -EIO;
 	}
 
+#if defined(CONFIG_ETH_E1000_TSO)
+	if (net_pkt_gso_size(pkt)) {
+		return e1000_tso(dev, pkt, len);
+	}
+#endif
+
 	return e1000_tx(dev, dev->txb, len);
 }
 
-static struct net_pkt *e1000_rx(struct e1000_dev *dev)
+static struct net_pkt *e1000_rx(struct e1000_dev *dev,
+				volatile struct e1000_rx *rx)
 {
 	struct net_pkt *pkt = NULL;
 	void *buf;
 	ssize_t len;
 
-	LOG_DBG("rx.sta: 0x%02hx", dev->rx.sta);
-
-	if (!(dev->rx.sta & RDESC_STA_DD)) {
-		LOG_ERR("RX descriptor not ready");
-		goto out;
-	}
+	LOG_DBG("rx.sta: 0x%02hx", rx->sta);
 
-	buf = INT_TO_POINTER((u32_t)dev->rx.addr);
-	len = dev->rx.len - 4;
+	buf = INT_TO_POINTER((u32_t)rx->addr);
+	len = rx->len - 4;
 
 	if (len <= 0) {
-		LOG_ERR("Invalid RX descriptor length: %hu", dev->rx.len);
+		LOG_ERR("Invalid RX descriptor length: %hu", rx->len);
 		goto out;
 	}
 
@@ -136,6 +233,56 @@ out:
 	return pkt;
 }
 
+/* Receives up to budget frames from the RX ring and returns the number
+ * of descriptors processed. Without a list, each frame is passed to the
+ * stack on its own.
+ */
+static int e1000_rx_ring(struct e1000_dev *dev, sys_slist_t *pkts, int budget)
+{
+	int count;
+
+	for (count = 0; count < budget; count++) {
+		volatile struct e1000_rx *rx = &dev->rx[dev->rx_head];
+		struct net_pkt *pkt;
+
+		if (!(rx->sta & RDESC_STA_DD)) {
+			break;
+		}
+
+		pkt = e1000_rx(dev, rx);
+		if (!pkt) {
+			eth_stats_update_errors_rx(dev->iface);
+		} else if (pkts) {
+			net_pkt_rx_batch_add(pkts, pkt);
+		} else if (net_recv_data(dev->iface, pkt) < 0) {
+			net_pkt_unref(pkt);
+		}
+
+		/* Give the descriptor back to the device */
+		rx->sta = 0U;
+		iow32(dev, RDT, dev->rx_head);
+
+		dev->rx_head = (dev->rx_head + 1) % E1000_RX_DESC_NUM;
+	}
+
+	return count;
+}
+
+#if defined(CONFIG_NET_RX_BATCH)
+static int e1000_poll(struct net_rx_poll *poll, sys_slist_t *pkts, int budget)
+{
+	struct e1000_dev *dev = CONTAINER_OF(poll, struct e1000_dev, poll);
+	int count = e1000_rx_ring(dev, pkts, budget);
+
+	if (count < budget) {
+		/* Raised right away if a frame came in since the check */
+		iow32(dev, IMS, IMS_RXO | IMS_RXT0);
+	}
+
+	return count;
+}
+#endif
+
 static void e1000_isr(struct device *device)
 {
 	struct e1000_dev *dev = device->driver_data;
@@ -143,16 +290,16 @@ static void e1000_isr(struct device *device)
 
 	icr &= ~(ICR_TXDW | ICR_TXQE);
 
-	if (icr & ICR_RXO) {
-		struct net_pkt *pkt = e1000_rx(dev);
-
-		icr &= ~ICR_RXO;
+	if (icr & (ICR_RXO | ICR_RXT0)) {
+		icr &= ~(ICR_RXO | ICR_RXT0);
 
-		if (pkt) {
-			net_recv_data(dev->iface, pkt);
-		} else {
-			eth_stats_update_errors_rx(dev->iface);
-		}
+#if defined(CONFIG_NET_RX_BATCH)
+		/* Poll the ring until it is drained */
+		iow32(dev, IMC, IMS_RXO | IMS_RXT0);
+		net_rx_poll_schedule(&dev->poll);
+#else
+		(void)e1000_rx_ring(dev, NULL, E1000_RX_DESC_NUM);
+#endif
 	}
 
 	if (icr) {
@@ -191,28 +338,37 @@ static void e1000_init(struct net_if *iface)
 
 	/* Setup TX descriptor */
 
-	iow32(dev, TDBAL, (u32_t) &dev->tx);
+	iow32(dev, TDBAL, (u32_t) dev->tx);
 	iow32(dev, TDBAH, 0);
-	iow32(dev, TDLEN, 1*16);
+	iow32(dev, TDLEN, sizeof(dev->tx));
 
 	iow32(dev, TDH, 0);
 	iow32(dev, TDT, 0);
 
 	iow32(dev, TCTL, TCTL_EN);
 
-	/* Setup RX descriptor */
+	/* Setup RX descriptors */
 
-	dev->rx.addr = POINTER_TO_INT(dev->rxb);
-	dev->rx.len = sizeof(dev->rxb);
+	for (int i = 0; i < E1000_RX_DESC_NUM; i++) {
+		dev->rx[i].addr = POINTER_TO_INT(dev->rxb[i]);
+		dev->rx[i].sta = 0U;
+	}
 
-	iow32(dev, RDBAL, (u32_t) &dev->rx);
+	iow32(dev, RDBAL, (u32_t) dev->rx);
 	iow32(dev, RDBAH, 0);
-	iow32(dev, RDLEN, 1*16);
+	iow32(dev, RDLEN, sizeof(dev->rx));
 
+	/* The device owns all descriptors but the one before the head */
+	dev->rx_head = 0U;
 	iow32(dev, RDH, 0);
-	iow32(dev, RDT, 1);
+	iow32(dev, RDT, E1000_RX_DESC_NUM - 1);
+
+#if defined(CONFIG_NET_RX_BATCH)
+	net_rx_poll_init(&dev->poll, e1000_poll);
+#endif
 
-	iow32(dev, IMS, IMS_RXO);
+	iow32(dev, ITR, CONFIG_ETH_E1000_ITR);
+	iow32(dev, IMS, IMS_RXO | IMS_RXT0);
 
 	ral = ior32(dev, RAL);
 	rah = ior32(dev, RAH);
@@ -19,13 +19,29 @@ extern "C" {
 #define ICR_TXDW	     (1) /* Transmit Descriptor Written Back */
 #define ICR_TXQE	(1 << 1) /* Transmit Queue Empty */
 #define ICR_RXO		(1 << 6) /* Receiver Overrun */
+#define ICR_RXT0	(1 << 7) /* Receiver Timer Interrupt */
 
 #define IMS_RXO		(1 << 6) /* Receiver FIFO Overrun */
+#define IMS_RXT0	(1 << 7) /* Receiver Timer Interrupt */
 
 #define RCTL_MPE	(1 << 4) /* Multicast Promiscuous Enabled */
 
 #define TDESC_EOP	     (1) /* End Of Packet */
 #define TDESC_RS	(1 << 3) /* Report Status */
+#define TDESC_TSE	(1 << 2) /* TCP Segmentation Enable */
+#define TDESC_DEXT	(1 << 5) /* Descriptor Extension */
+
+#define TDESC_TUCMD_TCP	     (1) /* Packet is TCP */
+#define TDESC_TUCMD_IP	(1 << 1) /* Packet is IPv4 */
+
+#define TDESC_POPTS_IXSM     (1) /* Insert IP Checksum */
+#define TDESC_POPTS_TXSM (1 << 1) /* Insert TCP Checksum */
+
+/* Place the descriptor type and command in the length field of the
+ * context and data descriptors
+ */
+#define TDESC_DTYP_D	(1 << 20) /* TCP/IP Data (context is 0) */
+#define TDESC_CMD(_cmd)	((u32_t)(_cmd) << 24)
 
 #define RDESC_STA_DD	     (1) /* Descriptor Done */
 #define TDESC_STA_DD	     (1) /* Descriptor Done */
@@ -35,8 +51,10 @@ extern "C" {
 enum e1000_reg_t {
 	CTRL	= 0x0000,	/* Device Control */
 	ICR	= 0x00C0,	/* Interrupt Cause Read */
+	ITR	= 0x00C4,	/* Interrupt Throttling */
 	ICS	= 0x00C8,	/* Interrupt Cause Set */
 	IMS	= 0x00D0,	/* Interrupt Mask Set */
+	IMC	= 0x00D8,	/* Interrupt Mask Clear */
 	RCTL	= 0x0100,	/* Receive Control */
 	TCTL	= 0x0400,	/* Transmit Control */
 	RDBAL	= 0x2800,	/* Rx Descriptor Base Address Low */
@@ -64,6 +82,45 @@ struct e1000_tx {
 	u16_t special;
 };
 
+/* TCP/IP Context TX Descriptor */
+struct e1000_tx_ctx {
+	u8_t  ipcss;
+	u8_t  ipcso;
+	u16_t ipcse;
+	u8_t  tucss;
+	u8_t  tucso;
+	u16_t tucse;
+	u32_t paylen;	/* With the descriptor type and command */
+	u8_t  sta;
+	u8_t  hdrlen;
+	u16_t mss;
+};
+
+/* TCP/IP Data TX Descriptor */
+struct e1000_tx_data {
+	u64_t addr;
+	u32_t len;	/* With the descriptor type and command */
+	u8_t  sta;
+	u8_t  popts;
+	u16_t special;
+};
+
+/* The status is at the same offset in all TX descriptors */
+union e1000_tx_desc {
+	struct e1000_tx legacy;
+	struct e1000_tx_ctx ctx;
+	struct e1000_tx_data data;
+};
+
+/* The TX ring length must be a multiple of 128 bytes */
+#define E1000_TX_DESC_NUM 8
+
+#if defined(CONFIG_ETH_E1000_TSO)
+#define E1000_TXB_LEN (CONFIG_NET_TCP_GSO_MAX_SIZE + sizeof(struct net_eth_hdr))
+#else
+#define E1000_TXB_LEN NET_ETH_MTU
+#endif
+
 /* Legacy RX Descriptor */
 struct e1000_rx {
 	u64_t addr;
@@ -74,14 +131,25 @@ struct e1000_rx {
 	u16_t special;
 };
 
+/* The RX ring length must be a multiple of 128 bytes */
+#define E1000_RX_DESC_NUM 8
+
+/* Buffer size set by RCTL.BSIZE after reset */
+#define E1000_RXB_LEN 2048
+
 struct e1000_dev {
-	volatile struct e1000_tx tx __aligned(16);
-	volatile struct e1000_rx rx __aligned(16);
+	volatile union e1000_tx_desc tx[E1000_TX_DESC_NUM] __aligned(16);
+	volatile struct e1000_rx rx[E1000_RX_DESC_NUM] __aligned(16);
 	u32_t address;
+	unsigned int tx_tail;
+	unsigned int rx_head;
 	struct net_if *iface;
+#if defined(CONFIG_NET_RX_BATCH)
+	struct net_rx_poll poll;
+#endif
 	u8_t mac[ETH_ALEN];
-	u8_t txb[NET_ETH_MTU];
-	u8_t rxb[NET_ETH_MTU];
+	u8_t txb[E1000_TXB_LEN];
+	u8_t rxb[E1000_RX_DESC_NUM][E1000_RXB_LEN];
 };
 
 static const char *e1000_reg_to_string(enum e1000_reg_t r)
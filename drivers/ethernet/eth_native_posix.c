@@ -44,9 +44,19 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 #define ETH_HDR_LEN sizeof(struct net_eth_hdr)
 #endif
 
+#if defined(CONFIG_ETH_NATIVE_POSIX_TSO)
+#define ETH_SEND_LEN CONFIG_NET_TCP_GSO_MAX_SIZE
+#else
+#define ETH_SEND_LEN NET_ETH_MTU
+#endif
+
+/* Frame data starts after the virtio net header, if any */
+#define RECV_DATA(ctx) ((ctx)->recv + ETH_VNET_HDR_LEN)
+#define SEND_DATA(ctx) ((ctx)->send + ETH_VNET_HDR_LEN)
+
 struct eth_context {
-	u8_t recv[NET_ETH_MTU + ETH_HDR_LEN];
-	u8_t send[NET_ETH_MTU + ETH_HDR_LEN];
+	u8_t recv[ETH_VNET_HDR_LEN + NET_ETH_MTU + ETH_HDR_LEN];
+	u8_t send[ETH_VNET_HDR_LEN + ETH_SEND_LEN + ETH_HDR_LEN];
 	u8_t mac_addr[6];
 	struct net_linkaddr ll_addr;
 	struct net_if *iface;
@@ -175,22 +185,88 @@ static void update_gptp(struct net_if *iface, struct net_pkt *pkt,
 #define update_gptp(iface, pkt, send)
 #endif /* CONFIG_NET_GPTP */
 
+#if defined(CONFIG_ETH_NATIVE_POSIX_TSO)
+static u32_t pseudo_hdr_sum(const u8_t *addrs, size_t len)
+{
+	u32_t sum = 0U;
+
+	for (; len; addrs += 2, len -= 2) {
+		sum += (addrs[0] << 8) + addrs[1];
+	}
+
+	return sum;
+}
+
+/* Describes the segmentation of a GSO packet to the host kernel, which
+ * expects the TCP checksum field to hold the pseudo header sum.
+ */
+static void fill_vnet_hdr(struct eth_vnet_hdr *hdr, struct net_pkt *pkt,
+			  u8_t *frame, int count)
+{
+	struct net_eth_hdr *eth_hdr = (struct net_eth_hdr *)frame;
+	u16_t l2_len = sizeof(struct net_eth_hdr);
+	u16_t ip_len, tcp_off;
+	u32_t sum;
+
+	(void)memset(hdr, 0, sizeof(*hdr));
+
+	if (!net_pkt_gso_size(pkt)) {
+		return;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_VLAN) &&
+	    ntohs(eth_hdr->type) == NET_ETH_PTYPE_VLAN) {
+		l2_len = sizeof(struct net_eth_vlan_hdr);
+	}
+
+	ip_len = net_pkt_ip_hdr_len(pkt) + net_pkt_ip_opts_len(pkt);
+	tcp_off = l2_len + ip_len;
+
+	if (net_pkt_family(pkt) == AF_INET) {
+		/* Source and destination addresses end the header */
+		sum = pseudo_hdr_sum(frame + l2_len + 12,
+				     2 * sizeof(struct in_addr));
+		hdr->gso_type = ETH_VNET_HDR_GSO_TCPV4;
+	} else {
+		sum = pseudo_hdr_sum(frame + l2_len + 8,
+				     2 * sizeof(struct in6_addr));
+		hdr->gso_type = ETH_VNET_HDR_GSO_TCPV6;
+	}
+
+	sum += IPPROTO_TCP + count - tcp_off;
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+	sys_put_be16(sum, frame + tcp_off + 16);
+
+	hdr->flags = ETH_VNET_HDR_F_NEEDS_CSUM;
+	hdr->hdr_len = tcp_off + 4 * (frame[tcp_off + 12] >> 4);
+	hdr->gso_size = net_pkt_gso_size(pkt);
+	hdr->csum_start = tcp_off;
+	hdr->csum_offset = 16;
+}
+#else
+#define fill_vnet_hdr(hdr, pkt, frame, count)
+#endif /* CONFIG_ETH_NATIVE_POSIX_TSO */
+
 static int eth_send(struct device *dev, struct net_pkt *pkt)
 {
 	struct eth_context *ctx = dev->driver_data;
 	int count = net_pkt_get_len(pkt);
 	int ret;
 
-	ret = net_pkt_read(pkt, ctx->send, count);
+	ret = net_pkt_read(pkt, SEND_DATA(ctx), count);
 	if (ret) {
 		return ret;
 	}
 
+	fill_vnet_hdr((struct eth_vnet_hdr *)ctx->send, pkt, SEND_DATA(ctx),
+		      count);
+
 	update_gptp(net_pkt_iface(pkt), pkt, true);
 
 	LOG_DBG("Send pkt %p len %d", pkt, count);
 
-	ret = eth_write_data(ctx->dev_fd, ctx->send, count);
+	ret = eth_write_data(ctx->dev_fd, ctx->send, ETH_VNET_HDR_LEN + count);
 	if (ret < 0) {
 		LOG_DBG("Cannot send pkt %p (%d)", pkt, ret);
 	}
@@ -235,7 +311,7 @@ static inline struct net_if *get_iface(struct eth_context *ctx,
 static struct net_pkt *prepare_vlan_pkt(struct eth_context *ctx,
 					int count, u16_t *vlan_tag, int *status)
 {
-	struct net_eth_vlan_hdr *hdr = (struct net_eth_vlan_hdr *)ctx->recv;
+	struct net_eth_vlan_hdr *hdr = (struct net_eth_vlan_hdr *)RECV_DATA(ctx);
 	struct net_pkt *pkt;
 	u8_t pos;
 
@@ -256,7 +332,7 @@ static struct net_pkt *prepare_vlan_pkt(struct eth_context *ctx,
 	pos = 0;
 
 	if (IS_ENABLED(CONFIG_ETH_NATIVE_POSIX_VLAN_TAG_STRIP)) {
-		if (net_pkt_write(pkt, ctx->recv,
+		if (net_pkt_write(pkt, RECV_DATA(ctx),
 				  2 * sizeof(struct net_eth_addr))) {
 			goto error;
 		}
@@ -265,7 +341,7 @@ static struct net_pkt *prepare_vlan_pkt(struct eth_context *ctx,
 		count -= (2 * sizeof(struct net_eth_addr));
 	}
 
-	if (net_pkt_write(pkt, ctx->recv + pos, count)) {
+	if (net_pkt_write(pkt, RECV_DATA(ctx) + pos, count)) {
 		goto error;
 	}
 
@@ -303,7 +379,7 @@ static struct net_pkt *prepare_non_vlan_pkt(struct eth_context *ctx,
 		return NULL;
 	}
 
-	if (net_pkt_write(pkt, ctx->recv, count)) {
+	if (net_pkt_write(pkt, RECV_DATA(ctx), count)) {
 		net_pkt_unref(pkt);
 		*status = -ENOBUFS;
 		return NULL;
@@ -316,7 +392,8 @@ static struct net_pkt *prepare_non_vlan_pkt(struct eth_context *ctx,
 	return pkt;
 }
 
-static int read_data(struct eth_context *ctx, int fd)
+/* Returns the next frame, set to the interface it was received on */
+static struct net_pkt *read_data(struct eth_context *ctx, int fd)
 {
 	u16_t vlan_tag = NET_VLAN_TAG_UNSPEC;
 	struct net_if *iface;
@@ -325,23 +402,26 @@ static int read_data(struct eth_context *ctx, int fd)
 	int count;
 
 	count = eth_read_data(fd, ctx->recv, sizeof(ctx->recv));
-	if (count <= 0) {
-		return 0;
+	if (count <= (int)ETH_VNET_HDR_LEN) {
+		return NULL;
 	}
 
+	/* The host does not send GSO packets unless asked to */
+	count -= ETH_VNET_HDR_LEN;
+
 #if defined(CONFIG_NET_VLAN)
 	{
-		struct net_eth_hdr *hdr = (struct net_eth_hdr *)(ctx->recv);
+		struct net_eth_hdr *hdr = (struct net_eth_hdr *)RECV_DATA(ctx);
 
 		if (ntohs(hdr->type) == NET_ETH_PTYPE_VLAN) {
 			pkt = prepare_vlan_pkt(ctx, count, &vlan_tag, &status);
 			if (!pkt) {
-				return status;
+				return NULL;
 			}
 		} else {
 			pkt = prepare_non_vlan_pkt(ctx, count, &status);
 			if (!pkt) {
-				return status;
+				return NULL;
 			}
 
 			net_pkt_set_vlan_tci(pkt, 0);
@@ -351,7 +431,7 @@ static int read_data(struct eth_context *ctx, int fd)
 	{
 		pkt = prepare_non_vlan_pkt(ctx, count, &status);
 		if (!pkt) {
-			return status;
+			return NULL;
 		}
 	}
 #endif
@@ -360,12 +440,43 @@ static int read_data(struct eth_context *ctx, int fd)
 
 	update_gptp(iface, pkt, false);
 
-	if (net_recv_data(iface, pkt) < 0) {
+	net_pkt_set_iface(pkt, iface);
+
+	return pkt;
+}
+
+#if defined(CONFIG_NET_RX_BATCH)
+/* Passes the frames pending on the TAP device to the stack at once, up
+ * to the poll budget.
+ */
+static void recv_data(struct eth_context *ctx)
+{
+	sys_slist_t pkts;
+	int count = 0;
+
+	sys_slist_init(&pkts);
+
+	do {
+		struct net_pkt *pkt = read_data(ctx, ctx->dev_fd);
+
+		if (pkt) {
+			net_pkt_rx_batch_add(&pkts, pkt);
+		}
+	} while (++count < CONFIG_NET_RX_POLL_BUDGET &&
+		 !eth_wait_data(ctx->dev_fd));
+
+	(void)net_recv_data_batch(&pkts);
+}
+#else
+static void recv_data(struct eth_context *ctx)
+{
+	struct net_pkt *pkt = read_data(ctx, ctx->dev_fd);
+
+	if (pkt && net_recv_data(net_pkt_iface(pkt), pkt) < 0) {
 		net_pkt_unref(pkt);
 	}
-
-	return 0;
 }
+#endif /* CONFIG_NET_RX_BATCH */
 
 static void eth_rx(struct eth_context *ctx)
 {
@@ -374,7 +485,7 @@ static void eth_rx(struct eth_context *ctx)
 	while (1) {
 		if (net_if_is_up(ctx->iface)) {
 			while (!eth_wait_data(ctx->dev_fd)) {
-				read_data(ctx, ctx->dev_fd);
+				recv_data(ctx);
 				k_yield();
 			}
 		}
@@ -474,6 +585,9 @@ enum ethernet_hw_caps eth_posix_native_get_capabilities(struct device *dev)
 #endif
 #if defined(CONFIG_NET_LLDP)
 		| ETHERNET_LLDP
+#endif
+#if defined(CONFIG_ETH_NATIVE_POSIX_TSO)
+		| ETHERNET_HW_TSO
 #endif
 		;
 }
@@ -67,6 +67,10 @@ int eth_iface_create(const char *if_name, bool tun_only)
 #ifdef __linux
 	ifr.ifr_flags = (tun_only ? IFF_TUN : IFF_TAP) | IFF_NO_PI;
 
+	if (IS_ENABLED(CONFIG_ETH_NATIVE_POSIX_TSO) && !tun_only) {
+		ifr.ifr_flags |= IFF_VNET_HDR;
+	}
+
 	strncpy(ifr.ifr_name, if_name, IFNAMSIZ - 1);
 
 	ret = ioctl(fd, TUNSETIFF, (void *)&ifr);
@@ -25,6 +25,30 @@
 #define ETH_NATIVE_POSIX_STARTUP_SCRIPT_USER ""
 #endif
 
+#if defined(CONFIG_ETH_NATIVE_POSIX_TSO)
+/* Same layout as struct virtio_net_hdr, which prefixes every frame read
+ * from or written to the TAP device when it is created with IFF_VNET_HDR.
+ * The fields are in host byte order.
+ */
+struct eth_vnet_hdr {
+	u8_t flags;
+	u8_t gso_type;
+	u16_t hdr_len;
+	u16_t gso_size;
+	u16_t csum_start;
+	u16_t csum_offset;
+} __packed;
+
+#define ETH_VNET_HDR_F_NEEDS_CSUM 1
+#define ETH_VNET_HDR_GSO_NONE     0
+#define ETH_VNET_HDR_GSO_TCPV4    1
+#define ETH_VNET_HDR_GSO_TCPV6    4
+
+#define ETH_VNET_HDR_LEN sizeof(struct eth_vnet_hdr)
+#else
+#define ETH_VNET_HDR_LEN 0
+#endif
+
 int eth_iface_create(const char *if_name, bool tun_only);
 int eth_iface_remove(int fd);
 int eth_setup_host(const char *if_name);
@@ -23,6 +23,29 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 #include <net/net_if.h>
 
 #include <net/dummy.h>
+#include <net/loopback.h>
+#include <random/rand32.h>
+
+#if defined(CONFIG_NET_LOOPBACK_SIMULATE_PACKET_DROP)
+static u32_t drop_threshold;
+static u32_t dropped;
+
+int loopback_set_packet_drop_rate(unsigned int per_mille)
+{
+	if (per_mille > 1000) {
+		return -EINVAL;
+	}
+
+	drop_threshold = (u64_t)per_mille * UINT32_MAX / 1000;
+
+	return 0;
+}
+
+u32_t loopback_get_num_dropped_packets(void)
+{
+	return dropped;
+}
+#endif
 
 int loopback_dev_init(struct device *dev)
 {
@@ -50,6 +73,14 @@ static int loopback_send(struct device *dev, struct net_pkt *pkt)
 		return -ENODATA;
 	}
 
+#if defined(CONFIG_NET_LOOPBACK_SIMULATE_PACKET_DROP)
+	/* Lost on the way, as far as the sender can tell it was sent */
+	if (drop_threshold && sys_rand32_get() <= drop_threshold) {
+		dropped++;
+		return 0;
+	}
+#endif
+
 	/* We need to swap the IP addresses because otherwise
 	 * the packet will be dropped.
 	 */
@@ -43,6 +43,7 @@ extern "C" {
  * @param write_block_size Alignment size
  * @param nvs_lock Mutex
  * @param flash_device Flash Device
+ * @param lookup_cache Latest allocation table entry address per id hash
  */
 struct nvs_fs {
 	off_t offset;		/* filesystem offset in flash */
@@ -57,6 +58,9 @@ struct nvs_fs {
 
 	struct k_mutex nvs_lock;
 	struct device *flash_device;
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	u32_t lookup_cache[CONFIG_NVS_LOOKUP_CACHE_SIZE];
+#endif
 };
 
 /**
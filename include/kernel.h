@@ -120,6 +120,7 @@ typedef struct {
 struct k_thread;
 struct k_mutex;
 struct k_sem;
+struct k_event;
 struct k_msgq;
 struct k_mbox;
 struct k_pipe;
@@ -480,7 +481,9 @@ struct _thread_base {
 	/* True for the per-CPU idle threads */
 	u8_t is_idle;
 
-	/* CPU index on which thread was last run */
+	/* CPU index on which thread was last run (with per-CPU run
+	 * queues, the CPU whose queue holds it while it is queued)
+	 */
 	u8_t cpu;
 
 	/* Recursive count of irq_lock() calls */
@@ -2806,8 +2809,11 @@ __syscall int k_stack_pop(struct k_stack *stack, stack_data_t *data,
 struct k_work;
 struct k_work_poll;
 
+struct z_wakeup_batch;
+
 /* private, used by k_poll and k_work_poll */
-typedef int (*_poller_cb_t)(struct k_poll_event *event, u32_t state);
+typedef int (*_poller_cb_t)(struct k_poll_event *event, u32_t state,
+			    struct z_wakeup_batch *batch);
 struct _poller {
 	volatile bool is_polling;
 	struct k_thread *thread;
@@ -3580,6 +3586,154 @@ static inline unsigned int z_impl_k_sem_count_get(struct k_sem *sem)
 
 /** @} */
 
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+struct k_event {
+	_wait_q_t wait_q;
+	u32_t events;
+	struct k_spinlock lock;
+
+	_OBJECT_TRACING_NEXT_PTR(k_event)
+	_OBJECT_TRACING_LINKED_FLAG
+};
+
+#define Z_EVENT_INITIALIZER(obj) \
+	{ \
+	.wait_q = Z_WAIT_Q_INIT(&obj.wait_q), \
+	.events = 0, \
+	_OBJECT_TRACING_INIT \
+	}
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/**
+ * @defgroup event_apis Event APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/** Wait until any of the requested events is set (the default) */
+#define K_EVENT_WAIT_ANY 0
+/** Wait until all of the requested events are set */
+#define K_EVENT_WAIT_ALL BIT(0)
+/** Clear the requested events when the wait is satisfied */
+#define K_EVENT_WAIT_CLEAR BIT(1)
+
+/**
+ * @brief Initialize an event object.
+ *
+ * This routine initializes an event object, prior to its first use,
+ * with no events set.
+ *
+ * @param event Address of the event object.
+ *
+ * @return N/A
+ */
+__syscall void k_event_init(struct k_event *event);
+
+/**
+ * @brief Post events to an event object.
+ *
+ * This routine sets the given events in addition to those already
+ * set, and wakes every waiting thread whose condition is now met.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param event Address of the event object.
+ * @param events Set of events to post.
+ *
+ * @return Events that were set before the call.
+ */
+__syscall u32_t k_event_post(struct k_event *event, u32_t events);
+
+/**
+ * @brief Set the events of an event object.
+ *
+ * This routine replaces the events of @a event with @a events, and
+ * wakes every waiting thread whose condition is now met.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param event Address of the event object.
+ * @param events Set of events to set.
+ *
+ * @return Events that were set before the call.
+ */
+__syscall u32_t k_event_set(struct k_event *event, u32_t events);
+
+/**
+ * @brief Clear events of an event object.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param event Address of the event object.
+ * @param events Set of events to clear.
+ *
+ * @return Events that were set before the call.
+ */
+__syscall u32_t k_event_clear(struct k_event *event, u32_t events);
+
+/**
+ * @brief Wait for events.
+ *
+ * This routine waits until any of @a events (or all of them, with
+ * K_EVENT_WAIT_ALL in @a options) is set in @a event.  Waiting threads
+ * are checked in priority order when events are posted, so with
+ * K_EVENT_WAIT_CLEAR the highest priority thread consumes the events
+ * first.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param event Address of the event object.
+ * @param events Set of events to wait for.
+ * @param options K_EVENT_WAIT_ANY or K_EVENT_WAIT_ALL, optionally
+ *                ORed with K_EVENT_WAIT_CLEAR.
+ * @param timeout Non-negative waiting period (in milliseconds), or one
+ *                of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @return All events set at the time the wait was satisfied (before
+ *         any clearing), or 0 if it was not satisfied in time.
+ */
+__syscall u32_t k_event_wait(struct k_event *event, u32_t events,
+			     u32_t options, s32_t timeout);
+
+/**
+ * @brief Get the current events of an event object.
+ *
+ * @param event Address of the event object.
+ *
+ * @return Events currently set.
+ */
+__syscall u32_t k_event_get(struct k_event *event);
+
+/**
+ * @internal
+ */
+static inline u32_t z_impl_k_event_get(struct k_event *event)
+{
+	return event->events;
+}
+
+/**
+ * @brief Statically define and initialize an event object.
+ *
+ * The event object can be accessed outside the module where it is
+ * defined using:
+ *
+ * @code extern struct k_event <name>; @endcode
+ *
+ * @param name Name of the event object.
+ */
+#define K_EVENT_DEFINE(name) \
+	Z_STRUCT_SECTION_ITERABLE(k_event, name) = \
+		Z_EVENT_INITIALIZER(name)
+
+/** @} */
+
 /**
  * @defgroup msgq_apis Message Queue APIs
  * @ingroup kernel_apis
@@ -4289,6 +4443,16 @@ extern void k_pipe_block_put(struct k_pipe *pipe, struct k_mem_block *block,
  * @cond INTERNAL_HIDDEN
  */
 
+#ifdef CONFIG_MEM_SLAB_MAGAZINES
+struct z_mem_slab_magazine {
+	struct k_spinlock lock;
+	u32_t count;
+	u32_t hits;
+	u32_t misses;
+	void *blocks[CONFIG_MEM_SLAB_MAGAZINE_SIZE];
+};
+#endif
+
 struct k_mem_slab {
 	_wait_q_t wait_q;
 	u32_t num_blocks;
@@ -4296,6 +4460,11 @@ struct k_mem_slab {
 	char *buffer;
 	char *free_list;
 	u32_t num_used;
+#ifdef CONFIG_MEM_SLAB_MAGAZINES
+	/* Threads about to pend, forcing frees past the magazines */
+	atomic_t waiters;
+	struct z_mem_slab_magazine magazines[CONFIG_MP_NUM_CPUS];
+#endif
 
 	_OBJECT_TRACING_NEXT_PTR(k_mem_slab)
 	_OBJECT_TRACING_LINKED_FLAG
@@ -4426,7 +4595,20 @@ extern void k_mem_slab_free(struct k_mem_slab *slab, void **mem);
  */
 static inline u32_t k_mem_slab_num_used_get(struct k_mem_slab *slab)
 {
+#ifdef CONFIG_MEM_SLAB_MAGAZINES
+	u32_t cached = 0U;
+
+	/* num_used counts blocks off the shared free list, including
+	 * those cached in the magazines
+	 */
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		cached += slab->magazines[i].count;
+	}
+
+	return slab->num_used - cached;
+#else
 	return slab->num_used;
+#endif
 }
 
 /**
@@ -4442,9 +4624,35 @@ static inline u32_t k_mem_slab_num_used_get(struct k_mem_slab *slab)
  */
 static inline u32_t k_mem_slab_num_free_get(struct k_mem_slab *slab)
 {
-	return slab->num_blocks - slab->num_used;
+	return slab->num_blocks - k_mem_slab_num_used_get(slab);
 }
 
+#if defined(CONFIG_MEM_SLAB_MAGAZINES) || defined(__DOXYGEN__)
+/**
+ * @brief Memory slab magazine statistics
+ */
+struct k_mem_slab_magazine_stats {
+	/** Allocations served from a non-empty per-CPU magazine */
+	u32_t hits;
+	/** Allocations that had to refill from the shared free list */
+	u32_t misses;
+};
+
+/**
+ * @brief Get the per-CPU magazine statistics of a memory slab.
+ *
+ * Sums the hit and miss counts of every CPU's magazine.  The counts
+ * are read without locking and are only exact while the slab is idle.
+ *
+ * @param slab Address of the memory slab.
+ * @param stats Structure filled in with the statistics.
+ *
+ * @return N/A
+ */
+extern void k_mem_slab_magazine_stats_get(struct k_mem_slab *slab,
+					struct k_mem_slab_magazine_stats *stats);
+#endif
+
 /** @} */
 
 /**
@@ -4564,6 +4772,123 @@ extern void k_mem_pool_free_id(struct k_mem_block_id *id);
  * @}
  */
 
+/**
+ * @defgroup kheap_apis Kernel Heap APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/**
+ * @brief Kernel heap
+ *
+ * A k_heap is a sys_heap (see include/sys/sys_heap.h) protected by a
+ * spinlock, with a wait queue so that allocators may block until
+ * memory is freed.  Unlike k_mem_pool, allocations are sized to the
+ * byte (modulo a small header and alignment) rather than rounded to
+ * a power-of-four block size, and allocation and free run in
+ * constant time.
+ */
+struct k_heap {
+	struct sys_heap heap;
+	_wait_q_t wait_q;
+	struct k_spinlock lock;
+};
+
+/**
+ * @brief Initialize a k_heap
+ *
+ * This constructs a synchronized k_heap object over a memory region
+ * specified by the user.  Note that while any alignment and size can
+ * be passed as valid parameters, internal alignment restrictions
+ * inside the inner sys_heap mean that not all bytes may be usable as
+ * allocated memory.
+ *
+ * @param h Heap struct to initialize
+ * @param mem Pointer to memory.
+ * @param bytes Size of memory region, in bytes
+ */
+void k_heap_init(struct k_heap *h, void *mem, size_t bytes);
+
+/**
+ * @brief Allocate aligned memory from a k_heap
+ *
+ * Behaves in all ways like k_heap_alloc(), except that the returned
+ * memory (if available) will have a starting address in memory which
+ * is a multiple of the specified power-of-two alignment value in
+ * bytes.
+ *
+ * @param h Heap from which to allocate
+ * @param align Alignment in bytes, must be a power of two
+ * @param bytes Number of bytes requested
+ * @param timeout Waiting period (in milliseconds), or K_NO_WAIT or
+ *        K_FOREVER
+ * @return Pointer to memory the caller can now use, or NULL
+ */
+void *k_heap_aligned_alloc(struct k_heap *h, size_t align, size_t bytes,
+			   s32_t timeout);
+
+/**
+ * @brief Allocate memory from a k_heap
+ *
+ * Allocates and returns a memory buffer from the memory region owned
+ * by the heap.  If no memory is available immediately, the call will
+ * block for the specified timeout waiting for memory to be freed.  If
+ * the allocation cannot be performed by the expiration of the
+ * timeout, NULL will be returned.
+ *
+ * @note When called from an ISR, @a timeout must be K_NO_WAIT.
+ *
+ * @param h Heap from which to allocate
+ * @param bytes Desired size of block to allocate
+ * @param timeout Waiting period (in milliseconds), or K_NO_WAIT or
+ *        K_FOREVER
+ * @return A pointer to valid heap memory, or NULL
+ */
+void *k_heap_alloc(struct k_heap *h, size_t bytes, s32_t timeout);
+
+/**
+ * @brief Free memory allocated by k_heap_alloc()
+ *
+ * Returns the specified memory block, which must have been returned
+ * from k_heap_alloc() or k_heap_aligned_alloc(), to the heap for use
+ * by other callers.  Passing a NULL block is legal, and has no
+ * effect.
+ *
+ * @param h Heap to which to return the memory
+ * @param mem A valid memory block, or NULL
+ */
+void k_heap_free(struct k_heap *h, void *mem);
+
+/**
+ * @brief Get k_heap runtime statistics
+ *
+ * @param h Heap to query
+ * @param stats Structure filled in with the current statistics
+ */
+void k_heap_runtime_stats_get(struct k_heap *h,
+			      struct sys_heap_runtime_stats *stats);
+
+/**
+ * @brief Define a static k_heap
+ *
+ * This macro defines and initializes a static memory region and
+ * k_heap of the requested size.  After kernel start, &name can be
+ * used as if k_heap_init() had been called.
+ *
+ * @param name Symbol name for the struct k_heap object
+ * @param bytes Size of memory region, in bytes
+ */
+#define K_HEAP_DEFINE(name, bytes)				\
+	char __aligned(sizeof(void *)) kheap_##name[bytes];	\
+	Z_STRUCT_SECTION_ITERABLE(k_heap, name) = {		\
+		.heap = {					\
+			.init_mem = kheap_##name,		\
+			.init_bytes = (bytes),			\
+		 },						\
+	}
+
+/** @} */
+
 /**
  * @defgroup heap_apis Heap Memory Pool APIs
  * @ingroup kernel_apis
@@ -4897,7 +5222,7 @@ __syscall void k_poll_signal_check(struct k_poll_signal *signal,
  * @brief Signal a poll signal object.
  *
  * This routine makes ready a poll signal, which is basically a poll event of
- * type K_POLL_TYPE_SIGNAL. If a thread was polling on that event, it will be
+ * type K_POLL_TYPE_SIGNAL. Every thread polling on that event will be
  * made ready to run. A @a result value can be specified.
  *
  * The poll signal contains a 'signaled' field that, when set by
@@ -4914,7 +5239,7 @@ __syscall void k_poll_signal_check(struct k_poll_signal *signal,
  * @param result The value to store in the result field of the signal.
  *
  * @retval 0 The signal was delivered successfully.
- * @retval -EAGAIN The polling thread's timeout is in the process of expiring.
+ * @retval -EAGAIN A polling thread's timeout is in the process of expiring.
  * @req K-POLL-001
  */
 
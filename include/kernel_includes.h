@@ -26,6 +26,7 @@
 #include <sys/sflist.h>
 #include <sys/util.h>
 #include <sys/mempool_base.h>
+#include <sys/sys_heap.h>
 #include <kernel_structs.h>
 #include <kernel_version.h>
 #include <random/rand32.h>
@@ -50,6 +50,11 @@ extern "C" {
  */
 #define LOG_OUTPUT_FLAG_FORMAT_SYST		BIT(7)
 
+/** @brief Flag forcing binary dictionary format, decoded on the host with
+ *         the ELF file of the application.
+ */
+#define LOG_OUTPUT_FLAG_FORMAT_DICT		BIT(8)
+
 /**
  * @brief Prototype of the function processing output data.
  *
@@ -154,6 +159,16 @@ void log_output_hexdump(const struct log_output *log_output,
  */
 void log_output_dropped_process(const struct log_output *log_output, u32_t cnt);
 
+/** @brief Process dropped messages indication in dictionary format.
+ *
+ * Function outputs a binary record with the number of lost log messages.
+ *
+ * @param log_output Pointer to the log output instance.
+ * @param cnt        Number of dropped messages.
+ */
+void log_output_dict_dropped_process(const struct log_output *log_output,
+				     u32_t cnt);
+
 /** @brief Flush output buffer.
  *
  * @param log_output Pointer to the log output instance.
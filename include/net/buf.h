@@ -984,6 +984,149 @@ extern const struct net_buf_data_cb net_buf_var_cb;
 		NET_BUF_POOL_INITIALIZER(_name, &net_buf_data_alloc_##_name,  \
 					 _net_buf_##_name, _count, _destroy)
 
+/**
+ * @brief Size class of the data of a network buffer pool.
+ *
+ * The statistics are only updated, never reset.
+ */
+struct net_buf_data_class {
+	/** Data size of the blocks of this class */
+	const u16_t size;
+
+	/** Slab of the blocks, each with a small header before the data */
+	struct k_mem_slab *const slab;
+
+	/** Allocations served by this class */
+	atomic_t allocs;
+
+	/** Allocations served by this class as the best fit was empty */
+	atomic_t fallbacks;
+
+	/** Allocations which failed with this class as the best fit */
+	atomic_t failures;
+
+	/** Bytes requested by the allocations served by this class, as long
+	 *  as it does not wrap around.
+	 */
+	atomic_t requested;
+};
+
+struct net_buf_pool_class {
+	/** Data classes, by increasing size */
+	struct net_buf_data_class *const *classes;
+
+	/** Number of data classes */
+	u8_t count;
+};
+
+/** @cond INTERNAL_HIDDEN */
+extern const struct net_buf_data_cb net_buf_class_cb;
+
+/* Reference count and class index, in front of the data */
+#define NET_BUF_DATA_CLASS_HDR_SIZE 4
+/** @endcond */
+
+/**
+ * @def NET_BUF_DATA_CLASS_DEFINE
+ * @brief Define a size class for the data of network buffers
+ *
+ * Defines a memory slab of fixed size data blocks, to be used by one or
+ * more pools defined with NET_BUF_POOL_CLASS_DEFINE.
+ *
+ * @param _name      Name of the data class variable.
+ * @param _size      Data size of the blocks.
+ * @param _count     Number of blocks.
+ */
+#define NET_BUF_DATA_CLASS_DEFINE(_name, _size, _count)                       \
+	K_MEM_SLAB_DEFINE(net_buf_class_slab_##_name,                         \
+			  NET_BUF_DATA_CLASS_HDR_SIZE + (_size), _count, 4);  \
+	static struct net_buf_data_class _name = {                            \
+		.size = _size,                                                \
+		.slab = &net_buf_class_slab_##_name,                          \
+	}
+
+/**
+ * @def NET_BUF_POOL_CLASS_DEFINE
+ * @brief Define a new pool for buffers with size classes for the data
+ *
+ * Defines a net_buf_pool struct and the necessary memory storage (array of
+ * structs) for the needed amount of buffers. After this, the buffers can be
+ * accessed from the pool through net_buf_alloc. The pool is defined as a
+ * static variable, so if it needs to be exported outside the current module
+ * this needs to happen with the help of a separate pointer rather than an
+ * extern declaration.
+ *
+ * The data payload of the buffers will be allocated from the smallest data
+ * class it fits in, or from the next larger class if that one is empty.
+ * Blocking happens only on the best fitting class, once all the larger
+ * ones are empty too. Requests larger than the largest class fail.
+ *
+ * If provided with a custom destroy callback, this callback is
+ * responsible for eventually calling net_buf_destroy() to complete the
+ * process of returning the buffer to the pool.
+ *
+ * @param _name      Name of the pool variable.
+ * @param _count     Number of buffers in the pool.
+ * @param _destroy   Optional destroy callback when buffer is freed.
+ * @param ...        Pointers to the data classes, by increasing size.
+ */
+#define NET_BUF_POOL_CLASS_DEFINE(_name, _count, _destroy, ...)               \
+	static struct net_buf _net_buf_##_name[_count] __noinit;              \
+	static struct net_buf_data_class *const net_buf_classes_##_name[] = { \
+		__VA_ARGS__                                                   \
+	};                                                                    \
+	static const struct net_buf_pool_class net_buf_class_##_name = {      \
+		.classes = net_buf_classes_##_name,                           \
+		.count = ARRAY_SIZE(net_buf_classes_##_name),                 \
+	};                                                                    \
+	static const struct net_buf_data_alloc net_buf_class_alloc_##_name = {\
+		.cb = &net_buf_class_cb,                                      \
+		.alloc_data = (void *)&net_buf_class_##_name,                 \
+	};                                                                    \
+	struct net_buf_pool _name __net_buf_align                             \
+			__in_section(_net_buf_pool, static, _name) =          \
+		NET_BUF_POOL_INITIALIZER(_name, &net_buf_class_alloc_##_name, \
+					 _net_buf_##_name, _count, _destroy)
+
+/**
+ * @brief Get the data classes of a pool.
+ *
+ * @param pool Buffer pool.
+ *
+ * @return Data classes of a pool defined with NET_BUF_POOL_CLASS_DEFINE,
+ * NULL for the other pools.
+ */
+static inline
+const struct net_buf_pool_class *net_buf_pool_classes(struct net_buf_pool *pool)
+{
+	if (pool->alloc->cb != &net_buf_class_cb) {
+		return NULL;
+	}
+
+	return pool->alloc->alloc_data;
+}
+
+/**
+ * @brief Get the memory efficiency of a data class.
+ *
+ * @param data_class Data class.
+ *
+ * @return Percentage of the allocated data blocks that was requested by
+ * the allocations, 0 if there were none.
+ */
+static inline
+u32_t net_buf_data_class_efficiency(struct net_buf_data_class *data_class)
+{
+	u32_t allocs = atomic_get(&data_class->allocs);
+	u32_t requested = atomic_get(&data_class->requested);
+
+	if (!allocs) {
+		return 0;
+	}
+
+	return (u64_t)requested * 100U / ((u64_t)allocs * data_class->size);
+}
+
 /**
  * @def NET_BUF_POOL_DEFINE
  * @brief Define a new pool for buffers
@@ -0,0 +1,50 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Network loopback interface
+ */
+
+#ifndef ZEPHYR_INCLUDE_NET_LOOPBACK_H_
+#define ZEPHYR_INCLUDE_NET_LOOPBACK_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Loopback interface
+ * @defgroup loopback Loopback Interface
+ * @ingroup networking
+ * @{
+ */
+
+#if defined(CONFIG_NET_LOOPBACK_SIMULATE_PACKET_DROP)
+/**
+ * @brief Set the rate at which the loopback interface drops packets
+ *
+ * @param per_mille Drop rate, in packets per thousand
+ *
+ * @return 0 if ok, <0 if error
+ */
+int loopback_set_packet_drop_rate(unsigned int per_mille);
+
+/**
+ * @brief Get the number of packets the loopback interface has dropped
+ *
+ * @return Number of dropped packets
+ */
+u32_t loopback_get_num_dropped_packets(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* ZEPHYR_INCLUDE_NET_LOOPBACK_H_ */
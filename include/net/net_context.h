@@ -277,6 +277,11 @@ struct net_context {
 		struct k_fifo accept_q;
 	};
 
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+	/** epoll instances watching this socket */
+	sys_slist_t epoll_items;
+#endif /* CONFIG_NET_SOCKETS_EPOLL */
+
 #if defined(CONFIG_NET_SOCKETS_SOCKOPT_TLS)
 	/** TLS context information */
 	struct tls_context *tls;
@@ -82,6 +82,76 @@ enum net_verdict {
  */
 int net_recv_data(struct net_if *iface, struct net_pkt *pkt);
 
+#if defined(CONFIG_NET_RX_BATCH)
+/**
+ * @brief Called by network device driver to pass a batch of received
+ * network packets to the network stack.
+ *
+ * @details The packets are chained with net_pkt_rx_batch_add() and each
+ * one is received on the interface it was allocated for. Packets of the
+ * same traffic class are queued with a single work item, which processes
+ * them in one pass. Packets that cannot be received are unreffed.
+ *
+ * @param pkts List of network packets, empty on return.
+ *
+ * @return Number of packets queued.
+ */
+int net_recv_data_batch(sys_slist_t *pkts);
+
+struct net_rx_poll;
+
+/**
+ * @typedef net_rx_poll_cb_t
+ * @brief Callback receiving packets from a device in polled mode.
+ *
+ * @details Receives up to @a budget packets into @a pkts. If fewer are
+ * received, the device has no more packets pending and the callback
+ * re-enables its receive interrupt before returning. Otherwise it leaves
+ * the interrupt disabled and is called again.
+ *
+ * @param poll Poll context of the device.
+ * @param pkts List to add the received packets to.
+ * @param budget Maximum number of packets to receive.
+ *
+ * @return Number of packets received or dropped.
+ */
+typedef int (*net_rx_poll_cb_t)(struct net_rx_poll *poll, sys_slist_t *pkts,
+				int budget);
+
+/**
+ * @brief Polled receive context of a network device.
+ *
+ * A driver disables its receive interrupt when it fires and schedules
+ * the poll context, so that packets arriving back to back are received
+ * in batches from the RX thread instead of one per interrupt.
+ */
+struct net_rx_poll {
+	/** Work item running the callback */
+	struct k_work work;
+
+	/** Callback receiving the packets */
+	net_rx_poll_cb_t cb;
+};
+
+/**
+ * @brief Initialize a polled receive context.
+ *
+ * @param poll Poll context of the device.
+ * @param cb Callback receiving the packets.
+ */
+void net_rx_poll_init(struct net_rx_poll *poll, net_rx_poll_cb_t cb);
+
+/**
+ * @brief Schedule the polled reception of packets.
+ *
+ * @details This can be called from an ISR, with the receive interrupt
+ * of the device disabled.
+ *
+ * @param poll Poll context of the device.
+ */
+void net_rx_poll_schedule(struct net_rx_poll *poll);
+#endif /* CONFIG_NET_RX_BATCH */
+
 /**
  * @brief Send data to network.
  *
@@ -404,6 +404,57 @@ struct net_traffic_class {
 	int tc;
 };
 
+#if defined(CONFIG_NET_TX_QDISC)
+/** @cond INTERNAL_HIDDEN */
+struct net_if_qdisc_slot {
+	/* Ticket of the producer the slot is free for, or one past it
+	 * once the packet is stored.
+	 */
+	atomic_t seq;
+	struct net_pkt *pkt;
+};
+/** @endcond */
+
+/**
+ * @brief TX queue of one traffic class of a network interface
+ *
+ * Any number of threads can add packets, only the current owner of the
+ * interface queues takes them.
+ */
+struct net_if_qdisc_class {
+	/** @cond INTERNAL_HIDDEN */
+	struct net_if_qdisc_slot slots[CONFIG_NET_TX_QDISC_LEN];
+	atomic_t tail;
+	atomic_t head;
+	u32_t deficit;
+	struct k_work work;
+	u8_t tc;
+	/** @endcond */
+
+	/** Packets queued */
+	atomic_t queued;
+
+	/** Packets dropped because the queue was full */
+	atomic_t dropped;
+};
+
+/**
+ * @brief TX queuing discipline of a network interface
+ */
+struct net_if_qdisc {
+	/** Queue of each traffic class */
+	struct net_if_qdisc_class classes[NET_TC_TX_COUNT];
+
+	/** @cond INTERNAL_HIDDEN */
+	atomic_t owner;
+	u8_t next;
+	/** @endcond */
+
+	/** Packets passed to the driver without being queued */
+	atomic_t bypassed;
+};
+#endif /* CONFIG_NET_TX_QDISC */
+
 /**
  * @brief Network Interface Device structure
  *
@@ -469,6 +520,11 @@ struct net_if {
 
 	/** Network interface instance configuration */
 	struct net_if_config config;
+
+#if defined(CONFIG_NET_TX_QDISC)
+	/** TX queues of this network interface */
+	struct net_if_qdisc qdisc;
+#endif /* CONFIG_NET_TX_QDISC */
 } __net_if_align;
 
 /**
@@ -1932,6 +1988,18 @@ bool net_if_need_calc_rx_checksum(struct net_if *iface);
  */
 bool net_if_need_calc_tx_checksum(struct net_if *iface);
 
+/**
+ * @brief Check if TCP packets larger than the MTU can be sent, so that the
+ * L2 or the device splits them into segments (generic segmentation
+ * offload).
+ *
+ * @param iface Network interface
+ *
+ * @return True if the interface accepts TCP packets larger than the MTU,
+ * false otherwise.
+ */
+bool net_if_is_gso_capable(struct net_if *iface);
+
 /**
  * @brief Get interface according to index
  *
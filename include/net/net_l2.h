@@ -42,6 +42,12 @@ enum net_l2_flags {
 	 * IP address etc to network interface.
 	 */
 	NET_L2_POINT_TO_POINT			= BIT(3),
+
+	/** TCP packets larger than the MTU are accepted and split into
+	 * segments by the L2 or by the device (generic segmentation
+	 * offload).
+	 */
+	NET_L2_GSO				= BIT(4),
 } __packed;
 
 /**
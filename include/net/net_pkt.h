@@ -71,6 +71,10 @@ struct net_pkt {
 		 * the same memory area.
 		 */
 		intptr_t sock_recv_fifo;
+		/** Drivers chain the packets of a received batch before
+		 * they are queued to the RX work queue.
+		 */
+		sys_snode_t rx_batch_node;
 	};
 
 	/** Slab pointer from where it belongs to */
@@ -213,6 +217,13 @@ struct net_pkt {
 	u16_t vlan_tci;
 #endif /* CONFIG_NET_VLAN */
 
+#if defined(CONFIG_NET_TCP_GSO)
+	/* Payload size of the segments this TCP packet is split into by
+	 * the L2, or 0 if it fits in the MTU and is sent as is.
+	 */
+	u16_t gso_size;
+#endif /* CONFIG_NET_TCP_GSO */
+
 #if defined(CONFIG_NET_IPV6)
 	/* Where is the start of the last header before payload data
 	 * in IPv6 packet. This is offset value from start of the IPv6
@@ -251,6 +262,19 @@ static inline struct k_work *net_pkt_work(struct net_pkt *pkt)
 	return &pkt->work;
 }
 
+static inline void net_pkt_rx_batch_add(sys_slist_t *pkts,
+					struct net_pkt *pkt)
+{
+	sys_slist_append(pkts, &pkt->rx_batch_node);
+}
+
+static inline struct net_pkt *net_pkt_rx_batch_get(sys_slist_t *pkts)
+{
+	sys_snode_t *node = sys_slist_get(pkts);
+
+	return node ? CONTAINER_OF(node, struct net_pkt, rx_batch_node) : NULL;
+}
+
 /* The interface real ll address */
 static inline struct net_linkaddr *net_pkt_lladdr_if(struct net_pkt *pkt)
 {
@@ -750,6 +774,31 @@ static inline void net_pkt_set_vlan_tci(struct net_pkt *pkt, u16_t tci)
 }
 #endif
 
+#if defined(CONFIG_NET_TCP_GSO)
+static inline u16_t net_pkt_gso_size(struct net_pkt *pkt)
+{
+	return pkt->gso_size;
+}
+
+static inline void net_pkt_set_gso_size(struct net_pkt *pkt, u16_t size)
+{
+	pkt->gso_size = size;
+}
+#else
+static inline u16_t net_pkt_gso_size(struct net_pkt *pkt)
+{
+	ARG_UNUSED(pkt);
+
+	return 0;
+}
+
+static inline void net_pkt_set_gso_size(struct net_pkt *pkt, u16_t size)
+{
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(size);
+}
+#endif /* CONFIG_NET_TCP_GSO */
+
 #if defined(CONFIG_NET_PKT_TIMESTAMP)
 static inline struct net_ptp_time *net_pkt_timestamp(struct net_pkt *pkt)
 {
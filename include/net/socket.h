@@ -54,6 +54,8 @@ struct zsock_pollfd {
 
 /** zsock_recv: Read data without removing it from socket input queue */
 #define ZSOCK_MSG_PEEK 0x02
+/** zsock_recvmsg: Datagram was larger than the buffers (output value only) */
+#define ZSOCK_MSG_TRUNC 0x20
 /** zsock_recv/zsock_send: Override operation to non-blocking */
 #define ZSOCK_MSG_DONTWAIT 0x40
 
@@ -310,6 +312,81 @@ __syscall ssize_t zsock_recvfrom(int sock, void *buf, size_t max_len,
 				 int flags, struct sockaddr *src_addr,
 				 socklen_t *addrlen);
 
+/**
+ * @brief Receive a message from a socket
+ *
+ * @details
+ * @rst
+ * See `POSIX.1-2017 article
+ * <http://pubs.opengroup.org/onlinepubs/9699919799/functions/recvmsg.html>`__
+ * for normative description.
+ * This function is also exposed as ``recvmsg()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * Ancillary data is not supported, ``msg_controllen`` is set to 0.
+ * @endrst
+ */
+__syscall ssize_t zsock_recvmsg(int sock, struct msghdr *msg, int flags);
+
+/**
+ * @brief Receive several messages from a socket
+ *
+ * @details
+ * @rst
+ * See `Linux man page
+ * <http://man7.org/linux/man-pages/man2/recvmmsg.2.html>`__
+ * for a description.
+ * This function is also exposed as ``recvmmsg()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * Only the wait for the first message follows ``flags``, the others are
+ * received if already queued, as with Linux ``MSG_WAITFORONE``. There
+ * is no timeout argument.
+ * @endrst
+ *
+ * @return Number of messages received, or -1 if none could be.
+ */
+__syscall int zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+			     unsigned int vlen, int flags);
+
+/**
+ * @brief Send several messages on a socket
+ *
+ * @details
+ * @rst
+ * See `Linux man page
+ * <http://man7.org/linux/man-pages/man2/sendmmsg.2.html>`__
+ * for a description.
+ * This function is also exposed as ``sendmmsg()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @return Number of messages sent, or -1 if none could be.
+ */
+__syscall int zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+			     unsigned int vlen, int flags);
+
+#if defined(CONFIG_NET_SOCKETS_RECV_ZEROCOPY)
+struct net_buf;
+
+/**
+ * @brief Receive a datagram without copying its data
+ *
+ * @details Takes the next datagram queued on a UDP socket and passes the
+ * chain of network buffers holding its payload to the caller, which
+ * must release it with net_buf_unref(). As the buffers belong to the
+ * kernel, this is only available to supervisor threads.
+ *
+ * @param sock Datagram socket.
+ * @param frags Set to the buffer chain, NULL if the payload is empty.
+ * @param flags ZSOCK_MSG_DONTWAIT or 0.
+ * @param src_addr Set to the source address if not NULL.
+ * @param addrlen Size of @a src_addr, set to the actual size.
+ *
+ * @return Length of the payload, or -1 with errno set.
+ */
+ssize_t zsock_recv_zerocopy(int sock, struct net_buf **frags, int flags,
+			    struct sockaddr *src_addr, socklen_t *addrlen);
+#endif /* CONFIG_NET_SOCKETS_RECV_ZEROCOPY */
+
 /**
  * @brief Receive data from a connected peer
  *
@@ -358,6 +435,91 @@ __syscall int zsock_fcntl(int sock, int cmd, int flags);
  */
 __syscall int zsock_poll(struct zsock_pollfd *fds, int nfds, int timeout);
 
+/** zsock_epoll_ctl: Register a socket with an epoll instance */
+#define ZSOCK_EPOLL_CTL_ADD 1
+/** zsock_epoll_ctl: Remove a socket from an epoll instance */
+#define ZSOCK_EPOLL_CTL_DEL 2
+/** zsock_epoll_ctl: Change the events a socket is watched for */
+#define ZSOCK_EPOLL_CTL_MOD 3
+
+/* ZSOCK_EPOLL* values are compatible with Linux */
+/** zsock_epoll: Watch for readability */
+#define ZSOCK_EPOLLIN ZSOCK_POLLIN
+/** zsock_epoll: Watch for writability */
+#define ZSOCK_EPOLLOUT ZSOCK_POLLOUT
+/** zsock_epoll: Error condition (output value only) */
+#define ZSOCK_EPOLLERR ZSOCK_POLLERR
+/** zsock_epoll: Closed connection (output value only) */
+#define ZSOCK_EPOLLHUP ZSOCK_POLLHUP
+/** zsock_epoll: Disable the socket after it is reported once */
+#define ZSOCK_EPOLLONESHOT BIT(30)
+/** zsock_epoll: Report the socket only when it becomes ready */
+#define ZSOCK_EPOLLET BIT(31)
+
+/** Data returned by zsock_epoll_wait() for a ready socket */
+union zsock_epoll_data {
+	void *ptr;
+	int fd;
+	u32_t u32;
+};
+
+struct zsock_epoll_event {
+	/** Events watched for, or ready */
+	u32_t events;
+	/** Opaque data given to zsock_epoll_ctl() */
+	union zsock_epoll_data data;
+};
+
+/**
+ * @brief Create an epoll instance
+ *
+ * @details
+ * @rst
+ * See `Linux man page
+ * <http://man7.org/linux/man-pages/man7/epoll.7.html>`__ for
+ * normative description. Unlike zsock_poll(), sockets are registered
+ * with the instance once, and get queued on its ready list by the
+ * network stack when data arrives, so the cost of waiting depends on
+ * the number of ready sockets, not on the number of watched ones.
+ * Only native (non-TLS, non-offloaded) sockets can be registered.
+ * The instance is released with zsock_close().
+ * This function is also exposed as ``epoll_create1()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ */
+__syscall int zsock_epoll_create(int flags);
+
+/**
+ * @brief Add, modify or remove a socket watched by an epoll instance
+ *
+ * @details
+ * @rst
+ * See `Linux man page
+ * <http://man7.org/linux/man-pages/man2/epoll_ctl.2.html>`__
+ * for normative description. Closing a socket removes it from every
+ * instance it was registered with.
+ * This function is also exposed as ``epoll_ctl()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ */
+__syscall int zsock_epoll_ctl(int epfd, int op, int sock,
+			      struct zsock_epoll_event *event);
+
+/**
+ * @brief Wait for sockets watched by an epoll instance to become ready
+ *
+ * @details
+ * @rst
+ * See `Linux man page
+ * <http://man7.org/linux/man-pages/man2/epoll_wait.2.html>`__
+ * for normative description.
+ * This function is also exposed as ``epoll_wait()``
+ * if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ */
+__syscall int zsock_epoll_wait(int epfd, struct zsock_epoll_event *events,
+			       int maxevents, int timeout);
+
 /**
  * @brief Get various socket options
  *
@@ -629,11 +791,48 @@ static inline ssize_t recvfrom(int sock, void *buf, size_t max_len, int flags,
 	return zsock_recvfrom(sock, buf, max_len, flags, src_addr, addrlen);
 }
 
+static inline ssize_t recvmsg(int sock, struct msghdr *msg, int flags)
+{
+	return zsock_recvmsg(sock, msg, flags);
+}
+
+static inline int recvmmsg(int sock, struct mmsghdr *msgvec,
+			   unsigned int vlen, int flags)
+{
+	return zsock_recvmmsg(sock, msgvec, vlen, flags);
+}
+
+static inline int sendmmsg(int sock, struct mmsghdr *msgvec,
+			   unsigned int vlen, int flags)
+{
+	return zsock_sendmmsg(sock, msgvec, vlen, flags);
+}
+
 static inline int poll(struct zsock_pollfd *fds, int nfds, int timeout)
 {
 	return zsock_poll(fds, nfds, timeout);
 }
 
+#define epoll_event zsock_epoll_event
+#define epoll_data_t union zsock_epoll_data
+
+static inline int epoll_create1(int flags)
+{
+	return zsock_epoll_create(flags);
+}
+
+static inline int epoll_ctl(int epfd, int op, int sock,
+			    struct zsock_epoll_event *event)
+{
+	return zsock_epoll_ctl(epfd, op, sock, event);
+}
+
+static inline int epoll_wait(int epfd, struct zsock_epoll_event *events,
+			     int maxevents, int timeout)
+{
+	return zsock_epoll_wait(epfd, events, maxevents, timeout);
+}
+
 static inline int getsockopt(int sock, int level, int optname,
 			     void *optval, socklen_t *optlen)
 {
@@ -701,7 +900,18 @@ static inline char *inet_ntop(sa_family_t family, const void *src, char *dst,
 #define POLLHUP ZSOCK_POLLHUP
 #define POLLNVAL ZSOCK_POLLNVAL
 
+#define EPOLL_CTL_ADD ZSOCK_EPOLL_CTL_ADD
+#define EPOLL_CTL_DEL ZSOCK_EPOLL_CTL_DEL
+#define EPOLL_CTL_MOD ZSOCK_EPOLL_CTL_MOD
+#define EPOLLIN ZSOCK_EPOLLIN
+#define EPOLLOUT ZSOCK_EPOLLOUT
+#define EPOLLERR ZSOCK_EPOLLERR
+#define EPOLLHUP ZSOCK_EPOLLHUP
+#define EPOLLONESHOT ZSOCK_EPOLLONESHOT
+#define EPOLLET ZSOCK_EPOLLET
+
 #define MSG_PEEK ZSOCK_MSG_PEEK
+#define MSG_TRUNC ZSOCK_MSG_TRUNC
 #define MSG_DONTWAIT ZSOCK_MSG_DONTWAIT
 
 #define SHUT_RD ZSOCK_SHUT_RD
@@ -326,6 +326,47 @@ int settings_save_one(const char *name, const void *value, size_t val_len);
  */
 int settings_delete(const char *name);
 
+/**
+ * Start a batch of saves. Until the matching @ref settings_save_commit,
+ * values saved with @ref settings_save_one or deleted with
+ * @ref settings_delete are kept in RAM, repeated saves of a key only keeping
+ * the last value, and are then written to the backend as one batch. Batches
+ * nest, the outermost one writing the values.
+ *
+ * The batch is not atomic: if it does not fit in
+ * CONFIG_SETTINGS_SAVE_BUFFER_ENTRIES, or a value is longer than
+ * CONFIG_SETTINGS_SAVE_BUFFER_VAL_LEN, it is written in several parts.
+ *
+ * Requires CONFIG_SETTINGS_SAVE_BUFFER.
+ *
+ * @return 0 on success, -ENOENT if there is no destination backend.
+ */
+int settings_save_begin(void);
+
+/**
+ * Commit a batch of saves started by @ref settings_save_begin, writing the
+ * values kept in RAM if it is the outermost one.
+ *
+ * Requires CONFIG_SETTINGS_SAVE_BUFFER.
+ *
+ * Values the backend fails to write stay in RAM, and are written again by
+ * the next flush.
+ *
+ * @return 0 on success, -EINVAL if no batch was started or the first error
+ * returned by the backend.
+ */
+int settings_save_commit(void);
+
+/**
+ * Write the values kept in RAM to the backend now, whether in a batch or
+ * waiting for the delay of CONFIG_SETTINGS_SAVE_DEFERRED.
+ *
+ * Requires CONFIG_SETTINGS_SAVE_BUFFER.
+ *
+ * @return 0 on success, non-zero on failure.
+ */
+int settings_save_flush(void);
+
 /**
  * Call commit for all settings handler. This should apply all
  * settings which has been set, but not applied yet.
@@ -8,6 +8,10 @@
 
 #include <sys/atomic.h>
 
+#ifdef CONFIG_SPIN_STATS
+#include <stdbool.h>
+#endif
+
 /* There's a spinlock validation framework available when asserts are
  * enabled.  It adds a relatively hefty overhead (about 3k or so) to
  * kernel code size, don't use on platforms known to be small.
@@ -40,6 +44,15 @@ struct k_spinlock {
 	uintptr_t thread_cpu;
 #endif
 
+#ifdef CONFIG_SPIN_STATS
+	/* Number of times the lock was taken, and of those, how many
+	 * times it first had to spin because another CPU held it.
+	 * Only updated with the lock held.
+	 */
+	u32_t acquired;
+	u32_t contended;
+#endif
+
 #if defined(CONFIG_CPLUSPLUS) && !defined(CONFIG_SMP) && \
 	!defined(CONFIG_SPIN_VALIDATE)
 	/* If CONFIG_SMP and CONFIG_SPIN_VALIDATE are both not defined
@@ -74,7 +87,18 @@ static ALWAYS_INLINE k_spinlock_key_t k_spin_lock(struct k_spinlock *l)
 	__ASSERT(z_spin_lock_valid(l), "Recursive spinlock %p", l);
 #endif
 
-#ifdef CONFIG_SMP
+#ifdef CONFIG_SPIN_STATS
+	bool contended = false;
+
+	while (!atomic_cas(&l->locked, 0, 1)) {
+		contended = true;
+	}
+
+	l->acquired++;
+	if (contended) {
+		l->contended++;
+	}
+#elif defined(CONFIG_SMP)
 	while (!atomic_cas(&l->locked, 0, 1)) {
 	}
 #endif
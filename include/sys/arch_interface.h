@@ -344,6 +344,19 @@ static inline struct _cpu *arch_curr_cpu(void);
  * This will invoke z_sched_ipi() on other CPUs in the system.
  */
 void arch_sched_ipi(void);
+
+#ifdef CONFIG_ARCH_HAS_DIRECTED_IPIS
+/**
+ * Send a scheduler interrupt to a set of CPUs
+ *
+ * Like arch_sched_ipi(), but only the CPUs whose bits are set in
+ * @a cpu_bitmap (bit N for the CPU with id N) are interrupted.  A bit
+ * for the calling CPU is ignored.
+ *
+ * @param cpu_bitmap Bitmask of CPU ids to interrupt
+ */
+void arch_sched_directed_ipi(u32_t cpu_bitmap);
+#endif
 #endif /* CONFIG_SMP */
 
 /** @} */
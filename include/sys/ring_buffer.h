@@ -21,8 +21,25 @@ extern "C" {
 
 #define SIZE32_OF(x) (sizeof((x))/sizeof(u32_t))
 
+/* Multi-producer control word: count of puts in progress in the top
+ * bits, reserved write index in the low bits.
+ */
+#define Z_RING_BUF_MPSC_CNT_SHIFT 24
+#define Z_RING_BUF_MPSC_IDX_MASK (BIT(Z_RING_BUF_MPSC_CNT_SHIFT) - 1)
+#define Z_RING_BUF_MPSC_CNT_MAX 0xFFU
+
 /**
  * @brief A structure to represent a ring buffer
+ *
+ * One producer and one consumer may use a ring buffer concurrently
+ * without any locking: each side only writes its own index (@a tail for
+ * the producer, @a head for the consumer) and publishes it with a full
+ * memory barrier once the data it covers has been written or read.  An
+ * ISR feeding a thread, or the other way around, is the typical case.
+ * Byte mode ring buffers initialized with ring_buf_mpsc_init() or
+ * defined with RING_BUF_MPSC_DECLARE additionally accept any number of
+ * concurrent producers through the ring_buf_mpsc_put APIs.  Several
+ * consumers always need to be serialized by the caller.
  */
 struct ring_buf {
 	u32_t head;	 /**< Index in buf for the head element */
@@ -38,6 +55,13 @@ struct ring_buf {
 			u32_t tmp_tail;
 			u32_t tmp_head;
 		} byte_mode;
+		struct ring_buf_misc_mpsc_mode {
+			atomic_t ctrl; /**< Puts in progress and reserved
+					 * write index, in place of
+					 * tmp_tail.
+					 */
+			u32_t tmp_head;
+		} mpsc_mode;
 	} misc;
 	u32_t size;   /**< Size of buf in 32-bit chunks */
 
@@ -46,6 +70,19 @@ struct ring_buf {
 		u8_t *buf8;
 	} buf;
 	u32_t mask;   /**< Modulo mask if size is a power of 2 */
+	bool mpsc;    /**< Accepts multiple producers */
+};
+
+/**
+ * @brief A segment of a ring buffer claim
+ *
+ * A claim that wraps around the end of the ring buffer is returned as two
+ * segments, the second starting at the beginning of the buffer.  The size
+ * of an unused second segment is 0.
+ */
+struct ring_buf_seg {
+	u8_t *data; /**< Start of the segment within the ring buffer */
+	u32_t size; /**< Size of the segment (in bytes) */
 };
 
 /**
@@ -127,6 +164,25 @@ struct ring_buf {
 		.buf = { .buf8 = _ring_buffer_data_##name} \
 	}
 
+/**
+ * @brief Statically define and initialize a multi-producer byte ring buffer.
+ *
+ * This macro establishes a ring buffer like RING_BUF_DECLARE, which in
+ * addition accepts concurrent producers using ring_buf_mpsc_put(),
+ * ring_buf_mpsc_put_claim() and ring_buf_mpsc_put_finish().
+ *
+ * @param name  Name of the ring buffer.
+ * @param size8 Size of ring buffer (in bytes), at most 2^24.
+ */
+#define RING_BUF_MPSC_DECLARE(name, size8) \
+	BUILD_ASSERT(size8 <= BIT(Z_RING_BUF_MPSC_CNT_SHIFT)); \
+	static u8_t _ring_buffer_data_##name[size8]; \
+	struct ring_buf name = { \
+		.size = size8, \
+		.buf = { .buf8 = _ring_buffer_data_##name}, \
+		.mpsc = true \
+	}
+
 
 /**
  * @brief Initialize a ring buffer.
@@ -156,6 +212,44 @@ static inline void ring_buf_init(struct ring_buf *buf, u32_t size, void *data)
 	}
 }
 
+/**
+ * @brief Initialize a multi-producer byte ring buffer.
+ *
+ * Like ring_buf_init() for a byte mode ring buffer, for use with the
+ * ring_buf_mpsc_put APIs.  It is only used for ring buffers not defined
+ * using RING_BUF_MPSC_DECLARE.
+ *
+ * @param buf Address of ring buffer.
+ * @param size Ring buffer size (in bytes), at most 2^24.
+ * @param data Ring buffer data area (u8_t data[size]).
+ */
+static inline void ring_buf_mpsc_init(struct ring_buf *buf, u32_t size,
+				      void *data)
+{
+	__ASSERT_NO_MSG(size <= BIT(Z_RING_BUF_MPSC_CNT_SHIFT));
+	ring_buf_init(buf, size, data);
+	buf->mpsc = true;
+}
+
+/** @brief Update the tail of a multi-producer ring buffer.
+ *
+ * @note Function for internal use.
+ *
+ * On the consumer side of a multi-producer ring buffer the tail is only
+ * advanced when no put is in progress, which guarantees that all data up
+ * to the reserved index has been written.
+ *
+ * @param buf Ring buffer.
+ */
+static inline void z_ring_buf_mpsc_tail_sync(struct ring_buf *buf)
+{
+	u32_t ctrl = (u32_t)atomic_get(&buf->misc.mpsc_mode.ctrl);
+
+	if ((ctrl >> Z_RING_BUF_MPSC_CNT_SHIFT) == 0U) {
+		buf->tail = ctrl;
+	}
+}
+
 /** @brief Determine free space based on ring buffer parameters.
  *
  * @note Function for internal use.
@@ -186,6 +280,10 @@ static inline u32_t z_ring_buf_custom_space_get(u32_t size, u32_t head,
  */
 static inline int ring_buf_is_empty(struct ring_buf *buf)
 {
+	if (buf->mpsc) {
+		z_ring_buf_mpsc_tail_sync(buf);
+	}
+
 	return (buf->head == buf->tail);
 }
 
@@ -303,6 +401,29 @@ int ring_buf_item_get(struct ring_buf *buf, u16_t *type, u8_t *value,
  */
 u32_t ring_buf_put_claim(struct ring_buf *buf, u8_t **data, u32_t size);
 
+/**
+ * @brief Allocate buffer space for writing, across the wrap-around.
+ *
+ * Like ring_buf_put_claim(), but if the free space wraps around the end of
+ * the ring buffer both parts are claimed at once, so the whole claim can
+ * be filled by a single scatter-gather operation (e.g. DMA).  Written
+ * bytes are confirmed with ring_buf_put_finish() as usual.
+ *
+ * @warning
+ * Use cases involving multiple writers to the ring buffer must prevent
+ * concurrent write operations, either by preventing all writers from
+ * being preempted or by using a mutex to govern writes to the ring buffer.
+ *
+ * @param[in]  buf  Address of ring buffer.
+ * @param[out] seg  Array of two segments set to the claimed space.
+ * @param[in]  size Requested allocation size (in bytes).
+ *
+ * @return Total size of the claimed segments which can be smaller than
+ *	   requested if there is not enough free space.
+ */
+u32_t ring_buf_put_claim_segs(struct ring_buf *buf, struct ring_buf_seg seg[2],
+			      u32_t size);
+
 /**
  * @brief Indicate number of bytes written to allocated buffers.
  *
@@ -371,6 +492,29 @@ u32_t ring_buf_put(struct ring_buf *buf, const u8_t *data, u32_t size);
  */
 u32_t ring_buf_get_claim(struct ring_buf *buf, u8_t **data, u32_t size);
 
+/**
+ * @brief Get addresses of valid data in a ring buffer, across the wrap-around.
+ *
+ * Like ring_buf_get_claim(), but if the valid data wraps around the end of
+ * the ring buffer both parts are claimed at once, so the whole claim can
+ * be consumed by a single scatter-gather operation (e.g. DMA).  Consumed
+ * bytes are freed with ring_buf_get_finish() as usual.
+ *
+ * @warning
+ * Use cases involving multiple reads of the ring buffer must prevent
+ * concurrent read operations, either by preventing all readers from
+ * being preempted or by using a mutex to govern reads to the ring buffer.
+ *
+ * @param[in]  buf  Address of ring buffer.
+ * @param[out] seg  Array of two segments set to the claimed data.
+ * @param[in]  size Requested size (in bytes).
+ *
+ * @return Total size of the claimed segments which can be smaller than
+ *	   requested if there is not enough data.
+ */
+u32_t ring_buf_get_claim_segs(struct ring_buf *buf, struct ring_buf_seg seg[2],
+			      u32_t size);
+
 /**
  * @brief Indicate number of bytes read from claimed buffer.
  *
@@ -413,6 +557,47 @@ int ring_buf_get_finish(struct ring_buf *buf, u32_t size);
  */
 u32_t ring_buf_get(struct ring_buf *buf, u8_t *data, u32_t size);
 
+/**
+ * @brief Reserve space in a multi-producer ring buffer.
+ *
+ * Reserves exactly @a size bytes for the caller, who may be one of any
+ * number of concurrent producers running in threads or ISRs, and returns
+ * the space as up to two segments.  The whole reservation must be filled
+ * and then committed with ring_buf_mpsc_put_finish(); it cannot be
+ * shrunk.  The consumer sees the data once no reservation is in progress
+ * any more, so reservations should be held only briefly.
+ *
+ * @param[in]  buf  Address of ring buffer initialized for multiple producers.
+ * @param[out] seg  Array of two segments set to the reserved space.
+ * @param[in]  size Size to reserve (in bytes).
+ *
+ * @retval 0 Not enough free space, nothing was reserved.
+ * @retval size Space was reserved.
+ */
+u32_t ring_buf_mpsc_put_claim(struct ring_buf *buf, struct ring_buf_seg seg[2],
+			      u32_t size);
+
+/**
+ * @brief Commit a reservation in a multi-producer ring buffer.
+ *
+ * @param buf Address of ring buffer initialized for multiple producers.
+ */
+void ring_buf_mpsc_put_finish(struct ring_buf *buf);
+
+/**
+ * @brief Write (copy) data to a multi-producer ring buffer.
+ *
+ * Writes all of @a data, or nothing if there is not enough free space.
+ * Safe to call concurrently from any number of threads and ISRs.
+ *
+ * @param buf Address of ring buffer initialized for multiple producers.
+ * @param data Address of data.
+ * @param size Data size (in bytes).
+ *
+ * @retval Number of bytes written, either @a size or 0.
+ */
+u32_t ring_buf_mpsc_put(struct ring_buf *buf, const u8_t *data, u32_t size);
+
 /**
  * @}
  */
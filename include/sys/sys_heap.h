@@ -0,0 +1,142 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_SYS_HEAP_H_
+#define ZEPHYR_INCLUDE_SYS_SYS_HEAP_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <zephyr/types.h>
+
+/*
+ * General-purpose heap built on a two-level segregated fit (TLSF)
+ * allocator.  Free blocks are binned by size into a first level of
+ * power-of-two classes, each split linearly into second level
+ * sub-classes, with a bitmap per level.  Allocation and free are
+ * constant time: a request is rounded up to the next sub-class so
+ * that the head of the first non-empty bin at or above it always
+ * fits, and freed blocks are merged with their physical neighbours
+ * through boundary tags.
+ *
+ * All bookkeeping lives inside the managed memory region.  The heap
+ * is not synchronized: callers must provide their own locking (see
+ * k_heap for the kernel wrapper that does so).
+ */
+
+struct z_heap;
+
+struct sys_heap {
+	struct z_heap *heap;
+	void *init_mem;
+	size_t init_bytes;
+};
+
+/**
+ * @brief Heap runtime statistics
+ *
+ * Byte counts include the per-block header, so allocated_bytes plus
+ * free_bytes always equals the capacity of the heap.
+ */
+struct sys_heap_runtime_stats {
+	/** Bytes currently in free blocks */
+	size_t free_bytes;
+	/** Bytes currently in allocated blocks */
+	size_t allocated_bytes;
+	/** High-water mark of allocated_bytes since init */
+	size_t max_allocated_bytes;
+	/** Largest request that can currently be satisfied */
+	size_t largest_free_bytes;
+};
+
+/** @brief Initialize sys_heap
+ *
+ * Initializes a sys_heap struct to manage the specified memory.
+ *
+ * @param h Heap to initialize
+ * @param mem Untyped pointer to unused memory
+ * @param bytes Size of region pointed to by @a mem
+ */
+void sys_heap_init(struct sys_heap *h, void *mem, size_t bytes);
+
+/** @brief Allocate memory from a sys_heap
+ *
+ * Returns a pointer to a block of unused memory in the heap.  This
+ * memory will not otherwise be used until it is freed with
+ * sys_heap_free().  If no memory can be allocated, NULL will be
+ * returned.  The returned memory is aligned to at least twice the
+ * size of a pointer.
+ *
+ * @note The sys_heap implementation is not internally synchronized.
+ * No two sys_heap functions should operate on the same heap at the
+ * same time.  All locking must be provided by the user.
+ *
+ * @param h Heap from which to allocate
+ * @param bytes Number of bytes requested
+ * @return Pointer to memory the caller can now use, or NULL
+ */
+void *sys_heap_alloc(struct sys_heap *h, size_t bytes);
+
+/** @brief Allocate aligned memory from a sys_heap
+ *
+ * Behaves in all ways like sys_heap_alloc(), except that the
+ * returned memory (if available) will have a starting address in
+ * memory which is a multiple of the specified power-of-two
+ * alignment value in bytes.
+ *
+ * @param h Heap from which to allocate
+ * @param align Alignment in bytes, must be a power of two
+ * @param bytes Number of bytes requested
+ * @return Pointer to memory the caller can now use, or NULL
+ */
+void *sys_heap_aligned_alloc(struct sys_heap *h, size_t align, size_t bytes);
+
+/** @brief Free memory into a sys_heap
+ *
+ * De-allocates a pointer to memory previously returned from
+ * sys_heap_alloc() or sys_heap_realloc() such that it can be used
+ * for other purposes.  The caller must not use the memory region
+ * after entry to this function.  It is safe to pass NULL.
+ *
+ * @param h Heap to which to return the memory
+ * @param mem A pointer previously returned from sys_heap_alloc()
+ */
+void sys_heap_free(struct sys_heap *h, void *mem);
+
+/** @brief Resize memory allocated from a sys_heap
+ *
+ * Changes the size of the block at @a ptr to @a bytes, preserving
+ * its contents up to the smaller of the old and new sizes.  Shrinking
+ * and growing into a free physical neighbour happen in place; only
+ * otherwise is a new block allocated and the data copied.  A NULL
+ * @a ptr behaves like sys_heap_alloc(), and a zero @a bytes like
+ * sys_heap_free() returning NULL.  On failure NULL is returned and
+ * the original block is left untouched.
+ *
+ * @param h Heap from which the memory was allocated
+ * @param ptr Pointer previously returned from sys_heap_alloc(), or NULL
+ * @param bytes New size in bytes
+ * @return Pointer to the resized memory, or NULL
+ */
+void *sys_heap_realloc(struct sys_heap *h, void *ptr, size_t bytes);
+
+/** @brief Get heap runtime statistics
+ *
+ * @param h Heap to query
+ * @param stats Structure filled in with the current statistics
+ */
+void sys_heap_runtime_stats_get(struct sys_heap *h,
+				struct sys_heap_runtime_stats *stats);
+
+/** @brief Validate heap integrity
+ *
+ * Walks every block in the heap and cross-checks the boundary tags,
+ * free lists and bitmaps.  Intended for test code, not for normal
+ * operation.
+ *
+ * @param h Heap to validate
+ * @return true if the heap is consistent
+ */
+bool sys_heap_validate(struct sys_heap *h);
+
+#endif /* ZEPHYR_INCLUDE_SYS_SYS_HEAP_H_ */
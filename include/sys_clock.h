@@ -137,6 +137,9 @@ typedef void (*_timeout_func_t)(struct _timeout *t);
 
 struct _timeout {
 	sys_dnode_t node;
+#ifdef CONFIG_TIMEOUT_WHEEL
+	u64_t expiry;	/* absolute tick, used by the timing wheel */
+#endif
 	s32_t dticks;
 	_timeout_func_t fn;
 };
@@ -0,0 +1,234 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ *
+ * @brief Kernel event object.
+ *
+ * An event object is a 32-bit set of events that threads can wait on,
+ * either for any or for all of a mask of them.  Waiters sit directly on
+ * the object's wait queue with their condition, so posting costs one
+ * pass over the waiters and waiting costs nothing beyond pending,
+ * unlike k_poll() which has to register and unregister an event per
+ * condition on every call.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <debug/object_tracing_common.h>
+#include <toolchain.h>
+#include <wait_q.h>
+#include <ksched.h>
+#include <init.h>
+#include <syscall_handler.h>
+
+/* What a pending thread waits for; lives on its stack and is found
+ * through base.swap_data
+ */
+struct event_waiter {
+	u32_t events;
+	u32_t options;
+	/* Events at the time the wait was satisfied */
+	u32_t result;
+};
+
+#ifdef CONFIG_OBJECT_TRACING
+
+struct k_event *_trace_list_k_event;
+
+/*
+ * Complete initialization of statically defined event objects.
+ */
+static int init_event_module(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	Z_STRUCT_SECTION_FOREACH(k_event, event) {
+		SYS_TRACING_OBJ_INIT(k_event, event);
+	}
+	return 0;
+}
+
+SYS_INIT(init_event_module, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
+
+#endif /* CONFIG_OBJECT_TRACING */
+
+void z_impl_k_event_init(struct k_event *event)
+{
+	event->events = 0U;
+	z_waitq_init(&event->wait_q);
+
+	SYS_TRACING_OBJ_INIT(k_event, event);
+
+	z_object_init(event);
+}
+
+#ifdef CONFIG_USERSPACE
+static inline void z_vrfy_k_event_init(struct k_event *event)
+{
+	Z_OOPS(Z_SYSCALL_OBJ_INIT(event, K_OBJ_EVENT));
+	z_impl_k_event_init(event);
+}
+#include <syscalls/k_event_init_mrsh.c>
+#endif
+
+static bool are_wait_conditions_met(u32_t current, u32_t events,
+				    u32_t options)
+{
+	if ((options & K_EVENT_WAIT_ALL) != 0U) {
+		return (current & events) == events;
+	}
+
+	return (current & events) != 0U;
+}
+
+/* Called under the scheduler lock for each waiter, which is woken up
+ * if true is returned
+ */
+static bool event_wake_op(struct k_thread *thread, void *data)
+{
+	struct event_waiter *waiter = thread->base.swap_data;
+	u32_t *current = data;
+
+	if (!are_wait_conditions_met(*current, waiter->events,
+				     waiter->options)) {
+		return false;
+	}
+
+	waiter->result = *current;
+	if ((waiter->options & K_EVENT_WAIT_CLEAR) != 0U) {
+		*current &= ~waiter->events;
+	}
+
+	return true;
+}
+
+/* Replace the events selected by mask with those in events, and wake
+ * every waiter that is now satisfied.  Waiters are visited in priority
+ * order, so those clearing what they waited for consume it before
+ * lower priority ones get to look.
+ */
+static u32_t event_update(struct k_event *event, u32_t events, u32_t mask)
+{
+	k_spinlock_key_t key = k_spin_lock(&event->lock);
+	u32_t previous = event->events;
+	u32_t current = (previous & ~mask) | (events & mask);
+
+	/* Nothing can become satisfied unless new events appear */
+	if ((current & ~previous) == 0U) {
+		event->events = current;
+		k_spin_unlock(&event->lock, key);
+		return previous;
+	}
+
+	z_sched_wake_matching(&event->wait_q, event_wake_op, &current);
+
+	event->events = current;
+
+	z_reschedule(&event->lock, key);
+
+	return previous;
+}
+
+u32_t z_impl_k_event_post(struct k_event *event, u32_t events)
+{
+	return event_update(event, events, events);
+}
+
+#ifdef CONFIG_USERSPACE
+static inline u32_t z_vrfy_k_event_post(struct k_event *event, u32_t events)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(event, K_OBJ_EVENT));
+	return z_impl_k_event_post(event, events);
+}
+#include <syscalls/k_event_post_mrsh.c>
+#endif
+
+u32_t z_impl_k_event_set(struct k_event *event, u32_t events)
+{
+	return event_update(event, events, ~0U);
+}
+
+#ifdef CONFIG_USERSPACE
+static inline u32_t z_vrfy_k_event_set(struct k_event *event, u32_t events)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(event, K_OBJ_EVENT));
+	return z_impl_k_event_set(event, events);
+}
+#include <syscalls/k_event_set_mrsh.c>
+#endif
+
+u32_t z_impl_k_event_clear(struct k_event *event, u32_t events)
+{
+	return event_update(event, 0U, events);
+}
+
+#ifdef CONFIG_USERSPACE
+static inline u32_t z_vrfy_k_event_clear(struct k_event *event, u32_t events)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(event, K_OBJ_EVENT));
+	return z_impl_k_event_clear(event, events);
+}
+#include <syscalls/k_event_clear_mrsh.c>
+#endif
+
+u32_t z_impl_k_event_wait(struct k_event *event, u32_t events,
+			  u32_t options, s32_t timeout)
+{
+	struct event_waiter waiter = {
+		.events = events,
+		.options = options,
+	};
+	k_spinlock_key_t key;
+	u32_t current;
+
+	__ASSERT(((arch_is_in_isr() == false) || (timeout == K_NO_WAIT)), "");
+
+	if (events == 0U) {
+		return 0U;
+	}
+
+	key = k_spin_lock(&event->lock);
+	current = event->events;
+
+	if (are_wait_conditions_met(current, events, options)) {
+		if ((options & K_EVENT_WAIT_CLEAR) != 0U) {
+			event->events = current & ~events;
+		}
+		k_spin_unlock(&event->lock, key);
+		return current;
+	}
+
+	if (timeout == K_NO_WAIT) {
+		k_spin_unlock(&event->lock, key);
+		return 0U;
+	}
+
+	_current->base.swap_data = &waiter;
+	if (z_pend_curr(&event->lock, key, &event->wait_q, timeout) != 0) {
+		return 0U;
+	}
+
+	return waiter.result;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline u32_t z_vrfy_k_event_wait(struct k_event *event, u32_t events,
+					u32_t options, s32_t timeout)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(event, K_OBJ_EVENT));
+	return z_impl_k_event_wait(event, events, options, timeout);
+}
+#include <syscalls/k_event_wait_mrsh.c>
+#endif
+
+#ifdef CONFIG_USERSPACE
+static inline u32_t z_vrfy_k_event_get(struct k_event *event)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(event, K_OBJ_EVENT));
+	return z_impl_k_event_get(event);
+}
+#include <syscalls/k_event_get_mrsh.c>
+#endif
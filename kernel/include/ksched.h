@@ -36,6 +36,12 @@ BUILD_ASSERT(K_LOWEST_APPLICATION_THREAD_PRIO
 #define Z_ASSERT_VALID_PRIO(prio, entry_point) __ASSERT((prio) == -1, "")
 #endif
 
+/* State for a batch of wakeups, see z_ready_thread_batched() */
+struct z_wakeup_batch {
+	bool queued;
+	u32_t ipi_mask;
+};
+
 void z_sched_init(void);
 void z_move_thread_to_end_of_prio_q(struct k_thread *thread);
 void z_remove_thread_from_ready_q(struct k_thread *thread);
@@ -61,8 +67,36 @@ void z_reset_time_slice(void);
 void z_sched_abort(struct k_thread *thread);
 void z_sched_ipi(void);
 void z_sched_start(struct k_thread *thread);
+#ifdef CONFIG_SPIN_STATS
+void z_sched_lock_stats_get(u32_t *acquired, u32_t *contended);
+#endif
 void z_ready_thread(struct k_thread *thread);
 
+/* Batched wakeups: z_ready_thread_batched() queues the thread like
+ * z_ready_thread() but defers the cache update and any IPI to
+ * z_wakeup_batch_flush(), so that waking N threads costs one
+ * scheduling decision instead of N.  The flush must happen before
+ * the caller releases the lock under which it made the wakeups.
+ */
+static inline void z_wakeup_batch_init(struct z_wakeup_batch *batch)
+{
+	batch->queued = false;
+	batch->ipi_mask = 0U;
+}
+
+void z_ready_thread_batched(struct k_thread *thread,
+			    struct z_wakeup_batch *batch);
+void z_wakeup_batch_flush(struct z_wakeup_batch *batch);
+
+/* Call func, in priority order, on the threads pended on wait_q, and
+ * unpend and ready with a return value of 0 each one for which it
+ * returns true.  All of it runs under the scheduler lock, so func only
+ * sees threads that no timeout can unpend before they are woken.
+ */
+void z_sched_wake_matching(_wait_q_t *wait_q,
+			   bool (*func)(struct k_thread *thread, void *data),
+			   void *data);
+
 static inline void z_pend_curr_unlocked(_wait_q_t *wait_q, s32_t timeout)
 {
 	(void) z_pend_curr_irqlock(arch_irq_lock(), wait_q, timeout);
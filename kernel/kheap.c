@@ -0,0 +1,93 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <ksched.h>
+#include <wait_q.h>
+#include <init.h>
+
+void k_heap_init(struct k_heap *h, void *mem, size_t bytes)
+{
+	z_waitq_init(&h->wait_q);
+	sys_heap_init(&h->heap, mem, bytes);
+}
+
+static int statics_init(struct device *unused)
+{
+	ARG_UNUSED(unused);
+
+	Z_STRUCT_SECTION_FOREACH(k_heap, h) {
+		k_heap_init(h, h->heap.init_mem, h->heap.init_bytes);
+	}
+
+	return 0;
+}
+
+SYS_INIT(statics_init, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
+
+void *k_heap_aligned_alloc(struct k_heap *h, size_t align, size_t bytes,
+			   s32_t timeout)
+{
+	s64_t now, end = 0;
+	void *ret = NULL;
+	k_spinlock_key_t key = k_spin_lock(&h->lock);
+
+	__ASSERT(!arch_is_in_isr() || timeout == K_NO_WAIT, "");
+
+	if (timeout > 0) {
+		end = k_uptime_get() + timeout;
+	}
+
+	while (true) {
+		ret = sys_heap_aligned_alloc(&h->heap, align, bytes);
+
+		if (ret != NULL || timeout == K_NO_WAIT) {
+			break;
+		}
+
+		(void) z_pend_curr(&h->lock, key, &h->wait_q, timeout);
+		key = k_spin_lock(&h->lock);
+
+		if (timeout != K_FOREVER) {
+			now = k_uptime_get();
+			if (now >= end) {
+				ret = sys_heap_aligned_alloc(&h->heap, align,
+							     bytes);
+				break;
+			}
+			timeout = end - now;
+		}
+	}
+
+	k_spin_unlock(&h->lock, key);
+	return ret;
+}
+
+void *k_heap_alloc(struct k_heap *h, size_t bytes, s32_t timeout)
+{
+	return k_heap_aligned_alloc(h, sizeof(void *), bytes, timeout);
+}
+
+void k_heap_free(struct k_heap *h, void *mem)
+{
+	k_spinlock_key_t key = k_spin_lock(&h->lock);
+
+	sys_heap_free(&h->heap, mem);
+
+	/* Let any blocked allocators retry */
+	if (z_unpend_all(&h->wait_q) != 0) {
+		z_reschedule(&h->lock, key);
+	} else {
+		k_spin_unlock(&h->lock, key);
+	}
+}
+
+void k_heap_runtime_stats_get(struct k_heap *h,
+			      struct sys_heap_runtime_stats *stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&h->lock);
+
+	sys_heap_runtime_stats_get(&h->heap, stats);
+	k_spin_unlock(&h->lock, key);
+}
@@ -14,6 +14,7 @@
 #include <ksched.h>
 #include <init.h>
 #include <sys/check.h>
+#include <string.h>
 
 static struct k_spinlock lock;
 
@@ -43,6 +44,11 @@ static int create_free_list(struct k_mem_slab *slab)
 	slab->free_list = NULL;
 	p = slab->buffer;
 
+#ifdef CONFIG_MEM_SLAB_MAGAZINES
+	(void)memset(slab->magazines, 0, sizeof(slab->magazines));
+	atomic_set(&slab->waiters, 0);
+#endif
+
 	for (j = 0U; j < slab->num_blocks; j++) {
 		*(char **)p = slab->free_list;
 		slab->free_list = p;
@@ -101,11 +107,143 @@ out:
 	return rc;
 }
 
+#ifdef CONFIG_MEM_SLAB_MAGAZINES
+/* Magazines are refilled and drained half a magazine at a time, so
+ * that a CPU alternating allocs and frees at a boundary does not
+ * take the shared lock every time.
+ *
+ * Lock order is magazine (in CPU order), then the shared lock.  The
+ * caller's interrupts stay locked around a magazine lock so that it
+ * cannot migrate away from the CPU whose magazine it picked.
+ */
+#define MAG_BATCH (CONFIG_MEM_SLAB_MAGAZINE_SIZE / 2)
+
+static bool mag_alloc(struct k_mem_slab *slab, void **mem)
+{
+	unsigned int irq = arch_irq_lock();
+	struct z_mem_slab_magazine *mag = &slab->magazines[_current_cpu->id];
+	k_spinlock_key_t key = k_spin_lock(&mag->lock);
+	bool ret = false;
+
+	if (mag->count != 0U) {
+		mag->hits++;
+	} else {
+		k_spinlock_key_t skey = k_spin_lock(&lock);
+
+		mag->misses++;
+		while (mag->count < MAG_BATCH && slab->free_list != NULL) {
+			mag->blocks[mag->count++] = slab->free_list;
+			slab->free_list = *(char **)(slab->free_list);
+			slab->num_used++;
+		}
+		k_spin_unlock(&lock, skey);
+	}
+
+	if (mag->count != 0U) {
+		*mem = mag->blocks[--mag->count];
+		ret = true;
+	}
+
+	k_spin_unlock(&mag->lock, key);
+	arch_irq_unlock(irq);
+
+	return ret;
+}
+
+/* Last resort before failing or pending: take a block cached by
+ * any CPU
+ */
+static bool mag_steal(struct k_mem_slab *slab, void **mem)
+{
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct z_mem_slab_magazine *mag = &slab->magazines[i];
+		k_spinlock_key_t key = k_spin_lock(&mag->lock);
+
+		if (mag->count != 0U) {
+			*mem = mag->blocks[--mag->count];
+			k_spin_unlock(&mag->lock, key);
+			return true;
+		}
+
+		k_spin_unlock(&mag->lock, key);
+	}
+
+	return false;
+}
+
+static bool mag_free(struct k_mem_slab *slab, void *mem)
+{
+	unsigned int irq = arch_irq_lock();
+	struct z_mem_slab_magazine *mag = &slab->magazines[_current_cpu->id];
+	k_spinlock_key_t key = k_spin_lock(&mag->lock);
+	bool ret = false;
+
+	/* A thread that may pend has scanned (or will scan) every
+	 * magazine after raising waiters, so once it is raised frees
+	 * must go to the shared path where they can be handed over.
+	 */
+	if (atomic_get(&slab->waiters) == 0) {
+		if (mag->count == CONFIG_MEM_SLAB_MAGAZINE_SIZE) {
+			k_spinlock_key_t skey = k_spin_lock(&lock);
+
+			while (mag->count > CONFIG_MEM_SLAB_MAGAZINE_SIZE -
+			       MAG_BATCH) {
+				char *block = mag->blocks[--mag->count];
+
+				*(char **)block = slab->free_list;
+				slab->free_list = block;
+				slab->num_used--;
+			}
+			k_spin_unlock(&lock, skey);
+		}
+
+		mag->blocks[mag->count++] = mem;
+		ret = true;
+	}
+
+	k_spin_unlock(&mag->lock, key);
+	arch_irq_unlock(irq);
+
+	return ret;
+}
+
+void k_mem_slab_magazine_stats_get(struct k_mem_slab *slab,
+				   struct k_mem_slab_magazine_stats *stats)
+{
+	stats->hits = 0U;
+	stats->misses = 0U;
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		stats->hits += slab->magazines[i].hits;
+		stats->misses += slab->magazines[i].misses;
+	}
+}
+#endif /* CONFIG_MEM_SLAB_MAGAZINES */
+
 int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, s32_t timeout)
 {
-	k_spinlock_key_t key = k_spin_lock(&lock);
+	k_spinlock_key_t key;
 	int result;
 
+#ifdef CONFIG_MEM_SLAB_MAGAZINES
+	if (mag_alloc(slab, mem)) {
+		return 0;
+	}
+
+	if (timeout != K_NO_WAIT) {
+		atomic_inc(&slab->waiters);
+	}
+
+	if (mag_steal(slab, mem)) {
+		if (timeout != K_NO_WAIT) {
+			atomic_dec(&slab->waiters);
+		}
+		return 0;
+	}
+#endif
+
+	key = k_spin_lock(&lock);
+
 	if (slab->free_list != NULL) {
 		/* take a free block */
 		*mem = slab->free_list;
@@ -122,9 +260,18 @@ int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, s32_t timeout)
 		if (result == 0) {
 			*mem = _current->base.swap_data;
 		}
+#ifdef CONFIG_MEM_SLAB_MAGAZINES
+		atomic_dec(&slab->waiters);
+#endif
 		return result;
 	}
 
+#ifdef CONFIG_MEM_SLAB_MAGAZINES
+	if (timeout != K_NO_WAIT) {
+		atomic_dec(&slab->waiters);
+	}
+#endif
+
 	k_spin_unlock(&lock, key);
 
 	return result;
@@ -132,6 +279,12 @@ int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, s32_t timeout)
 
 void k_mem_slab_free(struct k_mem_slab *slab, void **mem)
 {
+#ifdef CONFIG_MEM_SLAB_MAGAZINES
+	if (mag_free(slab, *mem)) {
+		return;
+	}
+#endif
+
 	k_spinlock_key_t key = k_spin_lock(&lock);
 	struct k_thread *pending_thread = z_unpend_first_thread(&slab->wait_q);
 
@@ -139,8 +139,27 @@ void *k_mem_pool_malloc(struct k_mem_pool *pool, size_t size)
 	return (char *)block.data + WB_UP(sizeof(struct k_mem_block_id));
 }
 
+#ifdef CONFIG_HEAP_MEM_POOL_SYS_HEAP
+extern struct k_heap _system_heap;
+
+static bool in_system_heap(void *ptr)
+{
+	char *mem = _system_heap.heap.init_mem;
+
+	return (char *)ptr >= mem &&
+		(char *)ptr < mem + _system_heap.heap.init_bytes;
+}
+#endif
+
 void k_free(void *ptr)
 {
+#ifdef CONFIG_HEAP_MEM_POOL_SYS_HEAP
+	if (in_system_heap(ptr)) {
+		k_heap_free(&_system_heap, ptr);
+		return;
+	}
+#endif
+
 	if (ptr != NULL) {
 		/* point to hidden block descriptor at start of block */
 		ptr = (char *)ptr - WB_UP(sizeof(struct k_mem_block_id));
@@ -159,6 +178,23 @@ void k_free(void *ptr)
  * that has the address of the associated memory pool struct.
  */
 
+#ifdef CONFIG_HEAP_MEM_POOL_SYS_HEAP
+
+K_HEAP_DEFINE(_system_heap, CONFIG_HEAP_MEM_POOL_SIZE);
+
+/* Threads given the system pool allocate from _system_heap instead.
+ * This handle only identifies that case in z_thread_malloc() and is
+ * never dereferenced as a k_mem_pool.
+ */
+#define _HEAP_MEM_POOL ((struct k_mem_pool *)&_system_heap)
+
+void *k_malloc(size_t size)
+{
+	return k_heap_alloc(&_system_heap, size, K_NO_WAIT);
+}
+
+#else
+
 K_MEM_POOL_DEFINE(_heap_mem_pool, CONFIG_HEAP_MEM_POOL_MIN_SIZE,
 		  CONFIG_HEAP_MEM_POOL_SIZE, 1, 4);
 #define _HEAP_MEM_POOL (&_heap_mem_pool)
@@ -168,6 +204,8 @@ void *k_malloc(size_t size)
 	return k_mem_pool_malloc(_HEAP_MEM_POOL, size);
 }
 
+#endif /* CONFIG_HEAP_MEM_POOL_SYS_HEAP */
+
 void *k_calloc(size_t nmemb, size_t size)
 {
 	void *ret;
@@ -203,6 +241,12 @@ void *z_thread_malloc(size_t size)
 		pool = _current->resource_pool;
 	}
 
+#ifdef CONFIG_HEAP_MEM_POOL_SYS_HEAP
+	if (pool == _HEAP_MEM_POOL) {
+		return k_malloc(size);
+	}
+#endif
+
 	if (pool) {
 		ret = k_mem_pool_malloc(pool, size);
 	} else {
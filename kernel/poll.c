@@ -217,7 +217,8 @@ static inline int register_events(struct k_poll_event *events,
 	return events_registered;
 }
 
-static int k_poll_poller_cb(struct k_poll_event *event, u32_t state)
+static int k_poll_poller_cb(struct k_poll_event *event, u32_t state,
+			    struct z_wakeup_batch *batch)
 {
 	struct k_thread *thread = event->poller->thread;
 
@@ -239,7 +240,7 @@ static int k_poll_poller_cb(struct k_poll_event *event, u32_t state)
 		return 0;
 	}
 
-	z_ready_thread(thread);
+	z_ready_thread_batched(thread, batch);
 
 	return 0;
 }
@@ -376,15 +377,18 @@ oops_free:
 #include <syscalls/k_poll_mrsh.c>
 #endif
 
-/* must be called with interrupts locked */
-static int signal_poll_event(struct k_poll_event *event, u32_t state)
+/* must be called with interrupts locked, and the batch flushed before
+ * they are unlocked
+ */
+static int signal_poll_event(struct k_poll_event *event, u32_t state,
+			     struct z_wakeup_batch *batch)
 {
 	struct _poller *poller = event->poller;
 	int retcode = 0;
 
 	if (poller) {
 		if (poller->cb != NULL) {
-			retcode = poller->cb(event, state);
+			retcode = poller->cb(event, state, batch);
 		}
 
 		poller->is_polling = false;
@@ -401,11 +405,16 @@ static int signal_poll_event(struct k_poll_event *event, u32_t state)
 void z_handle_obj_poll_events(sys_dlist_t *events, u32_t state)
 {
 	struct k_poll_event *poll_event;
+	struct z_wakeup_batch batch;
+
+	z_wakeup_batch_init(&batch);
 
 	poll_event = (struct k_poll_event *)sys_dlist_get(events);
 	if (poll_event != NULL) {
-		(void) signal_poll_event(poll_event, state);
+		(void) signal_poll_event(poll_event, state, &batch);
 	}
+
+	z_wakeup_batch_flush(&batch);
 }
 
 void z_impl_k_poll_signal_init(struct k_poll_signal *signal)
@@ -448,6 +457,8 @@ int z_impl_k_poll_signal_raise(struct k_poll_signal *signal, int result)
 {
 	k_spinlock_key_t key = k_spin_lock(&lock);
 	struct k_poll_event *poll_event;
+	struct z_wakeup_batch batch;
+	int rc = 0;
 
 	signal->result = result;
 	signal->signaled = 1U;
@@ -458,7 +469,25 @@ int z_impl_k_poll_signal_raise(struct k_poll_signal *signal, int result)
 		return 0;
 	}
 
-	int rc = signal_poll_event(poll_event, K_POLL_STATE_SIGNALED);
+	/* The signal stays raised until reset, so every poller waiting
+	 * on it is satisfied: wake them all with a single scheduling
+	 * decision.
+	 */
+	z_wakeup_batch_init(&batch);
+
+	do {
+		int ret = signal_poll_event(poll_event, K_POLL_STATE_SIGNALED,
+					    &batch);
+
+		if (rc == 0) {
+			rc = ret;
+		}
+
+		poll_event = (struct k_poll_event *)
+			sys_dlist_get(&signal->poll_events);
+	} while (poll_event != NULL);
+
+	z_wakeup_batch_flush(&batch);
 
 	z_reschedule(&lock, key);
 	return rc;
@@ -520,10 +549,13 @@ static void triggered_work_expiration_handler(struct _timeout *timeout)
 	k_work_submit_to_queue(work_q, &twork->work);
 }
 
-static int triggered_work_poller_cb(struct k_poll_event *event, u32_t status)
+static int triggered_work_poller_cb(struct k_poll_event *event, u32_t status,
+				    struct z_wakeup_batch *batch)
 {
 	struct _poller *poller = event->poller;
 
+	ARG_UNUSED(batch);
+
 	if (poller->is_polling && poller->thread) {
 		struct k_work_poll *twork =
 			CONTAINER_OF(poller, struct k_work_poll, poller);
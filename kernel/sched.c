@@ -25,6 +25,7 @@
 #if defined(CONFIG_SCHED_DUMB)
 #define _priq_run_add		z_priq_dumb_add
 #define _priq_run_remove	z_priq_dumb_remove
+#define _priq_run_peek		z_priq_dumb_best
 # if defined(CONFIG_SCHED_CPU_MASK)
 #  define _priq_run_best	_priq_dumb_mask_best
 # else
@@ -34,10 +35,12 @@
 #define _priq_run_add		z_priq_rb_add
 #define _priq_run_remove	z_priq_rb_remove
 #define _priq_run_best		z_priq_rb_best
+#define _priq_run_peek		z_priq_rb_best
 #elif defined(CONFIG_SCHED_MULTIQ)
 #define _priq_run_add		z_priq_mq_add
 #define _priq_run_remove	z_priq_mq_remove
 #define _priq_run_best		z_priq_mq_best
+#define _priq_run_peek		z_priq_mq_best
 #endif
 
 #if defined(CONFIG_WAITQ_SCALABLE)
@@ -176,9 +179,148 @@ static ALWAYS_INLINE struct k_thread *_priq_dumb_mask_best(sys_dlist_t *pq)
 }
 #endif
 
+/* The run queue holding a ready thread.  With per-CPU run queues
+ * this is the queue of the CPU recorded in base.cpu, which for a
+ * running thread is the CPU it is running on.
+ */
+static ALWAYS_INLINE struct _ready_q *thread_ready_q(struct k_thread *thread)
+{
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
+	return &_kernel.cpus[thread->base.cpu].ready_q;
+#else
+	ARG_UNUSED(thread);
+	return &_kernel.ready_q;
+#endif
+}
+
+static ALWAYS_INLINE void runq_add(struct k_thread *thread)
+{
+	_priq_run_add(&thread_ready_q(thread)->runq, thread);
+}
+
+static ALWAYS_INLINE void runq_remove(struct k_thread *thread)
+{
+	_priq_run_remove(&thread_ready_q(thread)->runq, thread);
+}
+
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
+/* The thread a CPU would run next if it rescheduled now, ignoring
+ * cooperative and metairq subtleties.  Only used as a placement hint.
+ */
+static struct k_thread *cpu_top(struct _cpu *cpu)
+{
+	struct k_thread *thread = _priq_run_peek(&cpu->ready_q.runq);
+
+	if (thread != NULL &&
+	    z_is_t1_higher_prio_than_t2(thread, cpu->current)) {
+		return thread;
+	}
+	return cpu->current;
+}
+
+/* True if a CPU whose top thread is t1 is a better home for new work
+ * than one whose top thread is t2, i.e. t1 is idle or lower priority.
+ */
+static bool runs_lower(struct k_thread *t1, struct k_thread *t2)
+{
+	if (z_is_idle_thread_object(t2)) {
+		return false;
+	}
+	return z_is_idle_thread_object(t1) ||
+		z_is_t1_higher_prio_than_t2(t2, t1);
+}
+
+/* Pick the CPU whose queue a newly ready thread joins: the allowed
+ * CPU running the least important work, preferring the CPU the
+ * thread last ran on when there is a tie so it stays cache-warm.
+ * CPUs that have not been started yet are skipped.
+ */
+static int select_cpu(struct k_thread *thread)
+{
+	struct k_thread *best_top = NULL;
+	int best = -1;
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		int id = (thread->base.cpu + i) % CONFIG_MP_NUM_CPUS;
+		struct _cpu *cpu = &_kernel.cpus[id];
+		struct k_thread *top;
+
+#ifdef CONFIG_SCHED_CPU_MASK
+		if ((thread->base.cpu_mask & BIT(id)) == 0) {
+			continue;
+		}
+#endif
+		if (cpu->current == NULL) {
+			continue;
+		}
+
+		top = cpu_top(cpu);
+		if (best < 0 || runs_lower(top, best_top)) {
+			best = id;
+			best_top = top;
+		}
+	}
+
+	return best < 0 ? _current_cpu->id : best;
+}
+
+/* Idle work stealing: with nothing queued locally, offer the best
+ * thread queued on any other CPU.  Only the head of each remote
+ * queue is examined (with CPU masks, the first thread this CPU may
+ * run).  The thread is only taken if next_up() actually picks it.
+ */
+static struct k_thread *steal(void)
+{
+	struct k_thread *best = NULL;
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct k_thread *thread;
+
+		if (i == _current_cpu->id) {
+			continue;
+		}
+
+		thread = _priq_run_best(&_kernel.cpus[i].ready_q.runq);
+		if (thread != NULL && (best == NULL ||
+				       z_is_t1_higher_prio_than_t2(thread,
+								   best))) {
+			best = thread;
+		}
+	}
+
+	return best;
+}
+#endif
+
+static ALWAYS_INLINE struct k_thread *runq_best(void)
+{
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
+	struct k_thread *thread = _priq_run_best(&_current_cpu->ready_q.runq);
+
+	return thread != NULL ? thread : steal();
+#else
+	return _priq_run_best(&_kernel.ready_q.runq);
+#endif
+}
+
+#if defined(CONFIG_SCHED_PER_CPU_RUNQ) && defined(CONFIG_SCHED_IPI_SUPPORTED)
+/* Interrupt the CPUs in the bitmask, or all other CPUs if the
+ * architecture cannot direct IPIs at specific CPUs.
+ */
+static void sched_ipi(u32_t cpu_bitmap)
+{
+#ifdef CONFIG_ARCH_HAS_DIRECTED_IPIS
+	arch_sched_directed_ipi(cpu_bitmap);
+#else
+	ARG_UNUSED(cpu_bitmap);
+	arch_sched_ipi();
+#endif
+}
+#endif
+
 static ALWAYS_INLINE struct k_thread *next_up(void)
 {
-	struct k_thread *thread = _priq_run_best(&_kernel.ready_q.runq);
+	struct k_thread *thread = runq_best();
 
 #if (CONFIG_NUM_METAIRQ_PRIORITIES > 0) && (CONFIG_NUM_COOP_PRIORITIES > 0)
 	/* MetaIRQs must always attempt to return back to a
@@ -248,15 +390,18 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 	/* Put _current back into the queue */
 	if (thread != _current && active &&
 		!z_is_idle_thread_object(_current) && !queued) {
-		_priq_run_add(&_kernel.ready_q.runq, _current);
+		runq_add(_current);
 		z_mark_thread_as_queued(_current);
 	}
 
 	/* Take the new _current out of the queue */
 	if (z_is_thread_queued(thread)) {
-		_priq_run_remove(&_kernel.ready_q.runq, thread);
+		runq_remove(thread);
 	}
 	z_mark_thread_as_not_queued(thread);
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
+	thread->base.cpu = _current_cpu->id;
+#endif
 
 	return thread;
 #endif
@@ -376,16 +521,71 @@ static void update_cache(int preempt_ok)
 #endif
 }
 
-static void ready_thread(struct k_thread *thread)
+/* Puts a thread on the run queue without updating the cache or
+ * sending IPIs, so that a batch of wakeups can share one decision
+ * about both.  CPUs that need to be interrupted are added to
+ * ipi_mask.  Returns false if the thread is not actually ready.
+ */
+static bool queue_ready_thread(struct k_thread *thread, u32_t *ipi_mask)
 {
-	if (z_is_thread_ready(thread)) {
-		sys_trace_thread_ready(thread);
-		_priq_run_add(&_kernel.ready_q.runq, thread);
-		z_mark_thread_as_queued(thread);
-		update_cache(0);
+	if (!z_is_thread_ready(thread)) {
+		return false;
+	}
+
+	sys_trace_thread_ready(thread);
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
+	thread->base.cpu = select_cpu(thread);
+#endif
+	runq_add(thread);
+	z_mark_thread_as_queued(thread);
+
 #if defined(CONFIG_SMP) &&  defined(CONFIG_SCHED_IPI_SUPPORTED)
+# ifdef CONFIG_SCHED_PER_CPU_RUNQ
+	/* Only the CPU the thread was queued on needs to look,
+	 * and only if it would preempt what is running there
+	 */
+	struct _cpu *cpu = &_kernel.cpus[thread->base.cpu];
+
+	if (cpu != _current_cpu &&
+	    (z_is_idle_thread_object(cpu->current) ||
+	     z_is_t1_higher_prio_than_t2(thread, cpu->current))) {
+		*ipi_mask |= BIT(cpu->id);
+	}
+# else
+	/* Any CPU might pick it up */
+	*ipi_mask |= BIT_MASK(CONFIG_MP_NUM_CPUS);
+# endif
+#else
+	ARG_UNUSED(ipi_mask);
+#endif
+
+	return true;
+}
+
+/* Second half of a wakeup: refresh the cache and kick other CPUs */
+static void flush_ready(u32_t ipi_mask)
+{
+	update_cache(0);
+
+#if defined(CONFIG_SMP) &&  defined(CONFIG_SCHED_IPI_SUPPORTED)
+	if (ipi_mask != 0U) {
+# ifdef CONFIG_SCHED_PER_CPU_RUNQ
+		sched_ipi(ipi_mask);
+# else
 		arch_sched_ipi();
+# endif
+	}
+#else
+	ARG_UNUSED(ipi_mask);
 #endif
+}
+
+static void ready_thread(struct k_thread *thread)
+{
+	u32_t ipi_mask = 0U;
+
+	if (queue_ready_thread(thread, &ipi_mask)) {
+		flush_ready(ipi_mask);
 	}
 }
 
@@ -396,13 +596,33 @@ void z_ready_thread(struct k_thread *thread)
 	}
 }
 
+void z_ready_thread_batched(struct k_thread *thread,
+			    struct z_wakeup_batch *batch)
+{
+	LOCKED(&sched_spinlock) {
+		if (queue_ready_thread(thread, &batch->ipi_mask)) {
+			batch->queued = true;
+		}
+	}
+}
+
+void z_wakeup_batch_flush(struct z_wakeup_batch *batch)
+{
+	if (batch->queued) {
+		LOCKED(&sched_spinlock) {
+			flush_ready(batch->ipi_mask);
+		}
+		z_wakeup_batch_init(batch);
+	}
+}
+
 void z_move_thread_to_end_of_prio_q(struct k_thread *thread)
 {
 	LOCKED(&sched_spinlock) {
 		if (z_is_thread_queued(thread)) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
+			runq_remove(thread);
 		}
-		_priq_run_add(&_kernel.ready_q.runq, thread);
+		runq_add(thread);
 		z_mark_thread_as_queued(thread);
 		update_cache(thread == _current);
 	}
@@ -428,7 +648,7 @@ void z_thread_single_suspend(struct k_thread *thread)
 
 	LOCKED(&sched_spinlock) {
 		if (z_is_thread_queued(thread)) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
+			runq_remove(thread);
 			z_mark_thread_as_not_queued(thread);
 		}
 		z_mark_thread_as_suspended(thread);
@@ -462,8 +682,7 @@ void z_thread_single_abort(struct k_thread *thread)
 	LOCKED(&sched_spinlock) {
 		if (z_is_thread_ready(thread)) {
 			if (z_is_thread_queued(thread)) {
-				_priq_run_remove(&_kernel.ready_q.runq,
-						 thread);
+				runq_remove(thread);
 				z_mark_thread_as_not_queued(thread);
 			}
 			update_cache(thread == _current);
@@ -508,7 +727,7 @@ void z_thread_single_abort(struct k_thread *thread)
 static void unready_thread(struct k_thread *thread)
 {
 	if (z_is_thread_queued(thread)) {
-		_priq_run_remove(&_kernel.ready_q.runq, thread);
+		runq_remove(thread);
 		z_mark_thread_as_not_queued(thread);
 	}
 	update_cache(thread == _current);
@@ -567,12 +786,17 @@ ALWAYS_INLINE struct k_thread *z_find_first_thread_to_unpend(_wait_q_t *wait_q,
 	return ret;
 }
 
+static void unpend_thread_no_timeout(struct k_thread *thread)
+{
+	_priq_wait_remove(&pended_on(thread)->waitq, thread);
+	z_mark_thread_as_not_pending(thread);
+	thread->base.pended_on = NULL;
+}
+
 ALWAYS_INLINE void z_unpend_thread_no_timeout(struct k_thread *thread)
 {
 	LOCKED(&sched_spinlock) {
-		_priq_wait_remove(&pended_on(thread)->waitq, thread);
-		z_mark_thread_as_not_pending(thread);
-		thread->base.pended_on = NULL;
+		unpend_thread_no_timeout(thread);
 	}
 }
 
@@ -583,12 +807,15 @@ void z_thread_timeout(struct _timeout *timeout)
 	struct k_thread *thread = CONTAINER_OF(timeout,
 					       struct k_thread, base.timeout);
 
-	if (thread->base.pended_on != NULL) {
-		z_unpend_thread_no_timeout(thread);
+	LOCKED(&sched_spinlock) {
+		/* A waker may have unpended the thread since it expired */
+		if (thread->base.pended_on != NULL) {
+			unpend_thread_no_timeout(thread);
+		}
+		z_mark_thread_as_started(thread);
+		z_mark_thread_as_not_suspended(thread);
+		ready_thread(thread);
 	}
-	z_mark_thread_as_started(thread);
-	z_mark_thread_as_not_suspended(thread);
-	z_ready_thread(thread);
 }
 #endif
 
@@ -638,6 +865,51 @@ void z_unpend_thread(struct k_thread *thread)
 	(void)z_abort_thread_timeout(thread);
 }
 
+void z_sched_wake_matching(_wait_q_t *wait_q,
+			   bool (*func)(struct k_thread *thread, void *data),
+			   void *data)
+{
+	struct k_thread *thread, *found;
+	u32_t ipi_mask = 0U;
+	bool queued = false;
+	int skip = 0;
+	int i;
+
+	LOCKED(&sched_spinlock) {
+		/* The wait queue cannot be modified while it is walked, so
+		 * start over after each wakeup past the threads refused
+		 */
+		do {
+			found = NULL;
+			i = 0;
+
+			_WAIT_Q_FOR_EACH(wait_q, thread) {
+				if (i++ < skip) {
+					continue;
+				}
+				if (func(thread, data)) {
+					found = thread;
+					break;
+				}
+				skip++;
+			}
+
+			if (found != NULL) {
+				unpend_thread_no_timeout(found);
+				(void)z_abort_thread_timeout(found);
+				arch_thread_return_value_set(found, 0);
+				if (queue_ready_thread(found, &ipi_mask)) {
+					queued = true;
+				}
+			}
+		} while (found != NULL);
+
+		if (queued) {
+			flush_ready(ipi_mask);
+		}
+	}
+}
+
 /* Priority set utility that does no rescheduling, it just changes the
  * run queue state, returning true if a reschedule is needed later.
  */
@@ -651,9 +923,9 @@ bool z_set_prio(struct k_thread *thread, int prio)
 		if (need_sched) {
 			/* Don't requeue on SMP if it's the running thread */
 			if (!IS_ENABLED(CONFIG_SMP) || z_is_thread_queued(thread)) {
-				_priq_run_remove(&_kernel.ready_q.runq, thread);
+				runq_remove(thread);
 				thread->base.prio = prio;
-				_priq_run_add(&_kernel.ready_q.runq, thread);
+				runq_add(thread);
 			} else {
 				thread->base.prio = prio;
 			}
@@ -672,7 +944,11 @@ void z_thread_priority_set(struct k_thread *thread, int prio)
 	bool need_sched = z_set_prio(thread, prio);
 
 #if defined(CONFIG_SMP) && defined(CONFIG_SCHED_IPI_SUPPORTED)
+# ifdef CONFIG_SCHED_PER_CPU_RUNQ
+	sched_ipi(BIT(thread->base.cpu));
+# else
 	arch_sched_ipi();
+# endif
 #endif
 
 	if (need_sched && _current->base.sched_locked == 0) {
@@ -948,25 +1224,40 @@ struct k_thread *z_priq_mq_best(struct _priq_mq *pq)
 int z_unpend_all(_wait_q_t *wait_q)
 {
 	int need_sched = 0;
+	u32_t ipi_mask = 0U;
+	bool queued = false;
 	struct k_thread *thread;
 
-	while ((thread = z_waitq_head(wait_q)) != NULL) {
-		z_unpend_thread(thread);
-		z_ready_thread(thread);
-		need_sched = 1;
+	/* Move the whole wait queue over under one lock hold, and make
+	 * a single cache update and IPI decision at the end instead of
+	 * one per waiter.
+	 */
+	LOCKED(&sched_spinlock) {
+		while ((thread = _priq_wait_best(&wait_q->waitq)) != NULL) {
+			unpend_thread_no_timeout(thread);
+			(void)z_abort_thread_timeout(thread);
+			if (queue_ready_thread(thread, &ipi_mask)) {
+				queued = true;
+			}
+			need_sched = 1;
+		}
+
+		if (queued) {
+			flush_ready(ipi_mask);
+		}
 	}
 
 	return need_sched;
 }
 
-void z_sched_init(void)
+static void init_ready_q(struct _ready_q *rq)
 {
 #ifdef CONFIG_SCHED_DUMB
-	sys_dlist_init(&_kernel.ready_q.runq);
+	sys_dlist_init(&rq->runq);
 #endif
 
 #ifdef CONFIG_SCHED_SCALABLE
-	_kernel.ready_q.runq = (struct _priq_rb) {
+	rq->runq = (struct _priq_rb) {
 		.tree = {
 			.lessthan_fn = z_priq_rb_lessthan,
 		}
@@ -974,8 +1265,19 @@ void z_sched_init(void)
 #endif
 
 #ifdef CONFIG_SCHED_MULTIQ
-	for (int i = 0; i < ARRAY_SIZE(_kernel.ready_q.runq.queues); i++) {
-		sys_dlist_init(&_kernel.ready_q.runq.queues[i]);
+	for (int i = 0; i < ARRAY_SIZE(rq->runq.queues); i++) {
+		sys_dlist_init(&rq->runq.queues[i]);
+	}
+#endif
+}
+
+void z_sched_init(void)
+{
+	init_ready_q(&_kernel.ready_q);
+
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		init_ready_q(&_kernel.cpus[i].ready_q);
 	}
 #endif
 
@@ -985,6 +1287,19 @@ void z_sched_init(void)
 #endif
 }
 
+#ifdef CONFIG_SPIN_STATS
+/* Acquisition and contention counts of the scheduler lock, for
+ * benchmarks comparing run queue layouts
+ */
+void z_sched_lock_stats_get(u32_t *acquired, u32_t *contended)
+{
+	LOCKED(&sched_spinlock) {
+		*acquired = sched_spinlock.acquired;
+		*contended = sched_spinlock.contended;
+	}
+}
+#endif
+
 int z_impl_k_thread_priority_get(k_tid_t thread)
 {
 	return thread->base.prio;
@@ -1036,8 +1351,8 @@ void z_impl_k_thread_deadline_set(k_tid_t tid, int deadline)
 	LOCKED(&sched_spinlock) {
 		thread->base.prio_deadline = k_cycle_get_32() + deadline;
 		if (z_is_thread_queued(thread)) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
-			_priq_run_add(&_kernel.ready_q.runq, thread);
+			runq_remove(thread);
+			runq_add(thread);
 		}
 	}
 }
@@ -1066,10 +1381,9 @@ void z_impl_k_yield(void)
 		LOCKED(&sched_spinlock) {
 			if (!IS_ENABLED(CONFIG_SMP) ||
 			    z_is_thread_queued(_current)) {
-				_priq_run_remove(&_kernel.ready_q.runq,
-						 _current);
+				runq_remove(_current);
 			}
-			_priq_run_add(&_kernel.ready_q.runq, _current);
+			runq_add(_current);
 			z_mark_thread_as_queued(_current);
 			update_cache(1);
 		}
@@ -1187,7 +1501,8 @@ void z_impl_k_wakeup(k_tid_t thread)
 	z_mark_thread_as_not_suspended(thread);
 	z_ready_thread(thread);
 
-#if defined(CONFIG_SMP) && defined(CONFIG_SCHED_IPI_SUPPORTED)
+#if defined(CONFIG_SMP) && defined(CONFIG_SCHED_IPI_SUPPORTED) && \
+	!defined(CONFIG_SCHED_PER_CPU_RUNQ)
 	arch_sched_ipi();
 #endif
 
@@ -1221,7 +1536,11 @@ void z_sched_abort(struct k_thread *thread)
 	thread->base.thread_state |= _THREAD_ABORTING;
 	k_spin_unlock(&sched_spinlock, key);
 #ifdef CONFIG_SCHED_IPI_SUPPORTED
+# ifdef CONFIG_SCHED_PER_CPU_RUNQ
+	sched_ipi(BIT(thread->base.cpu));
+# else
 	arch_sched_ipi();
+# endif
 #endif
 
 	/* Wait for it to be flagged dead either by the CPU it was
@@ -1234,7 +1553,7 @@ void z_sched_abort(struct k_thread *thread)
 			thread->base.thread_state |= _THREAD_DEAD;
 			k_spin_unlock(&sched_spinlock, key);
 		} else if (z_is_thread_queued(thread)) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
+			runq_remove(thread);
 			z_mark_thread_as_not_queued(thread);
 			thread->base.thread_state |= _THREAD_DEAD;
 			k_spin_unlock(&sched_spinlock, key);
@@ -791,6 +791,7 @@ void z_init_thread_base(struct _thread_base *thread_base, int priority,
 
 #ifdef CONFIG_SMP
 	thread_base->is_idle = 0;
+	thread_base->cpu = 0U;
 #endif
 
 	/* swap_data does not need to be initialized */
@@ -11,6 +11,7 @@
 #include <syscall_handler.h>
 #include <drivers/timer/system_timer.h>
 #include <sys_clock.h>
+#include <sys/math_extras.h>
 
 #define LOCKED(lck) for (k_spinlock_key_t __i = {},			\
 					  __key = k_spin_lock(lck);	\
@@ -19,7 +20,9 @@
 
 static u64_t curr_tick;
 
+#ifdef CONFIG_TIMEOUT_DLIST
 static sys_dlist_t timeout_list = SYS_DLIST_STATIC_INIT(&timeout_list);
+#endif
 
 static struct k_spinlock timeout_lock;
 
@@ -41,6 +44,196 @@ static inline int z_vrfy_z_clock_hw_cycles_per_sec_runtime_get(void)
 #endif /* CONFIG_USERSPACE */
 #endif /* CONFIG_TIMER_READS_ITS_FREQUENCY_AT_RUNTIME */
 
+#ifdef CONFIG_TIMEOUT_WHEEL
+
+/* Hierarchical timing wheel.  Each level has WHEEL_SLOTS list heads
+ * and a bitmap of the non-empty ones.  A timeout lives at the lowest
+ * level whose "block" (the range of ticks covered by one full
+ * revolution of that level) also contains curr_tick, in the slot
+ * selected by the bits of its expiry at that level.  Timeouts that
+ * don't share even the top level block with curr_tick sit on an
+ * unsorted overflow list.
+ *
+ * With that placement rule everything at level N expires before
+ * anything at level N+1, and within a level the lowest set bit of
+ * the bitmap is the earliest slot, so finding the next expiry never
+ * has to search more than one slot.  When curr_tick moves into a new
+ * block at some level, the slot it moved into is "cascaded" down by
+ * re-placing its entries, which only happens once per entry per
+ * level.
+ */
+#define WHEEL_BITS 5
+#define WHEEL_SLOTS BIT(WHEEL_BITS)
+#define WHEEL_MASK (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS CONFIG_TIMEOUT_WHEEL_LEVELS
+#define WHEEL_RANGE_BITS (WHEEL_BITS * WHEEL_LEVELS)
+
+static sys_dlist_t wheel[WHEEL_LEVELS][WHEEL_SLOTS];
+static u32_t wheel_map[WHEEL_LEVELS];
+static sys_dlist_t wheel_overflow = SYS_DLIST_STATIC_INIT(&wheel_overflow);
+
+/* Earliest timeout, valid only when first_valid is set */
+static struct _timeout *first_cache;
+static bool first_valid = true;
+
+static sys_dlist_t *wheel_slot(u64_t expiry, int *level, int *idx)
+{
+	for (int lvl = 0; lvl < WHEEL_LEVELS; lvl++) {
+		int shift = WHEEL_BITS * (lvl + 1);
+
+		if ((expiry >> shift) == (curr_tick >> shift)) {
+			*level = lvl;
+			*idx = (expiry >> (WHEEL_BITS * lvl)) & WHEEL_MASK;
+			return &wheel[lvl][*idx];
+		}
+	}
+
+	*level = -1;
+	return &wheel_overflow;
+}
+
+static void wheel_place(struct _timeout *t)
+{
+	int lvl, idx;
+	sys_dlist_t *slot = wheel_slot(t->expiry, &lvl, &idx);
+
+	/* Slot heads are zero-initialized BSS, so set them up lazily */
+	if (lvl >= 0 && (wheel_map[lvl] & BIT(idx)) == 0U) {
+		sys_dlist_init(slot);
+		wheel_map[lvl] |= BIT(idx);
+	}
+
+	sys_dlist_append(slot, &t->node);
+}
+
+/* Re-place every entry of a slot against the current curr_tick */
+static void wheel_cascade(sys_dlist_t *slot, int lvl, int idx)
+{
+	sys_dlist_t tmp = SYS_DLIST_STATIC_INIT(&tmp);
+	sys_dnode_t *node;
+
+	if (lvl >= 0) {
+		if ((wheel_map[lvl] & BIT(idx)) == 0U) {
+			return;
+		}
+		wheel_map[lvl] &= ~BIT(idx);
+	}
+
+	while ((node = sys_dlist_get(slot)) != NULL) {
+		sys_dlist_append(&tmp, node);
+	}
+
+	while ((node = sys_dlist_get(&tmp)) != NULL) {
+		wheel_place(CONTAINER_OF(node, struct _timeout, node));
+	}
+}
+
+static struct _timeout *earliest(sys_dlist_t *list)
+{
+	struct _timeout *t, *ret = NULL;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(list, t, node) {
+		if (ret == NULL || t->expiry < ret->expiry) {
+			ret = t;
+		}
+	}
+
+	return ret;
+}
+
+static struct _timeout *first(void)
+{
+	if (first_valid) {
+		return first_cache;
+	}
+
+	first_cache = NULL;
+	for (int lvl = 0; lvl < WHEEL_LEVELS; lvl++) {
+		if (wheel_map[lvl] != 0U) {
+			int idx = u32_count_trailing_zeros(wheel_map[lvl]);
+			sys_dnode_t *head = sys_dlist_peek_head(&wheel[lvl][idx]);
+
+			/* Everything in a level 0 slot expires together */
+			first_cache = lvl == 0
+				? CONTAINER_OF(head, struct _timeout, node)
+				: earliest(&wheel[lvl][idx]);
+			break;
+		}
+	}
+
+	if (first_cache == NULL) {
+		first_cache = earliest(&wheel_overflow);
+	}
+
+	first_valid = true;
+	return first_cache;
+}
+
+static s32_t timeout_dticks(struct _timeout *timeout)
+{
+	u64_t dticks = timeout->expiry - curr_tick;
+
+	return (s32_t)MIN(dticks, (u64_t)INT_MAX);
+}
+
+static s32_t first_dticks(void)
+{
+	return timeout_dticks(first());
+}
+
+static void insert_timeout(struct _timeout *to, s32_t ticks)
+{
+	to->dticks = ticks;
+	to->expiry = curr_tick + ticks;
+	wheel_place(to);
+
+	if (first_valid &&
+	    (first_cache == NULL || to->expiry < first_cache->expiry)) {
+		first_cache = to;
+	}
+}
+
+static void remove_timeout(struct _timeout *t)
+{
+	int lvl, idx;
+	sys_dlist_t *slot = wheel_slot(t->expiry, &lvl, &idx);
+
+	sys_dlist_remove(&t->node);
+	if (lvl >= 0 && sys_dlist_is_empty(slot)) {
+		wheel_map[lvl] &= ~BIT(idx);
+	}
+
+	if (t == first_cache) {
+		first_valid = false;
+	}
+}
+
+/* Callers never advance past the earliest expiry, so any level whose
+ * block changed but isn't the one being cascaded into is empty.
+ */
+static void advance(s32_t ticks)
+{
+	u64_t old = curr_tick;
+
+	curr_tick += ticks;
+
+	if ((old >> WHEEL_RANGE_BITS) != (curr_tick >> WHEEL_RANGE_BITS)) {
+		wheel_cascade(&wheel_overflow, -1, 0);
+	}
+
+	for (int lvl = WHEEL_LEVELS - 1; lvl > 0; lvl--) {
+		int shift = WHEEL_BITS * lvl;
+
+		if ((old >> shift) != (curr_tick >> shift)) {
+			int idx = (curr_tick >> shift) & WHEEL_MASK;
+
+			wheel_cascade(&wheel[lvl][idx], lvl, idx);
+		}
+	}
+}
+
+#else /* CONFIG_TIMEOUT_DLIST */
+
 static struct _timeout *first(void)
 {
 	sys_dnode_t *t = sys_dlist_peek_head(&timeout_list);
@@ -55,6 +248,32 @@ static struct _timeout *next(struct _timeout *t)
 	return n == NULL ? NULL : CONTAINER_OF(n, struct _timeout, node);
 }
 
+static s32_t first_dticks(void)
+{
+	return first()->dticks;
+}
+
+static void insert_timeout(struct _timeout *to, s32_t ticks)
+{
+	struct _timeout *t;
+
+	to->dticks = ticks;
+	for (t = first(); t != NULL; t = next(t)) {
+		__ASSERT(t->dticks >= 0, "");
+
+		if (t->dticks > to->dticks) {
+			t->dticks -= to->dticks;
+			sys_dlist_insert(&t->node, &to->node);
+			break;
+		}
+		to->dticks -= t->dticks;
+	}
+
+	if (t == NULL) {
+		sys_dlist_append(&timeout_list, &to->node);
+	}
+}
+
 static void remove_timeout(struct _timeout *t)
 {
 	if (next(t) != NULL) {
@@ -64,6 +283,31 @@ static void remove_timeout(struct _timeout *t)
 	sys_dlist_remove(&t->node);
 }
 
+static s32_t timeout_dticks(struct _timeout *timeout)
+{
+	s32_t ticks = 0;
+
+	for (struct _timeout *t = first(); t != NULL; t = next(t)) {
+		ticks += t->dticks;
+		if (timeout == t) {
+			break;
+		}
+	}
+
+	return ticks;
+}
+
+static void advance(s32_t ticks)
+{
+	if (first() != NULL) {
+		first()->dticks -= ticks;
+	}
+
+	curr_tick += ticks;
+}
+
+#endif /* CONFIG_TIMEOUT_WHEEL */
+
 static s32_t elapsed(void)
 {
 	return announce_remaining == 0 ? z_clock_elapsed() : 0;
@@ -73,7 +317,8 @@ static s32_t next_timeout(void)
 {
 	struct _timeout *to = first();
 	s32_t ticks_elapsed = elapsed();
-	s32_t ret = to == NULL ? MAX_WAIT : MAX(0, to->dticks - ticks_elapsed);
+	s32_t ret = to == NULL ? MAX_WAIT
+		: MAX(0, first_dticks() - ticks_elapsed);
 
 #ifdef CONFIG_TIMESLICING
 	if (_current_cpu->slice_ticks && _current_cpu->slice_ticks < ret) {
@@ -90,23 +335,7 @@ void z_add_timeout(struct _timeout *to, _timeout_func_t fn, s32_t ticks)
 	ticks = MAX(1, ticks);
 
 	LOCKED(&timeout_lock) {
-		struct _timeout *t;
-
-		to->dticks = ticks + elapsed();
-		for (t = first(); t != NULL; t = next(t)) {
-			__ASSERT(t->dticks >= 0, "");
-
-			if (t->dticks > to->dticks) {
-				t->dticks -= to->dticks;
-				sys_dlist_insert(&t->node, &to->node);
-				break;
-			}
-			to->dticks -= t->dticks;
-		}
-
-		if (t == NULL) {
-			sys_dlist_append(&timeout_list, &to->node);
-		}
+		insert_timeout(to, ticks + elapsed());
 
 		if (to == first()) {
 			z_clock_set_timeout(next_timeout(), false);
@@ -137,12 +366,7 @@ s32_t z_timeout_remaining(struct _timeout *timeout)
 	}
 
 	LOCKED(&timeout_lock) {
-		for (struct _timeout *t = first(); t != NULL; t = next(t)) {
-			ticks += t->dticks;
-			if (timeout == t) {
-				break;
-			}
-		}
+		ticks = timeout_dticks(timeout);
 	}
 
 	return ticks - elapsed();
@@ -191,11 +415,11 @@ void z_clock_announce(s32_t ticks)
 
 	announce_remaining = ticks;
 
-	while (first() != NULL && first()->dticks <= announce_remaining) {
+	while (first() != NULL && first_dticks() <= announce_remaining) {
 		struct _timeout *t = first();
-		int dt = t->dticks;
+		int dt = first_dticks();
 
-		curr_tick += dt;
+		advance(dt);
 		announce_remaining -= dt;
 		t->dticks = 0;
 		remove_timeout(t);
@@ -205,11 +429,7 @@ void z_clock_announce(s32_t ticks)
 		key = k_spin_lock(&timeout_lock);
 	}
 
-	if (first() != NULL) {
-		first()->dticks -= announce_remaining;
-	}
-
-	curr_tick += announce_remaining;
+	advance(announce_remaining);
 	announce_remaining = 0;
 
 	z_clock_set_timeout(next_timeout(), false);
@@ -18,9 +18,6 @@ static const osEventFlagsAttr_t init_event_flags_attrs = {
 	.cb_size = 0,
 };
 
-#define DONT_CARE               (0)
-#define NSEC_PER_MSEC           (NSEC_PER_USEC * USEC_PER_MSEC)
-
 /**
  * @brief Create and Initialize an Event Flags object.
  */
@@ -43,10 +40,7 @@ osEventFlagsId_t osEventFlagsNew(const osEventFlagsAttr_t *attr)
 		return NULL;
 	}
 
-	k_poll_signal_init(&events->poll_signal);
-	k_poll_event_init(&events->poll_event, K_POLL_TYPE_SIGNAL,
-			  K_POLL_MODE_NOTIFY_ONLY, &events->poll_signal);
-	events->signal_results = 0U;
+	k_event_init(&events->event);
 
 	if (attr->name == NULL) {
 		strncpy(events->name, init_event_flags_attrs.name,
@@ -64,19 +58,15 @@ osEventFlagsId_t osEventFlagsNew(const osEventFlagsAttr_t *attr)
 uint32_t osEventFlagsSet(osEventFlagsId_t ef_id, uint32_t flags)
 {
 	struct cv2_event_flags *events = (struct cv2_event_flags *)ef_id;
-	int key;
 
 	if ((ef_id == NULL) || (flags & 0x80000000)) {
 		return osFlagsErrorParameter;
 	}
 
-	key = irq_lock();
-	events->signal_results |= flags;
-	irq_unlock(key);
-
-	k_poll_signal_raise(&events->poll_signal, DONT_CARE);
+	(void)k_event_post(&events->event, flags);
 
-	return events->signal_results;
+	/* Waiters woken by the post may already have cleared the flags */
+	return k_event_get(&events->event);
 }
 
 /**
@@ -85,19 +75,12 @@ uint32_t osEventFlagsSet(osEventFlagsId_t ef_id, uint32_t flags)
 uint32_t osEventFlagsClear(osEventFlagsId_t ef_id, uint32_t flags)
 {
 	struct cv2_event_flags *events = (struct cv2_event_flags *)ef_id;
-	int key;
-	u32_t sig;
 
 	if ((ef_id == NULL) || (flags & 0x80000000)) {
 		return osFlagsErrorParameter;
 	}
 
-	key = irq_lock();
-	sig = events->signal_results;
-	events->signal_results &= ~(flags);
-	irq_unlock(key);
-
-	return sig;
+	return k_event_clear(&events->event, flags);
 }
 
 /**
@@ -107,10 +90,9 @@ uint32_t osEventFlagsWait(osEventFlagsId_t ef_id, uint32_t flags,
 			  uint32_t options, uint32_t timeout)
 {
 	struct cv2_event_flags *events = (struct cv2_event_flags *)ef_id;
-	int retval, key;
+	u32_t k_options = K_EVENT_WAIT_ANY;
+	s32_t k_timeout;
 	u32_t sig;
-	u32_t time_delta_ms, timeout_ms = k_ticks_to_ms_floor64(timeout);
-	u64_t time_stamp_start, hwclk_cycles_delta, time_delta_ns;
 
 	/* Can be called from ISRs only if timeout is set to 0 */
 	if (timeout > 0 && k_is_in_isr()) {
@@ -121,78 +103,33 @@ uint32_t osEventFlagsWait(osEventFlagsId_t ef_id, uint32_t flags,
 		return osFlagsErrorParameter;
 	}
 
-	for (;;) {
-
-		time_stamp_start = (u64_t)k_cycle_get_32();
-
-		switch (timeout) {
-		case 0:
-			retval = k_poll(&events->poll_event, 1, K_NO_WAIT);
-			break;
-		case osWaitForever:
-			retval = k_poll(&events->poll_event, 1, K_FOREVER);
-			break;
-		default:
-			retval = k_poll(&events->poll_event, 1, timeout_ms);
-			break;
-		}
-
-		switch (retval) {
-		case 0:
-			break;
-		case -EAGAIN:
-			return osFlagsErrorTimeout;
-		default:
-			return osFlagsErrorUnknown;
-		}
-
-		__ASSERT(events->poll_event.state == K_POLL_STATE_SIGNALED,
-			 "event state not signalled!");
-		__ASSERT(events->poll_event.signal->signaled == 1U,
-			 "event signaled is not 1");
-
-		/* Reset the states to facilitate the next trigger */
-		events->poll_event.signal->signaled = 0U;
-		events->poll_event.state = K_POLL_STATE_NOT_READY;
-
-		if (options & osFlagsWaitAll) {
-
-			/* Check if all events we are waiting on have
-			 * been signalled
-			 */
-			if ((events->signal_results & flags) == flags) {
-				break;
-			}
-
-			/* If we need to wait on more signals, we need to
-			 * adjust the timeout value accordingly based on
-			 * the time that has already elapsed.
-			 */
-			hwclk_cycles_delta =
-				(u64_t)k_cycle_get_32() - time_stamp_start;
-
-			time_delta_ns =
-				(u32_t)k_cyc_to_ns_floor64(hwclk_cycles_delta);
-
-			time_delta_ms = (u32_t)time_delta_ns / NSEC_PER_MSEC;
-
-			if (timeout_ms > time_delta_ms) {
-				timeout_ms -= time_delta_ms;
-			} else {
-				timeout_ms = 0U;
-			}
-		} else {
-			break;
-		}
-	}
-
-	sig = events->signal_results;
+	if (options & osFlagsWaitAll) {
+		k_options |= K_EVENT_WAIT_ALL;
+	}
+
 	if (!(options & osFlagsNoClear)) {
+		k_options |= K_EVENT_WAIT_CLEAR;
+	}
 
-		/* Clear signal flags as the thread is ready now */
-		key = irq_lock();
-		events->signal_results &= ~(flags);
-		irq_unlock(key);
+	switch (timeout) {
+	case 0:
+		k_timeout = K_NO_WAIT;
+		break;
+	case osWaitForever:
+		k_timeout = K_FOREVER;
+		break;
+	default:
+		k_timeout = k_ticks_to_ms_floor64(timeout);
+		break;
+	}
+
+	/* The wait condition is evaluated and the flags cleared by the
+	 * kernel atomically with the wakeup, so there is no need to loop
+	 * and recompute the remaining timeout here.
+	 */
+	sig = k_event_wait(&events->event, flags, k_options, k_timeout);
+	if (sig == 0U) {
+		return osFlagsErrorTimeout;
 	}
 
 	return sig;
@@ -223,7 +160,7 @@ uint32_t osEventFlagsGet(osEventFlagsId_t ef_id)
 		return 0;
 	}
 
-	return events->signal_results;
+	return k_event_get(&events->event);
 }
 
 /**
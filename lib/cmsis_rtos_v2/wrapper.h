@@ -60,9 +60,7 @@ struct cv2_msgq {
 };
 
 struct cv2_event_flags {
-	struct k_poll_signal poll_signal;
-	struct k_poll_event poll_event;
-	u32_t signal_results;
+	struct k_event event;
 	char name[16];
 };
 
@@ -0,0 +1,536 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <sys/sys_heap.h>
+#include <kernel.h>
+#include <string.h>
+#include <sys/__assert.h>
+#include <sys/math_extras.h>
+
+/* Second level bins per first level class */
+#define SL_BITS 3
+#define SL_COUNT BIT(SL_BITS)
+
+/* One first level class per bit of a 32 bit size */
+#define FL_MAX 32
+
+/* Every block starts with a boundary tag holding its own size and
+ * the size of the block physically before it, so both neighbours
+ * can be found in O(1) on free.  Free blocks additionally hold the
+ * links of their bin list in what would otherwise be user data.
+ */
+struct blk {
+	size_t prev_size;	/* 0 for the first block */
+	size_t size;		/* includes this header, BLK_USED flag */
+	struct blk *next_free;
+	struct blk *prev_free;
+};
+
+#define BLK_USED 1U
+
+#define ALIGN_SZ (2 * sizeof(void *))
+#define ALIGN_LOG2 (sizeof(void *) == 8 ? 4 : 3)
+#define HDR_SZ offsetof(struct blk, next_free)
+#define MIN_BLK sizeof(struct blk)
+
+/* Blocks below SMALL_SZ are binned linearly in first level class 0 */
+#define SMALL_LOG2 (SL_BITS + ALIGN_LOG2)
+#define SMALL_SZ BIT(SMALL_LOG2)
+
+struct z_heap {
+	struct blk *first;
+	struct blk *end;	/* zero-length used sentinel */
+	size_t capacity;
+	size_t allocated;
+	size_t max_allocated;
+	u32_t fl_bitmap;
+	u8_t sl_bitmap[FL_MAX];
+	int fl_count;
+	struct blk *free[][SL_COUNT];
+};
+
+BUILD_ASSERT(HDR_SZ == ALIGN_SZ);
+
+static inline size_t blk_size(struct blk *b)
+{
+	return b->size & ~(size_t)BLK_USED;
+}
+
+static inline bool blk_used(struct blk *b)
+{
+	return (b->size & BLK_USED) != 0U;
+}
+
+static inline struct blk *blk_next(struct blk *b)
+{
+	return (struct blk *)((u8_t *)b + blk_size(b));
+}
+
+static inline struct blk *blk_prev(struct blk *b)
+{
+	return (struct blk *)((u8_t *)b - b->prev_size);
+}
+
+static inline void *blk_mem(struct blk *b)
+{
+	return (u8_t *)b + HDR_SZ;
+}
+
+static inline struct blk *mem_blk(void *mem)
+{
+	return (struct blk *)((u8_t *)mem - HDR_SZ);
+}
+
+static inline int msb(u32_t x)
+{
+	return 31 - u32_count_leading_zeros(x);
+}
+
+/* Sets the size of a block, keeping the boundary tag of the
+ * following block in sync.
+ */
+static void set_size(struct blk *b, size_t size, bool used)
+{
+	b->size = size | (used ? BLK_USED : 0U);
+	blk_next(b)->prev_size = size;
+}
+
+static void mapping(size_t size, int *fl, int *sl)
+{
+	if (size < SMALL_SZ) {
+		*fl = 0;
+		*sl = size >> ALIGN_LOG2;
+	} else {
+		int f = msb(size);
+
+		*fl = f - SMALL_LOG2 + 1;
+		*sl = (size >> (f - SL_BITS)) ^ SL_COUNT;
+	}
+}
+
+/* Number of bytes a block needs to satisfy a request, or 0 if the
+ * request can never be satisfied.
+ */
+static size_t request_size(struct z_heap *h, size_t bytes)
+{
+	if (bytes == 0U || bytes > h->capacity) {
+		return 0;
+	}
+
+	return MAX(ROUND_UP(bytes + HDR_SZ, ALIGN_SZ), MIN_BLK);
+}
+
+static void free_list_add(struct z_heap *h, struct blk *b)
+{
+	int fl, sl;
+	struct blk *head;
+
+	mapping(blk_size(b), &fl, &sl);
+	head = h->free[fl][sl];
+
+	b->prev_free = NULL;
+	b->next_free = head;
+	if (head != NULL) {
+		head->prev_free = b;
+	}
+	h->free[fl][sl] = b;
+
+	h->fl_bitmap |= BIT(fl);
+	h->sl_bitmap[fl] |= BIT(sl);
+}
+
+static void free_list_remove(struct z_heap *h, struct blk *b)
+{
+	int fl, sl;
+
+	mapping(blk_size(b), &fl, &sl);
+
+	if (b->prev_free != NULL) {
+		b->prev_free->next_free = b->next_free;
+	} else {
+		h->free[fl][sl] = b->next_free;
+	}
+	if (b->next_free != NULL) {
+		b->next_free->prev_free = b->prev_free;
+	}
+
+	if (h->free[fl][sl] == NULL) {
+		h->sl_bitmap[fl] &= ~BIT(sl);
+		if (h->sl_bitmap[fl] == 0U) {
+			h->fl_bitmap &= ~BIT(fl);
+		}
+	}
+}
+
+/* Constant time "good fit": round the request up to the next second
+ * level bin so that any block found in the first non-empty bin at or
+ * above it is big enough.
+ */
+static struct blk *find_fit(struct z_heap *h, size_t size)
+{
+	size_t search = size;
+	u32_t slmap, flmap;
+	int fl, sl;
+
+	if (size >= SMALL_SZ) {
+		search += BIT(msb(size) - SL_BITS) - 1;
+	}
+
+	mapping(search, &fl, &sl);
+	if (fl < h->fl_count) {
+		slmap = h->sl_bitmap[fl] & (~0U << sl);
+		if (slmap == 0U) {
+			flmap = fl + 1 < FL_MAX
+				? h->fl_bitmap & (~0U << (fl + 1)) : 0U;
+			if (flmap != 0U) {
+				fl = u32_count_trailing_zeros(flmap);
+				slmap = h->sl_bitmap[fl];
+			}
+		}
+
+		if (slmap != 0U) {
+			sl = u32_count_trailing_zeros(slmap);
+			return h->free[fl][sl];
+		}
+	}
+
+	/* Nothing is guaranteed to fit.  Before failing, look through
+	 * the (unrounded) bin of the request itself, which may still
+	 * hold a large enough block.  This only happens when the heap
+	 * is nearly exhausted.
+	 */
+	mapping(size, &fl, &sl);
+	for (struct blk *b = h->free[fl][sl]; b != NULL; b = b->next_free) {
+		if (blk_size(b) >= size) {
+			return b;
+		}
+	}
+
+	return NULL;
+}
+
+/* Returns a free block to its bin, merging it with free neighbours */
+static void free_blk(struct z_heap *h, struct blk *b)
+{
+	struct blk *n = blk_next(b);
+	size_t size = blk_size(b);
+
+	if (!blk_used(n)) {
+		free_list_remove(h, n);
+		size += blk_size(n);
+	}
+
+	if (b->prev_size != 0U && !blk_used(blk_prev(b))) {
+		struct blk *p = blk_prev(b);
+
+		free_list_remove(h, p);
+		size += blk_size(p);
+		b = p;
+	}
+
+	set_size(b, size, false);
+	free_list_add(h, b);
+}
+
+/* Trims a used block down to size, freeing the tail if it's big
+ * enough to be a block of its own.
+ */
+static void split_tail(struct z_heap *h, struct blk *b, size_t size)
+{
+	size_t rem = blk_size(b) - size;
+
+	if (rem >= MIN_BLK) {
+		struct blk *r = (struct blk *)((u8_t *)b + size);
+
+		set_size(b, size, true);
+		r->prev_size = size;
+		set_size(r, rem, false);
+		free_blk(h, r);
+	}
+}
+
+static void account(struct z_heap *h, size_t before, size_t after)
+{
+	h->allocated += after - before;
+	h->max_allocated = MAX(h->max_allocated, h->allocated);
+}
+
+void *sys_heap_alloc(struct sys_heap *heap, size_t bytes)
+{
+	struct z_heap *h = heap->heap;
+	size_t size = request_size(h, bytes);
+	struct blk *b;
+
+	if (size == 0U) {
+		return NULL;
+	}
+
+	b = find_fit(h, size);
+	if (b == NULL) {
+		return NULL;
+	}
+
+	free_list_remove(h, b);
+	set_size(b, blk_size(b), true);
+	split_tail(h, b, size);
+	account(h, 0, blk_size(b));
+
+	return blk_mem(b);
+}
+
+void *sys_heap_aligned_alloc(struct sys_heap *heap, size_t align,
+			     size_t bytes)
+{
+	struct z_heap *h = heap->heap;
+	size_t size = request_size(h, bytes);
+	size_t padded;
+	uintptr_t mem, aligned;
+	struct blk *b;
+
+	__ASSERT((align & (align - 1)) == 0U, "align must be a power of 2");
+
+	if (align <= ALIGN_SZ) {
+		return sys_heap_alloc(heap, bytes);
+	}
+
+	/* Leave room to carve a free block off the front */
+	if (size == 0U ||
+	    size_add_overflow(size, align + MIN_BLK, &padded)) {
+		return NULL;
+	}
+
+	b = find_fit(h, padded);
+	if (b == NULL) {
+		return NULL;
+	}
+
+	free_list_remove(h, b);
+
+	mem = (uintptr_t)blk_mem(b);
+	aligned = ROUND_UP(mem, align);
+	if (aligned != mem && aligned - mem < MIN_BLK) {
+		aligned += align;
+	}
+
+	if (aligned != mem) {
+		struct blk *nb = mem_blk((void *)aligned);
+		size_t lead = aligned - mem;
+
+		/* The block's predecessor is in use (free blocks never
+		 * touch), so the leading fragment needs no merging.
+		 */
+		nb->prev_size = lead;
+		set_size(nb, blk_size(b) - lead, true);
+		set_size(b, lead, false);
+		free_list_add(h, b);
+		b = nb;
+	} else {
+		set_size(b, blk_size(b), true);
+	}
+
+	split_tail(h, b, size);
+	account(h, 0, blk_size(b));
+
+	return blk_mem(b);
+}
+
+void sys_heap_free(struct sys_heap *heap, void *mem)
+{
+	struct z_heap *h = heap->heap;
+	struct blk *b;
+
+	if (mem == NULL) {
+		return;
+	}
+
+	b = mem_blk(mem);
+	__ASSERT(blk_used(b), "double free of %p", mem);
+	__ASSERT(blk_next(b)->prev_size == blk_size(b),
+		 "corrupted heap block %p", mem);
+
+	account(h, blk_size(b), 0);
+	free_blk(h, b);
+}
+
+void *sys_heap_realloc(struct sys_heap *heap, void *ptr, size_t bytes)
+{
+	struct z_heap *h = heap->heap;
+	size_t size, cur;
+	struct blk *b, *n;
+	void *mem;
+
+	if (ptr == NULL) {
+		return sys_heap_alloc(heap, bytes);
+	}
+
+	if (bytes == 0U) {
+		sys_heap_free(heap, ptr);
+		return NULL;
+	}
+
+	size = request_size(h, bytes);
+	if (size == 0U) {
+		return NULL;
+	}
+
+	b = mem_blk(ptr);
+	cur = blk_size(b);
+	n = blk_next(b);
+
+	if (size <= cur) {
+		split_tail(h, b, size);
+		account(h, cur, blk_size(b));
+		return ptr;
+	}
+
+	if (!blk_used(n) && cur + blk_size(n) >= size) {
+		free_list_remove(h, n);
+		set_size(b, cur + blk_size(n), true);
+		split_tail(h, b, size);
+		account(h, cur, blk_size(b));
+		return ptr;
+	}
+
+	mem = sys_heap_alloc(heap, bytes);
+	if (mem != NULL) {
+		(void)memcpy(mem, ptr, cur - HDR_SZ);
+		sys_heap_free(heap, ptr);
+	}
+
+	return mem;
+}
+
+void sys_heap_runtime_stats_get(struct sys_heap *heap,
+				struct sys_heap_runtime_stats *stats)
+{
+	struct z_heap *h = heap->heap;
+	size_t largest = 0;
+
+	/* The largest block lives in the highest non-empty bin, whose
+	 * members only differ by less than one bin width.
+	 */
+	if (h->fl_bitmap != 0U) {
+		int fl = msb(h->fl_bitmap);
+		int sl = msb(h->sl_bitmap[fl]);
+
+		for (struct blk *b = h->free[fl][sl]; b != NULL;
+		     b = b->next_free) {
+			largest = MAX(largest, blk_size(b));
+		}
+	}
+
+	stats->allocated_bytes = h->allocated;
+	stats->free_bytes = h->capacity - h->allocated;
+	stats->max_allocated_bytes = h->max_allocated;
+	stats->largest_free_bytes = largest == 0U ? 0 : largest - HDR_SZ;
+}
+
+void sys_heap_init(struct sys_heap *heap, void *mem, size_t bytes)
+{
+	uintptr_t start = ROUND_UP((uintptr_t)mem, ALIGN_SZ);
+	uintptr_t end = ROUND_DOWN((uintptr_t)mem + bytes, ALIGN_SZ);
+	struct z_heap *h = (struct z_heap *)start;
+	size_t hdr;
+	int fl, sl;
+
+	__ASSERT(bytes <= UINT32_MAX, "heap too large");
+
+	/* The whole region is an upper bound on the largest block */
+	mapping(end - start, &fl, &sl);
+
+	hdr = ROUND_UP(sizeof(struct z_heap) + (fl + 1) * sizeof(h->free[0]),
+		       ALIGN_SZ);
+	__ASSERT(end - start >= hdr + MIN_BLK + HDR_SZ, "heap too small");
+
+	(void)memset(h, 0, hdr);
+	h->fl_count = fl + 1;
+	h->first = (struct blk *)(start + hdr);
+	h->end = (struct blk *)(end - HDR_SZ);
+	h->capacity = (uintptr_t)h->end - (uintptr_t)h->first;
+
+	h->first->prev_size = 0;
+	set_size(h->first, h->capacity, false);
+	h->end->size = BLK_USED;
+	free_list_add(h, h->first);
+
+	heap->heap = h;
+	heap->init_mem = mem;
+	heap->init_bytes = bytes;
+}
+
+static bool in_bin(struct z_heap *h, struct blk *b)
+{
+	int fl, sl;
+
+	mapping(blk_size(b), &fl, &sl);
+	for (struct blk *f = h->free[fl][sl]; f != NULL; f = f->next_free) {
+		if (f == b) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool sys_heap_validate(struct sys_heap *heap)
+{
+	struct z_heap *h = heap->heap;
+	size_t prev = 0, allocated = 0, nfree = 0;
+	bool prev_free = false;
+	struct blk *b;
+
+	for (b = h->first; b != h->end; b = blk_next(b)) {
+		size_t size = blk_size(b);
+
+		if (size < MIN_BLK || (size % ALIGN_SZ) != 0U ||
+		    b->prev_size != prev ||
+		    (uintptr_t)b + size > (uintptr_t)h->end) {
+			return false;
+		}
+
+		if (blk_used(b)) {
+			allocated += size;
+			prev_free = false;
+		} else {
+			if (prev_free || !in_bin(h, b)) {
+				return false;
+			}
+			nfree++;
+			prev_free = true;
+		}
+		prev = size;
+	}
+
+	if (h->end->prev_size != prev || allocated != h->allocated) {
+		return false;
+	}
+
+	for (int fl = 0; fl < FL_MAX; fl++) {
+		if (((h->fl_bitmap & BIT(fl)) != 0U) !=
+		    (h->sl_bitmap[fl] != 0U)) {
+			return false;
+		}
+
+		for (int sl = 0; fl < h->fl_count && sl < SL_COUNT; sl++) {
+			struct blk *prev_blk = NULL;
+
+			if (((h->sl_bitmap[fl] & BIT(sl)) != 0U) !=
+			    (h->free[fl][sl] != NULL)) {
+				return false;
+			}
+
+			for (b = h->free[fl][sl]; b != NULL;
+			     b = b->next_free) {
+				if (blk_used(b) || b->prev_free != prev_blk ||
+				    nfree == 0U) {
+					return false;
+				}
+				nfree--;
+				prev_blk = b;
+			}
+		}
+	}
+
+	return nfree == 0U;
+}
@@ -21,12 +21,38 @@ struct ring_element {
 	u32_t  value  :8;  /**< Room for small integral values */
 };
 
+/* The producer owns tail and the consumer owns head.  Each side reads the
+ * other's index before touching the data it covers, and publishes its own
+ * only after it is done with the data, both with full barriers, which is
+ * what makes one producer and one consumer safe without locking.
+ */
+static inline u32_t idx_get(const u32_t *idx)
+{
+	return (u32_t)atomic_get((const atomic_t *)idx);
+}
+
+static inline void idx_set(u32_t *idx, u32_t val)
+{
+	(void)atomic_set((atomic_t *)idx, (atomic_val_t)val);
+}
+
+static inline u32_t tail_get(struct ring_buf *buf)
+{
+	if (buf->mpsc) {
+		z_ring_buf_mpsc_tail_sync(buf);
+		return buf->tail;
+	}
+
+	return idx_get(&buf->tail);
+}
+
 int ring_buf_item_put(struct ring_buf *buf, u16_t type, u8_t value,
 		      u32_t *data, u8_t size32)
 {
 	u32_t i, space, index, rc;
 
-	space = ring_buf_space_get(buf);
+	space = z_ring_buf_custom_space_get(buf->size, idx_get(&buf->head),
+					    buf->tail);
 	if (space >= (size32 + 1)) {
 		struct ring_element *header =
 			(struct ring_element *)&buf->buf.buf32[buf->tail];
@@ -39,13 +65,13 @@ int ring_buf_item_put(struct ring_buf *buf, u16_t type, u8_t value,
 				index = (i + buf->tail + 1) & buf->mask;
 				buf->buf.buf32[index] = data[i];
 			}
-			buf->tail = (buf->tail + size32 + 1) & buf->mask;
+			idx_set(&buf->tail, (buf->tail + size32 + 1) & buf->mask);
 		} else {
 			for (i = 0U; i < size32; ++i) {
 				index = (i + buf->tail + 1) % buf->size;
 				buf->buf.buf32[index] = data[i];
 			}
-			buf->tail = (buf->tail + size32 + 1) % buf->size;
+			idx_set(&buf->tail, (buf->tail + size32 + 1) % buf->size);
 		}
 		rc = 0U;
 	} else {
@@ -62,7 +88,7 @@ int ring_buf_item_get(struct ring_buf *buf, u16_t *type, u8_t *value,
 	struct ring_element *header;
 	u32_t i, index;
 
-	if (ring_buf_is_empty(buf)) {
+	if (buf->head == idx_get(&buf->tail)) {
 		return -EAGAIN;
 	}
 
@@ -82,13 +108,13 @@ int ring_buf_item_get(struct ring_buf *buf, u16_t *type, u8_t *value,
 			index = (i + buf->head + 1) & buf->mask;
 			data[i] = buf->buf.buf32[index];
 		}
-		buf->head = (buf->head + header->length + 1) & buf->mask;
+		idx_set(&buf->head, (buf->head + header->length + 1) & buf->mask);
 	} else {
 		for (i = 0U; i < header->length; ++i) {
 			index = (i + buf->head + 1) % buf->size;
 			data[i] = buf->buf.buf32[index];
 		}
-		buf->head = (buf->head + header->length + 1) % buf->size;
+		idx_set(&buf->head, (buf->head + header->length + 1) % buf->size);
 	}
 
 	return 0;
@@ -110,7 +136,9 @@ u32_t ring_buf_put_claim(struct ring_buf *buf, u8_t **data, u32_t size)
 {
 	u32_t space, trail_size, allocated;
 
-	space = z_ring_buf_custom_space_get(buf->size, buf->head,
+	__ASSERT_NO_MSG(!buf->mpsc);
+
+	space = z_ring_buf_custom_space_get(buf->size, idx_get(&buf->head),
 					    buf->misc.byte_mode.tmp_tail);
 
 	/* Limit requested size to available size. */
@@ -129,12 +157,13 @@ u32_t ring_buf_put_claim(struct ring_buf *buf, u8_t **data, u32_t size)
 
 int ring_buf_put_finish(struct ring_buf *buf, u32_t size)
 {
-	if (size > ring_buf_space_get(buf)) {
+	if (size > z_ring_buf_custom_space_get(buf->size, idx_get(&buf->head),
+					       buf->tail)) {
 		return -EINVAL;
 	}
 
-	buf->tail = wrap(buf->tail + size, buf->size);
-	buf->misc.byte_mode.tmp_tail = buf->tail;
+	buf->misc.byte_mode.tmp_tail = wrap(buf->tail + size, buf->size);
+	idx_set(&buf->tail, buf->misc.byte_mode.tmp_tail);
 
 	return 0;
 }
@@ -167,7 +196,7 @@ u32_t ring_buf_get_claim(struct ring_buf *buf, u8_t **data, u32_t size)
 	space = (buf->size - 1) -
 		z_ring_buf_custom_space_get(buf->size,
 					    buf->misc.byte_mode.tmp_head,
-					    buf->tail);
+					    tail_get(buf));
 	trail_size = buf->size - buf->misc.byte_mode.tmp_head;
 
 	/* Limit requested size to available size. */
@@ -185,14 +214,16 @@ u32_t ring_buf_get_claim(struct ring_buf *buf, u8_t **data, u32_t size)
 
 int ring_buf_get_finish(struct ring_buf *buf, u32_t size)
 {
-	u32_t allocated = (buf->size - 1) - ring_buf_space_get(buf);
+	u32_t allocated = (buf->size - 1) -
+		z_ring_buf_custom_space_get(buf->size, buf->head,
+					    tail_get(buf));
 
 	if (size > allocated) {
 		return -EINVAL;
 	}
 
-	buf->head = wrap(buf->head + size, buf->size);
-	buf->misc.byte_mode.tmp_head = buf->head;
+	buf->misc.byte_mode.tmp_head = wrap(buf->head + size, buf->size);
+	idx_set(&buf->head, buf->misc.byte_mode.tmp_head);
 
 	return 0;
 }
@@ -217,3 +248,82 @@ u32_t ring_buf_get(struct ring_buf *buf, u8_t *data, u32_t size)
 
 	return total_size;
 }
+
+u32_t ring_buf_put_claim_segs(struct ring_buf *buf, struct ring_buf_seg seg[2],
+			      u32_t size)
+{
+	seg[0].size = ring_buf_put_claim(buf, &seg[0].data, size);
+	seg[1].size = ring_buf_put_claim(buf, &seg[1].data,
+					 size - seg[0].size);
+
+	return seg[0].size + seg[1].size;
+}
+
+u32_t ring_buf_get_claim_segs(struct ring_buf *buf, struct ring_buf_seg seg[2],
+			      u32_t size)
+{
+	seg[0].size = ring_buf_get_claim(buf, &seg[0].data, size);
+	seg[1].size = ring_buf_get_claim(buf, &seg[1].data,
+					 size - seg[0].size);
+
+	return seg[0].size + seg[1].size;
+}
+
+u32_t ring_buf_mpsc_put_claim(struct ring_buf *buf, struct ring_buf_seg seg[2],
+			      u32_t size)
+{
+	atomic_t *ctrl = &buf->misc.mpsc_mode.ctrl;
+	u32_t old, idx, space;
+
+	__ASSERT_NO_MSG(buf->mpsc);
+
+	/* Bump the count of puts in progress and move the reserved index
+	 * past our space in one step, so that a count of zero always means
+	 * everything up to the reserved index has been written.
+	 */
+	do {
+		old = (u32_t)atomic_get(ctrl);
+		idx = old & Z_RING_BUF_MPSC_IDX_MASK;
+		space = z_ring_buf_custom_space_get(buf->size,
+						    idx_get(&buf->head), idx);
+
+		if (size == 0U || size > space ||
+		    (old >> Z_RING_BUF_MPSC_CNT_SHIFT) ==
+		    Z_RING_BUF_MPSC_CNT_MAX) {
+			return 0;
+		}
+	} while (!atomic_cas(ctrl, (atomic_val_t)old,
+			     (atomic_val_t)((old & ~Z_RING_BUF_MPSC_IDX_MASK) +
+					    BIT(Z_RING_BUF_MPSC_CNT_SHIFT) +
+					    wrap(idx + size, buf->size))));
+
+	seg[0].data = &buf->buf.buf8[idx];
+	seg[0].size = MIN(size, buf->size - idx);
+	seg[1].data = buf->buf.buf8;
+	seg[1].size = size - seg[0].size;
+
+	return size;
+}
+
+void ring_buf_mpsc_put_finish(struct ring_buf *buf)
+{
+	__ASSERT_NO_MSG(buf->mpsc);
+
+	(void)atomic_sub(&buf->misc.mpsc_mode.ctrl,
+			 (atomic_val_t)BIT(Z_RING_BUF_MPSC_CNT_SHIFT));
+}
+
+u32_t ring_buf_mpsc_put(struct ring_buf *buf, const u8_t *data, u32_t size)
+{
+	struct ring_buf_seg seg[2];
+
+	if (ring_buf_mpsc_put_claim(buf, seg, size) == 0U) {
+		return 0;
+	}
+
+	memcpy(seg[0].data, data, seg[0].size);
+	memcpy(seg[1].data, data + seg[0].size, seg[1].size);
+	ring_buf_mpsc_put_finish(buf);
+
+	return size;
+}
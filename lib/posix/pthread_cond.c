@@ -60,10 +60,7 @@ int pthread_cond_broadcast(pthread_cond_t *cv)
 {
 	int key = irq_lock();
 
-	while (z_waitq_head(&cv->wait_q)) {
-		_ready_one_thread(&cv->wait_q);
-	}
-
+	(void)z_unpend_all(&cv->wait_q);
 	z_reschedule_irqlock(key);
 
 	return 0;
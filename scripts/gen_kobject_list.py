@@ -81,6 +81,7 @@ kobjects = OrderedDict([
     ("k_queue", (None, False)),
     ("k_poll_signal", (None, False)),
     ("k_sem", (None, False)),
+    ("k_event", ("CONFIG_EVENTS", False)),
     ("k_stack", (None, False)),
     ("k_thread", (None, False)),
     ("k_timer", (None, False)),
@@ -0,0 +1,294 @@
+#!/usr/bin/env python3
+#
+# SPDX-License-Identifier: Apache-2.0
+"""
+Decode dictionary format logs (CONFIG_LOG_DICTIONARY).
+
+The target sends the address of each format string with the raw arguments
+of the message. This script looks the strings and the log source names up
+in the ELF file of the application and prints the messages as the logger
+would have. The record layout is described in
+subsys/logging/log_output_dict.c.
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+from elftools.elf.elffile import ELFFile
+from elftools.elf.sections import SymbolTableSection
+
+TYPE_STD = 0xD1
+TYPE_HEXDUMP = 0xD2
+TYPE_DROPPED = 0xD3
+
+SEVERITY = [None, "err", "wrn", "inf", "dbg"]
+
+HEXDUMP_BYTES_IN_LINE = 16
+
+# printf conversion, the groups being the flags, width and precision, the
+# length modifier and the conversion itself
+FMT_RE = re.compile(r"%([-+ #0]*\d*(?:\.\d+)?)(hh|h|ll|l|z|j|t|L)?([diouxXcspfFeEgG%])")
+
+
+class Elf:
+    def __init__(self, path):
+        self.elf = ELFFile(open(path, "rb"))
+        self.word = 8 if self.elf.elfclass == 64 else 4
+        self.endian = "<" if self.elf.little_endian else ">"
+        self.ptr = "Q" if self.word == 8 else "I"
+        self.segments = []
+
+        for section in self.elf.iter_sections():
+            if section["sh_type"] == "SHT_NOBITS" or not section["sh_addr"]:
+                continue
+            self.segments.append((section["sh_addr"], section.data()))
+
+        self.sources = self._sources()
+
+    def symbol(self, name):
+        for section in self.elf.iter_sections():
+            if not isinstance(section, SymbolTableSection):
+                continue
+            syms = section.get_symbol_by_name(name)
+            if syms:
+                return syms[0]["st_value"]
+        return None
+
+    def string(self, addr):
+        for start, data in self.segments:
+            if start <= addr < start + len(data):
+                end = data.find(b"\0", addr - start)
+                if end < 0:
+                    end = len(data)
+                return data[addr - start:end].decode("utf-8", "replace")
+        return None
+
+    def word_at(self, addr):
+        for start, data in self.segments:
+            if start <= addr and addr + self.word <= start + len(data):
+                return struct.unpack_from(self.endian + self.ptr, data,
+                                          addr - start)[0]
+        return None
+
+    def _sources(self):
+        # struct log_source_const_data is a name pointer and a level,
+        # padded to two words
+        start = self.symbol("__log_const_start")
+        end = self.symbol("__log_const_end")
+        sources = []
+
+        if start is None or end is None:
+            return sources
+
+        for addr in range(start, end, 2 * self.word):
+            name = self.word_at(addr)
+            sources.append(self.string(name) if name is not None else None)
+
+        return sources
+
+
+class Stream:
+    def __init__(self, data, elf):
+        self.data = data
+        self.pos = 0
+        self.elf = elf
+
+    def remaining(self):
+        return len(self.data) - self.pos
+
+    def get(self, fmt):
+        fmt = self.elf.endian + fmt.replace("P", self.elf.ptr)
+        size = struct.calcsize(fmt)
+        if self.remaining() < size:
+            raise EOFError
+        values = struct.unpack_from(fmt, self.data, self.pos)
+        self.pos += size
+        return values if len(values) > 1 else values[0]
+
+    def bytes(self, length):
+        if self.remaining() < length:
+            raise EOFError
+        value = self.data[self.pos:self.pos + length]
+        self.pos += length
+        return value
+
+
+def to_signed(value, bits):
+    if value & (1 << (bits - 1)):
+        return value - (1 << bits)
+    return value
+
+
+def format_message(fmt, args, strings, elf):
+    """Apply the C format string to the raw argument words"""
+    out = []
+    pos = 0
+    idx = 0
+    bits = elf.word * 8
+
+    for m in FMT_RE.finditer(fmt):
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        spec, _, conv = m.groups()
+
+        if conv == "%":
+            out.append("%")
+            continue
+
+        if idx >= len(args):
+            out.append(m.group(0))
+            continue
+
+        arg = args[idx]
+        if conv == "s":
+            value = strings.get(idx)
+            if value is None:
+                value = elf.string(arg)
+            if value is None:
+                value = "<0x%x>" % arg
+        elif conv in "di":
+            value = to_signed(arg, bits)
+        elif conv == "p":
+            conv = "s"
+            value = "0x%x" % arg
+        elif conv in "fFeEgG":
+            # Deferred logging does not support floating point arguments
+            conv = "s"
+            value = "<float>"
+        else:
+            value = arg
+
+        out.append(("%" + spec + conv) % value)
+        idx += 1
+
+    out.append(fmt[pos:])
+    return "".join(out)
+
+
+def prefix(args, elf, level, domain, source, timestamp):
+    if args.timestamp_freq:
+        seconds = timestamp / args.timestamp_freq
+        hours = int(seconds // 3600)
+        ts = "[%02d:%02d:%02d.%03d,%03d]" % (
+            hours, int(seconds // 60) % 60, int(seconds) % 60,
+            int(seconds * 1000) % 1000, int(seconds * 1000000) % 1000)
+    else:
+        ts = "[%08d]" % timestamp
+
+    if source < len(elf.sources) and elf.sources[source]:
+        name = elf.sources[source]
+    else:
+        name = "source %d" % source
+
+    if domain:
+        name = "%d/%s" % (domain, name)
+
+    severity = SEVERITY[level] if level < len(SEVERITY) else "???"
+
+    return "%s <%s> %s: " % (ts, severity, name)
+
+
+def decode(data, elf, args):
+    stream = Stream(data, elf)
+
+    while stream.remaining():
+        start = stream.pos
+        try:
+            rtype = stream.get("B")
+
+            if rtype == TYPE_DROPPED:
+                print("--- %d messages dropped ---" % stream.get("I"))
+                continue
+
+            if rtype not in (TYPE_STD, TYPE_HEXDUMP):
+                # Not at a record boundary, resynchronize on the next byte
+                continue
+
+            level_domain, source, timestamp = stream.get("BHI")
+            level = level_domain & 0x7
+            domain = (level_domain >> 3) & 0x7
+            addr = stream.get("P")
+            fmt = elf.string(addr)
+            if fmt is None:
+                fmt = "<unknown string 0x%x>" % addr
+
+            if rtype == TYPE_STD:
+                nargs, mask = stream.get("BH")
+                words = [stream.get("P") for _ in range(nargs)]
+                strings = {}
+                for i in range(nargs):
+                    if mask & (1 << i):
+                        length = stream.get("B")
+                        strings[i] = stream.bytes(length).decode(
+                            "utf-8", "replace")
+
+                text = format_message(fmt, words, strings, elf)
+
+                # Level none carries raw strings, as from printk
+                if level == 0:
+                    sys.stdout.write(text)
+                else:
+                    print(prefix(args, elf, level, domain, source,
+                                 timestamp) + text)
+            else:
+                length = stream.get("H")
+                payload = stream.bytes(length)
+                head = prefix(args, elf, level, domain, source, timestamp)
+                print(head + fmt)
+                for i in range(0, length, HEXDUMP_BYTES_IN_LINE):
+                    line = payload[i:i + HEXDUMP_BYTES_IN_LINE]
+                    hexa = " ".join("%02x" % b for b in line)
+                    text = "".join(chr(b) if 32 <= b < 127 else "."
+                                   for b in line)
+                    print(" " * len(head) + "%-48s|%s" % (hexa, text))
+        except EOFError:
+            # Incomplete record, kept for the next chunk of data
+            return data[start:]
+
+    return b""
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("elf", help="zephyr.elf of the application")
+    parser.add_argument("logs", nargs="?", default="-",
+                        help="binary log data, standard input by default")
+    parser.add_argument("-d", "--serial_port",
+                        help="read the logs from a serial port instead")
+    parser.add_argument("-b", "--serial_baudrate", type=int, default=115200,
+                        help="serial baudrate")
+    parser.add_argument("-f", "--timestamp_freq", type=int, default=0,
+                        help="timestamp frequency, to print it as a time")
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+    elf = Elf(args.elf)
+    pending = b""
+
+    if args.serial_port:
+        import serial
+
+        port = serial.Serial(args.serial_port, args.serial_baudrate)
+        while True:
+            pending = decode(pending + port.read(port.in_waiting or 1),
+                             elf, args)
+            sys.stdout.flush()
+
+    if args.logs == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.logs, "rb") as f:
+            data = f.read()
+
+    if decode(data, elf, args):
+        print("--- incomplete record at the end ---", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,212 @@
+# SPDX-License-Identifier: Apache-2.0
+"""
+Tests of log_dict_parser.py on logs recorded against a small ELF file
+made up by the test, holding the strings and log sources the logs refer to.
+"""
+
+import os
+import struct
+import subprocess
+import sys
+
+import pytest
+
+pytest.importorskip("elftools")
+
+PARSER = os.path.join(os.path.dirname(__file__), "..", "log_dict_parser.py")
+
+TYPE_STD = 0xD1
+TYPE_HEXDUMP = 0xD2
+TYPE_DROPPED = 0xD3
+
+LEVEL_ERR = 1
+LEVEL_INF = 3
+
+RODATA_ADDR = 0x1000
+LOG_CONST_ADDR = 0x2000
+
+SOURCES = ["source_a", "source_b"]
+STRINGS = ["value %d, %s and %s", "literal", "raw %x\n", "dump"]
+
+
+class Target:
+    """Word size and byte order of the target and addresses of the ELF"""
+
+    def __init__(self, elfclass, endian):
+        self.elfclass = elfclass
+        self.word = 8 if elfclass == 64 else 4
+        self.endian = endian
+        self.ptr = "Q" if elfclass == 64 else "I"
+
+        self.rodata = b""
+        self.addr = {}
+        for s in SOURCES + STRINGS:
+            self.addr[s] = RODATA_ADDR + len(self.rodata)
+            self.rodata += s.encode() + b"\0"
+
+        # struct log_source_const_data: name pointer and level, padded to
+        # two words
+        self.log_const = b"".join(
+            self.pack("PP", self.addr[s], 0) for s in SOURCES)
+
+    def pack(self, fmt, *values):
+        return struct.pack(self.endian + fmt.replace("P", self.ptr), *values)
+
+    def elf(self):
+        strtab = b"\0__log_const_start\0__log_const_end\0"
+        # Symbols bound globally, with no type
+        GLOBAL = 0x10
+        shstrtab = b"\0.rodata\0log_const_sections\0.symtab\0.strtab\0" \
+                   b".shstrtab\0"
+
+        if self.elfclass == 64:
+            sym_fmt = "IBBHQQ"
+            symtab = b"".join([
+                self.pack(sym_fmt, 0, 0, 0, 0, 0, 0),
+                self.pack(sym_fmt, 1, GLOBAL, 0, 2, LOG_CONST_ADDR, 0),
+                self.pack(sym_fmt, 19, GLOBAL, 0, 2,
+                          LOG_CONST_ADDR + len(self.log_const), 0)])
+            ehdr_fmt = "16sHHIQQQIHHHHHH"
+            shdr_fmt = "IIQQQQIIQQ"
+        else:
+            sym_fmt = "IIIBBH"
+            symtab = b"".join([
+                self.pack(sym_fmt, 0, 0, 0, 0, 0, 0),
+                self.pack(sym_fmt, 1, LOG_CONST_ADDR, 0, GLOBAL, 0, 2),
+                self.pack(sym_fmt, 19, LOG_CONST_ADDR + len(self.log_const),
+                          0, GLOBAL, 0, 2)])
+            ehdr_fmt = "16sHHIIIIIHHHHHH"
+            shdr_fmt = "IIIIIIIIII"
+
+        ehdr_size = struct.calcsize(ehdr_fmt)
+        sym_size = struct.calcsize(sym_fmt)
+
+        # name, type, flags, address, data, link, entry size
+        sections = [
+            (0, 0, 0, 0, b"", 0, 0),
+            (1, 1, 2, RODATA_ADDR, self.rodata, 0, 0),
+            (9, 1, 2, LOG_CONST_ADDR, self.log_const, 0, 0),
+            (28, 2, 0, 0, symtab, 4, sym_size),
+            (36, 3, 0, 0, strtab, 0, 0),
+            (44, 3, 0, 0, shstrtab, 0, 0),
+        ]
+
+        body = b""
+        headers = b""
+        for name, stype, flags, addr, data, link, entsize in sections:
+            offset = ehdr_size + len(body) if data else 0
+            info = 1 if stype == 2 else 0
+            headers += self.pack(shdr_fmt, name, stype, flags, addr, offset,
+                                 len(data), link, info, 1, entsize)
+            body += data
+
+        ident = b"\x7fELF" + bytes([2 if self.elfclass == 64 else 1,
+                                    1 if self.endian == "<" else 2, 1])
+        ehdr = self.pack(ehdr_fmt, ident.ljust(16, b"\0"), 2,
+                         62 if self.elfclass == 64 else 3, 1, 0, 0,
+                         ehdr_size + len(body), 0, ehdr_size, 0, 0,
+                         struct.calcsize(shdr_fmt), len(sections),
+                         len(sections) - 1)
+
+        return ehdr + body + headers
+
+    def hdr(self, rtype, level, domain, source, timestamp, addr):
+        return self.pack("BBHIP", rtype, level | (domain << 3), source,
+                         timestamp, addr)
+
+    def std(self, level, domain, source, timestamp, fmt, args,
+            strings=None):
+        strings = strings or {}
+        mask = sum(1 << i for i in strings)
+        words = [a & ((1 << (8 * self.word)) - 1) for a in args]
+
+        record = self.hdr(TYPE_STD, level, domain, source, timestamp,
+                          self.addr[fmt])
+        record += self.pack("BH", len(args), mask)
+        record += self.pack("P" * len(words), *words)
+        for i in sorted(strings):
+            record += self.pack("B", len(strings[i])) + strings[i].encode()
+
+        return record
+
+    def hexdump(self, level, source, timestamp, meta, data):
+        return self.hdr(TYPE_HEXDUMP, level, 0, source, timestamp,
+                        self.addr[meta]) + self.pack("H", len(data)) + data
+
+    def dropped(self, count):
+        return self.pack("BI", TYPE_DROPPED, count)
+
+
+TARGETS = [(32, "<"), (64, "<"), (32, ">")]
+
+
+def run_parser(tmp_path, target, logs, *options):
+    elf = tmp_path / "zephyr.elf"
+    elf.write_bytes(target.elf())
+    log_file = tmp_path / "logs.bin"
+    log_file.write_bytes(logs)
+
+    return subprocess.run(
+        [sys.executable, PARSER, *options, str(elf), str(log_file)],
+        stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+        universal_newlines=True, check=True)
+
+
+@pytest.mark.parametrize("elfclass,endian", TARGETS)
+def test_std(tmp_path, elfclass, endian):
+    target = Target(elfclass, endian)
+    logs = target.std(LEVEL_INF, 0, 1, 1234, "value %d, %s and %s",
+                      [-5, target.addr["literal"], 0xdead],
+                      {2: "dup"})
+    logs += target.std(LEVEL_ERR, 2, 0, 99, "value %d, %s and %s",
+                       [7, target.addr["literal"], 0xbeef],
+                       {2: "other"})
+    logs += target.std(0, 0, 0, 0, "raw %x\n", [255])
+
+    out = run_parser(tmp_path, target, logs)
+
+    assert out.stdout == (
+        "[00001234] <inf> source_b: value -5, literal and dup\n"
+        "[00000099] <err> 2/source_a: value 7, literal and other\n"
+        "raw ff\n")
+    assert out.stderr == ""
+
+
+@pytest.mark.parametrize("elfclass,endian", TARGETS)
+def test_hexdump(tmp_path, elfclass, endian):
+    target = Target(elfclass, endian)
+    logs = target.hexdump(LEVEL_ERR, 0, 5, "dump", b"0123456789abcdef\0\xff")
+
+    out = run_parser(tmp_path, target, logs)
+
+    head = "[00000005] <err> source_a: "
+    assert out.stdout.splitlines() == [
+        head + "dump",
+        " " * len(head) +
+        "30 31 32 33 34 35 36 37 38 39 61 62 63 64 65 66 |0123456789abcdef",
+        " " * len(head) + "%-48s|.." % "00 ff",
+    ]
+
+
+def test_dropped_and_resync(tmp_path):
+    target = Target(32, "<")
+    # A stray byte before the records is skipped
+    logs = b"\x00" + target.dropped(3)
+    logs += target.std(LEVEL_INF, 0, 1, 1500, "raw %x\n", [16])
+
+    out = run_parser(tmp_path, target, logs, "-f", "1000")
+
+    assert out.stdout == (
+        "--- 3 messages dropped ---\n"
+        "[00:00:01.500,000] <inf> source_b: raw 10\n\n")
+
+
+def test_incomplete_record(tmp_path):
+    target = Target(32, "<")
+    record = target.std(LEVEL_INF, 0, 0, 1, "raw %x\n", [1])
+    logs = target.dropped(1) + record[:-2]
+
+    out = run_parser(tmp_path, target, logs)
+
+    assert out.stdout == "--- 1 messages dropped ---\n"
+    assert "incomplete record" in out.stderr
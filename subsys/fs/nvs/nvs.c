@@ -26,6 +26,43 @@ static inline size_t nvs_al_size(struct nvs_fs *fs, size_t len)
 	}
 	return (len + (fs->write_block_size - 1U)) & ~(fs->write_block_size - 1U);
 }
+
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+/* nvs_lookup_cache_pos returns the lookup cache slot of id */
+static inline size_t nvs_lookup_cache_pos(u16_t id)
+{
+	return id % CONFIG_NVS_LOOKUP_CACHE_SIZE;
+}
+
+/* drop the lookup cache slots that point into an erased sector, they have
+ * to fall back to a walk from ate_wra.
+ */
+static void nvs_lookup_cache_invalidate(struct nvs_fs *fs, u32_t addr)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(fs->lookup_cache); i++) {
+		if ((fs->lookup_cache[i] >> ADDR_SECT_SHIFT) ==
+		    (addr >> ADDR_SECT_SHIFT)) {
+			fs->lookup_cache[i] = NVS_LOOKUP_CACHE_WALK;
+		}
+	}
+}
+#endif
+
+/* nvs_walk_start returns the address from which to walk back to find the
+ * latest ate of id, or NVS_LOOKUP_CACHE_NO_ADDR if id has never been
+ * written. Without the lookup cache this is always ate_wra.
+ */
+static u32_t nvs_walk_start(struct nvs_fs *fs, u16_t id)
+{
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	u32_t addr = fs->lookup_cache[nvs_lookup_cache_pos(id)];
+
+	if (addr != NVS_LOOKUP_CACHE_WALK) {
+		return addr;
+	}
+#endif
+	return fs->ate_wra;
+}
 /* end basic routines */
 
 /* flash routines */
@@ -103,6 +140,13 @@ static int nvs_flash_ate_wrt(struct nvs_fs *fs, const struct nvs_ate *entry)
 
 	rc = nvs_flash_al_wrt(fs, fs->ate_wra, entry,
 			       sizeof(struct nvs_ate));
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	/* 0xFFFF is the id of sector close ate's, these are never looked up */
+	if (!rc && (entry->id != 0xFFFF)) {
+		fs->lookup_cache[nvs_lookup_cache_pos(entry->id)] =
+			fs->ate_wra;
+	}
+#endif
 	fs->ate_wra -= nvs_al_size(fs, sizeof(struct nvs_ate));
 
 	return rc;
@@ -243,6 +287,9 @@ static int nvs_flash_erase_sector(struct nvs_fs *fs, u32_t addr)
 		return rc;
 	}
 	(void) flash_write_protection_set(fs->flash_device, 1);
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	nvs_lookup_cache_invalidate(fs, addr);
+#endif
 	return 0;
 }
 
@@ -397,6 +444,39 @@ static int nvs_prev_ate(struct nvs_fs *fs, u32_t *addr, struct nvs_ate *ate)
 	return 0;
 }
 
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+/* rebuild the lookup cache by walking all ate's from newest to oldest, the
+ * first valid ate found for a slot is the latest one.
+ */
+static int nvs_lookup_cache_rebuild(struct nvs_fs *fs)
+{
+	int rc;
+	u32_t addr, ate_addr;
+	u32_t *slot;
+	struct nvs_ate ate;
+
+	(void)memset(fs->lookup_cache, 0xff, sizeof(fs->lookup_cache));
+	addr = fs->ate_wra;
+
+	while (1) {
+		ate_addr = addr;
+		rc = nvs_prev_ate(fs, &addr, &ate);
+		if (rc) {
+			return rc;
+		}
+		slot = &fs->lookup_cache[nvs_lookup_cache_pos(ate.id)];
+		if ((ate.id != 0xFFFF) && (*slot == NVS_LOOKUP_CACHE_NO_ADDR) &&
+		    (!nvs_ate_crc8_check(&ate))) {
+			*slot = ate_addr;
+		}
+		if (addr == fs->ate_wra) {
+			break;
+		}
+	}
+	return 0;
+}
+#endif
+
 static void nvs_sector_advance(struct nvs_fs *fs, u32_t *addr)
 {
 	*addr += (1 << ADDR_SECT_SHIFT);
@@ -480,7 +560,10 @@ static int nvs_gc(struct nvs_fs *fs)
 		if (rc) {
 			return rc;
 		}
-		wlk_addr = fs->ate_wra;
+		wlk_addr = nvs_walk_start(fs, gc_ate.id);
+		if (wlk_addr == NVS_LOOKUP_CACHE_NO_ADDR) {
+			wlk_addr = fs->ate_wra;
+		}
 		while (1) {
 			wlk_prev_addr = wlk_addr;
 			rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
@@ -521,6 +604,18 @@ static int nvs_gc(struct nvs_fs *fs)
 			}
 		}
 
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+		if (fs->lookup_cache[nvs_lookup_cache_pos(gc_ate.id)] ==
+		    gc_prev_addr) {
+			/* the latest ate of the slot was not copied (deleted
+			 * item), older ate's of the slot can only be in this
+			 * sector too and update the slot again when copied.
+			 */
+			fs->lookup_cache[nvs_lookup_cache_pos(gc_ate.id)] =
+				NVS_LOOKUP_CACHE_NO_ADDR;
+		}
+#endif
+
 		/* stop gc at end of the sector */
 		if (gc_prev_addr == stop_addr) {
 			break;
@@ -548,6 +643,13 @@ static int nvs_startup(struct nvs_fs *fs)
 
 	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
 
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	/* forget any previous use of fs, an interrupted gc restarted below
+	 * must walk from ate_wra.
+	 */
+	(void)memset(fs->lookup_cache, 0xff, sizeof(fs->lookup_cache));
+#endif
+
 	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
 	/* step through the sectors to find a open sector following
 	 * a closed sector, this is where NVS can to write.
@@ -664,6 +766,10 @@ static int nvs_startup(struct nvs_fs *fs)
 		}
 	}
 
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	rc = nvs_lookup_cache_rebuild(fs);
+#endif
+
 end:
 	k_mutex_unlock(&fs->nvs_lock);
 	return rc;
@@ -774,10 +880,10 @@ ssize_t nvs_write(struct nvs_fs *fs, u16_t id, const void *data, size_t len)
 	}
 
 	/* find latest entry with same id */
-	wlk_addr = fs->ate_wra;
+	wlk_addr = nvs_walk_start(fs, id);
 	rd_addr = wlk_addr;
 
-	while (1) {
+	while (wlk_addr != NVS_LOOKUP_CACHE_NO_ADDR) {
 		rd_addr = wlk_addr;
 		rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
 		if (rc) {
@@ -892,7 +998,10 @@ ssize_t nvs_read_hist(struct nvs_fs *fs, u16_t id, void *data, size_t len,
 
 	cnt_his = 0U;
 
-	wlk_addr = fs->ate_wra;
+	wlk_addr = nvs_walk_start(fs, id);
+	if (wlk_addr == NVS_LOOKUP_CACHE_NO_ADDR) {
+		return -ENOENT;
+	}
 	rd_addr = wlk_addr;
 
 	while (cnt_his <= cnt) {
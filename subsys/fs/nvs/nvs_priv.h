@@ -28,6 +28,14 @@ extern "C" {
 
 #define NVS_BLOCK_SIZE 32
 
+/*
+ * Lookup cache slot values that are not ate addresses: no ate for any
+ * id of the slot exists, or the slot must be looked up by a walk from
+ * ate_wra because the ate it pointed to was garbage collected.
+ */
+#define NVS_LOOKUP_CACHE_NO_ADDR 0xFFFFFFFF
+#define NVS_LOOKUP_CACHE_WALK 0xFFFFFFFE
+
 /* Allocation Table Entry */
 struct nvs_ate {
 	u16_t id;	/* data id */
@@ -34,6 +34,10 @@ static void put(const struct log_backend *const backend,
 	u32_t flag = IS_ENABLED(CONFIG_LOG_BACKEND_UART_SYST_ENABLE) ?
 		LOG_OUTPUT_FLAG_FORMAT_SYST : 0;
 
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_UART_DICT_ENABLE)) {
+		flag = LOG_OUTPUT_FLAG_FORMAT_DICT;
+	}
+
 	log_backend_std_put(&log_output, flag, msg);
 }
 
@@ -56,6 +60,11 @@ static void dropped(const struct log_backend *const backend, u32_t cnt)
 {
 	ARG_UNUSED(backend);
 
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_UART_DICT_ENABLE)) {
+		log_output_dict_dropped_process(&log_output, cnt);
+		return;
+	}
+
 	log_backend_std_dropped(&log_output, cnt);
 }
 
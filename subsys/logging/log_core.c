@@ -5,6 +5,7 @@
  */
 #include <logging/log_msg.h>
 #include "log_list.h"
+#include "log_mpsc.h"
 #include <logging/log.h>
 #include <logging/log_backend.h>
 #include <logging/log_ctrl.h>
@@ -58,7 +59,9 @@ struct k_mem_slab log_strdup_pool;
 static u8_t __noinit __aligned(sizeof(void *))
 		log_strdup_pool_buf[LOG_STRDUP_POOL_BUFFER_SIZE];
 
+#if !defined(CONFIG_LOG_MPSC_BUFFER)
 static struct log_list_t list;
+#endif
 static atomic_t initialized;
 static bool panic_mode;
 static bool backend_attached;
@@ -181,6 +184,45 @@ static void detect_missed_strdup(struct log_msg *msg)
 #undef ERR_MSG
 }
 
+/* Messages in the packet buffer are queued in allocation order, committing
+ * them needs no lock.
+ */
+static inline void msg_enqueue(struct log_msg *msg)
+{
+#if defined(CONFIG_LOG_MPSC_BUFFER)
+	log_mpsc_commit(&log_msg_mpsc, (union log_msg_chunk *)msg);
+#else
+	unsigned int key = irq_lock();
+
+	log_list_add_tail(&list, msg);
+
+	irq_unlock(key);
+#endif
+}
+
+static inline struct log_msg *msg_dequeue(void)
+{
+#if defined(CONFIG_LOG_MPSC_BUFFER)
+	return (struct log_msg *)log_mpsc_claim(&log_msg_mpsc);
+#else
+	unsigned int key = irq_lock();
+	struct log_msg *msg = log_list_head_get(&list);
+
+	irq_unlock(key);
+
+	return msg;
+#endif
+}
+
+static inline bool msg_pending(void)
+{
+#if defined(CONFIG_LOG_MPSC_BUFFER)
+	return log_mpsc_is_ready(&log_msg_mpsc);
+#else
+	return (log_list_head_peek(&list) != NULL);
+#endif
+}
+
 static inline void msg_finalize(struct log_msg *msg,
 				struct log_msg_ids src_level)
 {
@@ -191,11 +233,7 @@ static inline void msg_finalize(struct log_msg *msg,
 
 	atomic_inc(&buffered_cnt);
 
-	key = irq_lock();
-
-	log_list_add_tail(&list, msg);
-
-	irq_unlock(key);
+	msg_enqueue(msg);
 
 	if (panic_mode) {
 		key = irq_lock();
@@ -454,7 +492,9 @@ void log_core_init(void)
 
 	if (!IS_ENABLED(CONFIG_LOG_IMMEDIATE)) {
 		log_msg_pool_init();
+#if !defined(CONFIG_LOG_MPSC_BUFFER)
 		log_list_init(&list);
+#endif
 
 		k_mem_slab_init(&log_strdup_pool, log_strdup_pool_buf,
 					sizeof(struct log_strdup_buf),
@@ -656,10 +696,8 @@ bool z_impl_log_process(bool bypass)
 	if (!backend_attached && !bypass) {
 		return false;
 	}
-	unsigned int key = irq_lock();
 
-	msg = log_list_head_get(&list);
-	irq_unlock(key);
+	msg = msg_dequeue();
 
 	if (msg != NULL) {
 		atomic_dec(&buffered_cnt);
@@ -670,7 +708,7 @@ bool z_impl_log_process(bool bypass)
 		dropped_notify();
 	}
 
-	return (log_list_head_peek(&list) != NULL);
+	return msg_pending();
 }
 
 #ifdef CONFIG_USERSPACE
@@ -0,0 +1,235 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <sys/__assert.h>
+#include <sys/util.h>
+#include "log_mpsc.h"
+
+/* Descriptor of a record: state, lap of the ring in which it was allocated
+ * and number of chunks. Descriptors of free space and of chunks inside
+ * records are empty. The lap tells a record from one which used the same
+ * position before, when read with an index that is no longer current.
+ */
+#define DESC_EMPTY	0
+#define DESC_BUSY	1 /* Allocated, filled by the producer. */
+#define DESC_COMMITTED	2 /* Waiting for the consumer. */
+#define DESC_DONE	3 /* Released or padding, space can be reclaimed. */
+
+#define DESC_LEN_BITS	16
+#define DESC_LAP_BITS	14
+#define DESC_STATE_POS	(DESC_LEN_BITS + DESC_LAP_BITS)
+
+#define DESC(state, lap, len) \
+	(((u32_t)(state) << DESC_STATE_POS) | ((lap) << DESC_LEN_BITS) | (len))
+#define DESC_STATE(desc) ((u32_t)(desc) >> DESC_STATE_POS)
+#define DESC_LAP(desc) \
+	(((u32_t)(desc) >> DESC_LEN_BITS) & BIT_MASK(DESC_LAP_BITS))
+#define DESC_LEN(desc)	((u32_t)(desc) & BIT_MASK(DESC_LEN_BITS))
+
+/* Indexes wrap after the number of laps a descriptor can tell apart. */
+static inline u32_t idx_wrap(struct log_mpsc_t *buf)
+{
+	return buf->size << DESC_LAP_BITS;
+}
+
+static inline u32_t idx_add(struct log_mpsc_t *buf, u32_t idx, u32_t n)
+{
+	idx += n;
+
+	return (idx >= idx_wrap(buf)) ? idx - idx_wrap(buf) : idx;
+}
+
+static inline u32_t idx_pos(struct log_mpsc_t *buf, u32_t idx)
+{
+	return idx % buf->size;
+}
+
+static inline u32_t idx_lap(struct log_mpsc_t *buf, u32_t idx)
+{
+	return idx / buf->size;
+}
+
+static inline u32_t idx_dist(struct log_mpsc_t *buf, u32_t from, u32_t to)
+{
+	return (to >= from) ? to - from : to + idx_wrap(buf) - from;
+}
+
+/* Get descriptor of the record at given index, empty if the index is not
+ * current anymore.
+ */
+static atomic_val_t desc_get(struct log_mpsc_t *buf, u32_t idx)
+{
+	atomic_val_t desc = atomic_get(&buf->desc[idx_pos(buf, idx)]);
+
+	return (DESC_LAP(desc) == idx_lap(buf, idx)) ? desc : DESC_EMPTY;
+}
+
+/* Reclaim released records at the tail of the ring. A released record
+ * which was never claimed is skipped for the consumer on the way.
+ */
+static void tail_advance(struct log_mpsc_t *buf)
+{
+	atomic_val_t desc;
+	u32_t tail, next;
+
+	for (;;) {
+		tail = atomic_get(&buf->tail_idx);
+		desc = desc_get(buf, tail);
+
+		if (DESC_STATE(desc) != DESC_DONE) {
+			return;
+		}
+
+		next = idx_add(buf, tail, DESC_LEN(desc));
+		(void)atomic_cas(&buf->rd_idx, tail, next);
+
+		/* Clearing the descriptor makes this context the only one
+		 * moving the tail past the record.
+		 */
+		if (!atomic_cas(&buf->desc[idx_pos(buf, tail)], desc,
+				DESC_EMPTY)) {
+			return;
+		}
+
+		atomic_set(&buf->tail_idx, next);
+	}
+}
+
+void log_mpsc_init(struct log_mpsc_t *buf, union log_msg_chunk *chunks,
+		   atomic_t *desc, u32_t size)
+{
+	__ASSERT_NO_MSG((size > 0) && (size < BIT(DESC_LEN_BITS)));
+
+	buf->chunks = chunks;
+	buf->desc = desc;
+	buf->size = size;
+	atomic_set(&buf->wr_idx, 0);
+	atomic_set(&buf->rd_idx, 0);
+	atomic_set(&buf->tail_idx, 0);
+
+	for (u32_t i = 0; i < size; i++) {
+		atomic_set(&desc[i], DESC_EMPTY);
+	}
+}
+
+union log_msg_chunk *log_mpsc_alloc(struct log_mpsc_t *buf, u32_t length)
+{
+	u32_t wr, used, pos, pad;
+
+	if ((length == 0U) || (length > buf->size)) {
+		return NULL;
+	}
+
+	for (;;) {
+		wr = atomic_get(&buf->wr_idx);
+		used = idx_dist(buf, atomic_get(&buf->tail_idx), wr);
+		pos = idx_pos(buf, wr);
+
+		/* Records are contiguous, pad the end of the ring if the
+		 * record does not fit there.
+		 */
+		pad = (pos + length > buf->size) ? buf->size - pos : 0U;
+
+		if (used + pad + length <= buf->size) {
+			if (atomic_cas(&buf->wr_idx, wr,
+				       idx_add(buf, wr, pad + length))) {
+				break;
+			}
+		} else if (used == 0U) {
+			/* Empty but the record only fits from the start */
+			if (atomic_cas(&buf->wr_idx, wr,
+				       idx_add(buf, wr, pad))) {
+				atomic_set(&buf->desc[pos],
+					   DESC(DESC_DONE, idx_lap(buf, wr),
+						pad));
+				tail_advance(buf);
+			}
+		} else {
+			return NULL;
+		}
+	}
+
+	if (pad) {
+		atomic_set(&buf->desc[pos],
+			   DESC(DESC_DONE, idx_lap(buf, wr), pad));
+		wr = idx_add(buf, wr, pad);
+		pos = 0U;
+	}
+
+	atomic_set(&buf->desc[pos],
+		   DESC(DESC_BUSY, idx_lap(buf, wr), length));
+
+	return &buf->chunks[pos];
+}
+
+void log_mpsc_commit(struct log_mpsc_t *buf, union log_msg_chunk *chunk)
+{
+	u32_t pos = chunk - buf->chunks;
+	atomic_val_t desc = atomic_get(&buf->desc[pos]);
+
+	atomic_set(&buf->desc[pos],
+		   DESC(DESC_COMMITTED, DESC_LAP(desc), DESC_LEN(desc)));
+}
+
+union log_msg_chunk *log_mpsc_claim(struct log_mpsc_t *buf)
+{
+	atomic_val_t desc;
+	u32_t rd;
+
+	for (;;) {
+		rd = atomic_get(&buf->rd_idx);
+		if (rd == atomic_get(&buf->wr_idx)) {
+			return NULL;
+		}
+
+		desc = desc_get(buf, rd);
+
+		if ((DESC_STATE(desc) != DESC_COMMITTED) &&
+		    (DESC_STATE(desc) != DESC_DONE)) {
+			/* Oldest record still being filled */
+			return NULL;
+		}
+
+		if (!atomic_cas(&buf->rd_idx, rd,
+				idx_add(buf, rd, DESC_LEN(desc)))) {
+			continue;
+		}
+
+		if (DESC_STATE(desc) == DESC_COMMITTED) {
+			return &buf->chunks[idx_pos(buf, rd)];
+		}
+
+		tail_advance(buf);
+	}
+}
+
+void log_mpsc_free(struct log_mpsc_t *buf, union log_msg_chunk *chunk)
+{
+	u32_t pos = chunk - buf->chunks;
+	atomic_val_t desc = atomic_get(&buf->desc[pos]);
+
+	atomic_set(&buf->desc[pos],
+		   DESC(DESC_DONE, DESC_LAP(desc), DESC_LEN(desc)));
+	tail_advance(buf);
+}
+
+bool log_mpsc_is_ready(struct log_mpsc_t *buf)
+{
+	u32_t rd = atomic_get(&buf->rd_idx);
+	u32_t state;
+
+	if (rd == atomic_get(&buf->wr_idx)) {
+		return false;
+	}
+
+	state = DESC_STATE(desc_get(buf, rd));
+
+	return (state == DESC_COMMITTED) || (state == DESC_DONE);
+}
+
+u32_t log_mpsc_num_used_get(struct log_mpsc_t *buf)
+{
+	return idx_dist(buf, atomic_get(&buf->tail_idx),
+			atomic_get(&buf->wr_idx));
+}
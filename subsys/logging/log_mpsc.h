@@ -0,0 +1,110 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef LOG_MPSC_H_
+#define LOG_MPSC_H_
+
+#include <logging/log_msg.h>
+#include <sys/atomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Multi producer, single consumer packet buffer instance structure.
+ *
+ * Records of one or more contiguous chunks are allocated from a ring of
+ * chunks by any number of producers and consumed in allocation order. The
+ * state of each record is kept in a descriptor word at the position of its
+ * first chunk, so no lock is needed on either side.
+ *
+ * Indexes count chunks over many laps of the ring, so that an index read
+ * before the ring went around is not taken for the current one.
+ */
+struct log_mpsc_t {
+	union log_msg_chunk *chunks;
+	atomic_t *desc;
+	u32_t size;
+	atomic_t wr_idx;   /*!< End of allocated records. */
+	atomic_t rd_idx;   /*!< End of claimed records. */
+	atomic_t tail_idx; /*!< End of reclaimed space. */
+};
+
+/** @brief Initialize packet buffer instance.
+ *
+ * @param buf    Buffer instance.
+ * @param chunks Memory for the records.
+ * @param desc   Descriptors, one for each chunk.
+ * @param size   Number of chunks.
+ */
+void log_mpsc_init(struct log_mpsc_t *buf, union log_msg_chunk *chunks,
+		   atomic_t *desc, u32_t size);
+
+/** @brief Allocate record of contiguous chunks.
+ *
+ * The record is not seen by the consumer until committed.
+ *
+ * @param buf    Buffer instance.
+ * @param length Number of chunks.
+ *
+ * @return First chunk of the record or NULL if there is no space.
+ */
+union log_msg_chunk *log_mpsc_alloc(struct log_mpsc_t *buf, u32_t length);
+
+/** @brief Make allocated record available to the consumer.
+ *
+ * @param buf   Buffer instance.
+ * @param chunk First chunk of the record.
+ */
+void log_mpsc_commit(struct log_mpsc_t *buf, union log_msg_chunk *chunk);
+
+/** @brief Claim the oldest record.
+ *
+ * Records are claimed in allocation order, the oldest one blocks the next
+ * ones until it is committed.
+ *
+ * @param buf Buffer instance.
+ *
+ * @return First chunk of the record or NULL if none is committed.
+ */
+union log_msg_chunk *log_mpsc_claim(struct log_mpsc_t *buf);
+
+/** @brief Release record.
+ *
+ * Records can be released in any order, committed or not. Space is
+ * reclaimed up to the oldest record still in use.
+ *
+ * @param buf   Buffer instance.
+ * @param chunk First chunk of the record.
+ */
+void log_mpsc_free(struct log_mpsc_t *buf, union log_msg_chunk *chunk);
+
+/** @brief Check if the oldest record can be claimed.
+ *
+ * @param buf Buffer instance.
+ *
+ * @return True if a committed record is pending.
+ */
+bool log_mpsc_is_ready(struct log_mpsc_t *buf);
+
+/** @brief Get number of chunks in use.
+ *
+ * Counts the chunks of the records not reclaimed yet, including the padding
+ * left at the end of the ring by a record which did not fit there.
+ *
+ * @param buf Buffer instance.
+ *
+ * @return Number of chunks in use.
+ */
+u32_t log_mpsc_num_used_get(struct log_mpsc_t *buf);
+
+#if defined(CONFIG_LOG_MPSC_BUFFER)
+/** @brief Buffer of the log messages. */
+extern struct log_mpsc_t log_msg_mpsc;
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOG_MPSC_H_ */
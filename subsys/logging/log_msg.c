@@ -10,6 +10,7 @@
 #include <logging/log_core.h>
 #include <string.h>
 #include <assert.h>
+#include "log_mpsc.h"
 
 BUILD_ASSERT_MSG((sizeof(struct log_msg_ids) == sizeof(u16_t)),
 		  "Structure must fit in 2 bytes");
@@ -38,6 +39,21 @@ BUILD_ASSERT_MSG((sizeof(union log_msg_head_data) ==
 #endif
 
 #define MSG_SIZE sizeof(union log_msg_chunk)
+
+#if defined(CONFIG_LOG_MPSC_BUFFER)
+/* Record descriptors are taken from the buffer size as well. */
+#define NUM_OF_MSGS (CONFIG_LOG_BUFFER_SIZE / (MSG_SIZE + sizeof(atomic_t)))
+
+struct log_mpsc_t log_msg_mpsc;
+static atomic_t log_msg_mpsc_desc[NUM_OF_MSGS];
+static union log_msg_chunk __noinit log_msg_pool_buf[NUM_OF_MSGS];
+
+void log_msg_pool_init(void)
+{
+	log_mpsc_init(&log_msg_mpsc, log_msg_pool_buf, log_msg_mpsc_desc,
+		      NUM_OF_MSGS);
+}
+#else
 #define NUM_OF_MSGS (CONFIG_LOG_BUFFER_SIZE / MSG_SIZE)
 
 struct k_mem_slab log_msg_pool;
@@ -48,7 +64,75 @@ void log_msg_pool_init(void)
 {
 	k_mem_slab_init(&log_msg_pool, log_msg_pool_buf, MSG_SIZE, NUM_OF_MSGS);
 }
+#endif
+
+/* Number of chunks following the head of a standard message. */
+#define STD_CONT_CHUNKS(nargs) \
+	(((nargs) > LOG_MSG_NARGS_SINGLE_CHUNK) ? \
+	 ceiling_fraction((nargs) - LOG_MSG_NARGS_HEAD_CHUNK, ARGS_CONT_MSG) : 0)
+
+/* Number of chunks following the head of a hexdump message. */
+#define HEXDUMP_CONT_CHUNKS(length) \
+	(((length) > LOG_MSG_HEXDUMP_BYTES_SINGLE_CHUNK) ? \
+	 ceiling_fraction((length) - LOG_MSG_HEXDUMP_BYTES_HEAD_CHUNK, \
+			  HEXDUMP_BYTES_CONT_MSG) : 0)
+
+/* Allocate chunks without waiting. Messages in the packet buffer are
+ * allocated in one piece, the slab only provides single chunks.
+ */
+static union log_msg_chunk *pool_alloc(u32_t chunks)
+{
+	union log_msg_chunk *chunk = NULL;
+
+#if defined(CONFIG_LOG_MPSC_BUFFER)
+	chunk = log_mpsc_alloc(&log_msg_mpsc, chunks);
+#else
+	__ASSERT_NO_MSG(chunks == 1U);
+
+	if (k_mem_slab_alloc(&log_msg_pool, (void **)&chunk, K_NO_WAIT) != 0) {
+		chunk = NULL;
+	}
+#endif
+
+	return chunk;
+}
+
+static union log_msg_chunk *no_space_handle(u32_t chunks)
+{
+	union log_msg_chunk *msg = NULL;
+	bool more;
+
+	if (IS_ENABLED(CONFIG_LOG_MODE_OVERFLOW) && (chunks <= NUM_OF_MSGS)) {
+		do {
+			more = log_process(true);
+			log_dropped();
+			msg = pool_alloc(chunks);
+		} while ((msg == NULL) && more);
+	} else {
+		log_dropped();
+	}
+
+	return msg;
+}
+
+#if defined(CONFIG_LOG_MPSC_BUFFER)
+/* Allocate head of a message with the chunks following it. */
+static union log_msg_chunk *msg_chunks_alloc(u32_t cont_chunks)
+{
+	union log_msg_chunk *msg = pool_alloc(1 + cont_chunks);
+
+	if (msg == NULL) {
+		msg = no_space_handle(1 + cont_chunks);
+	}
+
+	return msg;
+}
 
+union log_msg_chunk *log_msg_chunk_alloc(void)
+{
+	return msg_chunks_alloc(0);
+}
+#else
 /* Return true if interrupts were unlocked in the context of this call. */
 static bool is_irq_unlocked(void)
 {
@@ -84,12 +168,14 @@ union log_msg_chunk *log_msg_chunk_alloc(void)
 
 	return msg;
 }
+#endif
 
 void log_msg_get(struct log_msg *msg)
 {
 	atomic_inc(&msg->hdr.ref_cnt);
 }
 
+#if !defined(CONFIG_LOG_MPSC_BUFFER)
 static void cont_free(struct log_msg_cont *cont)
 {
 	struct log_msg_cont *next;
@@ -100,6 +186,7 @@ static void cont_free(struct log_msg_cont *cont)
 		cont = next;
 	}
 }
+#endif
 
 static void msg_free(struct log_msg *msg)
 {
@@ -150,33 +237,23 @@ static void msg_free(struct log_msg *msg)
 		}
 	}
 
+#if defined(CONFIG_LOG_MPSC_BUFFER)
+	/* Continuation chunks are part of the same record */
+	log_mpsc_free(&log_msg_mpsc, (union log_msg_chunk *)msg);
+#else
 	if (msg->hdr.params.generic.ext == 1) {
 		cont_free(msg->payload.ext.next);
 	}
 
 	k_mem_slab_free(&log_msg_pool, (void **)&msg);
+#endif
 }
 
 union log_msg_chunk *log_msg_no_space_handle(void)
 {
-	union log_msg_chunk *msg = NULL;
-	bool more;
-	int err;
-
-	if (IS_ENABLED(CONFIG_LOG_MODE_OVERFLOW)) {
-		do {
-			more = log_process(true);
-			log_dropped();
-			err = k_mem_slab_alloc(&log_msg_pool,
-					       (void **)&msg,
-					       K_NO_WAIT);
-		} while ((err != 0) && more);
-	} else {
-		log_dropped();
-	}
-	return msg;
-
+	return no_space_handle(1);
 }
+
 void log_msg_put(struct log_msg *msg)
 {
 	atomic_dec(&msg->hdr.ref_cnt);
@@ -234,6 +311,18 @@ const char *log_msg_str_get(struct log_msg *msg)
 	return msg->str;
 }
 
+/* Allocate chunk following the previous one of a message. In the packet
+ * buffer it was allocated with the head, as the next chunk of the record.
+ */
+static struct log_msg_cont *cont_alloc(void *prev)
+{
+#if defined(CONFIG_LOG_MPSC_BUFFER)
+	return &((union log_msg_chunk *)prev + 1)->cont;
+#else
+	return (struct log_msg_cont *)log_msg_chunk_alloc();
+#endif
+}
+
 /** @brief Allocate chunk for extended standard log message.
  *
  *  @details Extended standard log message is used when number of arguments
@@ -248,9 +337,22 @@ static struct log_msg *msg_alloc(u32_t nargs)
 {
 	struct log_msg_cont *cont;
 	struct log_msg_cont **next;
-	struct  log_msg *msg = z_log_msg_std_alloc();
+	struct  log_msg *msg;
+	void *prev;
 	int n = (int)nargs;
 
+#if defined(CONFIG_LOG_MPSC_BUFFER)
+	msg = (struct log_msg *)msg_chunks_alloc(STD_CONT_CHUNKS(nargs));
+	if (msg != NULL) {
+		/* all fields reset to 0, reference counter to 1 */
+		msg->hdr.ref_cnt = 1;
+		msg->hdr.params.raw = 0U;
+		msg->hdr.params.std.type = LOG_MSG_TYPE_STD;
+	}
+#else
+	msg = z_log_msg_std_alloc();
+#endif
+
 	if ((msg == NULL) || nargs <= LOG_MSG_NARGS_SINGLE_CHUNK) {
 		return msg;
 	}
@@ -260,9 +362,10 @@ static struct log_msg *msg_alloc(u32_t nargs)
 	n -= LOG_MSG_NARGS_HEAD_CHUNK;
 	next = &msg->payload.ext.next;
 	*next = NULL;
+	prev = msg;
 
 	while (n > 0) {
-		cont = (struct log_msg_cont *)log_msg_chunk_alloc();
+		cont = cont_alloc(prev);
 
 		if (cont == NULL) {
 			msg_free(msg);
@@ -272,6 +375,7 @@ static struct log_msg *msg_alloc(u32_t nargs)
 		*next = cont;
 		cont->next = NULL;
 		next = &cont->next;
+		prev = cont;
 		n -= ARGS_CONT_MSG;
 	}
 
@@ -329,12 +433,17 @@ struct log_msg *log_msg_hexdump_create(const char *str,
 	struct log_msg_cont *cont;
 	struct log_msg *msg;
 	u32_t chunk_length;
+	void *prev;
 
 	/* Saturate length. */
 	length = (length > LOG_MSG_HEXDUMP_MAX_LENGTH) ?
 		 LOG_MSG_HEXDUMP_MAX_LENGTH : length;
 
+#if defined(CONFIG_LOG_MPSC_BUFFER)
+	msg = (struct log_msg *)msg_chunks_alloc(HEXDUMP_CONT_CHUNKS(length));
+#else
 	msg = (struct log_msg *)log_msg_chunk_alloc();
+#endif
 	if (msg == NULL) {
 		return NULL;
 	}
@@ -362,9 +471,10 @@ struct log_msg *log_msg_hexdump_create(const char *str,
 	}
 
 	prev_cont = &msg->payload.ext.next;
+	prev = msg;
 
 	while (length > 0) {
-		cont = (struct log_msg_cont *)log_msg_chunk_alloc();
+		cont = cont_alloc(prev);
 		if (cont == NULL) {
 			msg_free(msg);
 			return NULL;
@@ -373,6 +483,7 @@ struct log_msg *log_msg_hexdump_create(const char *str,
 		*prev_cont = cont;
 		cont->next = NULL;
 		prev_cont = &cont->next;
+		prev = cont;
 
 		chunk_length = (length > HEXDUMP_BYTES_CONT_MSG) ?
 			       HEXDUMP_BYTES_CONT_MSG : length;
@@ -57,6 +57,8 @@ extern void log_output_string_syst_process(const struct log_output *log_output,
 extern void log_output_hexdump_syst_process(const struct log_output *log_output,
 				struct log_msg_ids src_level,
 				const u8_t *data, u32_t length, u32_t flag);
+extern void log_output_msg_dict_process(const struct log_output *log_output,
+				struct log_msg *msg, u32_t flag);
 
 /* The RFC 5424 allows very flexible mapping and suggest the value 0 being the
  * highest severity and 7 to be the lowest (debugging level) severity.
@@ -536,6 +538,12 @@ void log_output_msg_process(const struct log_output *log_output,
 		return;
 	}
 
+	if (IS_ENABLED(CONFIG_LOG_DICTIONARY) &&
+	    flags & LOG_OUTPUT_FLAG_FORMAT_DICT) {
+		log_output_msg_dict_process(log_output, msg, flags);
+		return;
+	}
+
 	prefix_offset = raw_string ?
 			0 : prefix_print(log_output, flags, std_msg, timestamp,
 					 level, domain_id, source_id);
@@ -0,0 +1,181 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Dictionary format output. Messages are not formatted on target, each one
+ * is sent as a binary record which scripts/logging/log_dict_parser.py
+ * decodes using the ELF file of the application. All fields are in target
+ * byte order, pointers and arguments are native words.
+ *
+ * Every record starts with its type:
+ *	u8	LOG_DICT_TYPE_STD, LOG_DICT_TYPE_HEXDUMP or LOG_DICT_TYPE_DROPPED
+ *
+ * Standard and hexdump records continue with:
+ *	u8	level (bits 0-2) and domain ID (bits 3-5)
+ *	u16	source ID
+ *	u32	timestamp
+ *
+ * Standard record:
+ *	ptr	address of the format string
+ *	u8	number of arguments
+ *	u16	mask of the arguments sent as strings
+ *	arg	arguments
+ *	for each bit set in the mask, lowest first:
+ *	u8	string length
+ *	char	string, not terminated
+ *
+ * Hexdump record:
+ *	ptr	address of the metadata string
+ *	u16	data length
+ *	u8	data
+ *
+ * Dropped record:
+ *	u32	number of dropped messages
+ */
+
+#include <string.h>
+#include <logging/log.h>
+#include <logging/log_ctrl.h>
+#include <logging/log_output.h>
+
+#define LOG_DICT_TYPE_STD	0xD1
+#define LOG_DICT_TYPE_HEXDUMP	0xD2
+#define LOG_DICT_TYPE_DROPPED	0xD3
+
+#define LOG_DICT_STRING_MAX_LEN	255
+
+#define HEXDUMP_CHUNK_LEN	32
+
+struct log_dict_hdr {
+	u8_t type;
+	u8_t level_domain;
+	u16_t source_id;
+	u32_t timestamp;
+} __packed;
+
+static void dict_write(const struct log_output *log_output,
+		       const void *data, size_t len)
+{
+	struct log_output_control_block *cb = log_output->control_block;
+	const u8_t *bytes = data;
+	size_t offset, part;
+
+	while (len) {
+		offset = atomic_get(&cb->offset);
+		if (offset == log_output->size) {
+			log_output_flush(log_output);
+			continue;
+		}
+
+		part = MIN(len, log_output->size - offset);
+		memcpy(&log_output->buf[offset], bytes, part);
+		atomic_add(&cb->offset, part);
+
+		bytes += part;
+		len -= part;
+	}
+}
+
+static void hdr_write(const struct log_output *log_output, u8_t type,
+		      struct log_msg *msg)
+{
+	struct log_dict_hdr hdr = {
+		.type = type,
+		.level_domain = log_msg_level_get(msg) |
+				(log_msg_domain_id_get(msg) << 3),
+		.source_id = log_msg_source_id_get(msg),
+		.timestamp = log_msg_timestamp_get(msg),
+	};
+
+	dict_write(log_output, &hdr, sizeof(hdr));
+}
+
+static void std_write(const struct log_output *log_output,
+		      struct log_msg *msg)
+{
+	const char *str = log_msg_str_get(msg);
+	u8_t nargs = log_msg_nargs_get(msg);
+	u16_t str_mask = 0U;
+	log_arg_t arg;
+	u8_t len;
+	int i;
+
+	/* Strings duplicated by log_strdup() are not in the ELF file */
+	for (i = 0; i < nargs; i++) {
+		if (log_is_strdup((void *)log_msg_arg_get(msg, i))) {
+			str_mask |= BIT(i);
+		}
+	}
+
+	hdr_write(log_output, LOG_DICT_TYPE_STD, msg);
+	dict_write(log_output, &str, sizeof(str));
+	dict_write(log_output, &nargs, sizeof(nargs));
+	dict_write(log_output, &str_mask, sizeof(str_mask));
+
+	for (i = 0; i < nargs; i++) {
+		arg = log_msg_arg_get(msg, i);
+		dict_write(log_output, &arg, sizeof(arg));
+	}
+
+	for (i = 0; i < nargs; i++) {
+		if (!(str_mask & BIT(i))) {
+			continue;
+		}
+
+		str = (const char *)log_msg_arg_get(msg, i);
+		len = strnlen(str, LOG_DICT_STRING_MAX_LEN);
+
+		dict_write(log_output, &len, sizeof(len));
+		dict_write(log_output, str, len);
+	}
+}
+
+static void hexdump_write(const struct log_output *log_output,
+			  struct log_msg *msg)
+{
+	const char *str = log_msg_str_get(msg);
+	u16_t length = msg->hdr.params.hexdump.length;
+	u8_t data[HEXDUMP_CHUNK_LEN];
+	size_t offset = 0;
+	size_t len;
+
+	hdr_write(log_output, LOG_DICT_TYPE_HEXDUMP, msg);
+	dict_write(log_output, &str, sizeof(str));
+	dict_write(log_output, &length, sizeof(length));
+
+	while (offset < length) {
+		len = sizeof(data);
+		log_msg_hexdump_data_get(msg, data, &len, offset);
+		if (!len) {
+			/* Keep the record length the host expects */
+			len = MIN(sizeof(data), length - offset);
+			(void)memset(data, 0, len);
+		}
+
+		dict_write(log_output, data, len);
+		offset += len;
+	}
+}
+
+void log_output_msg_dict_process(const struct log_output *log_output,
+				 struct log_msg *msg, u32_t flag)
+{
+	if (log_msg_is_std(msg)) {
+		std_write(log_output, msg);
+	} else {
+		hexdump_write(log_output, msg);
+	}
+
+	log_output_flush(log_output);
+}
+
+void log_output_dict_dropped_process(const struct log_output *log_output,
+				     u32_t cnt)
+{
+	u8_t type = LOG_DICT_TYPE_DROPPED;
+
+	dict_write(log_output, &type, sizeof(type));
+	dict_write(log_output, &cnt, sizeof(cnt));
+
+	log_output_flush(log_output);
+}
@@ -158,6 +158,83 @@ const struct net_buf_data_cb net_buf_fixed_cb = {
 	.unref = fixed_data_unref,
 };
 
+static u8_t *class_data_alloc(struct net_buf *buf, size_t *size,
+			      s32_t timeout)
+{
+	struct net_buf_pool *pool = net_buf_pool_get(buf->pool_id);
+	const struct net_buf_pool_class *pc = pool->alloc->alloc_data;
+	struct net_buf_data_class *data_class;
+	u8_t *block;
+	int best, i;
+
+	/* Smallest class the data fits in */
+	for (best = 0; best < pc->count; best++) {
+		if (pc->classes[best]->size >= *size) {
+			break;
+		}
+	}
+
+	if (best == pc->count) {
+		return NULL;
+	}
+
+	for (i = best; i < pc->count; i++) {
+		if (!k_mem_slab_alloc(pc->classes[i]->slab, (void **)&block,
+				      K_NO_WAIT)) {
+			break;
+		}
+	}
+
+	if (i == pc->count) {
+		i = best;
+
+		if (timeout == K_NO_WAIT ||
+		    k_mem_slab_alloc(pc->classes[i]->slab, (void **)&block,
+				     timeout)) {
+			atomic_inc(&pc->classes[i]->failures);
+			return NULL;
+		}
+	}
+
+	data_class = pc->classes[i];
+
+	atomic_inc(&data_class->allocs);
+	atomic_add(&data_class->requested, *size);
+
+	if (i != best) {
+		atomic_inc(&data_class->fallbacks);
+	}
+
+	/* The reference count is right before the data, as for the other
+	 * reference counted allocators.
+	 */
+	block[NET_BUF_DATA_CLASS_HDR_SIZE - 2] = i;
+	block[NET_BUF_DATA_CLASS_HDR_SIZE - 1] = 1U;
+
+	return block + NET_BUF_DATA_CLASS_HDR_SIZE;
+}
+
+static void class_data_unref(struct net_buf *buf, u8_t *data)
+{
+	struct net_buf_pool *pool = net_buf_pool_get(buf->pool_id);
+	const struct net_buf_pool_class *pc = pool->alloc->alloc_data;
+	u8_t *block = data - NET_BUF_DATA_CLASS_HDR_SIZE;
+	u8_t *ref_count = data - 1;
+	u8_t idx = *(data - 2);
+
+	if (--(*ref_count)) {
+		return;
+	}
+
+	k_mem_slab_free(pc->classes[idx]->slab, (void **)&block);
+}
+
+const struct net_buf_data_cb net_buf_class_cb = {
+	.alloc = class_data_alloc,
+	.ref   = generic_data_ref,
+	.unref = class_data_unref,
+};
+
 #if (CONFIG_HEAP_MEM_POOL_SIZE > 0)
 
 static u8_t *heap_data_alloc(struct net_buf *buf, size_t *size, s32_t timeout)
@@ -346,22 +423,31 @@ success:
 	return buf;
 }
 
+/* Pools with data classes give the smallest class as fixed size buffer */
+static size_t fixed_data_size(struct net_buf_pool *pool)
+{
+	const struct net_buf_pool_class *pc = net_buf_pool_classes(pool);
+	const struct net_buf_pool_fixed *fixed = pool->alloc->alloc_data;
+
+	if (pc) {
+		return pc->classes[0]->size;
+	}
+
+	return fixed->data_size;
+}
+
 #if defined(CONFIG_NET_BUF_LOG)
 struct net_buf *net_buf_alloc_fixed_debug(struct net_buf_pool *pool,
 					  s32_t timeout, const char *func,
 					  int line)
 {
-	const struct net_buf_pool_fixed *fixed = pool->alloc->alloc_data;
-
-	return net_buf_alloc_len_debug(pool, fixed->data_size, timeout, func,
-				       line);
+	return net_buf_alloc_len_debug(pool, fixed_data_size(pool), timeout,
+				       func, line);
 }
 #else
 struct net_buf *net_buf_alloc_fixed(struct net_buf_pool *pool, s32_t timeout)
 {
-	const struct net_buf_pool_fixed *fixed = pool->alloc->alloc_data;
-
-	return net_buf_alloc_len(pool, fixed->data_size, timeout);
+	return net_buf_alloc_len(pool, fixed_data_size(pool), timeout);
 }
 #endif
 
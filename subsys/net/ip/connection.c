@@ -59,6 +59,30 @@ static struct net_conn conns[CONFIG_NET_MAX_CONN];
 static sys_slist_t conn_unused;
 static sys_slist_t conn_used;
 
+/* For input demultiplexing, connections are also hashed on the ports
+ * they specify: those with a local and a remote port on both of them,
+ * those with only a local port on that one, and the rest are kept on a
+ * wildcard list.  A packet can only match connections in its two
+ * buckets and on the wildcard list.  These are all kept newest first,
+ * and merged in that order, so net_conn_input() sees the candidates in
+ * the same order as in conn_used, and its best-match rules give the
+ * same result as a full scan.
+ */
+#define CONN_HASH_MASK (CONFIG_NET_CONN_HASH_BUCKETS - 1)
+
+BUILD_ASSERT_MSG((CONFIG_NET_CONN_HASH_BUCKETS & CONN_HASH_MASK) == 0,
+		 "CONFIG_NET_CONN_HASH_BUCKETS must be a power of two");
+
+static sys_slist_t conn_hash_full[CONFIG_NET_CONN_HASH_BUCKETS];
+static sys_slist_t conn_hash_local[CONFIG_NET_CONN_HASH_BUCKETS];
+static sys_slist_t conn_wildcard;
+static u32_t conn_seq;
+
+/* Iterator over the connections a packet may match */
+struct conn_iter {
+	sys_snode_t *next[3];
+};
+
 #if (CONFIG_NET_CONN_LOG_LEVEL >= LOG_LEVEL_DBG)
 static inline
 void conn_register_debug(struct net_conn *conn,
@@ -113,6 +137,74 @@ void conn_register_debug(struct net_conn *conn,
 #define conn_register_debug(...)
 #endif /* (CONFIG_NET_CONN_LOG_LEVEL >= LOG_LEVEL_DBG) */
 
+/* Ports are in network byte order */
+static inline u32_t conn_hash(u16_t proto, u16_t local_port,
+			      u16_t remote_port)
+{
+	u32_t hash = ((u32_t)proto << 16) ^ local_port ^
+		     ((u32_t)remote_port * 31U);
+
+	hash ^= hash >> 16;
+	hash ^= hash >> 8;
+
+	return hash & CONN_HASH_MASK;
+}
+
+static sys_slist_t *conn_bucket(struct net_conn *conn)
+{
+	u16_t local_port = net_sin(&conn->local_addr)->sin_port;
+	u16_t remote_port = net_sin(&conn->remote_addr)->sin_port;
+
+	if (!(conn->flags & NET_CONN_LOCAL_PORT_SPEC)) {
+		return &conn_wildcard;
+	}
+
+	if (!(conn->flags & NET_CONN_REMOTE_PORT_SPEC)) {
+		return &conn_hash_local[conn_hash(conn->proto, local_port, 0)];
+	}
+
+	return &conn_hash_full[conn_hash(conn->proto, local_port,
+					 remote_port)];
+}
+
+static void conn_iter_init(struct conn_iter *iter, u16_t proto,
+			   u16_t src_port, u16_t dst_port)
+{
+	iter->next[0] = sys_slist_peek_head(
+		&conn_hash_full[conn_hash(proto, dst_port, src_port)]);
+	iter->next[1] = sys_slist_peek_head(
+		&conn_hash_local[conn_hash(proto, dst_port, 0)]);
+	iter->next[2] = sys_slist_peek_head(&conn_wildcard);
+}
+
+/* Return the newest connection not yet returned */
+static struct net_conn *conn_iter_next(struct conn_iter *iter)
+{
+	struct net_conn *newest = NULL;
+	int from = 0;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(iter->next); i++) {
+		struct net_conn *conn;
+
+		if (!iter->next[i]) {
+			continue;
+		}
+
+		conn = CONTAINER_OF(iter->next[i], struct net_conn, hash_node);
+		if (!newest || (s32_t)(conn->seq - newest->seq) > 0) {
+			newest = conn;
+			from = i;
+		}
+	}
+
+	if (newest) {
+		iter->next[from] = sys_slist_peek_next(iter->next[from]);
+	}
+
+	return newest;
+}
+
 static struct net_conn *conn_get_unused(void)
 {
 	sys_snode_t *node;
@@ -130,8 +222,10 @@ static struct net_conn *conn_get_unused(void)
 static void conn_set_used(struct net_conn *conn)
 {
 	conn->flags |= NET_CONN_IN_USE;
+	conn->seq = conn_seq++;
 
 	sys_slist_prepend(&conn_used, &conn->node);
+	sys_slist_prepend(conn_bucket(conn), &conn->hash_node);
 }
 
 static void conn_set_unused(struct net_conn *conn)
@@ -373,6 +467,7 @@ int net_conn_unregister(struct net_conn_handle *handle)
 	NET_DBG("Connection handler %p removed", conn);
 
 	sys_slist_find_and_remove(&conn_used, &conn->node);
+	sys_slist_find_and_remove(conn_bucket(conn), &conn->hash_node);
 
 	conn_set_unused(conn);
 
@@ -509,6 +604,7 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 	struct net_conn *best_match = NULL;
 	bool is_mcast_pkt = false, mcast_pkt_delivered = false;
 	s16_t best_rank = -1;
+	struct conn_iter iter;
 	struct net_conn *conn;
 	u16_t src_port;
 	u16_t dst_port;
@@ -564,7 +660,9 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 		}
 	}
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&conn_used, conn, node) {
+	conn_iter_init(&iter, proto, src_port, dst_port);
+
+	while ((conn = conn_iter_next(&iter)) != NULL) {
 		if (conn->proto != proto) {
 			continue;
 		}
@@ -728,6 +826,12 @@ void net_conn_init(void)
 
 	sys_slist_init(&conn_unused);
 	sys_slist_init(&conn_used);
+	sys_slist_init(&conn_wildcard);
+
+	for (i = 0; i < CONFIG_NET_CONN_HASH_BUCKETS; i++) {
+		sys_slist_init(&conn_hash_full[i]);
+		sys_slist_init(&conn_hash_local[i]);
+	}
 
 	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
 		sys_slist_prepend(&conn_unused, &conns[i].node);
@@ -50,6 +50,12 @@ struct net_conn {
 	/** Internal slist node */
 	sys_snode_t node;
 
+	/** Node in the demultiplexing hash bucket */
+	sys_snode_t hash_node;
+
+	/** Registration order, newer connections are matched first */
+	u32_t seq;
+
 	/** Remote IP address */
 	struct sockaddr remote_addr;
 
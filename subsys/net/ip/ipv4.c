@@ -293,6 +293,20 @@ enum net_verdict net_ipv4_input(struct net_pkt *pkt)
 		goto drop;
 	}
 
+	if (sys_get_be16(hdr->offset) &
+	    (NET_IPV4_MF | NET_IPV4_FRAGH_OFFSET_MASK)) {
+#if defined(CONFIG_NET_IPV4_FRAGMENT)
+		verdict = net_ipv4_handle_fragment_hdr(pkt, hdr);
+		if (verdict != NET_DROP) {
+			return verdict;
+		}
+#else
+		NET_DBG("DROP: fragmented packet");
+#endif
+		net_stats_update_ip_errors_fragerr(net_pkt_iface(pkt));
+		goto drop;
+	}
+
 	net_pkt_acknowledge_data(pkt, &ipv4_access);
 
 	if (opts_len) {
@@ -132,4 +132,93 @@ static inline int net_ipv4_parse_hdr_options(struct net_pkt *pkt,
 }
 #endif
 
+#define NET_IPV4_MF BIT(13)  /* More fragments */
+#define NET_IPV4_DF BIT(14)  /* Do not fragment */
+#define NET_IPV4_FRAGH_OFFSET_MASK 0x1fff
+
+#if defined(CONFIG_NET_IPV4_FRAGMENT)
+/** Store pending IPv4 fragment information that is needed for reassembly. */
+struct net_ipv4_reassembly {
+	/** IPv4 source address of the fragment */
+	struct in_addr src;
+
+	/** IPv4 destination address of the fragment */
+	struct in_addr dst;
+
+	/**
+	 * Timeout for cancelling the reassembly. The timer is used
+	 * also to detect if this reassembly slot is used or not.
+	 */
+	struct k_delayed_work timer;
+
+	/** Pending fragments, sorted by offset */
+	struct net_pkt *pkt[CONFIG_NET_IPV4_FRAGMENT_MAX_PKT];
+
+	/** Payload offset of each pending fragment */
+	u16_t offset[CONFIG_NET_IPV4_FRAGMENT_MAX_PKT];
+
+	/** Payload length, known once the last fragment has arrived */
+	u16_t len;
+
+	/** IPv4 fragment identification */
+	u16_t id;
+
+	/** Upper layer protocol */
+	u8_t proto;
+
+	/** Datagrams reassembled in this slot */
+	u32_t reassembled;
+
+	/** Datagrams whose fragments did not all arrive in time */
+	u32_t timeouts;
+
+	/** Datagrams dropped because of invalid or too many fragments */
+	u32_t dropped;
+};
+
+/**
+ * @typedef net_ipv4_frag_cb_t
+ * @brief Callback used while iterating over IPv4 reassembly slots.
+ *
+ * @param reass IPv4 fragment reassembly struct
+ * @param user_data A valid pointer on some user data or NULL
+ */
+typedef void (*net_ipv4_frag_cb_t)(struct net_ipv4_reassembly *reass,
+				   void *user_data);
+
+/**
+ * @brief Go through all the IPv4 reassembly slots, pending or not.
+ *
+ * @param cb Callback to call for each slot.
+ * @param user_data User specified data or NULL.
+ */
+void net_ipv4_frag_foreach(net_ipv4_frag_cb_t cb, void *user_data);
+
+/**
+ * @brief Handle a received IPv4 fragment.
+ *
+ * @param pkt Network packet, with the cursor at the IPv4 header
+ * @param hdr IPv4 header of the fragment
+ *
+ * @return NET_OK if the fragment was taken, NET_DROP otherwise.
+ */
+enum net_verdict net_ipv4_handle_fragment_hdr(struct net_pkt *pkt,
+					      struct net_ipv4_hdr *hdr);
+
+/**
+ * @brief Fragment an IPv4 packet larger than the MTU if needed.
+ *
+ * @param pkt Network packet to send
+ *
+ * @return NET_OK if the packet can be sent as it is, NET_CONTINUE if
+ * it was sent as fragments, NET_DROP if it cannot be sent.
+ */
+enum net_verdict net_ipv4_prepare_for_send(struct net_pkt *pkt);
+#else
+static inline enum net_verdict net_ipv4_prepare_for_send(struct net_pkt *pkt)
+{
+	return NET_OK;
+}
+#endif /* CONFIG_NET_IPV4_FRAGMENT */
+
 #endif /* __IPV4_H */
@@ -0,0 +1,598 @@
+/** @file
+ * @brief IPv4 Fragment related functions
+ */
+
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(net_ipv4, CONFIG_NET_IPV4_LOG_LEVEL);
+
+#include <errno.h>
+#include <random/rand32.h>
+#include <net/net_core.h>
+#include <net/net_pkt.h>
+#include <net/net_context.h>
+#include "net_private.h"
+#include "ipv4.h"
+
+#define IPV4_REASSEMBLY_TIMEOUT K_SECONDS(CONFIG_NET_IPV4_FRAGMENT_TIMEOUT)
+
+#define BUF_ALLOC_TIMEOUT K_MSEC(100)
+
+#define FRAGMENTS_MAX_PKT CONFIG_NET_IPV4_FRAGMENT_MAX_PKT
+
+/* Largest IPv4 datagram, header included */
+#define IPV4_MAX_LEN 0xffff
+
+/* Every host must be able to forward a datagram of 68 bytes without
+ * further fragmentation, RFC 791 ch. 3.2
+ */
+#define IPV4_MIN_FRAG_MTU 68
+
+/* Options that must be repeated in every fragment, RFC 791 ch. 3.1 */
+#define NET_IPV4_OPTS_COPIED 0x80
+
+static bool reassembly_init_done;
+
+static struct net_ipv4_reassembly
+reassembly[CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT];
+
+/* A slot is in use as long as it holds at least one fragment */
+static struct net_ipv4_reassembly *reassembly_get(u16_t id, u8_t proto,
+						  struct in_addr *src,
+						  struct in_addr *dst)
+{
+	int i, avail = -1;
+
+	for (i = 0; i < CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT; i++) {
+		if (reassembly[i].pkt[0] &&
+		    reassembly[i].id == id &&
+		    reassembly[i].proto == proto &&
+		    net_ipv4_addr_cmp(src, &reassembly[i].src) &&
+		    net_ipv4_addr_cmp(dst, &reassembly[i].dst)) {
+			return &reassembly[i];
+		}
+
+		if (reassembly[i].pkt[0]) {
+			continue;
+		}
+
+		if (avail < 0) {
+			avail = i;
+		}
+	}
+
+	if (avail < 0) {
+		return NULL;
+	}
+
+	k_delayed_work_submit(&reassembly[avail].timer,
+			      IPV4_REASSEMBLY_TIMEOUT);
+
+	net_ipaddr_copy(&reassembly[avail].src, src);
+	net_ipaddr_copy(&reassembly[avail].dst, dst);
+
+	reassembly[avail].id = id;
+	reassembly[avail].proto = proto;
+	reassembly[avail].len = 0U;
+
+	return &reassembly[avail];
+}
+
+static void reassembly_cancel(struct net_ipv4_reassembly *reass)
+{
+	int i;
+
+	NET_DBG("Cancel 0x%x", reass->id);
+
+	k_delayed_work_cancel(&reass->timer);
+
+	for (i = 0; i < FRAGMENTS_MAX_PKT; i++) {
+		if (!reass->pkt[i]) {
+			continue;
+		}
+
+		NET_DBG("[%d] IPv4 reassembly pkt %p %zd bytes data",
+			i, reass->pkt[i], net_pkt_get_len(reass->pkt[i]));
+
+		net_pkt_unref(reass->pkt[i]);
+		reass->pkt[i] = NULL;
+	}
+}
+
+static void reassembly_info(char *str, struct net_ipv4_reassembly *reass)
+{
+	NET_DBG("%s id 0x%x src %s dst %s remain %d ms", str, reass->id,
+		log_strdup(net_sprint_ipv4_addr(&reass->src)),
+		log_strdup(net_sprint_ipv4_addr(&reass->dst)),
+		k_delayed_work_remaining_get(&reass->timer));
+}
+
+static void reassembly_timeout(struct k_work *work)
+{
+	struct net_ipv4_reassembly *reass =
+		CONTAINER_OF(work, struct net_ipv4_reassembly, timer);
+
+	if (!reass->pkt[0]) {
+		return;
+	}
+
+	reassembly_info("Reassembly cancelled", reass);
+
+	reass->timeouts++;
+	reassembly_cancel(reass);
+}
+
+/* Payload length of a pending fragment. The first fragment still has its
+ * IPv4 header, the other ones had it removed when they arrived.
+ */
+static u16_t fragment_len(struct net_ipv4_reassembly *reass, int i)
+{
+	u16_t len = net_pkt_get_len(reass->pkt[i]);
+
+	if (reass->offset[i] == 0U) {
+		len -= net_pkt_ip_hdr_len(reass->pkt[i]) +
+		       net_pkt_ipv4_opts_len(reass->pkt[i]);
+	}
+
+	return len;
+}
+
+static bool reassembly_complete(struct net_ipv4_reassembly *reass)
+{
+	u16_t expected = 0U;
+	int i;
+
+	if (!reass->len) {
+		return false;
+	}
+
+	for (i = 0; i < FRAGMENTS_MAX_PKT && reass->pkt[i]; i++) {
+		if (reass->offset[i] != expected) {
+			return false;
+		}
+
+		expected += fragment_len(reass, i);
+	}
+
+	return expected == reass->len;
+}
+
+static void reassemble_packet(struct net_ipv4_reassembly *reass)
+{
+	NET_PKT_DATA_ACCESS_CONTIGUOUS_DEFINE(ipv4_access, struct net_ipv4_hdr);
+	struct net_pkt *pkt = reass->pkt[0];
+	struct net_ipv4_hdr *hdr;
+	struct net_buf *last;
+	int i;
+
+	k_delayed_work_cancel(&reass->timer);
+
+	/* The buffers of the fragments are chained as they are */
+	last = net_buf_frag_last(pkt->buffer);
+
+	for (i = 1; i < FRAGMENTS_MAX_PKT && reass->pkt[i]; i++) {
+		last->frags = reass->pkt[i]->buffer;
+		last = net_buf_frag_last(last->frags);
+
+		reass->pkt[i]->buffer = NULL;
+		net_pkt_unref(reass->pkt[i]);
+		reass->pkt[i] = NULL;
+	}
+
+	reass->pkt[0] = NULL;
+	reass->reassembled++;
+
+	net_pkt_cursor_init(pkt);
+
+	hdr = (struct net_ipv4_hdr *)net_pkt_get_data(pkt, &ipv4_access);
+	if (!hdr) {
+		goto error;
+	}
+
+	hdr->len = htons(net_pkt_get_len(pkt));
+	hdr->offset[0] = 0U;
+	hdr->offset[1] = 0U;
+	hdr->chksum = 0U;
+	hdr->chksum = net_calc_chksum_ipv4(pkt);
+
+	net_pkt_set_data(pkt, &ipv4_access);
+
+	NET_DBG("New pkt %p IPv4 len is %zd bytes", pkt,
+		net_pkt_get_len(pkt));
+
+	/* The datagram is no longer fragmented so this does not recurse
+	 * any further.
+	 */
+	net_pkt_cursor_init(pkt);
+
+	if (net_ipv4_input(pkt) != NET_DROP) {
+		return;
+	}
+error:
+	net_pkt_unref(pkt);
+}
+
+void net_ipv4_frag_foreach(net_ipv4_frag_cb_t cb, void *user_data)
+{
+	int i;
+
+	for (i = 0; reassembly_init_done &&
+		     i < CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT; i++) {
+		cb(&reassembly[i], user_data);
+	}
+}
+
+enum net_verdict net_ipv4_handle_fragment_hdr(struct net_pkt *pkt,
+					      struct net_ipv4_hdr *hdr)
+{
+	u8_t hdr_len = (hdr->vhl & NET_IPV4_IHL_MASK) * 4U;
+	u16_t flag = sys_get_be16(hdr->offset);
+	u16_t offset = (flag & NET_IPV4_FRAGH_OFFSET_MASK) * 8U;
+	struct net_ipv4_reassembly *reass;
+	u16_t len;
+	int i;
+
+	if (!reassembly_init_done) {
+		for (i = 0; i < CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT; i++) {
+			k_delayed_work_init(&reassembly[i].timer,
+					    reassembly_timeout);
+		}
+
+		reassembly_init_done = true;
+	}
+
+	reass = reassembly_get(sys_get_be16(hdr->id), hdr->proto,
+			       &hdr->src, &hdr->dst);
+	if (!reass) {
+		NET_DBG("Cannot get reassembly slot, dropping pkt %p", pkt);
+		return NET_DROP;
+	}
+
+	/* The header is needed for the reassembled packet only once */
+	if (offset) {
+		net_pkt_cursor_init(pkt);
+
+		if (net_pkt_pull(pkt, hdr_len)) {
+			goto drop;
+		}
+
+		len = net_pkt_get_len(pkt);
+	} else {
+		len = net_pkt_get_len(pkt) - hdr_len;
+	}
+
+	if ((u32_t)offset + len > IPV4_MAX_LEN - hdr_len) {
+		NET_DBG("Reassembled IPv4 packet too large");
+		goto drop;
+	}
+
+	if (flag & NET_IPV4_MF) {
+		if (len % 8) {
+			goto drop;
+		}
+	} else {
+		if (reass->len && reass->len != offset + len) {
+			goto drop;
+		}
+
+		reass->len = offset + len;
+	}
+
+	/* The fragments might come in wrong order so place them
+	 * in reassembly chain in correct order.
+	 */
+	for (i = 0; i < FRAGMENTS_MAX_PKT && reass->pkt[i]; i++) {
+		if (reass->offset[i] >= offset) {
+			break;
+		}
+	}
+
+	if (reass->pkt[FRAGMENTS_MAX_PKT - 1]) {
+		NET_DBG("No slots available for 0x%x", reass->id);
+		goto drop;
+	}
+
+	/* Overlapping fragments are not accepted, like for IPv6 in
+	 * RFC 5722.
+	 */
+	if ((i > 0 &&
+	     reass->offset[i - 1] + fragment_len(reass, i - 1) > offset) ||
+	    (reass->pkt[i] && offset + len > reass->offset[i])) {
+		NET_DBG("Overlapping fragment 0x%x offset %u", reass->id,
+			offset);
+		goto drop;
+	}
+
+	memmove(&reass->pkt[i + 1], &reass->pkt[i],
+		sizeof(reass->pkt[0]) * (FRAGMENTS_MAX_PKT - i - 1));
+	memmove(&reass->offset[i + 1], &reass->offset[i],
+		sizeof(reass->offset[0]) * (FRAGMENTS_MAX_PKT - i - 1));
+
+	NET_DBG("Storing pkt %p to slot %d offset %d", pkt, i, offset);
+
+	reass->pkt[i] = pkt;
+	reass->offset[i] = offset;
+
+	if (!reassembly_complete(reass)) {
+		reassembly_info("Reassembly nth pkt", reass);
+		return NET_OK;
+	}
+
+	reassembly_info("Reassembly last pkt", reass);
+
+	reassemble_packet(reass);
+
+	return NET_OK;
+
+drop:
+	reass->dropped++;
+
+	/* The caller releases this fragment, the pending ones go now.
+	 * A lone first fragment did not get the slot yet.
+	 */
+	if (reass->pkt[0]) {
+		reassembly_cancel(reass);
+	} else {
+		k_delayed_work_cancel(&reass->timer);
+	}
+
+	return NET_DROP;
+}
+
+/* Only the options with the copied flag go into the later fragments.
+ * Returns the length of the header that is left.
+ */
+static u8_t fragment_options(u8_t *hdr, u8_t hdr_len)
+{
+	u8_t *opts = hdr + sizeof(struct net_ipv4_hdr);
+	u8_t opts_len = hdr_len - sizeof(struct net_ipv4_hdr);
+	u8_t i = 0U, len = 0U;
+
+	while (i < opts_len && opts[i] != NET_IPV4_OPTS_EO) {
+		u8_t opt_len;
+
+		if (opts[i] == NET_IPV4_OPTS_NOP) {
+			i++;
+			continue;
+		}
+
+		if (i + 1 >= opts_len) {
+			break;
+		}
+
+		opt_len = opts[i + 1];
+		if (opt_len < 2U || i + opt_len > opts_len) {
+			break;
+		}
+
+		if (opts[i] & NET_IPV4_OPTS_COPIED) {
+			memmove(opts + len, opts + i, opt_len);
+			len += opt_len;
+		}
+
+		i += opt_len;
+	}
+
+	while (len % 4U) {
+		opts[len++] = NET_IPV4_OPTS_EO;
+	}
+
+	return sizeof(struct net_ipv4_hdr) + len;
+}
+
+/* Detach the first len bytes of the packet. Whole buffers are moved to
+ * the fragment, only a buffer straddling the end is cloned.
+ */
+static struct net_buf *payload_split(struct net_pkt *pkt, size_t len)
+{
+	struct net_buf *head = pkt->buffer;
+	struct net_buf *buf = head;
+	struct net_buf *prev = NULL;
+	struct net_buf *rest;
+
+	while (buf && len >= buf->len) {
+		len -= buf->len;
+		prev = buf;
+		buf = buf->frags;
+	}
+
+	if (buf && len) {
+		rest = net_buf_clone(buf, BUF_ALLOC_TIMEOUT);
+		if (!rest) {
+			return NULL;
+		}
+
+		net_buf_pull(rest, len);
+		rest->frags = buf->frags;
+
+		buf->len = len;
+		buf->frags = NULL;
+
+		pkt->buffer = rest;
+
+		return head;
+	}
+
+	if (prev) {
+		prev->frags = NULL;
+	}
+
+	pkt->buffer = buf;
+
+	return prev ? head : NULL;
+}
+
+static int send_ipv4_fragment(struct net_pkt *pkt, u8_t *hdr, u8_t hdr_len,
+			      u16_t id, u16_t frag_offset, u16_t fit_len,
+			      bool final)
+{
+	NET_PKT_DATA_ACCESS_CONTIGUOUS_DEFINE(ipv4_access, struct net_ipv4_hdr);
+	struct net_ipv4_hdr *ipv4_hdr;
+	struct net_pkt *frag_pkt;
+	struct net_buf *payload;
+	int ret = -ENOBUFS;
+
+	frag_pkt = net_pkt_alloc_with_buffer(net_pkt_iface(pkt), hdr_len -
+					     sizeof(struct net_ipv4_hdr),
+					     AF_INET, 0, BUF_ALLOC_TIMEOUT);
+	if (!frag_pkt) {
+		return -ENOMEM;
+	}
+
+	if (net_pkt_write(frag_pkt, hdr, hdr_len)) {
+		goto fail;
+	}
+
+	payload = payload_split(pkt, fit_len);
+	if (!payload) {
+		goto fail;
+	}
+
+	net_pkt_append_buffer(frag_pkt, payload);
+
+	net_pkt_set_priority(frag_pkt, net_pkt_priority(pkt));
+	net_pkt_set_ip_hdr_len(frag_pkt, sizeof(struct net_ipv4_hdr));
+	net_pkt_set_ipv4_opts_len(frag_pkt,
+				  hdr_len - sizeof(struct net_ipv4_hdr));
+
+	net_pkt_cursor_init(frag_pkt);
+
+	ipv4_hdr = (struct net_ipv4_hdr *)net_pkt_get_data(frag_pkt,
+							   &ipv4_access);
+	if (!ipv4_hdr) {
+		goto fail;
+	}
+
+	ipv4_hdr->vhl = 0x40 | (hdr_len / 4U);
+	ipv4_hdr->len = htons(hdr_len + fit_len);
+	sys_put_be16(id, ipv4_hdr->id);
+	sys_put_be16((frag_offset / 8U) | (final ? 0 : NET_IPV4_MF),
+		     ipv4_hdr->offset);
+	ipv4_hdr->chksum = 0U;
+
+	if (net_if_need_calc_tx_checksum(net_pkt_iface(frag_pkt))) {
+		ipv4_hdr->chksum = net_calc_chksum_ipv4(frag_pkt);
+	}
+
+	net_pkt_set_data(frag_pkt, &ipv4_access);
+
+	ret = net_send_data(frag_pkt);
+	if (ret < 0) {
+		goto fail;
+	}
+
+	return 0;
+
+fail:
+	NET_DBG("Cannot send fragment (%d)", ret);
+	net_pkt_unref(frag_pkt);
+
+	return ret;
+}
+
+/* The payload buffers of the packet are handed over to the fragments, so
+ * the packet must not be sent or referenced by anyone else afterwards.
+ */
+static int net_ipv4_send_fragmented_pkt(struct net_pkt *pkt, u16_t mtu)
+{
+	u8_t hdr[sizeof(struct net_ipv4_hdr) + NET_IPV4_HDR_OPTNS_MAX_LEN];
+	u16_t id = sys_rand32_get();
+	u16_t frag_offset = 0U;
+	u16_t fit_len;
+	u8_t hdr_len;
+	size_t len;
+	int ret;
+
+	net_pkt_cursor_init(pkt);
+
+	if (net_pkt_read(pkt, hdr, sizeof(struct net_ipv4_hdr))) {
+		return -ENOBUFS;
+	}
+
+	hdr_len = (hdr[0] & NET_IPV4_IHL_MASK) * 4U;
+	if (hdr_len < sizeof(struct net_ipv4_hdr) ||
+	    net_pkt_read(pkt, hdr + sizeof(struct net_ipv4_hdr),
+			 hdr_len - sizeof(struct net_ipv4_hdr))) {
+		return -EINVAL;
+	}
+
+	net_pkt_cursor_init(pkt);
+
+	if (net_pkt_pull(pkt, hdr_len)) {
+		return -ENOBUFS;
+	}
+
+	len = net_pkt_get_len(pkt);
+
+	while (len) {
+		fit_len = (mtu - hdr_len) & ~7U;
+		if (fit_len >= len) {
+			fit_len = len;
+		}
+
+		ret = send_ipv4_fragment(pkt, hdr, hdr_len, id, frag_offset,
+					 fit_len, fit_len == len);
+		if (ret < 0) {
+			return ret;
+		}
+
+		if (frag_offset == 0U) {
+			hdr_len = fragment_options(hdr, hdr_len);
+		}
+
+		len -= fit_len;
+		frag_offset += fit_len;
+	}
+
+	return 0;
+}
+
+enum net_verdict net_ipv4_prepare_for_send(struct net_pkt *pkt)
+{
+	NET_PKT_DATA_ACCESS_CONTIGUOUS_DEFINE(ipv4_access, struct net_ipv4_hdr);
+	u16_t mtu = net_if_get_mtu(net_pkt_iface(pkt));
+	size_t pkt_len = net_pkt_get_len(pkt);
+	struct net_ipv4_hdr *hdr;
+	int ret;
+
+	/* TCP packets larger than the MTU are split into segments by the
+	 * L2 instead.
+	 */
+	if (!mtu || pkt_len <= mtu || net_pkt_gso_size(pkt)) {
+		return NET_OK;
+	}
+
+	net_pkt_cursor_init(pkt);
+
+	hdr = (struct net_ipv4_hdr *)net_pkt_get_data(pkt, &ipv4_access);
+	if (!hdr) {
+		return NET_DROP;
+	}
+
+	if (pkt_len > IPV4_MAX_LEN ||
+	    mtu < IPV4_MIN_FRAG_MTU ||
+	    (sys_get_be16(hdr->offset) & NET_IPV4_DF)) {
+		NET_DBG("Cannot fragment IPv4 pkt %p len %zd", pkt, pkt_len);
+		return NET_DROP;
+	}
+
+	/* Packets kept for retransmission cannot give their buffers away */
+	if (atomic_get(&pkt->atomic_ref) > 1) {
+		NET_DBG("Cannot fragment shared IPv4 pkt %p", pkt);
+		return NET_DROP;
+	}
+
+	ret = net_ipv4_send_fragmented_pkt(pkt, mtu);
+	if (ret < 0) {
+		NET_DBG("Cannot fragment IPv4 pkt (%d)", ret);
+		return NET_DROP;
+	}
+
+	/* The fragments are sent, and the packet has no data left */
+	net_pkt_unref(pkt);
+
+	return NET_CONTINUE;
+}
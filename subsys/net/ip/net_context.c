@@ -1569,11 +1569,14 @@ static int context_sendto(struct net_context *context,
 	} else if (IS_ENABLED(CONFIG_NET_TCP) &&
 		   net_context_get_ip_proto(context) == IPPROTO_TCP) {
 #if IS_ENABLED(CONFIG_NET_TCP2)
-		ret = net_tcp_queue(context, buf, len, msghdr);
+		ret = net_tcp_queue(context, buf, len, msghdr, timeout);
 		if (ret < 0) {
 			goto fail;
 		}
 
+		/* Only part of the data fits in the send buffer */
+		len = ret;
+
 		net_pkt_unref(pkt);
 #else
 		ret = context_write_data(pkt, buf, len, msghdr);
@@ -173,6 +173,8 @@ static void init_rx_queues(void)
 	 */
 	net_if_init();
 
+	init_rx_batches();
+
 	net_tc_rx_init();
 
 	/* This will take the interface up and start everything. */
@@ -367,13 +369,11 @@ static void process_rx_packet(struct k_work *work)
 	net_rx(net_pkt_iface(pkt), pkt);
 }
 
-static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
+static u8_t net_rx_tc(struct net_if *iface, struct net_pkt *pkt)
 {
 	u8_t prio = net_pkt_priority(pkt);
 	u8_t tc = net_rx_priority2tc(prio);
 
-	k_work_init(net_pkt_work(pkt), process_rx_packet);
-
 #if defined(CONFIG_NET_STATISTICS)
 	net_stats_update_tc_recv_pkt(iface, tc);
 	net_stats_update_tc_recv_bytes(iface, tc, net_pkt_get_len(pkt));
@@ -384,11 +384,19 @@ static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
 	NET_DBG("TC %d with prio %d pkt %p", tc, prio, pkt);
 #endif
 
+	return tc;
+}
+
+static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
+{
+	u8_t tc = net_rx_tc(iface, pkt);
+
+	k_work_init(net_pkt_work(pkt), process_rx_packet);
+
 	net_tc_submit_to_rx_queue(tc, pkt);
 }
 
-/* Called by driver when an IP packet has been received */
-int net_recv_data(struct net_if *iface, struct net_pkt *pkt)
+static int net_recv_prepare(struct net_if *iface, struct net_pkt *pkt)
 {
 	if (!pkt || !iface) {
 		return -EINVAL;
@@ -414,11 +422,139 @@ int net_recv_data(struct net_if *iface, struct net_pkt *pkt)
 
 	net_pkt_set_iface(pkt, iface);
 
+	return 0;
+}
+
+/* Called by driver when an IP packet has been received */
+int net_recv_data(struct net_if *iface, struct net_pkt *pkt)
+{
+	int ret;
+
+	ret = net_recv_prepare(iface, pkt);
+	if (ret < 0) {
+		return ret;
+	}
+
 	net_queue_rx(iface, pkt);
 
 	return 0;
 }
 
+#if defined(CONFIG_NET_RX_BATCH)
+/* Packets waiting for the RX thread of each traffic class. The work item
+ * is submitted when the first packet is added, so a batch costs a single
+ * submission however many packets it holds.
+ */
+struct net_rx_batch {
+	struct k_work work;
+	struct k_spinlock lock;
+	sys_slist_t pkts;
+};
+
+static struct net_rx_batch rx_batches[NET_TC_RX_COUNT];
+
+static void process_rx_batch(struct k_work *work)
+{
+	struct net_rx_batch *batch = CONTAINER_OF(work, struct net_rx_batch,
+						  work);
+	k_spinlock_key_t key;
+	struct net_pkt *pkt;
+	sys_slist_t pkts;
+
+	key = k_spin_lock(&batch->lock);
+	pkts = batch->pkts;
+	sys_slist_init(&batch->pkts);
+	k_spin_unlock(&batch->lock, key);
+
+	while ((pkt = net_pkt_rx_batch_get(&pkts))) {
+		net_rx(net_pkt_iface(pkt), pkt);
+	}
+}
+
+int net_recv_data_batch(sys_slist_t *pkts)
+{
+	sys_slist_t queued[NET_TC_RX_COUNT];
+	k_spinlock_key_t key;
+	struct net_pkt *pkt;
+	int count = 0;
+	u8_t tc;
+
+	for (tc = 0U; tc < NET_TC_RX_COUNT; tc++) {
+		sys_slist_init(&queued[tc]);
+	}
+
+	while ((pkt = net_pkt_rx_batch_get(pkts))) {
+		struct net_if *iface = net_pkt_iface(pkt);
+
+		if (net_recv_prepare(iface, pkt) < 0) {
+			net_pkt_unref(pkt);
+			continue;
+		}
+
+		net_pkt_rx_batch_add(&queued[net_rx_tc(iface, pkt)], pkt);
+		count++;
+	}
+
+	for (tc = 0U; tc < NET_TC_RX_COUNT; tc++) {
+		struct net_rx_batch *batch = &rx_batches[tc];
+
+		if (sys_slist_is_empty(&queued[tc])) {
+			continue;
+		}
+
+		key = k_spin_lock(&batch->lock);
+		sys_slist_merge_slist(&batch->pkts, &queued[tc]);
+		k_spin_unlock(&batch->lock, key);
+
+		net_tc_submit_work_to_rx_queue(tc, &batch->work);
+	}
+
+	return count;
+}
+
+static void process_rx_poll(struct k_work *work)
+{
+	struct net_rx_poll *poll = CONTAINER_OF(work, struct net_rx_poll,
+						work);
+	sys_slist_t pkts;
+	int count;
+
+	sys_slist_init(&pkts);
+
+	count = poll->cb(poll, &pkts, CONFIG_NET_RX_POLL_BUDGET);
+
+	(void)net_recv_data_batch(&pkts);
+
+	/* The batch work is queued ahead of the next poll */
+	if (count >= CONFIG_NET_RX_POLL_BUDGET) {
+		net_rx_poll_schedule(poll);
+	}
+}
+
+void net_rx_poll_init(struct net_rx_poll *poll, net_rx_poll_cb_t cb)
+{
+	k_work_init(&poll->work, process_rx_poll);
+	poll->cb = cb;
+}
+
+void net_rx_poll_schedule(struct net_rx_poll *poll)
+{
+	u8_t tc = net_rx_priority2tc(CONFIG_NET_RX_DEFAULT_PRIORITY);
+
+	net_tc_submit_work_to_rx_queue(tc, &poll->work);
+}
+
+static void init_rx_batches(void)
+{
+	for (int i = 0; i < NET_TC_RX_COUNT; i++) {
+		k_work_init(&rx_batches[i].work, process_rx_batch);
+		sys_slist_init(&rx_batches[i].pkts);
+	}
+}
+#else
+#define init_rx_batches(...)
+#endif /* CONFIG_NET_RX_BATCH */
+
 static inline void l3_init(void)
 {
 	net_icmpv4_init();
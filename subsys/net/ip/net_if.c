@@ -21,6 +21,7 @@ LOG_MODULE_REGISTER(net_if, CONFIG_NET_IF_LOG_LEVEL);
 
 #include "net_private.h"
 #include "ipv6.h"
+#include "ipv4.h"
 #include "ipv4_autoconf_internal.h"
 
 #include "net_stats.h"
@@ -144,7 +145,7 @@ static inline void net_context_send_cb(struct net_context *context,
 	}
 }
 
-static bool net_if_tx(struct net_if *iface, struct net_pkt *pkt)
+bool net_if_tx(struct net_if *iface, struct net_pkt *pkt)
 {
 	struct net_linkaddr *dst;
 	struct net_context *context;
@@ -242,6 +243,7 @@ static bool net_if_tx(struct net_if *iface, struct net_pkt *pkt)
 	return true;
 }
 
+#if !defined(CONFIG_NET_TX_QDISC)
 static void process_tx_packet(struct k_work *work)
 {
 	struct net_pkt *pkt;
@@ -250,14 +252,13 @@ static void process_tx_packet(struct k_work *work)
 
 	net_if_tx(net_pkt_iface(pkt), pkt);
 }
+#endif
 
 void net_if_queue_tx(struct net_if *iface, struct net_pkt *pkt)
 {
 	u8_t prio = net_pkt_priority(pkt);
 	u8_t tc = net_tx_priority2tc(prio);
 
-	k_work_init(net_pkt_work(pkt), process_tx_packet);
-
 	net_stats_update_tc_sent_pkt(iface, tc);
 	net_stats_update_tc_sent_bytes(iface, tc, net_pkt_get_len(pkt));
 	net_stats_update_tc_sent_priority(iface, tc, prio);
@@ -266,7 +267,13 @@ void net_if_queue_tx(struct net_if *iface, struct net_pkt *pkt)
 	NET_DBG("TC %d with prio %d pkt %p", tc, prio, pkt);
 #endif
 
+#if defined(CONFIG_NET_TX_QDISC)
+	net_if_qdisc_enqueue(iface, tc, pkt);
+#else
+	k_work_init(net_pkt_work(pkt), process_tx_packet);
+
 	net_tc_submit_to_tx_queue(tc, pkt);
+#endif
 }
 
 void net_if_stats_reset(struct net_if *iface)
@@ -350,6 +357,11 @@ enum net_verdict net_if_send_data(struct net_if *iface, struct net_pkt *pkt)
 		verdict = net_ipv6_prepare_for_send(pkt);
 	}
 
+	/* Split the packet if it does not fit the MTU */
+	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET) {
+		verdict = net_ipv4_prepare_for_send(pkt);
+	}
+
 done:
 	/*   NET_OK in which case packet has checked successfully. In this case
 	 *   the net_context callback is called after successful delivery in
@@ -3403,6 +3415,15 @@ bool net_if_need_calc_rx_checksum(struct net_if *iface)
 	return need_calc_checksum(iface, ETHERNET_HW_RX_CHKSUM_OFFLOAD);
 }
 
+bool net_if_is_gso_capable(struct net_if *iface)
+{
+	if (!IS_ENABLED(CONFIG_NET_TCP_GSO)) {
+		return false;
+	}
+
+	return !!(l2_flags_get(iface) & NET_L2_GSO);
+}
+
 struct net_if *net_if_get_by_index(int index)
 {
 	if (index <= 0) {
@@ -3658,6 +3679,7 @@ void net_if_init(void)
 	for (iface = __net_if_start, if_count = 0; iface != __net_if_end;
 	     iface++, if_count++) {
 		init_iface(iface);
+		net_if_qdisc_init(iface);
 	}
 
 	if (iface == __net_if_start) {
@@ -119,7 +119,33 @@ NET_BUF_POOL_FIXED_DEFINE(rx_bufs, CONFIG_NET_BUF_RX_COUNT,
 NET_BUF_POOL_FIXED_DEFINE(tx_bufs, CONFIG_NET_BUF_TX_COUNT,
 			  CONFIG_NET_BUF_DATA_SIZE, NULL);
 
-#else /* !CONFIG_NET_BUF_FIXED_DATA_SIZE */
+#elif defined(CONFIG_NET_BUF_CLASS_DATA_SIZE)
+
+BUILD_ASSERT_MSG(CONFIG_NET_BUF_DATA_SIZE <
+		 CONFIG_NET_BUF_DATA_CLASS_MEDIUM_SIZE &&
+		 CONFIG_NET_BUF_DATA_CLASS_MEDIUM_SIZE <
+		 CONFIG_NET_BUF_DATA_CLASS_LARGE_SIZE,
+		 "Data classes must have increasing sizes");
+
+NET_BUF_DATA_CLASS_DEFINE(rx_small, CONFIG_NET_BUF_DATA_SIZE,
+			  CONFIG_NET_BUF_RX_COUNT);
+NET_BUF_DATA_CLASS_DEFINE(rx_medium, CONFIG_NET_BUF_DATA_CLASS_MEDIUM_SIZE,
+			  CONFIG_NET_BUF_DATA_CLASS_MEDIUM_COUNT);
+NET_BUF_DATA_CLASS_DEFINE(rx_large, CONFIG_NET_BUF_DATA_CLASS_LARGE_SIZE,
+			  CONFIG_NET_BUF_DATA_CLASS_LARGE_COUNT);
+NET_BUF_DATA_CLASS_DEFINE(tx_small, CONFIG_NET_BUF_DATA_SIZE,
+			  CONFIG_NET_BUF_TX_COUNT);
+NET_BUF_DATA_CLASS_DEFINE(tx_medium, CONFIG_NET_BUF_DATA_CLASS_MEDIUM_SIZE,
+			  CONFIG_NET_BUF_DATA_CLASS_MEDIUM_COUNT);
+NET_BUF_DATA_CLASS_DEFINE(tx_large, CONFIG_NET_BUF_DATA_CLASS_LARGE_SIZE,
+			  CONFIG_NET_BUF_DATA_CLASS_LARGE_COUNT);
+
+NET_BUF_POOL_CLASS_DEFINE(rx_bufs, CONFIG_NET_BUF_RX_COUNT, NULL,
+			  &rx_small, &rx_medium, &rx_large);
+NET_BUF_POOL_CLASS_DEFINE(tx_bufs, CONFIG_NET_BUF_TX_COUNT, NULL,
+			  &tx_small, &tx_medium, &tx_large);
+
+#else /* CONFIG_NET_BUF_VARIABLE_DATA_SIZE */
 
 NET_BUF_POOL_VAR_DEFINE(rx_bufs, CONFIG_NET_BUF_RX_COUNT,
 			CONFIG_NET_BUF_DATA_POOL_SIZE, NULL);
@@ -835,18 +861,44 @@ void net_pkt_get_info(struct k_mem_slab **rx,
 }
 
 #if defined(CONFIG_NET_DEBUG_NET_PKT_ALLOC)
+#if defined(CONFIG_NET_BUF_CLASS_DATA_SIZE)
+static void print_data_classes(const char *str, struct net_buf_pool *pool)
+{
+	const struct net_buf_pool_class *pc = net_buf_pool_classes(pool);
+	int i;
+
+	for (i = 0; i < pc->count; i++) {
+		struct net_buf_data_class *data_class = pc->classes[i];
+
+		NET_DBG("%s %u: free %u allocs %d fallbacks %d failures %d "
+			"efficiency %u%%", str, data_class->size,
+			k_mem_slab_num_free_get(data_class->slab),
+			atomic_get(&data_class->allocs),
+			atomic_get(&data_class->fallbacks),
+			atomic_get(&data_class->failures),
+			net_buf_data_class_efficiency(data_class));
+	}
+}
+#else
+#define print_data_classes(...)
+#endif /* CONFIG_NET_BUF_CLASS_DATA_SIZE */
+
 void net_pkt_print(void)
 {
 	NET_DBG("TX %u RX %u RDATA %d TDATA %d",
 		k_mem_slab_num_free_get(&tx_pkts),
 		k_mem_slab_num_free_get(&rx_pkts),
 		get_frees(&rx_bufs), get_frees(&tx_bufs));
+
+	print_data_classes("RDATA", &rx_bufs);
+	print_data_classes("TDATA", &tx_bufs);
 }
 #endif /* CONFIG_NET_DEBUG_NET_PKT_ALLOC */
 
 /* New allocator and API starts here */
 
-#if defined(CONFIG_NET_BUF_FIXED_DATA_SIZE)
+#if defined(CONFIG_NET_BUF_FIXED_DATA_SIZE) || \
+	defined(CONFIG_NET_BUF_CLASS_DATA_SIZE)
 
 #if NET_LOG_LEVEL >= LOG_LEVEL_DBG
 static struct net_buf *pkt_alloc_buffer(struct net_buf_pool *pool,
@@ -864,7 +916,14 @@ static struct net_buf *pkt_alloc_buffer(struct net_buf_pool *pool,
 	while (size) {
 		struct net_buf *new;
 
+#if defined(CONFIG_NET_BUF_CLASS_DATA_SIZE)
+		new = net_buf_alloc_len(pool,
+					MIN(size,
+					    CONFIG_NET_BUF_DATA_CLASS_LARGE_SIZE),
+					timeout);
+#else
 		new = net_buf_alloc_fixed(pool, timeout);
+#endif
 		if (!new) {
 			goto error;
 		}
@@ -908,7 +967,7 @@ error:
 	return NULL;
 }
 
-#else /* !CONFIG_NET_BUF_FIXED_DATA_SIZE */
+#else /* CONFIG_NET_BUF_VARIABLE_DATA_SIZE */
 
 #if NET_LOG_LEVEL >= LOG_LEVEL_DBG
 static struct net_buf *pkt_alloc_buffer(struct net_buf_pool *pool,
@@ -952,6 +1011,12 @@ static size_t pkt_buffer_length(struct net_pkt *pkt,
 		max_len = 0;
 	}
 
+	/* TCP packets are split to the MTU by the L2 */
+	if (IS_ENABLED(CONFIG_NET_TCP_GSO) && proto == IPPROTO_TCP &&
+	    net_if_is_gso_capable(net_pkt_iface(pkt))) {
+		max_len = MAX(max_len, CONFIG_NET_TCP_GSO_MAX_SIZE);
+	}
+
 	/* Family vs iface MTU */
 	if (IS_ENABLED(CONFIG_NET_IPV6) && family == AF_INET6) {
 		if (IS_ENABLED(CONFIG_NET_IPV6_FRAGMENT) && (size > max_len)) {
@@ -963,6 +1028,11 @@ static size_t pkt_buffer_length(struct net_pkt *pkt,
 
 		max_len = MAX(max_len, NET_IPV6_MTU);
 	} else if (IS_ENABLED(CONFIG_NET_IPV4) && family == AF_INET) {
+		if (IS_ENABLED(CONFIG_NET_IPV4_FRAGMENT) && (size > max_len)) {
+			/* Same for IPv4 fragmentation */
+			max_len = size;
+		}
+
 		max_len = MAX(max_len, NET_IPV4_MTU);
 	} else { /* family == AF_UNSPEC */
 #if defined (CONFIG_NET_L2_ETHERNET)
@@ -1701,6 +1771,7 @@ static void clone_pkt_attributes(struct net_pkt *pkt, struct net_pkt *clone_pkt)
 	net_pkt_set_timestamp(clone_pkt, net_pkt_timestamp(pkt));
 	net_pkt_set_priority(clone_pkt, net_pkt_priority(pkt));
 	net_pkt_set_orig_iface(clone_pkt, net_pkt_orig_iface(pkt));
+	net_pkt_set_gso_size(clone_pkt, net_pkt_gso_size(pkt));
 
 	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET) {
 		net_pkt_set_ipv4_ttl(clone_pkt, net_pkt_ipv4_ttl(pkt));
@@ -78,6 +78,19 @@ static inline enum net_verdict net_ipv6_input(struct net_pkt *pkt,
 #endif
 extern void net_tc_submit_to_tx_queue(u8_t tc, struct net_pkt *pkt);
 extern void net_tc_submit_to_rx_queue(u8_t tc, struct net_pkt *pkt);
+#if defined(CONFIG_NET_RX_BATCH)
+extern void net_tc_submit_work_to_rx_queue(u8_t tc, struct k_work *work);
+#endif
+#if defined(CONFIG_NET_TX_QDISC)
+extern void net_tc_submit_work_to_tx_queue(u8_t tc, struct k_work *work);
+extern int net_tc_tx_thread_priority(u8_t tc);
+extern void net_if_qdisc_init(struct net_if *iface);
+extern void net_if_qdisc_enqueue(struct net_if *iface, u8_t tc,
+				 struct net_pkt *pkt);
+#else
+static inline void net_if_qdisc_init(struct net_if *iface) { }
+#endif
+extern bool net_if_tx(struct net_if *iface, struct net_pkt *pkt);
 extern enum net_verdict net_promisc_mode_input(struct net_pkt *pkt);
 
 char *net_sprint_addr(sa_family_t af, const void *addr);
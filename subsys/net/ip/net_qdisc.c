@@ -0,0 +1,234 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_qdisc, CONFIG_NET_TC_LOG_LEVEL);
+
+#include <zephyr.h>
+
+#include <net/net_core.h>
+#include <net/net_if.h>
+#include <net/net_pkt.h>
+
+#include "net_private.h"
+
+#define QDISC_LEN CONFIG_NET_TX_QDISC_LEN
+
+BUILD_ASSERT_MSG((QDISC_LEN & (QDISC_LEN - 1)) == 0,
+		 "CONFIG_NET_TX_QDISC_LEN must be a power of two");
+
+/* The class queues are bounded multi-producer rings. A producer takes a
+ * ticket by advancing the tail, and may fill the slot of the ticket once
+ * the sequence number of the slot equals the ticket, i.e. once the
+ * consumer has emptied it in the previous lap.
+ */
+static bool class_push(struct net_if_qdisc_class *cl, struct net_pkt *pkt)
+{
+	struct net_if_qdisc_slot *slot;
+	u32_t pos;
+	s32_t diff;
+
+	while (true) {
+		pos = atomic_get(&cl->tail);
+		slot = &cl->slots[pos & (QDISC_LEN - 1)];
+		diff = (s32_t)((u32_t)atomic_get(&slot->seq) - pos);
+
+		if (diff < 0) {
+			return false; /* Full */
+		}
+
+		if (diff == 0 && atomic_cas(&cl->tail, pos, pos + 1)) {
+			break;
+		}
+	}
+
+	slot->pkt = pkt;
+	atomic_set(&slot->seq, pos + 1);
+
+	return true;
+}
+
+static struct net_pkt *class_peek(struct net_if_qdisc_class *cl)
+{
+	u32_t pos = atomic_get(&cl->head);
+	struct net_if_qdisc_slot *slot = &cl->slots[pos & (QDISC_LEN - 1)];
+
+	if ((u32_t)atomic_get(&slot->seq) != pos + 1) {
+		return NULL;
+	}
+
+	return slot->pkt;
+}
+
+static void class_pop(struct net_if_qdisc_class *cl)
+{
+	u32_t pos = atomic_get(&cl->head);
+	struct net_if_qdisc_slot *slot = &cl->slots[pos & (QDISC_LEN - 1)];
+
+	atomic_set(&cl->head, pos + 1);
+	atomic_set(&slot->seq, pos + QDISC_LEN);
+}
+
+/* Highest traffic class with a packet queued, or -1 */
+static int qdisc_pending(struct net_if_qdisc *q)
+{
+	int tc;
+
+	for (tc = NET_TC_TX_COUNT - 1; tc >= 0; tc--) {
+		if (class_peek(&q->classes[tc])) {
+			break;
+		}
+	}
+
+	return tc;
+}
+
+#if defined(CONFIG_NET_TX_QDISC_WFQ)
+/* Deficit round robin, traffic class n has a weight of n + 1 */
+static struct net_pkt *qdisc_dequeue(struct net_if_qdisc *q)
+{
+	int empty = 0;
+
+	while (empty < NET_TC_TX_COUNT) {
+		struct net_if_qdisc_class *cl = &q->classes[q->next];
+		struct net_pkt *pkt = class_peek(cl);
+
+		if (!pkt) {
+			cl->deficit = 0U;
+			empty++;
+		} else if (net_pkt_get_len(pkt) <= cl->deficit) {
+			cl->deficit -= net_pkt_get_len(pkt);
+			class_pop(cl);
+			return pkt;
+		} else {
+			empty = 0;
+		}
+
+		q->next = (q->next + 1) % NET_TC_TX_COUNT;
+		q->classes[q->next].deficit +=
+			CONFIG_NET_TX_QDISC_QUANTUM * (q->next + 1);
+	}
+
+	return NULL;
+}
+#else
+static struct net_pkt *qdisc_dequeue(struct net_if_qdisc *q)
+{
+	int tc = qdisc_pending(q);
+	struct net_pkt *pkt;
+
+	if (tc < 0) {
+		return NULL;
+	}
+
+	pkt = class_peek(&q->classes[tc]);
+	class_pop(&q->classes[tc]);
+
+	return pkt;
+}
+#endif /* CONFIG_NET_TX_QDISC_WFQ */
+
+/* Let the TX thread of the highest pending traffic class run the queues
+ * once the current owner has released them.
+ */
+static void qdisc_kick(struct net_if_qdisc *q)
+{
+	int tc = qdisc_pending(q);
+
+	if (tc >= 0) {
+		net_tc_submit_work_to_tx_queue(tc, &q->classes[tc].work);
+	}
+}
+
+static void qdisc_run(struct k_work *work)
+{
+	struct net_if_qdisc_class *cl = CONTAINER_OF(work,
+						     struct net_if_qdisc_class,
+						     work);
+	struct net_if_qdisc *q = CONTAINER_OF(cl - cl->tc,
+					      struct net_if_qdisc, classes);
+	struct net_if *iface = CONTAINER_OF(q, struct net_if, qdisc);
+	int budget = QDISC_LEN;
+	struct net_pkt *pkt;
+
+	/* The owner kicks the queues again when it is done */
+	if (!atomic_cas(&q->owner, 0, 1)) {
+		return;
+	}
+
+	while (budget-- > 0 && (pkt = qdisc_dequeue(q))) {
+		net_if_tx(iface, pkt);
+	}
+
+	atomic_clear(&q->owner);
+
+	qdisc_kick(q);
+}
+
+/* The queues are empty and the caller would not be preempted by the TX
+ * thread anyway, so it can as well call the driver itself.
+ */
+static bool qdisc_bypass(struct net_if_qdisc *q, u8_t tc)
+{
+	if (k_is_in_isr() ||
+	    k_thread_priority_get(k_current_get()) >
+	    net_tc_tx_thread_priority(tc)) {
+		return false;
+	}
+
+	if (!atomic_cas(&q->owner, 0, 1)) {
+		return false;
+	}
+
+	if (qdisc_pending(q) >= 0) {
+		atomic_clear(&q->owner);
+		return false;
+	}
+
+	return true;
+}
+
+void net_if_qdisc_enqueue(struct net_if *iface, u8_t tc, struct net_pkt *pkt)
+{
+	struct net_if_qdisc *q = &iface->qdisc;
+	struct net_if_qdisc_class *cl = &q->classes[tc];
+
+	if (qdisc_bypass(q, tc)) {
+		atomic_inc(&q->bypassed);
+
+		net_if_tx(iface, pkt);
+
+		atomic_clear(&q->owner);
+		qdisc_kick(q);
+		return;
+	}
+
+	if (!class_push(cl, pkt)) {
+		NET_DBG("TC %d queue full, dropping pkt %p", tc, pkt);
+		atomic_inc(&cl->dropped);
+		net_pkt_unref(pkt);
+		return;
+	}
+
+	atomic_inc(&cl->queued);
+
+	net_tc_submit_work_to_tx_queue(tc, &cl->work);
+}
+
+void net_if_qdisc_init(struct net_if *iface)
+{
+	struct net_if_qdisc *q = &iface->qdisc;
+	int tc, i;
+
+	for (tc = 0; tc < NET_TC_TX_COUNT; tc++) {
+		struct net_if_qdisc_class *cl = &q->classes[tc];
+
+		for (i = 0; i < QDISC_LEN; i++) {
+			atomic_set(&cl->slots[i].seq, i);
+		}
+
+		cl->tc = tc;
+		k_work_init(&cl->work, qdisc_run);
+	}
+}
@@ -36,6 +36,7 @@ LOG_MODULE_REGISTER(net_shell, LOG_LEVEL_DBG);
 #endif
 
 #include "ipv6.h"
+#include "ipv4.h"
 
 #if defined(CONFIG_NET_ARP)
 #include "ethernet/arp.h"
@@ -267,6 +268,28 @@ static void print_supported_ethernet_capabilities(
 }
 #endif /* CONFIG_NET_L2_ETHERNET */
 
+#if defined(CONFIG_NET_TX_QDISC)
+static void print_qdisc(const struct shell *shell, struct net_if *iface)
+{
+	struct net_if_qdisc *q = &iface->qdisc;
+	int i;
+
+	PR("TX queues : %s, %d pkts bypassed\n",
+	   IS_ENABLED(CONFIG_NET_TX_QDISC_WFQ) ? "weighted fair" :
+	   "strict priority", atomic_get(&q->bypassed));
+	PR("TC  Queued\tDropped\tDepth\n");
+
+	for (i = 0; i < NET_TC_TX_COUNT; i++) {
+		struct net_if_qdisc_class *cl = &q->classes[i];
+
+		PR("[%d] %d\t\t%d\t%u\n", i, atomic_get(&cl->queued),
+		   atomic_get(&cl->dropped),
+		   (u32_t)atomic_get(&cl->tail) -
+		   (u32_t)atomic_get(&cl->head));
+	}
+}
+#endif /* CONFIG_NET_TX_QDISC */
+
 static void iface_cb(struct net_if *iface, void *user_data)
 {
 #if defined(CONFIG_NET_NATIVE)
@@ -319,6 +342,10 @@ static void iface_cb(struct net_if *iface, void *user_data)
 
 	PR("MTU       : %d\n", net_if_get_mtu(iface));
 
+#if defined(CONFIG_NET_TX_QDISC)
+	print_qdisc(shell, iface);
+#endif
+
 #if defined(CONFIG_NET_L2_ETHERNET_MGMT)
 	count = 0;
 	ret = net_mgmt(NET_REQUEST_ETHERNET_GET_PRIORITY_QUEUES_NUM,
@@ -1242,6 +1269,43 @@ static void ipv6_frag_cb(struct net_ipv6_reassembly *reass,
 }
 #endif /* CONFIG_NET_IPV6_FRAGMENT */
 
+#if defined(CONFIG_NET_IPV4_FRAGMENT)
+static void ipv4_frag_cb(struct net_ipv4_reassembly *reass,
+			 void *user_data)
+{
+	struct net_shell_user_data *data = user_data;
+	const struct shell *shell = data->shell;
+	int *count = data->user_data;
+	char src[NET_IPV4_ADDR_LEN];
+	int i;
+
+	if (!*count) {
+		PR("\nIPv4 reassembly Reassembled Timeouts Dropped\n");
+	}
+
+	PR("%p      %11u %8u %7u\n", reass, reass->reassembled,
+	   reass->timeouts, reass->dropped);
+
+	(*count)++;
+
+	if (!reass->pkt[0]) {
+		return;
+	}
+
+	snprintk(src, sizeof(src), "%s", net_sprint_ipv4_addr(&reass->src));
+
+	PR("    Id 0x%04x remain %d ms %s -> %s\n", reass->id,
+	   k_delayed_work_remaining_get(&reass->timer),
+	   src, net_sprint_ipv4_addr(&reass->dst));
+
+	for (i = 0; i < CONFIG_NET_IPV4_FRAGMENT_MAX_PKT && reass->pkt[i];
+	     i++) {
+		PR("    [%d] pkt %p offset %u len %zd\n", i, reass->pkt[i],
+		   reass->offset[i], net_pkt_get_len(reass->pkt[i]));
+	}
+}
+#endif /* CONFIG_NET_IPV4_FRAGMENT */
+
 #if defined(CONFIG_NET_DEBUG_NET_PKT_ALLOC)
 static void allocs_cb(struct net_pkt *pkt,
 		      struct net_buf *buf,
@@ -1466,6 +1530,12 @@ static int cmd_net_conn(const struct shell *shell, size_t argc, char *argv[])
 	/* Do not print anything if no fragments are pending atm */
 #endif
 
+#if defined(CONFIG_NET_IPV4_FRAGMENT)
+	count = 0;
+
+	net_ipv4_frag_foreach(ipv4_frag_cb, &user_data);
+#endif
+
 #else
 	PR_INFO("Set %s to enable %s support.\n",
 		"CONFIG_NET_OFFLOAD or CONFIG_NET_NATIVE",
@@ -2634,6 +2704,27 @@ static void context_info(struct net_context *context, void *user_data)
 }
 #endif /* CONFIG_NET_OFFLOAD || CONFIG_NET_NATIVE */
 
+#if defined(CONFIG_NET_BUF_CLASS_DATA_SIZE)
+static void print_data_classes(const struct shell *shell, const char *name,
+			       struct net_buf_pool *pool)
+{
+	const struct net_buf_pool_class *pc = net_buf_pool_classes(pool);
+	int i;
+
+	for (i = 0; i < pc->count; i++) {
+		struct net_buf_data_class *data_class = pc->classes[i];
+
+		PR("%s\t%u\t%u\t%u\t%d\t%d\t%d\t%u%%\n", name,
+		   data_class->size, data_class->slab->num_blocks,
+		   k_mem_slab_num_free_get(data_class->slab),
+		   atomic_get(&data_class->allocs),
+		   atomic_get(&data_class->fallbacks),
+		   atomic_get(&data_class->failures),
+		   net_buf_data_class_efficiency(data_class));
+	}
+}
+#endif /* CONFIG_NET_BUF_CLASS_DATA_SIZE */
+
 static int cmd_net_mem(const struct shell *shell, size_t argc, char *argv[])
 {
 	ARG_UNUSED(argc);
@@ -2676,6 +2767,14 @@ static int cmd_net_mem(const struct shell *shell, size_t argc, char *argv[])
 		"CONFIG_NET_BUF_POOL_USAGE", "net_buf allocation");
 #endif /* CONFIG_NET_BUF_POOL_USAGE */
 
+#if defined(CONFIG_NET_BUF_CLASS_DATA_SIZE)
+	PR("\nData classes:\n");
+	PR("Pool\tSize\tTotal\tAvail\tAllocs\tFallbk\tFailed\tEfficiency\n");
+
+	print_data_classes(shell, "RX", rx_data);
+	print_data_classes(shell, "TX", tx_data);
+#endif
+
 	if (IS_ENABLED(CONFIG_NET_CONTEXT_NET_PKT_POOL)) {
 		struct net_shell_user_data user_data;
 		struct ctx_info info;
@@ -48,6 +48,11 @@ static inline void net_stats_update_ip_errors_vhlerr(struct net_if *iface)
 	UPDATE_STAT(iface, stats.ip_errors.vhlerr++);
 }
 
+static inline void net_stats_update_ip_errors_fragerr(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.ip_errors.fragerr++);
+}
+
 static inline void net_stats_update_bytes_recv(struct net_if *iface,
 					       u32_t bytes)
 {
@@ -63,6 +68,7 @@ static inline void net_stats_update_bytes_sent(struct net_if *iface,
 #define net_stats_update_processing_error(iface)
 #define net_stats_update_ip_errors_protoerr(iface)
 #define net_stats_update_ip_errors_vhlerr(iface)
+#define net_stats_update_ip_errors_fragerr(iface)
 #define net_stats_update_bytes_recv(iface, bytes)
 #define net_stats_update_bytes_sent(iface, bytes)
 #endif /* CONFIG_NET_STATISTICS */
@@ -38,11 +38,30 @@ void net_tc_submit_to_tx_queue(u8_t tc, struct net_pkt *pkt)
 	k_work_submit_to_queue(&tx_classes[tc].work_q, net_pkt_work(pkt));
 }
 
+#if defined(CONFIG_NET_TX_QDISC)
+void net_tc_submit_work_to_tx_queue(u8_t tc, struct k_work *work)
+{
+	k_work_submit_to_queue(&tx_classes[tc].work_q, work);
+}
+
+int net_tc_tx_thread_priority(u8_t tc)
+{
+	return k_thread_priority_get(&tx_classes[tc].work_q.thread);
+}
+#endif
+
 void net_tc_submit_to_rx_queue(u8_t tc, struct net_pkt *pkt)
 {
 	k_work_submit_to_queue(&rx_classes[tc].work_q, net_pkt_work(pkt));
 }
 
+#if defined(CONFIG_NET_RX_BATCH)
+void net_tc_submit_work_to_rx_queue(u8_t tc, struct k_work *work)
+{
+	k_work_submit_to_queue(&rx_classes[tc].work_q, work);
+}
+#endif
+
 int net_tx_priority2tc(enum net_priority prio)
 {
 	if (prio > NET_PRIORITY_NC) {
@@ -36,7 +36,7 @@ LOG_MODULE_REGISTER(net_route, CONFIG_NET_ROUTE_LOG_LEVEL);
 /* We keep track of the routes in a separate list so that we can remove
  * the oldest routes (at tail) if needed.
  */
-static sys_slist_t routes;
+static sys_dlist_t routes = SYS_DLIST_STATIC_INIT(&routes);
 
 static void net_route_nexthop_remove(struct net_nbr *nbr)
 {
@@ -253,12 +253,202 @@ static int nbr_nexthop_put(struct net_nbr *nbr)
 /* Route was accessed, so place it in front of the routes list */
 static inline void update_route_access(struct net_route_entry *route)
 {
-	sys_slist_find_and_remove(&routes, &route->node);
-	sys_slist_prepend(&routes, &route->node);
+	sys_dlist_remove(&route->node);
+	sys_dlist_prepend(&routes, &route->node);
 }
 
-struct net_route_entry *net_route_lookup(struct net_if *iface,
-					 struct in6_addr *dst)
+#if defined(CONFIG_NET_ROUTE_TRIE)
+/* The routes are indexed by a path compressed binary trie over their
+ * prefixes. Every node either holds the routes for its prefix, or
+ * branches to two children, so the trie needs at most 2 * N - 1 nodes
+ * for N routes.
+ */
+struct route_trie_node {
+	struct route_trie_node *child[2];
+	sys_slist_t routes;
+	struct in6_addr prefix;
+	u8_t len;
+};
+
+static struct route_trie_node trie_nodes[2 * CONFIG_NET_MAX_ROUTES];
+static struct route_trie_node *trie_free;
+static struct route_trie_node *trie_root;
+
+static inline int addr_bit(const struct in6_addr *addr, u8_t bit)
+{
+	return (addr->s6_addr[bit / 8] >> (7 - bit % 8)) & 1;
+}
+
+/* Number of leading bits, up to max, that the addresses have in common */
+static u8_t common_len(const struct in6_addr *addr1,
+		       const struct in6_addr *addr2, u8_t max)
+{
+	u8_t len = 0U;
+	int i;
+
+	for (i = 0; i < sizeof(struct in6_addr) && len < max; i++) {
+		u8_t diff = addr1->s6_addr[i] ^ addr2->s6_addr[i];
+
+		if (diff) {
+			len += __builtin_clz(diff) - 24;
+			break;
+		}
+
+		len += 8U;
+	}
+
+	return MIN(len, max);
+}
+
+static struct route_trie_node *trie_node_alloc(const struct in6_addr *addr,
+					       u8_t len)
+{
+	struct route_trie_node *node = trie_free;
+
+	NET_ASSERT(node, "Route trie nodes exhausted");
+
+	trie_free = node->child[0];
+
+	node->child[0] = NULL;
+	node->child[1] = NULL;
+	sys_slist_init(&node->routes);
+	node->len = len;
+
+	(void)memset(&node->prefix, 0, sizeof(node->prefix));
+	memcpy(&node->prefix, addr, len / 8U);
+
+	if (len % 8U) {
+		node->prefix.s6_addr[len / 8U] = addr->s6_addr[len / 8U] &
+			(u8_t)(0xff << (8 - len % 8U));
+	}
+
+	return node;
+}
+
+static void trie_node_free(struct route_trie_node *node)
+{
+	node->child[0] = trie_free;
+	trie_free = node;
+}
+
+static void route_trie_add(struct net_route_entry *route)
+{
+	struct route_trie_node **link = &trie_root;
+	struct route_trie_node *node = trie_root;
+	struct route_trie_node *leaf, *branch;
+	u8_t len = route->prefix_len;
+	u8_t common = 0U;
+
+	while (node) {
+		common = common_len(&node->prefix, &route->addr,
+				    MIN(node->len, len));
+		if (common < node->len) {
+			break;
+		}
+
+		if (node->len == len) {
+			sys_slist_append(&node->routes, &route->trie_node);
+			return;
+		}
+
+		link = &node->child[addr_bit(&route->addr, node->len)];
+		node = *link;
+	}
+
+	leaf = trie_node_alloc(&route->addr, len);
+	sys_slist_append(&leaf->routes, &route->trie_node);
+
+	if (!node) {
+		*link = leaf;
+		return;
+	}
+
+	if (common == len) {
+		/* The new prefix covers the one of the node */
+		leaf->child[addr_bit(&node->prefix, len)] = node;
+		*link = leaf;
+		return;
+	}
+
+	/* The prefixes diverge, so branch where they do */
+	branch = trie_node_alloc(&route->addr, common);
+	branch->child[addr_bit(&route->addr, common)] = leaf;
+	branch->child[addr_bit(&node->prefix, common)] = node;
+	*link = branch;
+}
+
+static void route_trie_del(struct net_route_entry *route)
+{
+	struct route_trie_node **link = &trie_root, **parent_link = NULL;
+	struct route_trie_node *node = trie_root;
+	struct route_trie_node *child, *parent;
+
+	while (node && node->len < route->prefix_len) {
+		parent_link = link;
+		link = &node->child[addr_bit(&route->addr, node->len)];
+		node = *link;
+	}
+
+	if (!node || node->len != route->prefix_len ||
+	    !sys_slist_find_and_remove(&node->routes, &route->trie_node)) {
+		return;
+	}
+
+	if (!sys_slist_is_empty(&node->routes) ||
+	    (node->child[0] && node->child[1])) {
+		return;
+	}
+
+	/* A node without routes is only kept for branching */
+	child = node->child[0] ? node->child[0] : node->child[1];
+	*link = child;
+	trie_node_free(node);
+
+	if (child || !parent_link) {
+		return;
+	}
+
+	/* The parent lost a child, so it might not branch anymore */
+	parent = *parent_link;
+	if (sys_slist_is_empty(&parent->routes)) {
+		*parent_link = parent->child[0] ? parent->child[0] :
+						  parent->child[1];
+		trie_node_free(parent);
+	}
+}
+
+static struct net_route_entry *route_find(struct net_if *iface,
+					  struct in6_addr *dst)
+{
+	struct route_trie_node *node = trie_root;
+	struct net_route_entry *route, *found = NULL;
+
+	/* The deeper a node, the longer its prefix */
+	while (node && net_ipv6_is_prefix((u8_t *)dst,
+					  (u8_t *)&node->prefix,
+					  node->len)) {
+		SYS_SLIST_FOR_EACH_CONTAINER(&node->routes, route, trie_node) {
+			if (!iface || route->iface == iface) {
+				found = route;
+				break;
+			}
+		}
+
+		if (node->len == 128U) {
+			break;
+		}
+
+		node = node->child[addr_bit(dst, node->len)];
+	}
+
+	return found;
+}
+#else
+#define route_trie_add(...)
+#define route_trie_del(...)
+
+static struct net_route_entry *route_find(struct net_if *iface,
+					  struct in6_addr *dst)
 {
 	struct net_route_entry *route, *found = NULL;
 	u8_t longest_match = 0U;
@@ -286,6 +476,16 @@ struct net_route_entry *net_route_lookup(struct net_if *iface,
 		}
 	}
 
+	return found;
+}
+#endif /* CONFIG_NET_ROUTE_TRIE */
+
+struct net_route_entry *net_route_lookup(struct net_if *iface,
+					 struct in6_addr *dst)
+{
+	struct net_route_entry *found;
+
+	found = route_find(iface, dst);
 	if (found) {
 		net_route_info("Found", found, dst);
 
@@ -353,9 +553,7 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	nbr = nbr_new(iface, addr, prefix_len);
 	if (!nbr) {
 		/* Remove the oldest route and try again */
-		sys_snode_t *last = sys_slist_peek_tail(&routes);
-
-		sys_slist_find_and_remove(&routes, last);
+		sys_dnode_t *last = sys_dlist_peek_tail(&routes);
 
 		route = CONTAINER_OF(last,
 				     struct net_route_entry,
@@ -401,7 +599,8 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	route = net_route_data(nbr);
 	route->iface = iface;
 
-	sys_slist_prepend(&routes, &route->node);
+	sys_dlist_prepend(&routes, &route->node);
+	route_trie_add(route);
 
 	tmp = nbr_nexthop_get(iface, nexthop);
 
@@ -454,13 +653,17 @@ int net_route_del(struct net_route_entry *route)
 	net_mgmt_event_notify(NET_EVENT_IPV6_ROUTE_DEL, route->iface);
 #endif
 
-	sys_slist_find_and_remove(&routes, &route->node);
+	if (sys_dnode_is_linked(&route->node)) {
+		sys_dlist_remove(&route->node);
+	}
 
 	nbr = net_route_get_nbr(route);
 	if (!nbr) {
 		return -ENOENT;
 	}
 
+	route_trie_del(route);
+
 	net_route_info("Deleted", route, &route->addr);
 
 	SYS_SLIST_FOR_EACH_CONTAINER(&route->nexthop, nexthop_route, node) {
@@ -845,6 +1048,14 @@ int net_route_packet_if(struct net_pkt *pkt, struct net_if *iface)
 
 void net_route_init(void)
 {
+#if defined(CONFIG_NET_ROUTE_TRIE)
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(trie_nodes); i++) {
+		trie_node_free(&trie_nodes[i]);
+	}
+#endif
+
 	NET_DBG("Allocated %d routing entries (%zu bytes)",
 		CONFIG_NET_MAX_ROUTES, sizeof(net_route_entries_pool));
 
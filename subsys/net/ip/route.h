@@ -15,6 +15,7 @@
 
 #include <kernel.h>
 #include <sys/slist.h>
+#include <sys/dlist.h>
 
 #include <net/net_ip.h>
 
@@ -46,7 +47,14 @@ struct net_route_entry {
 	 * we can remove it if we run out of available routes.
 	 * The oldest one is the last entry in the list.
 	 */
-	sys_snode_t node;
+	sys_dnode_t node;
+
+#if defined(CONFIG_NET_ROUTE_TRIE)
+	/** Node in the list of routes for the same prefix in the lookup
+	 * trie.
+	 */
+	sys_snode_t trie_node;
+#endif
 
 	/** List of neighbors that the routes go through. */
 	sys_slist_t nexthop;
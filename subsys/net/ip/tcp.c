@@ -804,6 +804,22 @@ const char *net_tcp_state_str(enum net_tcp_state state)
 	return "";
 }
 
+/* Payload that fits in the MTU along with the IP and TCP headers */
+static u16_t gso_mss(struct net_context *context)
+{
+	u16_t mtu = net_if_get_mtu(net_context_get_iface(context));
+	u16_t hdr_len;
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) &&
+	    net_context_get_family(context) == AF_INET6) {
+		hdr_len = NET_IPV6TCPH_LEN;
+	} else {
+		hdr_len = NET_IPV4TCPH_LEN;
+	}
+
+	return mtu > hdr_len ? mtu - hdr_len : 0;
+}
+
 int net_tcp_queue_data(struct net_context *context, struct net_pkt *pkt)
 {
 	struct net_conn *conn = (struct net_conn *)context->conn_handler;
@@ -821,6 +837,15 @@ int net_tcp_queue_data(struct net_context *context, struct net_pkt *pkt)
 		return -ESHUTDOWN;
 	}
 
+	if (IS_ENABLED(CONFIG_NET_TCP_GSO) &&
+	    net_if_is_gso_capable(net_pkt_iface(pkt))) {
+		u16_t mss = gso_mss(context);
+
+		if (data_len > mss) {
+			net_pkt_set_gso_size(pkt, mss);
+		}
+	}
+
 	/* Set PSH on all packets, our window is so small that there's
 	 * no point in the remote side trying to finesse things and
 	 * coalesce packets.
@@ -905,7 +930,7 @@ int net_tcp_send_pkt(struct net_pkt *pkt)
 	 */
 	net_pkt_set_data(pkt, &tcp_access);
 
-	if (calc_chksum) {
+	if (calc_chksum && !net_pkt_gso_size(pkt)) {
 		net_pkt_cursor_init(pkt);
 		net_pkt_skip(pkt, net_pkt_ip_hdr_len(pkt) +
 			     net_pkt_ip_opts_len(pkt));
@@ -1294,13 +1319,148 @@ int net_tcp_finalize(struct net_pkt *pkt)
 
 	tcp_hdr->chksum = 0U;
 
-	if (net_if_need_calc_tx_checksum(net_pkt_iface(pkt))) {
+	/* Segments of a GSO packet get their own checksum */
+	if (net_if_need_calc_tx_checksum(net_pkt_iface(pkt)) &&
+	    !net_pkt_gso_size(pkt)) {
 		tcp_hdr->chksum = net_calc_chksum_tcp(pkt);
 	}
 
 	return net_pkt_set_data(pkt, &tcp_access);
 }
 
+#if defined(CONFIG_NET_TCP_GSO)
+static struct net_pkt *gso_alloc_segment(struct net_pkt *pkt, size_t len)
+{
+	struct net_pkt *seg;
+
+	seg = net_pkt_alloc_with_buffer(net_pkt_iface(pkt), len, AF_UNSPEC, 0,
+					ALLOC_TIMEOUT);
+	if (!seg) {
+		return NULL;
+	}
+
+	net_pkt_set_family(seg, net_pkt_family(pkt));
+	net_pkt_set_context(seg, net_pkt_context(pkt));
+	net_pkt_set_ip_hdr_len(seg, net_pkt_ip_hdr_len(pkt));
+	net_pkt_set_priority(seg, net_pkt_priority(pkt));
+	net_pkt_set_vlan_tci(seg, net_pkt_vlan_tci(pkt));
+	memcpy(net_pkt_lladdr_src(seg), net_pkt_lladdr_src(pkt),
+	       sizeof(struct net_linkaddr));
+	memcpy(net_pkt_lladdr_dst(seg), net_pkt_lladdr_dst(pkt),
+	       sizeof(struct net_linkaddr));
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET) {
+		net_pkt_set_ipv4_ttl(seg, net_pkt_ipv4_ttl(pkt));
+		net_pkt_set_ipv4_opts_len(seg, net_pkt_ipv4_opts_len(pkt));
+	} else if (IS_ENABLED(CONFIG_NET_IPV6) &&
+		   net_pkt_family(pkt) == AF_INET6) {
+		net_pkt_set_ipv6_hop_limit(seg, net_pkt_ipv6_hop_limit(pkt));
+		net_pkt_set_ipv6_ext_len(seg, net_pkt_ipv6_ext_len(pkt));
+		net_pkt_set_ipv6_hdr_prev(seg, net_pkt_ipv6_hdr_prev(pkt));
+		net_pkt_set_ipv6_next_hdr(seg, net_pkt_ipv6_next_hdr(pkt));
+	}
+
+	return seg;
+}
+
+int net_tcp_gso_segment(struct net_pkt *pkt, net_tcp_gso_cb_t cb,
+			void *user_data)
+{
+	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct net_tcp_hdr);
+	size_t ip_len = net_pkt_ip_hdr_len(pkt) + net_pkt_ip_opts_len(pkt);
+	struct net_pkt_cursor backup;
+	struct net_tcp_hdr *tcp_hdr;
+	size_t hdr_len, offset, len;
+	struct net_pkt *seg;
+	u32_t seq;
+	u8_t flags;
+	int ret = 0;
+	bool ow;
+
+	ow = net_pkt_is_being_overwritten(pkt);
+	net_pkt_cursor_backup(pkt, &backup);
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+
+	if (net_pkt_skip(pkt, ip_len)) {
+		ret = -EMSGSIZE;
+		goto out;
+	}
+
+	tcp_hdr = (struct net_tcp_hdr *)net_pkt_get_data(pkt, &tcp_access);
+	if (!tcp_hdr) {
+		ret = -EMSGSIZE;
+		goto out;
+	}
+
+	hdr_len = ip_len + NET_TCP_HDR_LEN(tcp_hdr);
+	seq = sys_get_be32(tcp_hdr->seq);
+	flags = tcp_hdr->flags;
+	len = net_pkt_get_len(pkt) - hdr_len;
+
+	for (offset = 0; offset < len; offset += net_pkt_gso_size(pkt)) {
+		size_t seg_len = MIN(net_pkt_gso_size(pkt), len - offset);
+		struct net_tcp_hdr *seg_hdr;
+
+		seg = gso_alloc_segment(pkt, hdr_len + seg_len);
+		if (!seg) {
+			ret = -ENOMEM;
+			goto out;
+		}
+
+		net_pkt_cursor_init(pkt);
+
+		if (net_pkt_copy(seg, pkt, hdr_len) ||
+		    net_pkt_skip(pkt, offset) ||
+		    net_pkt_copy(seg, pkt, seg_len)) {
+			ret = -ENOBUFS;
+			goto fail;
+		}
+
+		net_pkt_cursor_init(seg);
+		net_pkt_set_overwrite(seg, true);
+		net_pkt_skip(seg, ip_len);
+
+		seg_hdr = (struct net_tcp_hdr *)net_pkt_get_data(seg,
+								 &tcp_access);
+		if (!seg_hdr) {
+			ret = -ENOBUFS;
+			goto fail;
+		}
+
+		sys_put_be32(seq + offset, seg_hdr->seq);
+
+		/* PSH and FIN belong to the end of the data */
+		if (offset + seg_len < len) {
+			seg_hdr->flags = flags & ~(NET_TCP_PSH | NET_TCP_FIN);
+		}
+
+		net_pkt_set_data(seg, &tcp_access);
+
+		ret = finalize_segment(seg);
+		if (ret < 0) {
+			goto fail;
+		}
+
+		ret = cb(seg, user_data);
+		if (ret < 0) {
+			goto fail;
+		}
+	}
+
+	ret = 0;
+	goto out;
+
+fail:
+	net_pkt_unref(seg);
+out:
+	net_pkt_cursor_restore(pkt, &backup);
+	net_pkt_set_overwrite(pkt, ow);
+
+	return ret;
+}
+#endif /* CONFIG_NET_TCP_GSO */
+
 int net_tcp_parse_opts(struct net_pkt *pkt, int opt_totlen,
 		       struct net_tcp_options *opts)
 {
@@ -7,7 +7,6 @@
 #include <logging/log.h>
 LOG_MODULE_REGISTER(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
 
-#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <zephyr.h>
@@ -20,15 +19,22 @@ LOG_MODULE_REGISTER(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
 
 static int tcp_rto = CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT;
 static int tcp_retries = 3;
-static int tcp_window = NET_IPV6_MTU;
+static int tcp_window = CONFIG_NET_TCP_WINDOW_SIZE;
 static bool tcp_echo;
+static bool tcp_sack = IS_ENABLED(CONFIG_NET_TCP_SACK);
+static bool tcp_wscale = true;
 
 static sys_slist_t tcp_conns = SYS_SLIST_STATIC_INIT(&tcp_conns);
 
 static K_MEM_SLAB_DEFINE(tcp_conns_slab, sizeof(struct tcp),
 				CONFIG_NET_MAX_CONTEXTS, 4);
 
-NET_BUF_POOL_DEFINE(tcp_nbufs, 64/*count*/, CONFIG_NET_BUF_DATA_SIZE, 0, NULL);
+/* At least the send buffers of two connections */
+#define TCP_NBUFS_COUNT MAX(64, 2 * CONFIG_NET_TCP_WINDOW_SIZE / \
+			    CONFIG_NET_BUF_DATA_SIZE)
+
+NET_BUF_POOL_DEFINE(tcp_nbufs, TCP_NBUFS_COUNT, CONFIG_NET_BUF_DATA_SIZE, 0,
+		    NULL);
 
 static void tcp_in(struct tcp *conn, struct net_pkt *pkt);
 
@@ -299,6 +305,16 @@ static void tcp_win_free(struct tcp_win *w, const char *name)
 	tcp_free(w);
 }
 
+static void tcp_ooo_flush(struct tcp *conn)
+{
+	struct net_pkt *pkt;
+
+	while ((pkt = tcp_slist(&conn->ooo_queue, get,
+				struct net_pkt, next))) {
+		tcp_pkt_unref(pkt);
+	}
+}
+
 static int tcp_conn_unref(struct tcp *conn)
 {
 	int ref_count = atomic_dec(&conn->ref_count) - 1;
@@ -306,6 +322,9 @@ static int tcp_conn_unref(struct tcp *conn)
 
 	NET_DBG("conn: %p, ref_count=%d", conn, ref_count);
 
+	/* Wake up a sender waiting for space, it checks the state */
+	k_sem_give(&conn->snd_sem);
+
 	if (ref_count) {
 		tp_out(conn->iface, "TP_TRACE", "event", "CONN_DELETE");
 		goto out;
@@ -331,6 +350,10 @@ static int tcp_conn_unref(struct tcp *conn)
 
 	tcp_send_queue_flush(conn);
 
+	k_delayed_work_cancel(&conn->rexmit_timer);
+
+	tcp_ooo_flush(conn);
+
 	tcp_win_free(conn->snd, "SND");
 	tcp_win_free(conn->rcv, "RCV");
 
@@ -478,34 +501,29 @@ static void tcp_win_append(struct tcp *conn, struct tcp_win *win,
 	NET_DBG("%s %zu->%zu byte(s)", name, prev_len, win->len);
 }
 
-static struct net_buf *tcp_win_peek(struct tcp *conn, struct tcp_win *w,
-					const char *name, size_t len)
+/* Drop the first len bytes of the window, once the peer has acked them */
+static void tcp_win_trim(struct tcp_win *w, const char *name, size_t len)
 {
-	size_t total = len;
-	struct net_buf *in, *out;
-	sys_slist_t list;
-
-	sys_slist_init(&list);
-
-	in = tcp_slist(&w->bufs, peek_head, struct net_buf, user_data);
-
-	while (in && total > 0) {
-
-		out = tcp_nbuf_clone(in);
-
-		sys_slist_append(&list, (void *)out);
+	size_t prev_len = w->len, size;
+	struct net_buf *buf;
 
-		total -= out->len;
+	while (len && (buf = tcp_slist(&w->bufs, peek_head, struct net_buf,
+				       user_data))) {
+		size = MIN(len, buf->len);
 
-		NET_DBG("total: %zd, out->len: %hu", total, out->len);
+		if (size == buf->len) {
+			buf = tcp_slist(&w->bufs, get, struct net_buf,
+					user_data);
+			tcp_nbuf_unref(buf);
+		} else {
+			net_buf_pull(buf, size);
+		}
 
-		in = tcp_slist((sys_snode_t *)&in->user_data, peek_next,
-				struct net_buf, user_data);
+		w->len -= size;
+		len -= size;
 	}
 
-	NET_ASSERT(total == 0);
-
-	return (void *)sys_slist_peek_head(&list);
+	NET_DBG("%s %zu->%zu byte(s)", name, prev_len, w->len);
 }
 
 static const char *tcp_conn_state(struct tcp *conn, struct net_pkt *pkt)
@@ -556,6 +574,18 @@ static bool tcp_options_check(void *buf, ssize_t len)
 				goto end;
 			}
 			break;
+		case TCPOPT_SACK_PERM:
+			if (opt_len != 2) {
+				result = false;
+				goto end;
+			}
+			break;
+		case TCPOPT_SACK:
+			if (opt_len < 10 || (opt_len - 2) % 8) {
+				result = false;
+				goto end;
+			}
+			break;
 		default:
 			continue;
 		}
@@ -568,6 +598,48 @@ end:
 	return result;
 }
 
+static void tcp_options_parse(struct tcphdr *th, struct tcp_options *o)
+{
+	u8_t *options = (u8_t *)(th + 1), opt, opt_len;
+	ssize_t len = (th->th_off - 5) * 4;
+	int i;
+
+	if (len <= 0 || false == tcp_options_check(options, len)) {
+		return;
+	}
+
+	for ( ; len >= 2; options += opt_len, len -= opt_len) {
+		opt = options[0];
+		opt_len = (opt == TCPOPT_PAD || opt == TCPOPT_NOP) ?
+			1 : options[1];
+
+		switch (opt) {
+		case TCPOPT_MAXSEG:
+			o->mss = ntohs(UNALIGNED_GET((u16_t *)(options + 2)));
+			break;
+		case TCPOPT_WINDOW:
+			o->wscale = MIN(options[2], TCP_MAX_WSCALE);
+			o->wscale_ok = true;
+			break;
+		case TCPOPT_SACK_PERM:
+			o->sack_ok = true;
+			break;
+		case TCPOPT_SACK:
+			o->sack_count = MIN((opt_len - 2) / 8, TCP_SACK_BLOCKS);
+
+			for (i = 0; i < o->sack_count; i++) {
+				u32_t *p = (u32_t *)(options + 2 + i * 8);
+
+				o->sack[i].start = ntohl(UNALIGNED_GET(p));
+				o->sack[i].end = ntohl(UNALIGNED_GET(p + 1));
+			}
+			break;
+		default:
+			break;
+		}
+	}
+}
+
 static size_t tcp_data_len(struct net_pkt *pkt)
 {
 	struct net_ipv4_hdr *ip = ip_get(pkt);
@@ -582,13 +654,35 @@ static size_t tcp_data_len(struct net_pkt *pkt)
 	return len > 0 ? len : 0;
 }
 
-static size_t tcp_data_get(struct tcp *conn, struct net_pkt *pkt)
+/* Deliver the segment's data from offset off on */
+static size_t tcp_data_get(struct tcp *conn, struct net_pkt *pkt, size_t off)
 {
 	struct net_ipv4_hdr *ip = ip_get(pkt);
 	struct tcphdr *th = th_get(pkt);
-	ssize_t len = tcp_data_len(pkt);
+	size_t hdr_len = sizeof(*ip) + th->th_off * 4 + off;
+	ssize_t len = tcp_data_len(pkt) - off;
+
+	if (len <= 0) {
+		len = 0;
+		goto out;
+	}
+
+	if (conn->context->recv_cb) {
+		struct net_pkt *up = net_pkt_clone(pkt, K_NO_WAIT);
 
-	if (len > 0) {
+		if (up == NULL) {
+			len = 0;
+			goto out;
+		}
+
+		net_pkt_cursor_init(up);
+		net_pkt_set_overwrite(up, true);
+		net_pkt_skip(up, hdr_len);
+
+		net_context_packet_received(
+			(struct net_conn *)conn->context->conn_handler,
+			up, NULL, NULL, conn->recv_user_data);
+	} else {
 		void *buf;
 
 		if (tcp_nbufs_reserve(conn, len) == false) {
@@ -598,7 +692,8 @@ static size_t tcp_data_get(struct tcp *conn, struct net_pkt *pkt)
 
 		buf = tcp_malloc(len);
 
-		net_pkt_skip(pkt, sizeof(*ip) + th->th_off * 4);
+		net_pkt_cursor_init(pkt);
+		net_pkt_skip(pkt, hdr_len);
 
 		net_pkt_read(pkt, buf, len);
 
@@ -609,21 +704,38 @@ static size_t tcp_data_get(struct tcp *conn, struct net_pkt *pkt)
 		}
 
 		tcp_free(buf);
+	}
+out:
+	return len;
+}
+
+/* Merge the out of order queue into SACK blocks */
+static int tcp_ooo_sack(struct tcp *conn, struct tcp_sack *blocks)
+{
+	struct net_pkt *pkt;
+	int n = 0;
 
-		if (conn->context->recv_cb) {
-			struct net_pkt *up = net_pkt_clone(pkt, K_NO_WAIT);
+	SYS_SLIST_FOR_EACH_CONTAINER(&conn->ooo_queue, pkt, next) {
+		u32_t start = th_seq(th_get(pkt));
+		u32_t end = start + tcp_data_len(pkt);
 
-			net_pkt_cursor_init(up);
-			net_pkt_set_overwrite(up, true);
-			net_pkt_skip(up, 40);
+		if (n && seq_le(start, blocks[n - 1].end)) {
+			if (seq_gt(end, blocks[n - 1].end)) {
+				blocks[n - 1].end = end;
+			}
+			continue;
+		}
 
-			net_context_packet_received(
-				(struct net_conn *)conn->context->conn_handler,
-				up, NULL, NULL, conn->recv_user_data);
+		if (n == TCP_SACK_BLOCKS) {
+			break;
 		}
+
+		blocks[n].start = start;
+		blocks[n].end = end;
+		n++;
 	}
-out:
-	return len;
+
+	return n;
 }
 
 static void tcp_adj(struct net_pkt *pkt, int req_len)
@@ -634,9 +746,70 @@ static void tcp_adj(struct net_pkt *pkt, int req_len)
 	ip->len = htons(len);
 }
 
-static struct net_pkt *tcp_pkt_make(struct tcp *conn, u8_t flags)
+static u16_t tcp_mss(struct tcp *conn)
+{
+	u16_t mtu = conn->iface ? net_if_get_mtu(conn->iface) : 0;
+
+	return mtu > 40 ? mtu - 40 : TCP_DEFAULT_MSS;
+}
+
+static size_t tcp_options_make(struct tcp *conn, u8_t flags, u8_t *opts)
+{
+	u8_t *p = opts;
+
+	if (SYN & flags) {
+		*p++ = TCPOPT_MAXSEG;
+		*p++ = 4;
+		UNALIGNED_PUT(htons(tcp_mss(conn)), (u16_t *)p);
+		p += 2;
+
+		if (conn->wscale_ok) {
+			*p++ = TCPOPT_NOP;
+			*p++ = TCPOPT_WINDOW;
+			*p++ = 3;
+			*p++ = conn->rcv_wscale;
+		}
+
+		if (conn->sack_ok) {
+			*p++ = TCPOPT_NOP;
+			*p++ = TCPOPT_NOP;
+			*p++ = TCPOPT_SACK_PERM;
+			*p++ = 2;
+		}
+	} else if ((ACK & flags) && conn->sack_ok) {
+		struct tcp_sack blocks[TCP_SACK_BLOCKS];
+		int i, n = tcp_ooo_sack(conn, blocks);
+
+		if (n) {
+			*p++ = TCPOPT_NOP;
+			*p++ = TCPOPT_NOP;
+			*p++ = TCPOPT_SACK;
+			*p++ = 2 + n * 8;
+		}
+
+		for (i = 0; i < n; i++) {
+			UNALIGNED_PUT(htonl(blocks[i].start), (u32_t *)p);
+			UNALIGNED_PUT(htonl(blocks[i].end), (u32_t *)(p + 4));
+			p += 8;
+		}
+	}
+
+	return p - opts;
+}
+
+static u16_t tcp_win_adv(struct tcp *conn, u8_t flags)
 {
-	const size_t len = 40;
+	/* The window in a SYN is never scaled */
+	u32_t win = (SYN & flags) ? conn->win : conn->win >> conn->rcv_wscale;
+
+	return MIN(win, 0xffff);
+}
+
+static struct net_pkt *tcp_pkt_make(struct tcp *conn, u8_t flags, u32_t seq)
+{
+	u8_t opts[40];
+	size_t opts_len = tcp_options_make(conn, flags, opts);
+	size_t len = 40 + opts_len;
 	struct net_pkt *pkt = tcp_pkt_alloc(len);
 	struct net_ipv4_hdr *ip = ip_get(pkt);
 	struct tcphdr *th = (void *) (ip + 1);
@@ -654,10 +827,12 @@ static struct net_pkt *tcp_pkt_make(struct tcp *conn, u8_t flags)
 	th->th_sport = conn->src->sin.sin_port;
 	th->th_dport = conn->dst->sin.sin_port;
 
-	th->th_off = 5;
+	th->th_off = 5 + opts_len / 4;
 	th->th_flags = flags;
-	th->th_win = htons(conn->win);
-	th->th_seq = htonl(conn->seq);
+	th->th_win = htons(tcp_win_adv(conn, flags));
+	th->th_seq = htonl(seq);
+
+	memcpy(th + 1, opts, opts_len);
 
 	if (ACK & flags) {
 		th->th_ack = htonl(conn->ack);
@@ -668,122 +843,601 @@ static struct net_pkt *tcp_pkt_make(struct tcp *conn, u8_t flags)
 	return pkt;
 }
 
-static u32_t sum(void *data, size_t len)
+static void tcp_csum(struct net_pkt *pkt)
 {
-	u32_t s = 0;
+	struct net_ipv4_hdr *ip = ip_get(pkt);
+	struct tcphdr *th = (void *)(ip + 1);
+
+	net_pkt_set_family(pkt, AF_INET);
+	net_pkt_set_ip_hdr_len(pkt, sizeof(*ip));
+
+	ip->chksum = 0;
+	ip->chksum = net_calc_chksum_ipv4(pkt);
+
+	th->th_sum = 0;
+	th->th_sum = net_calc_chksum_tcp(pkt);
+}
+
+/* Add len bytes of the window, from offset off on, to the packet */
+static bool tcp_chain(struct net_pkt *pkt, struct tcp_win *w, size_t off,
+		      size_t len)
+{
+	struct net_buf *in, *buf;
+	size_t size;
+
+	in = tcp_slist(&w->bufs, peek_head, struct net_buf, user_data);
+
+	for ( ; in && len; in = tcp_slist((sys_snode_t *)&in->user_data,
+					  peek_next, struct net_buf,
+					  user_data)) {
+		if (off >= in->len) {
+			off -= in->len;
+			continue;
+		}
+
+		buf = net_pkt_get_frag(pkt, K_NO_WAIT);
+		if (buf == NULL) {
+			return false;
+		}
 
-	for ( ; len > 1; len -= 2, data = (u8_t *)data + 2) {
-		s += *((u16_t *)data);
+		size = MIN(in->len - off, len);
+		memcpy(net_buf_add(buf, size), in->data + off, size);
+		net_pkt_frag_add(pkt, buf);
+
+		off = 0;
+		len -= size;
 	}
 
-	if (len) {
-		s += *((u8_t *)data);
+	NET_DBG("len=%zu byte(s)", net_pkt_get_len(pkt));
+
+	return len == 0;
+}
+
+static void tcp_out(struct tcp *conn, u8_t flags)
+{
+	struct net_pkt *pkt = tcp_pkt_make(conn, flags, conn->seq);
+
+	tcp_csum(pkt);
+
+	NET_DBG("%s", tcp_th(pkt));
+
+	if (tcp_send_cb) {
+		tcp_send_cb(pkt);
+		goto out;
 	}
 
-	return s;
+	sys_slist_append(&conn->send_queue, &pkt->next);
+
+	tcp_send_process(&conn->send_timer);
+out:
+	return;
 }
 
-static uint16_t cs(int32_t s)
+static void tcp_rexmit_timer_start(struct tcp *conn)
 {
-	return ~((s & 0xFFFF) + (s >> 16));
+	k_delayed_work_submit(&conn->rexmit_timer, K_MSEC(conn->rto));
 }
 
-static void tcp_csum(struct net_pkt *pkt)
+/* Send len bytes of the window from seq on, new or retransmitted */
+static void tcp_out_data(struct tcp *conn, u32_t seq, size_t len)
 {
-	struct net_ipv4_hdr *ip = ip_get(pkt);
-	struct tcphdr *th = (void *)(ip + 1);
-	struct net_buf *buf = pkt->frags;
-	size_t hlen = sizeof(struct net_ipv4_hdr);
-	u16_t len = ntohs(ip->len) - hlen;
-	u32_t s;
-	int i, j = 0;
+	struct net_pkt *pkt;
 
-	ip->chksum = cs(sum(ip, sizeof(*ip)));
+	if (seq == conn->snd_max && conn->rtt_timing == false) {
+		conn->rtt_timing = true;
+		conn->rtt_seq = seq + len;
+		conn->rtt_start = k_uptime_get_32();
+	} else if (conn->rtt_timing && seq_lt(seq, conn->rtt_seq)) {
+		/* Karn's algorithm, retransmissions are not timed */
+		conn->rtt_timing = false;
+	}
 
-	s = sum(&ip->src, sizeof(struct in_addr) * 2);
-	s += ntohs(ip->proto + len);
+	if (seq_gt(seq + len, conn->snd_max)) {
+		conn->snd_max = seq + len;
+	}
 
-	th->th_sum = 0;
+	if (k_delayed_work_remaining_get(&conn->rexmit_timer) == 0) {
+		tcp_rexmit_timer_start(conn);
+	}
 
-	s += sum(th, buf->len - hlen);
+	pkt = tcp_pkt_make(conn, PSH | ACK, seq);
 
-	SYS_SLIST_FOR_EACH_CONTAINER((sys_slist_t *)&buf->node, buf, node) {
+	if (tcp_chain(pkt, conn->snd, seq - conn->snd_una, len) == false) {
+		/* Left to the retransmission timer */
+		tcp_pkt_unref(pkt);
+		goto out;
+	}
 
-		for (i = 0; i < buf->len; i++, j++) {
+	tcp_adj(pkt, len);
 
-			s += (j % 2) ? buf->data[i] << 8 : buf->data[i];
+	tcp_csum(pkt);
+
+	if (tcp_send_cb) {
+		tcp_send_cb(pkt);
+		goto out;
+	}
+
+	tcp_send(pkt);
+out:
+	return;
+}
+
+/* Add a block to the scoreboard, which is kept sorted and merged */
+static void tcp_sack_add(struct tcp *conn, u32_t start, u32_t end)
+{
+	struct tcp_sack *sb = conn->sack;
+	int i = 0, n = conn->sack_count;
+
+	if (seq_lt(start, conn->snd_una)) {
+		start = conn->snd_una;
+	}
+
+	if (seq_ge(start, end) || seq_gt(end, conn->snd_max)) {
+		return;
+	}
+
+	while (i < n) {
+		if (seq_lt(sb[i].end, start)) {
+			i++;
+			continue;
 		}
+
+		if (seq_lt(end, sb[i].start)) {
+			break;
+		}
+
+		if (seq_lt(sb[i].start, start)) {
+			start = sb[i].start;
+		}
+
+		if (seq_gt(sb[i].end, end)) {
+			end = sb[i].end;
+		}
+
+		memmove(&sb[i], &sb[i + 1], (n - i - 1) * sizeof(*sb));
+		n--;
 	}
 
-	th->th_sum = cs(s);
+	if (n == TCP_SACK_SCOREBOARD) {
+		if (i == n) {
+			return;
+		}
+		n--; /* Forget the highest block */
+	}
+
+	memmove(&sb[i + 1], &sb[i], (n - i) * sizeof(*sb));
+	sb[i].start = start;
+	sb[i].end = end;
+
+	conn->sack_count = n + 1;
 }
 
-static void tcp_chain_free(struct net_buf *head)
+/* Forget the blocks below snd_una */
+static void tcp_sack_trim(struct tcp *conn)
 {
-	struct net_buf *next;
+	struct tcp_sack *sb = conn->sack;
+	int i = 0, n = conn->sack_count;
 
-	for ( ; head; head = next) {
-		next = head->frags;
-		head->frags = NULL;
-		tcp_nbuf_unref(head);
+	while (i < n && seq_le(sb[i].end, conn->snd_una)) {
+		i++;
+	}
+
+	memmove(sb, &sb[i], (n - i) * sizeof(*sb));
+	conn->sack_count = n - i;
+
+	if (conn->sack_count && seq_lt(sb[0].start, conn->snd_una)) {
+		sb[0].start = conn->snd_una;
 	}
 }
 
-static void tcp_chain(struct net_pkt *pkt, struct net_buf *head)
+/* SACKed bytes below seq */
+static u32_t tcp_sacked(struct tcp *conn, u32_t seq)
 {
-	struct net_buf *buf;
+	u32_t sacked = 0;
+	int i;
 
-	for ( ; head; head = head->frags) {
-		buf = net_pkt_get_frag(pkt, K_NO_WAIT);
-		memcpy(net_buf_add(buf, head->len), head->data, head->len);
-		NET_DBG("+%hu", head->len);
-		net_pkt_frag_add(pkt, buf);
+	for (i = 0; i < conn->sack_count; i++) {
+		struct tcp_sack *sb = &conn->sack[i];
+
+		if (seq_le(seq, sb->start)) {
+			break;
+		}
+
+		sacked += (seq_lt(seq, sb->end) ? seq : sb->end) - sb->start;
 	}
 
-	NET_DBG("len=%zu byte(s)", net_pkt_get_len(pkt));
+	return sacked;
 }
 
-static void tcp_out(struct tcp *conn, u8_t flags, ...)
+/* Data in flight during SACK recovery (RFC 6675), the holes below the
+ * highest SACKed byte are taken as lost until they are retransmitted
+ */
+static u32_t tcp_pipe(struct tcp *conn)
 {
-	struct net_pkt *pkt = tcp_pkt_make(conn, flags);
+	u32_t high = conn->sack_count ?
+		conn->sack[conn->sack_count - 1].end : conn->snd_una;
+	u32_t rxt = seq_lt(conn->rexmit_next, high) ? conn->rexmit_next : high;
 
-	if (PSH & flags) {
-		size_t len = conn->snd->len;
-		struct net_buf *buf = tcp_win_peek(conn, conn->snd, "SND", len);
+	return (conn->snd_max - high) + (rxt - conn->snd_una) -
+		tcp_sacked(conn, rxt);
+}
 
-		{
-			va_list ap;
-			ssize_t *out_len;
+/* The next hole to retransmit during SACK recovery */
+static bool tcp_sack_hole(struct tcp *conn, u32_t *seq, size_t *len)
+{
+	u32_t next = conn->rexmit_next;
+	int i;
+
+	for (i = 0; i < conn->sack_count; i++) {
+		if (seq_lt(next, conn->sack[i].start)) {
+			*seq = next;
+			*len = MIN(conn->sack[i].start - next, conn->mss);
+			return true;
+		}
 
-			va_start(ap, flags);
-			out_len = va_arg(ap, ssize_t *);
-			*out_len = len;
-			va_end(ap);
+		if (seq_lt(next, conn->sack[i].end)) {
+			next = conn->sack[i].end;
 		}
+	}
+
+	return false;
+}
+
+/* Send as much as the congestion window and the peer's receive window
+ * allow, the holes first during SACK recovery
+ */
+static void tcp_send_data(struct tcp *conn)
+{
+	u32_t seq, flight, cwnd;
+	size_t len;
+
+	while (true) {
+		bool sack_recovery = conn->in_recovery && conn->sack_ok;
+
+		/* Limited transmit of new data on the first dupacks keeps
+		 * the ACK clock of a small window running, RFC 3042
+		 */
+		cwnd = conn->cwnd;
+		if (conn->in_recovery == false) {
+			cwnd += MIN(conn->dup_acks, 2) * conn->mss;
+		}
+
+		if (sack_recovery && tcp_sack_hole(conn, &seq, &len)) {
+			if (tcp_pipe(conn) + len > conn->cwnd) {
+				break;
+			}
 
-		tcp_chain(pkt, buf);
+			conn->rexmit_next = seq + len;
+			tcp_out_data(conn, seq, len);
+			continue;
+		}
 
-		tcp_chain_free(buf);
+		flight = conn->seq - conn->snd_una;
+		len = MIN(conn->snd->len - flight, conn->mss);
 
-		tcp_adj(pkt, len);
+		if (flight == 0) { /* A window smaller than a segment */
+			len = MIN(len, conn->snd_wnd);
+		}
+
+		if (len == 0 || flight + len > conn->snd_wnd ||
+		    (sack_recovery ? tcp_pipe(conn) : flight) + len > cwnd) {
+			break;
+		}
+
+		seq = conn->seq;
+		conn_seq(conn, + len);
+		tcp_out_data(conn, seq, len);
 	}
 
-	tcp_csum(pkt);
+	/* Also probes a zero window */
+	if (conn->snd->len &&
+	    k_delayed_work_remaining_get(&conn->rexmit_timer) == 0) {
+		tcp_rexmit_timer_start(conn);
+	}
+}
 
-	NET_DBG("%s", tcp_th(pkt));
+static void tcp_rtt_update(struct tcp *conn, u32_t rtt)
+{
+	if (conn->srtt == 0) {
+		conn->srtt = rtt;
+		conn->rttvar = rtt / 2;
+	} else {
+		u32_t delta = conn->srtt > rtt ?
+			conn->srtt - rtt : rtt - conn->srtt;
 
-	if (tcp_send_cb) {
-		tcp_send_cb(pkt);
+		conn->rttvar = (3 * conn->rttvar + delta) / 4;
+		conn->srtt = (7 * conn->srtt + rtt) / 8;
+	}
+
+	conn->rto = MIN(MAX(conn->srtt + 4 * conn->rttvar, TCP_RTO_MIN),
+			TCP_RTO_MAX);
+
+	NET_DBG("rtt: %u, srtt: %u, rttvar: %u, rto: %u", rtt, conn->srtt,
+		conn->rttvar, conn->rto);
+}
+
+static void tcp_dup_ack(struct tcp *conn)
+{
+	u32_t flight = conn->snd_max - conn->snd_una;
+	u32_t seq = conn->snd_una;
+	size_t len = MIN(flight, conn->mss);
+
+	if (conn->in_recovery) {
+		if (conn->sack_ok == false) {
+			conn->cwnd += conn->mss; /* Inflate, RFC 6582 */
+		}
+		return;
+	}
+
+	/* No new recovery for the losses of the previous window */
+	if (seq_le(conn->snd_una, conn->recover)) {
+		return;
+	}
+
+	/* With SACK, a hole is also lost once three segments above it
+	 * have arrived, which small windows reach before three dupacks
+	 * (RFC 6675 IsLost)
+	 */
+	if (++conn->dup_acks < 3 && !(conn->sack_ok &&
+		tcp_sacked(conn, conn->snd_max) >= 3 * conn->mss)) {
+		return;
+	}
+
+	NET_DBG("fast retransmit, flight: %u, cwnd: %u", flight, conn->cwnd);
+
+	conn->ssthresh = MAX(flight / 2, 2 * conn->mss);
+	conn->cwnd = conn->ssthresh;
+	conn->recover = conn->snd_max;
+	conn->rexmit_next = conn->snd_una;
+	conn->in_recovery = true;
+
+	if (conn->sack_ok) {
+		(void)tcp_sack_hole(conn, &seq, &len);
+	} else {
+		conn->cwnd += 3 * conn->mss;
+	}
+
+	conn->rexmit_next = seq + len;
+	tcp_out_data(conn, seq, len);
+}
+
+static void tcp_ack_in(struct tcp *conn, struct tcphdr *th, size_t len)
+{
+	struct tcp_options opts = { 0 };
+	u32_t ack = th_ack(th), acked;
+	u32_t wnd = th_win(th) << conn->snd_wscale;
+	bool dup = len == 0 && ack == conn->snd_una &&
+		wnd == conn->snd_wnd && conn->snd_una != conn->snd_max;
+	int i;
+
+	if (seq_lt(ack, conn->snd_una) || seq_gt(ack, conn->snd_max)) {
 		goto out;
 	}
 
-	sys_slist_append(&conn->send_queue, &pkt->next);
+	if (conn->sack_ok) {
+		tcp_options_parse(th, &opts);
 
-	tcp_send_process(&conn->send_timer);
+		for (i = 0; i < opts.sack_count; i++) {
+			tcp_sack_add(conn, opts.sack[i].start,
+				     opts.sack[i].end);
+		}
+	}
+
+	conn->snd_wnd = wnd;
+
+	if (ack == conn->snd_una) {
+		if (dup) {
+			tcp_dup_ack(conn);
+		}
+		goto send;
+	}
+
+	acked = ack - conn->snd_una;
+
+	tcp_win_trim(conn->snd, "SND", acked);
+
+	k_sem_give(&conn->snd_sem);
+
+	conn->snd_una = ack;
+
+	if (seq_lt(conn->seq, ack)) {
+		conn_seq(conn, ack - conn->seq);
+	}
+
+	if (seq_lt(conn->rexmit_next, ack)) {
+		conn->rexmit_next = ack;
+	}
+
+	tcp_sack_trim(conn);
+
+	conn->dup_acks = 0;
+	conn->rexmit_retries = 0;
+
+	if (conn->rtt_timing && seq_ge(ack, conn->rtt_seq)) {
+		conn->rtt_timing = false;
+		tcp_rtt_update(conn, k_uptime_get_32() - conn->rtt_start);
+	}
+
+	if (conn->in_recovery) {
+		if (seq_ge(ack, conn->recover)) {
+			conn->in_recovery = false;
+			conn->cwnd = MIN(conn->ssthresh, conn->snd_max -
+					 conn->snd_una + conn->mss);
+		} else if (conn->sack_ok == false) {
+			/* Partial ack, the next segment is lost too */
+			conn->cwnd -= MIN(conn->cwnd, acked);
+			if (acked >= conn->mss) {
+				conn->cwnd += conn->mss;
+			}
+			conn->cwnd = MAX(conn->cwnd, conn->mss);
+
+			tcp_out_data(conn, conn->snd_una,
+				     MIN(conn->snd_max - conn->snd_una,
+					 conn->mss));
+		}
+	} else if (conn->cwnd < conn->ssthresh) {
+		conn->cwnd += MIN(acked, conn->mss); /* Slow start */
+	} else {
+		conn->cwnd += MAX(1U, conn->mss * conn->mss / conn->cwnd);
+	}
+
+	if (conn->snd_una == conn->snd_max) {
+		k_delayed_work_cancel(&conn->rexmit_timer);
+	} else {
+		tcp_rexmit_timer_start(conn);
+	}
+send:
+	tcp_send_data(conn);
 out:
 	return;
 }
 
+static void tcp_rexmit_timeout(struct k_work *work)
+{
+	struct tcp *conn = CONTAINER_OF(work, struct tcp, rexmit_timer);
+	int key = irq_lock();
+	u32_t flight;
+
+	if (conn->state != TCP_ESTABLISHED) {
+		goto out;
+	}
+
+	flight = conn->snd_max - conn->snd_una;
+
+	conn->rto = MIN(conn->rto * 2, TCP_RTO_MAX);
+
+	if (flight == 0) {
+		if (conn->snd->len) { /* Zero window probe */
+			conn_seq(conn, + 1);
+			tcp_out_data(conn, conn->seq - 1, 1);
+		}
+		goto out;
+	}
+
+	if (conn->rexmit_retries++ == CONFIG_NET_TCP_RETRY_COUNT) {
+		tcp_conn_unref(conn);
+		goto out;
+	}
+
+	NET_DBG("rto: %u, flight: %u, cwnd: %u", conn->rto, flight,
+		conn->cwnd);
+
+	conn->ssthresh = MAX(flight / 2, 2 * conn->mss);
+	conn->cwnd = conn->mss;
+	conn->recover = conn->snd_max;
+	conn->in_recovery = false;
+	conn->dup_acks = 0;
+	conn->sack_count = 0;
+
+	/* Go back to the first unacked byte */
+	conn_seq(conn, -(conn->seq - conn->snd_una));
+
+	tcp_send_data(conn);
+out:
+	irq_unlock(key);
+}
+
+/* Negotiate the options of a received SYN or SYN-ACK */
+static void tcp_options_syn(struct tcp *conn, struct tcphdr *th)
+{
+	struct tcp_options opts = { .mss = TCP_DEFAULT_MSS };
+
+	tcp_options_parse(th, &opts);
+
+	conn->mss = opts.mss ? MIN(opts.mss, tcp_mss(conn)) : TCP_DEFAULT_MSS;
+	conn->sack_ok = conn->sack_ok && opts.sack_ok;
+	conn->wscale_ok = conn->wscale_ok && opts.wscale_ok;
+
+	if (conn->wscale_ok) {
+		conn->snd_wscale = opts.wscale;
+	} else {
+		conn->rcv_wscale = 0;
+	}
+
+	conn->snd_wnd = th_win(th);
+}
+
+static void tcp_sender_init(struct tcp *conn)
+{
+	conn->snd_una = conn->seq;
+	conn->snd_max = conn->seq;
+	conn->rexmit_next = conn->seq;
+	conn->recover = conn->seq - 1;
+	/* Initial window, RFC 3390 */
+	conn->cwnd = MIN(4 * conn->mss, MAX(2 * conn->mss, 4380));
+	conn->ssthresh = UINT32_MAX;
+}
+
+/* Queue a segment beyond a hole, in sequence number order */
+static void tcp_ooo_add(struct tcp *conn, struct net_pkt *pkt)
+{
+	u32_t seq = th_seq(th_get(pkt));
+	struct net_pkt *prev = NULL, *cur, *clone;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&conn->ooo_queue, cur, next) {
+		u32_t cur_seq = th_seq(th_get(cur));
+
+		if (cur_seq == seq && tcp_data_len(cur) >= tcp_data_len(pkt)) {
+			return;
+		}
+
+		if (seq_gt(cur_seq, seq)) {
+			break;
+		}
+
+		prev = cur;
+	}
+
+	clone = tcp_pkt_clone(pkt);
+	if (clone == NULL) {
+		return;
+	}
+
+	sys_slist_insert(&conn->ooo_queue, prev ? &prev->next : NULL,
+			 &clone->next);
+}
+
+static void tcp_data_in(struct tcp *conn, struct net_pkt *pkt, size_t len)
+{
+	u32_t seq = th_seq(th_get(pkt));
+	struct net_pkt *next;
+
+	if (seq_gt(seq, conn->ack)) {
+		if (seq_le(seq + len, conn->ack + conn->win)) {
+			tcp_ooo_add(conn, pkt);
+		}
+		goto out;
+	}
+
+	if (seq_le(seq + len, conn->ack)) {
+		goto out; /* peer has resent */
+	}
+
+	conn_ack(conn, + tcp_data_get(conn, pkt, conn->ack - seq));
+
+	/* The segments after the hole may follow now */
+	while ((next = tcp_slist(&conn->ooo_queue, peek_head,
+				 struct net_pkt, next))) {
+		seq = th_seq(th_get(next));
+		len = tcp_data_len(next);
+
+		if (seq_gt(seq, conn->ack)) {
+			break;
+		}
+
+		sys_slist_get(&conn->ooo_queue);
+
+		if (seq_gt(seq + len, conn->ack)) {
+			conn_ack(conn, + tcp_data_get(conn, next,
+						      conn->ack - seq));
+		}
+
+		tcp_pkt_unref(next);
+	}
+out:
+	tcp_out(conn, ACK);
+}
+
 static void tcp_conn_ref(struct tcp *conn)
 {
 	int ref_count = atomic_inc(&conn->ref_count) + 1;
@@ -807,16 +1461,33 @@ static struct tcp *tcp_conn_alloc(void)
 
 	conn->win = tcp_window;
 
+	conn->sack_ok = tcp_sack;
+	conn->wscale_ok = tcp_wscale;
+
+	while (conn->wscale_ok && (conn->win >> conn->rcv_wscale) > 0xffff &&
+	       conn->rcv_wscale < TCP_MAX_WSCALE) {
+		conn->rcv_wscale++;
+	}
+
+	conn->mss = TCP_DEFAULT_MSS;
+	conn->rto = tcp_rto;
+
 	conn->rcv = tcp_win_new();
 	conn->snd = tcp_win_new();
 
+	k_sem_init(&conn->snd_sem, 0, 1);
+
 	sys_slist_init(&conn->send_queue);
 
 	sys_slist_init(&conn->rsv_bufs);
 
+	sys_slist_init(&conn->ooo_queue);
+
 	k_timer_init(&conn->send_timer, tcp_send_process, NULL);
 	k_timer_user_data_set(&conn->send_timer, conn);
 
+	k_delayed_work_init(&conn->rexmit_timer, tcp_rexmit_timeout);
+
 	tcp_conn_ref(conn);
 
 	sys_slist_append(&tcp_conns, (sys_snode_t *)conn);
@@ -1037,6 +1708,7 @@ next_state:
 	case TCP_LISTEN:
 		if (FL(&fl, ==, SYN)) {
 			conn_ack(conn, th_seq(th) + 1); /* capture peer's isn */
+			tcp_options_syn(conn, th);
 			tcp_out(conn, SYN | ACK);
 			conn_seq(conn, + 1);
 			next = TCP_SYN_RECEIVED;
@@ -1050,13 +1722,12 @@ next_state:
 		if (FL(&fl, &, ACK, th_ack(th) == conn->seq &&
 				th_seq(th) == conn->ack)) {
 			tcp_send_timer_cancel(conn);
+			tcp_sender_init(conn);
 			next = TCP_ESTABLISHED;
 			net_context_set_state(conn->context,
 					      NET_CONTEXT_CONNECTED);
 			if (len) {
-				tcp_data_get(conn, pkt);
-				conn_ack(conn, + len);
-				tcp_out(conn, ACK);
+				tcp_data_in(conn, pkt, len);
 			}
 		}
 		break;
@@ -1065,26 +1736,22 @@ next_state:
 		 * ACK , shouldn't we go to SYN RECEIVED state? See Figure
 		 * 6 of RFC 793
 		 */
-		if (FL(&fl, &, ACK, th && th_seq(th) == conn->ack)) {
+		if (FL(&fl, &, ACK, th && th_ack(th) == conn->seq)) {
 			tcp_send_timer_cancel(conn);
 			next = TCP_ESTABLISHED;
 			net_context_set_state(conn->context,
 					      NET_CONTEXT_CONNECTED);
-			if (FL(&fl, &, PSH)) {
-				tcp_data_get(conn, pkt);
-			}
 			if (FL(&fl, &, SYN)) {
 				conn_ack(conn, th_seq(th) + 1);
+				tcp_options_syn(conn, th);
 				tcp_out(conn, ACK);
 			}
+			tcp_sender_init(conn);
 		}
 		break;
 	case TCP_ESTABLISHED:
-		if (!th && conn->snd->len) { /* TODO: Out of the loop */
-			ssize_t data_len;
-
-			tcp_out(conn, PSH | ACK, &data_len);
-			conn_seq(conn, + data_len);
+		if (!th) {
+			tcp_send_data(conn);
 			break;
 		}
 		/* full-close */
@@ -1094,37 +1761,17 @@ next_state:
 			next = TCP_CLOSE_WAIT;
 			break;
 		}
-		if (FL(&fl, &, PSH, th_seq(th) < conn->ack)) {
-			tcp_out(conn, ACK); /* peer has resent */
-			break;
+		if (FL(&fl, &, ACK)) {
+			tcp_ack_in(conn, th, len);
 		}
-		if (FL(&fl, &, PSH, th_seq(th) > conn->ack)) {
-			tcp_out(conn, RST);
-			next = TCP_CLOSED;
-			break;
-		}
-		/* Non piggybacking version for clarity now */
-		if (FL(&fl, &, PSH, th_seq(th) == conn->ack)) {
-			ssize_t len = tcp_data_get(conn, pkt);
-
-			if (len) {
-				conn_ack(conn, + len);
-				tcp_out(conn, ACK);
+		/* Out of order segments are queued and SACKed */
+		if (len) {
+			tcp_data_in(conn, pkt, len);
 
-				if (tcp_echo) { /* TODO: Out of the loop? */
-					tcp_out(conn, PSH, &len);
-					conn_seq(conn, + len);
-				}
-			} else {
-				tcp_out(conn, RST);
-				next = TCP_CLOSED;
-				break;
+			if (tcp_echo) {
+				tcp_send_data(conn);
 			}
 		}
-		if (FL(&fl, ==, ACK, th_ack(th) == conn->seq)) {
-			tcp_win_free(conn->snd, "SND");
-			conn->snd = tcp_win_new();
-		}
 		break; /* TODO: Catch all the rest here */
 	case TCP_CLOSE_WAIT:
 		tcp_out(conn, FIN | ACK);
@@ -1158,18 +1805,53 @@ next_state:
 	}
 }
 
+/* The send buffer holds as much as the receive window */
 static ssize_t _tcp_send(struct tcp *conn, const void *buf, size_t len,
-				int flags)
+			 s32_t timeout)
 {
+	s64_t end = k_uptime_get() + timeout;
 	int x = irq_lock();
+	ssize_t ret;
+
+	/* Keep the connection around while waiting for the acks */
+	tcp_conn_ref(conn);
+
+	while (conn->snd->len >= conn->win) {
+		if (conn->state != TCP_ESTABLISHED &&
+		    conn->state != TCP_CLOSE_WAIT) {
+			ret = -ECONNRESET;
+			goto out;
+		}
+
+		if (timeout != K_FOREVER) {
+			timeout = MAX(end - k_uptime_get(), 0);
+		}
+
+		irq_unlock(x);
+
+		ret = k_sem_take(&conn->snd_sem, timeout);
+
+		x = irq_lock();
+
+		if (ret < 0) {
+			ret = -EAGAIN;
+			goto out;
+		}
+	}
+
+	len = MIN(len, conn->win - conn->snd->len);
 
 	tcp_win_append(conn, conn->snd, "SND", buf, len);
 
 	tcp_in(conn, NULL);
 
+	ret = len;
+out:
 	irq_unlock(x);
 
-	return len;
+	tcp_conn_unref(conn);
+
+	return ret;
 }
 
 /* close() has been called on the socket */
@@ -1206,7 +1888,7 @@ int net_tcp_update_recv_wnd(struct net_context *context, s32_t delta)
 }
 
 int net_tcp_queue(struct net_context *context, const void *buf, size_t len,
-		  const struct msghdr *msghdr)
+		  const struct msghdr *msghdr, s32_t timeout)
 {
 	struct tcp *conn = context->tcp;
 	ssize_t ret = 0;
@@ -1219,18 +1901,29 @@ int net_tcp_queue(struct net_context *context, const void *buf, size_t len,
 	}
 
 	if (msghdr && msghdr->msg_iovlen > 0) {
+		ssize_t queued = 0;
 		int i;
 
 		for (i = 0; i < msghdr->msg_iovlen; i++) {
 			ret = _tcp_send(conn, msghdr->msg_iov[i].iov_base,
-					msghdr->msg_iov[i].iov_len, 0);
+					msghdr->msg_iov[i].iov_len, timeout);
 
 			if (ret < 0) {
 				break;
 			}
+
+			queued += ret;
+
+			if ((size_t)ret < msghdr->msg_iov[i].iov_len) {
+				break;
+			}
+		}
+
+		if (queued) {
+			ret = queued;
 		}
 	} else {
-		ret = _tcp_send(conn, buf, len, 0);
+		ret = _tcp_send(conn, buf, len, timeout);
 	}
 out:
 	NET_DBG("conn: %p, ret: %zd", conn, ret);
@@ -1271,6 +1964,10 @@ int net_tcp_connect(struct net_context *context,
 	struct tcp *conn = context->tcp;
 	int ret;
 
+	conn->src = tcp_calloc(1, sizeof(union tcp_endpoint));
+	conn->dst = tcp_calloc(1, sizeof(union tcp_endpoint));
+	conn->iface = net_context_get_iface(context);
+
 	switch (net_context_get_family(context)) {
 	case AF_INET:
 		net_sin(&conn->src->sa)->sin_port = local_port;
@@ -1475,6 +2172,17 @@ static struct net_buf *tcp_win_pop(struct tcp_win *w, const char *name,
 	return out;
 }
 
+static void tcp_chain_free(struct net_buf *head)
+{
+	struct net_buf *next;
+
+	for ( ; head; head = next) {
+		next = head->frags;
+		head->frags = NULL;
+		tcp_nbuf_unref(head);
+	}
+}
+
 static ssize_t tp_tcp_recv(int fd, void *buf, size_t len, int flags)
 {
 	struct tcp *conn = (void *)sys_slist_peek_head(&tcp_conns);
@@ -1648,6 +2356,9 @@ bool tp_input(struct net_pkt *pkt)
 					TP_INT);
 		tp_new_find_and_apply(tp_new, "tp_trace", &tp_trace, TP_BOOL);
 		tp_new_find_and_apply(tp_new, "tcp_echo", &tcp_echo, TP_BOOL);
+		tp_new_find_and_apply(tp_new, "tcp_sack", &tcp_sack, TP_BOOL);
+		tp_new_find_and_apply(tp_new, "tcp_wscale", &tcp_wscale,
+					TP_BOOL);
 		break;
 	case TP_INTROSPECT_REQUEST:
 		json_len = sizeof(buf);
@@ -90,11 +90,12 @@ int net_tcp_accept(struct net_context *context, net_tcp_accept_cb_t cb,
  * @param buf		Pointer to the data
  * @param len		Number of bytes
  * @param msghdr	Data for a vector array operation
+ * @param timeout	Time to wait for space in the send buffer
  *
- * @return 0 if ok, < 0 if error
+ * @return Number of bytes queued if ok, < 0 if error
  */
 int net_tcp_queue(struct net_context *context, const void *buf, size_t len,
-		  const struct msghdr *msghdr);
+		  const struct msghdr *msghdr, s32_t timeout);
 /* TODO: split into 2 functions, conn -> context, queue -> send? */
 
 /* The following functions are provided solely for the compatibility
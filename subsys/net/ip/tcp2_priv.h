@@ -11,6 +11,7 @@
 
 #define th_seq(_x) ntohl((_x)->th_seq)
 #define th_ack(_x) ntohl((_x)->th_ack)
+#define th_win(_x) ntohs((_x)->th_win)
 #define ip_get(_x) ((struct net_ipv4_hdr *) net_pkt_ip_data((_x)))
 #define ip6_get(_x) ((struct net_ipv6_hdr *) net_pkt_ip_data((_x)))
 
@@ -75,6 +76,11 @@ static struct net_pkt *tcp_pkt_alloc(size_t len)
 #define conn_ack(_conn, _req) (_conn)->ack += (_req)
 #endif
 
+#define seq_lt(_a, _b) ((s32_t)((_a) - (_b)) < 0)
+#define seq_le(_a, _b) ((s32_t)((_a) - (_b)) <= 0)
+#define seq_gt(_a, _b) seq_lt(_b, _a)
+#define seq_ge(_a, _b) seq_le(_b, _a)
+
 #define conn_state(_conn, _s)						\
 ({									\
 	NET_DBG("%s->%s",						\
@@ -87,6 +93,18 @@ static struct net_pkt *tcp_pkt_alloc(size_t len)
 #define TCPOPT_NOP	1
 #define TCPOPT_MAXSEG	2
 #define TCPOPT_WINDOW	3
+#define TCPOPT_SACK_PERM	4
+#define TCPOPT_SACK	5
+
+#define TCP_DEFAULT_MSS 536
+#define TCP_MAX_WSCALE 14
+
+/* SACK blocks in one ACK, 4 fit in the option space without timestamps */
+#define TCP_SACK_BLOCKS 4
+#define TCP_SACK_SCOREBOARD 8
+
+#define TCP_RTO_MIN 200
+#define TCP_RTO_MAX 60000
 
 enum pkt_addr {
 	SRC = 1,
@@ -140,6 +158,20 @@ struct tcp_win { /* TCP window */
 	sys_slist_t bufs;
 };
 
+struct tcp_sack { /* A SACK block, [start, end) */
+	u32_t start;
+	u32_t end;
+};
+
+struct tcp_options { /* Options of a received segment */
+	u16_t mss;
+	u8_t wscale;
+	bool wscale_ok;
+	bool sack_ok;
+	u8_t sack_count;
+	struct tcp_sack sack[TCP_SACK_BLOCKS];
+};
+
 union tcp_endpoint {
 	struct sockaddr sa;
 	struct sockaddr_in sin;
@@ -155,13 +187,42 @@ struct tcp { /* TCP connection */
 	u32_t ack;
 	union tcp_endpoint *src;
 	union tcp_endpoint *dst;
-	u16_t win;
+	u32_t win;
 	struct tcp_win *rcv;
 	struct tcp_win *snd;
+	struct k_sem snd_sem; /* Given when acks free space in snd */
 	struct k_timer send_timer;
 	sys_slist_t send_queue;
 	bool in_retransmission;
 	size_t send_retries;
+	/* Sender, seq is SND.NXT and snd_max the highest sequence sent */
+	u32_t snd_una;
+	u32_t snd_max;
+	u32_t snd_wnd;
+	u32_t cwnd;
+	u32_t ssthresh;
+	u32_t recover;
+	u32_t rexmit_next;
+	u16_t mss;
+	u8_t snd_wscale;
+	u8_t rcv_wscale;
+	u8_t dup_acks;
+	u8_t rexmit_retries;
+	bool wscale_ok;
+	bool sack_ok;
+	bool in_recovery;
+	struct tcp_sack sack[TCP_SACK_SCOREBOARD]; /* peer's SACK blocks */
+	u8_t sack_count;
+	/* RTT estimation (RFC 6298), in milliseconds */
+	bool rtt_timing;
+	u32_t rtt_seq;
+	u32_t rtt_start;
+	u32_t srtt;
+	u32_t rttvar;
+	u32_t rto;
+	struct k_delayed_work rexmit_timer;
+	/* Receiver, segments beyond a hole sorted by sequence number */
+	sys_slist_t ooo_queue;
 	struct net_if *iface;
 	net_tcp_accept_cb_t accept_cb;
 	atomic_t ref_count;
@@ -556,6 +556,35 @@ static inline int net_tcp_finalize(struct net_pkt *pkt)
 }
 #endif
 
+#if defined(CONFIG_NET_TCP_GSO)
+/**
+ * @brief Callback used while segmenting a TCP packet
+ *
+ * @param seg Segment, owned by the callback when it returns >= 0
+ * @param user_data User data given to net_tcp_gso_segment()
+ *
+ * @return >= 0 on success, negative errno otherwise.
+ */
+typedef int (*net_tcp_gso_cb_t)(struct net_pkt *seg, void *user_data);
+
+/**
+ * @brief Split a TCP packet larger than the MTU into segments
+ *
+ * Each segment holds a copy of the IP and TCP headers of the packet
+ * followed by at most net_pkt_gso_size() bytes of its payload, with the
+ * sequence number, lengths and checksums updated.
+ *
+ * @param pkt Finalized TCP packet, which is not modified
+ * @param cb Called with each segment in order
+ * @param user_data User data passed to the callback
+ *
+ * @return 0 on success, negative errno if a segment could not be built
+ * or the callback failed.
+ */
+int net_tcp_gso_segment(struct net_pkt *pkt, net_tcp_gso_cb_t cb,
+			void *user_data);
+#endif /* CONFIG_NET_TCP_GSO */
+
 /**
  * @brief Parse TCP options from network packet.
  *
@@ -489,38 +489,77 @@ int z_vrfy_net_addr_pton(sa_family_t family, const char *src,
 #include <syscalls/net_addr_pton_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
-static u16_t calc_chksum(u16_t sum, const u8_t *data, size_t len)
+#if defined(CONFIG_NET_CHKSUM_ARCH)
+/* Architecture specific variant of chksum_words() below */
+extern u16_t arch_net_chksum(const u8_t *data, size_t len);
+#define chksum_words arch_net_chksum
+#else
+/* Returns the ones' complement sum of the 16-bit words of the buffer, loaded
+ * in CPU byte order, which is the network order sum byte swapped on little
+ * endian CPUs (RFC 1071). The words are added 32 bits at a time into a 64-bit
+ * accumulator so the carries only need to be folded once, at the end.
+ */
+static u16_t chksum_words(const u8_t *data, size_t len)
 {
-	const u8_t *end;
-	u16_t tmp;
+	u64_t acc = 0U;
+	u32_t sum;
 
-	end = data + len - 1;
+	while (len >= 16) {
+		acc += UNALIGNED_GET((u32_t *)data);
+		acc += UNALIGNED_GET((u32_t *)(data + 4));
+		acc += UNALIGNED_GET((u32_t *)(data + 8));
+		acc += UNALIGNED_GET((u32_t *)(data + 12));
 
-	while (data < end) {
-		tmp = (data[0] << 8) + data[1];
-		sum += tmp;
-		if (sum < tmp) {
-			sum++;
-		}
+		data += 16;
+		len -= 16;
+	}
+
+	while (len >= 4) {
+		acc += UNALIGNED_GET((u32_t *)data);
+
+		data += 4;
+		len -= 4;
+	}
+
+	if (len >= 2) {
+		acc += UNALIGNED_GET((u16_t *)data);
 
 		data += 2;
+		len -= 2;
 	}
 
-	if (data == end) {
-		tmp = data[0] << 8;
-		sum += tmp;
-		if (sum < tmp) {
-			sum++;
-		}
+	/* A trailing byte is the first byte of a zero padded word */
+	if (len) {
+		acc += sys_be16_to_cpu(data[0] << 8);
 	}
 
+	acc = (acc & 0xffffffff) + (acc >> 32);
+	sum = (acc & 0xffffffff) + (acc >> 32);
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+
 	return sum;
 }
+#endif /* CONFIG_NET_CHKSUM_ARCH */
+
+static inline u16_t chksum_add(u16_t sum, u16_t val)
+{
+	u32_t tmp = sum + val;
+
+	return (tmp & 0xffff) + (tmp >> 16);
+}
+
+static u16_t calc_chksum(u16_t sum, const u8_t *data, size_t len)
+{
+	return chksum_add(sum, sys_be16_to_cpu(chksum_words(data, len)));
+}
 
 static inline u16_t pkt_calc_chksum(struct net_pkt *pkt, u16_t sum)
 {
 	struct net_pkt_cursor *cur = &pkt->cursor;
+	bool odd = false;
 	size_t len;
+	u16_t tmp;
 
 	if (!cur->buf || !cur->pos) {
 		return sum;
@@ -529,26 +568,28 @@ static inline u16_t pkt_calc_chksum(struct net_pkt *pkt, u16_t sum)
 	len = cur->buf->len - (cur->pos - cur->buf->data);
 
 	while (cur->buf) {
-		sum = calc_chksum(sum, cur->pos, len);
+		tmp = calc_chksum(0, cur->pos, len);
 
-		cur->buf = cur->buf->frags;
-		if (!cur->buf || !cur->buf->len) {
-			break;
+		/* After an odd number of bytes the fragment starts in the
+		 * middle of a word, so its sum has the bytes swapped.
+		 */
+		if (odd) {
+			tmp = __bswap_16(tmp);
 		}
 
-		cur->pos = cur->buf->data;
+		sum = chksum_add(sum, tmp);
 
 		if (len % 2) {
-			sum += *cur->pos;
-			if (sum < *cur->pos) {
-				sum++;
-			}
+			odd = !odd;
+		}
 
-			cur->pos++;
-			len = cur->buf->len - 1;
-		} else {
-			len = cur->buf->len;
+		cur->buf = cur->buf->frags;
+		if (!cur->buf || !cur->buf->len) {
+			break;
 		}
+
+		cur->pos = cur->buf->data;
+		len = cur->buf->len;
 	}
 
 	return sum;
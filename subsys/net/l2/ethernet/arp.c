@@ -28,7 +28,18 @@ static struct arp_entry arp_entries[CONFIG_NET_ARP_TABLE_SIZE];
 
 static sys_slist_t arp_free_entries;
 static sys_slist_t arp_pending_entries;
-static sys_slist_t arp_table;
+
+/* Resolved entries are kept in least recently used order for eviction,
+ * and are also hashed on the IPv4 address for lookup.
+ */
+static sys_dlist_t arp_table;
+
+#define ARP_HASH_MASK (CONFIG_NET_ARP_HASH_BUCKETS - 1)
+
+BUILD_ASSERT_MSG((CONFIG_NET_ARP_HASH_BUCKETS & ARP_HASH_MASK) == 0,
+		 "CONFIG_NET_ARP_HASH_BUCKETS must be a power of two");
+
+static sys_slist_t arp_hash[CONFIG_NET_ARP_HASH_BUCKETS];
 
 struct k_delayed_work arp_request_timer;
 
@@ -74,6 +85,54 @@ static struct arp_entry *arp_entry_find(sys_slist_t *list,
 	return NULL;
 }
 
+static inline sys_slist_t *arp_bucket(const struct in_addr *addr)
+{
+	u32_t hash = UNALIGNED_GET(&addr->s_addr);
+
+	/* Hosts on the same subnet differ in the last bytes of the
+	 * address, so fold those into the low bits.
+	 */
+	hash ^= hash >> 16;
+	hash ^= hash >> 8;
+
+	return &arp_hash[hash & ARP_HASH_MASK];
+}
+
+static struct arp_entry *arp_table_find(struct net_if *iface,
+					struct in_addr *dst,
+					sys_snode_t **previous)
+{
+	struct arp_entry *entry;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(arp_bucket(dst), entry, hash_node) {
+		NET_DBG("iface %p dst %s",
+			iface, log_strdup(net_sprint_ipv4_addr(&entry->ip)));
+
+		if (entry->iface == iface &&
+		    net_ipv4_addr_cmp(&entry->ip, dst)) {
+			return entry;
+		}
+
+		if (previous) {
+			*previous = &entry->hash_node;
+		}
+	}
+
+	return NULL;
+}
+
+static void arp_table_add(struct arp_entry *entry)
+{
+	sys_dlist_prepend(&arp_table, &entry->lru_node);
+	sys_slist_prepend(arp_bucket(&entry->ip), &entry->hash_node);
+}
+
+static void arp_table_remove(struct arp_entry *entry)
+{
+	sys_dlist_remove(&entry->lru_node);
+	sys_slist_find_and_remove(arp_bucket(&entry->ip), &entry->hash_node);
+}
+
 static inline struct arp_entry *arp_entry_find_move_first(struct net_if *iface,
 							  struct in_addr *dst)
 {
@@ -82,16 +141,22 @@ static inline struct arp_entry *arp_entry_find_move_first(struct net_if *iface,
 
 	NET_DBG("dst %s", log_strdup(net_sprint_ipv4_addr(dst)));
 
-	entry = arp_entry_find(&arp_table, iface, dst, &prev);
+	entry = arp_table_find(iface, dst, &prev);
 	if (entry) {
 		/* Let's assume the target is going to be accessed
 		 * more than once here in a short time frame. So we
 		 * place the entry first in position into the table
-		 * in order to reduce subsequent find.
+		 * and its bucket, so that it is evicted last and
+		 * found first.
 		 */
-		if (&entry->node != sys_slist_peek_head(&arp_table)) {
-			sys_slist_remove(&arp_table, prev, &entry->node);
-			sys_slist_prepend(&arp_table, &entry->node);
+		sys_dlist_remove(&entry->lru_node);
+		sys_dlist_prepend(&arp_table, &entry->lru_node);
+
+		if (prev) {
+			sys_slist_t *bucket = arp_bucket(dst);
+
+			sys_slist_remove(bucket, prev, &entry->hash_node);
+			sys_slist_prepend(bucket, &entry->hash_node);
 		}
 	}
 
@@ -145,20 +210,23 @@ static struct arp_entry *arp_entry_get_free(void)
 
 static struct arp_entry *arp_entry_get_last_from_table(void)
 {
-	sys_snode_t *node;
+	struct arp_entry *entry;
+	sys_dnode_t *node;
 
 	/* We assume last entry is the oldest one,
 	 * so is the preferred one to be taken out.
 	 */
 
-	node = sys_slist_peek_tail(&arp_table);
+	node = sys_dlist_peek_tail(&arp_table);
 	if (!node) {
 		return NULL;
 	}
 
-	sys_slist_find_and_remove(&arp_table, node);
+	entry = CONTAINER_OF(node, struct arp_entry, lru_node);
 
-	return CONTAINER_OF(node, struct arp_entry, node);
+	arp_table_remove(entry);
+
+	return entry;
 }
 
 
@@ -399,10 +467,9 @@ static void arp_gratuitous(struct net_if *iface,
 			   struct in_addr *src,
 			   struct net_eth_addr *hwaddr)
 {
-	sys_snode_t *prev = NULL;
 	struct arp_entry *entry;
 
-	entry = arp_entry_find(&arp_table, iface, src, &prev);
+	entry = arp_table_find(iface, src, NULL);
 	if (entry) {
 		NET_DBG("Gratuitous ARP hwaddr %s -> %s",
 			log_strdup(net_sprint_ll_addr(
@@ -434,10 +501,9 @@ static void arp_update(struct net_if *iface,
 		}
 
 		if (force) {
-			sys_snode_t *prev = NULL;
 			struct arp_entry *entry;
 
-			entry = arp_entry_find(&arp_table, iface, src, &prev);
+			entry = arp_table_find(iface, src, NULL);
 			if (entry) {
 				memcpy(&entry->eth, hwaddr,
 				       sizeof(struct net_eth_addr));
@@ -456,7 +522,7 @@ static void arp_update(struct net_if *iface,
 					entry->iface = iface;
 					net_ipaddr_copy(&entry->ip, src);
 					memcpy(&entry->eth, hwaddr, sizeof(entry->eth));
-					sys_slist_prepend(&arp_table, &entry->node);
+					arp_table_add(entry);
 				}
 			}
 		}
@@ -479,7 +545,7 @@ static void arp_update(struct net_if *iface,
 	memcpy(&entry->eth, hwaddr, sizeof(struct net_eth_addr));
 
 	/* Inserting entry into the table */
-	sys_slist_prepend(&arp_table, &entry->node);
+	arp_table_add(entry);
 
 	net_if_queue_tx(iface, pkt);
 }
@@ -674,20 +740,18 @@ void net_arp_clear_cache(struct net_if *iface)
 
 	NET_DBG("Flushing ARP table");
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&arp_table, entry, next, node) {
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&arp_table, entry, next, lru_node) {
 		if (iface && iface != entry->iface) {
-			prev = &entry->node;
 			continue;
 		}
 
+		/* The bucket is found from the address, so remove first */
+		arp_table_remove(entry);
 		arp_entry_cleanup(entry, false);
 
-		sys_slist_remove(&arp_table, prev, &entry->node);
 		sys_slist_prepend(&arp_free_entries, &entry->node);
 	}
 
-	prev = NULL;
-
 	NET_DBG("Flushing ARP pending requests");
 
 	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&arp_pending_entries,
@@ -713,7 +777,7 @@ int net_arp_foreach(net_arp_cb_t cb, void *user_data)
 	int ret = 0;
 	struct arp_entry *entry;
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&arp_table, entry, node) {
+	SYS_DLIST_FOR_EACH_CONTAINER(&arp_table, entry, lru_node) {
 		ret++;
 		cb(entry, user_data);
 	}
@@ -731,7 +795,11 @@ void net_arp_init(void)
 
 	sys_slist_init(&arp_free_entries);
 	sys_slist_init(&arp_pending_entries);
-	sys_slist_init(&arp_table);
+	sys_dlist_init(&arp_table);
+
+	for (i = 0; i < CONFIG_NET_ARP_HASH_BUCKETS; i++) {
+		sys_slist_init(&arp_hash[i]);
+	}
 
 	for (i = 0; i < CONFIG_NET_ARP_TABLE_SIZE; i++) {
 		/* Inserting entry as free */
@@ -10,6 +10,7 @@
 #if defined(CONFIG_NET_ARP) && defined(CONFIG_NET_NATIVE)
 
 #include <sys/slist.h>
+#include <sys/dlist.h>
 #include <net/ethernet.h>
 
 #ifdef __cplusplus
@@ -50,7 +51,13 @@ enum net_verdict net_arp_input(struct net_pkt *pkt,
 			       struct net_eth_hdr *eth_hdr);
 
 struct arp_entry {
-	sys_snode_t node;
+	union {
+		/* Free and pending entries */
+		sys_snode_t node;
+		/* Resolved entries, in least recently used order */
+		sys_dnode_t lru_node;
+	};
+	sys_snode_t hash_node;
 	u32_t req_start;
 	struct net_if *iface;
 	struct in_addr ip;
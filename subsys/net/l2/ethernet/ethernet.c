@@ -29,6 +29,7 @@ LOG_MODULE_REGISTER(net_ethernet, CONFIG_NET_L2_ETHERNET_LOG_LEVEL);
 #include "net_private.h"
 #include "ipv6.h"
 #include "ipv4_autoconf_internal.h"
+#include "tcp_internal.h"
 
 #define NET_BUF_TIMEOUT K_MSEC(100)
 
@@ -554,6 +555,34 @@ static void ethernet_remove_l2_header(struct net_pkt *pkt)
 	net_pkt_frag_unref(buf);
 }
 
+#if defined(CONFIG_NET_TCP_GSO)
+static int ethernet_send(struct net_if *iface, struct net_pkt *pkt);
+
+static int ethernet_send_segment(struct net_pkt *seg, void *user_data)
+{
+	return ethernet_send((struct net_if *)user_data, seg);
+}
+
+/* Splits a TCP packet larger than the MTU for a device without TCP
+ * segmentation offload. Like ethernet_send(), this consumes the packet
+ * on success.
+ */
+static int ethernet_send_gso(struct net_if *iface, struct net_pkt *pkt)
+{
+	int ret;
+
+	ret = net_tcp_gso_segment(pkt, ethernet_send_segment, iface);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = net_pkt_get_len(pkt);
+	net_pkt_unref(pkt);
+
+	return ret;
+}
+#endif /* CONFIG_NET_TCP_GSO */
+
 static int ethernet_send(struct net_if *iface, struct net_pkt *pkt)
 {
 	const struct ethernet_api *api = net_if_get_device(iface)->driver_api;
@@ -566,6 +595,13 @@ static int ethernet_send(struct net_if *iface, struct net_pkt *pkt)
 		goto error;
 	}
 
+#if defined(CONFIG_NET_TCP_GSO)
+	if (net_pkt_gso_size(pkt) &&
+	    !(net_eth_get_hw_capabilities(iface) & ETHERNET_HW_TSO)) {
+		return ethernet_send_gso(iface, pkt);
+	}
+#endif
+
 	if (IS_ENABLED(CONFIG_NET_IPV4) &&
 	    net_pkt_family(pkt) == AF_INET) {
 		struct net_pkt *tmp;
@@ -1117,6 +1153,10 @@ void ethernet_init(struct net_if *iface)
 		ctx->ethernet_l2_flags |= NET_L2_PROMISC_MODE;
 	}
 
+	if (IS_ENABLED(CONFIG_NET_TCP_GSO)) {
+		ctx->ethernet_l2_flags |= NET_L2_GSO;
+	}
+
 #if defined(CONFIG_NET_VLAN)
 	if (!(net_eth_get_hw_capabilities(iface) & ETHERNET_HW_VLAN)) {
 		return;
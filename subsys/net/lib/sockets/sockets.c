@@ -34,7 +34,11 @@ LOG_MODULE_REGISTER(net_sock, CONFIG_NET_SOCKETS_LOG_LEVEL);
 	do { \
 		const struct socket_op_vtable *vtable; \
 		void *ctx = get_sock_vtable(sock, &vtable); \
-		if (ctx == NULL || vtable->fn == NULL) { \
+		if (ctx == NULL) { \
+			return -1; \
+		} \
+		if (vtable->fn == NULL) { \
+			errno = EOPNOTSUPP; \
 			return -1; \
 		} \
 		return vtable->fn(ctx, __VA_ARGS__); \
@@ -199,6 +203,7 @@ int zsock_close_ctx(struct net_context *ctx)
 		(void)net_context_recv(ctx, NULL, K_NO_WAIT, NULL);
 	}
 
+	zsock_epoll_close_ctx(ctx);
 	zsock_flush_queue(ctx);
 
 	SET_ERRNO(net_context_put(ctx));
@@ -266,6 +271,7 @@ static void zsock_accepted_cb(struct net_context *new_ctx,
 		k_fifo_init(&new_ctx->recv_q);
 
 		k_fifo_put(&parent->accept_q, new_ctx);
+		zsock_epoll_notify(parent, ZSOCK_EPOLLIN);
 	}
 }
 
@@ -295,6 +301,7 @@ static void zsock_received_cb(struct net_context *ctx,
 			net_pkt_set_eof(last_pkt, true);
 			NET_DBG("Set EOF flag on pkt %p", last_pkt);
 		}
+		zsock_epoll_notify(ctx, ZSOCK_EPOLLIN);
 		return;
 	}
 
@@ -306,6 +313,7 @@ static void zsock_received_cb(struct net_context *ctx,
 	}
 
 	k_fifo_put(&ctx->recv_q, pkt);
+	zsock_epoll_notify(ctx, ZSOCK_EPOLLIN);
 }
 
 int zsock_bind_ctx(struct net_context *ctx, const struct sockaddr *addr,
@@ -610,13 +618,50 @@ ssize_t z_impl_zsock_sendmsg(int sock, const struct msghdr *msg, int flags)
 }
 
 #ifdef CONFIG_USERSPACE
+/* Sends a message from the buffers of a user message header. The
+ * header, its iovec array and the destination address are copied in.
+ */
+static ssize_t sendmsg_user(int sock, const struct msghdr *umsg, int flags)
+{
+	struct iovec iov[CONFIG_NET_SOCKETS_MSG_IOV_MAX];
+	struct sockaddr_storage name;
+	struct msghdr msg;
+
+	Z_OOPS(z_user_from_copy(&msg, (void *)umsg, sizeof(msg)));
+
+	if (msg.msg_iovlen > ARRAY_SIZE(iov)) {
+		errno = EMSGSIZE;
+		return -1;
+	}
+
+	Z_OOPS(z_user_from_copy(iov, msg.msg_iov,
+				msg.msg_iovlen * sizeof(struct iovec)));
+
+	for (size_t i = 0; i < msg.msg_iovlen; i++) {
+		Z_OOPS(Z_SYSCALL_MEMORY_READ(iov[i].iov_base,
+					     iov[i].iov_len));
+	}
+
+	if (msg.msg_name) {
+		Z_OOPS(Z_SYSCALL_VERIFY(msg.msg_namelen <= sizeof(name)));
+		Z_OOPS(z_user_from_copy(&name, msg.msg_name,
+					msg.msg_namelen));
+		msg.msg_name = &name;
+	}
+
+	Z_OOPS(msg.msg_control && Z_SYSCALL_MEMORY_READ(msg.msg_control,
+							msg.msg_controllen));
+
+	msg.msg_iov = iov;
+
+	return z_impl_zsock_sendmsg(sock, &msg, flags);
+}
+
 static inline ssize_t z_vrfy_zsock_sendmsg(int sock,
 					   const struct msghdr *msg,
 					   int flags)
 {
-	/* TODO: Create a copy of msg_buf and copy the data there */
-
-	return z_impl_zsock_sendmsg(sock, (const struct msghdr *)msg, flags);
+	return sendmsg_user(sock, msg, flags);
 }
 #include <syscalls/zsock_sendmsg_mrsh.c>
 #endif /* CONFIG_USERSPACE */
@@ -724,16 +769,10 @@ error:
 	return ret;
 }
 
-static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
-				       void *buf,
-				       size_t max_len,
-				       int flags,
-				       struct sockaddr *src_addr,
-				       socklen_t *addrlen)
+/* Takes the next datagram off the receive queue, or peeks at it */
+static struct net_pkt *zsock_dgram_get(struct net_context *ctx, int flags)
 {
 	s32_t timeout = K_FOREVER;
-	size_t recv_len = 0;
-	struct net_pkt_cursor backup;
 	struct net_pkt *pkt;
 
 	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
@@ -747,7 +786,7 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 		/* EAGAIN when timeout expired, EINTR when cancelled */
 		if (res && res != -EAGAIN && res != -EINTR) {
 			errno = -res;
-			return -1;
+			return NULL;
 		}
 
 		pkt = k_fifo_peek_head(&ctx->recv_q);
@@ -757,32 +796,74 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 
 	if (!pkt) {
 		errno = EAGAIN;
+	}
+
+	return pkt;
+}
+
+static int zsock_dgram_src_addr(struct net_context *ctx, struct net_pkt *pkt,
+				struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	int rv;
+
+	rv = sock_get_pkt_src_addr(pkt, net_context_get_ip_proto(ctx),
+				   src_addr, *addrlen);
+	if (rv < 0) {
+		errno = -rv;
 		return -1;
 	}
 
-	net_pkt_cursor_backup(pkt, &backup);
+	/* addrlen is a value-result argument, set to actual
+	 * size of source address
+	 */
+	if (src_addr->sa_family == AF_INET) {
+		*addrlen = sizeof(struct sockaddr_in);
+	} else if (src_addr->sa_family == AF_INET6) {
+		*addrlen = sizeof(struct sockaddr_in6);
+	} else {
+		errno = ENOTSUP;
+		return -1;
+	}
 
-	if (src_addr && addrlen) {
-		int rv;
+	return 0;
+}
 
-		rv = sock_get_pkt_src_addr(pkt, net_context_get_ip_proto(ctx),
-					   src_addr, *addrlen);
-		if (rv < 0) {
-			errno = -rv;
-			return -1;
-		}
+static void zsock_dgram_done(struct net_pkt *pkt, int flags,
+			     struct net_pkt_cursor *backup)
+{
+	net_stats_update_tc_rx_time(net_pkt_iface(pkt),
+				    net_pkt_priority(pkt),
+				    net_pkt_timestamp(pkt)->nanosecond,
+				    k_cycle_get_32());
 
-		/* addrlen is a value-result argument, set to actual
-		 * size of source address
-		 */
-		if (src_addr->sa_family == AF_INET) {
-			*addrlen = sizeof(struct sockaddr_in);
-		} else if (src_addr->sa_family == AF_INET6) {
-			*addrlen = sizeof(struct sockaddr_in6);
-		} else {
-			errno = ENOTSUP;
-			return -1;
-		}
+	if (!(flags & ZSOCK_MSG_PEEK)) {
+		net_pkt_unref(pkt);
+	} else {
+		net_pkt_cursor_restore(pkt, backup);
+	}
+}
+
+static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
+				       void *buf,
+				       size_t max_len,
+				       int flags,
+				       struct sockaddr *src_addr,
+				       socklen_t *addrlen)
+{
+	size_t recv_len = 0;
+	struct net_pkt_cursor backup;
+	struct net_pkt *pkt;
+
+	pkt = zsock_dgram_get(ctx, flags);
+	if (!pkt) {
+		return -1;
+	}
+
+	net_pkt_cursor_backup(pkt, &backup);
+
+	if (src_addr && addrlen &&
+	    zsock_dgram_src_addr(ctx, pkt, src_addr, addrlen) < 0) {
+		return -1;
 	}
 
 	recv_len = net_pkt_remaining_data(pkt);
@@ -795,17 +876,51 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 		return -1;
 	}
 
-	net_stats_update_tc_rx_time(net_pkt_iface(pkt),
-				    net_pkt_priority(pkt),
-				    net_pkt_timestamp(pkt)->nanosecond,
-				    k_cycle_get_32());
+	zsock_dgram_done(pkt, flags, &backup);
 
-	if (!(flags & ZSOCK_MSG_PEEK)) {
-		net_pkt_unref(pkt);
-	} else {
-		net_pkt_cursor_restore(pkt, &backup);
+	return recv_len;
+}
+
+static ssize_t zsock_recvmsg_dgram(struct net_context *ctx,
+				   struct msghdr *msg, int flags)
+{
+	size_t data_len, recv_len = 0;
+	struct net_pkt_cursor backup;
+	struct net_pkt *pkt;
+
+	pkt = zsock_dgram_get(ctx, flags);
+	if (!pkt) {
+		return -1;
+	}
+
+	net_pkt_cursor_backup(pkt, &backup);
+
+	if (msg->msg_name &&
+	    zsock_dgram_src_addr(ctx, pkt, msg->msg_name,
+				 &msg->msg_namelen) < 0) {
+		return -1;
+	}
+
+	/* Scatter the datagram over the buffers, one read each */
+	data_len = net_pkt_remaining_data(pkt);
+
+	for (size_t i = 0; i < msg->msg_iovlen && recv_len < data_len; i++) {
+		size_t len = MIN(msg->msg_iov[i].iov_len, data_len - recv_len);
+
+		if (net_pkt_read(pkt, msg->msg_iov[i].iov_base, len)) {
+			errno = ENOBUFS;
+			return -1;
+		}
+
+		recv_len += len;
+	}
+
+	if (recv_len < data_len) {
+		msg->msg_flags |= ZSOCK_MSG_TRUNC;
 	}
 
+	zsock_dgram_done(pkt, flags, &backup);
+
 	return recv_len;
 }
 
@@ -922,6 +1037,118 @@ ssize_t zsock_recvfrom_ctx(struct net_context *ctx, void *buf, size_t max_len,
 	return 0;
 }
 
+static ssize_t zsock_recvmsg_stream(struct net_context *ctx,
+				    struct msghdr *msg, int flags)
+{
+	ssize_t recv_len = 0;
+
+	for (size_t i = 0; i < msg->msg_iovlen; i++) {
+		size_t max_len = msg->msg_iov[i].iov_len;
+		ssize_t len;
+
+		if (max_len == 0) {
+			continue;
+		}
+
+		/* Only wait for the first bytes, like recv() */
+		len = zsock_recv_stream(ctx, msg->msg_iov[i].iov_base, max_len,
+					recv_len ? flags | ZSOCK_MSG_DONTWAIT :
+						   flags);
+		if (len < 0) {
+			return recv_len ? recv_len : -1;
+		}
+
+		recv_len += len;
+
+		/* A peek always starts over at the head of the queue */
+		if ((size_t)len < max_len || (flags & ZSOCK_MSG_PEEK)) {
+			break;
+		}
+	}
+
+	return recv_len;
+}
+
+ssize_t zsock_recvmsg_ctx(struct net_context *ctx, struct msghdr *msg,
+			  int flags)
+{
+	enum net_sock_type sock_type = net_context_get_type(ctx);
+
+	msg->msg_controllen = 0;
+	msg->msg_flags = 0;
+
+	if (sock_type == SOCK_DGRAM) {
+		return zsock_recvmsg_dgram(ctx, msg, flags);
+	} else if (sock_type == SOCK_STREAM) {
+		msg->msg_namelen = 0;
+		return zsock_recvmsg_stream(ctx, msg, flags);
+	}
+
+	__ASSERT(0, "Unknown socket type");
+
+	return 0;
+}
+
+#if defined(CONFIG_NET_SOCKETS_RECV_ZEROCOPY)
+ssize_t zsock_recv_zerocopy(int sock, struct net_buf **frags, int flags,
+			    struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	struct net_context *ctx;
+	struct net_pkt *pkt;
+	struct net_buf *buf;
+	size_t hdr_len, len;
+
+	ctx = z_get_fd_obj(sock, (const struct fd_op_vtable *)
+				 &sock_fd_op_vtable, ENOTSUP);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	if (net_context_get_type(ctx) != SOCK_DGRAM ||
+	    (flags & ZSOCK_MSG_PEEK)) {
+		errno = ENOTSUP;
+		return -1;
+	}
+
+	pkt = zsock_dgram_get(ctx, flags);
+	if (!pkt) {
+		return -1;
+	}
+
+	if (src_addr && addrlen &&
+	    zsock_dgram_src_addr(ctx, pkt, src_addr, addrlen) < 0) {
+		net_pkt_unref(pkt);
+		return -1;
+	}
+
+	len = net_pkt_remaining_data(pkt);
+	hdr_len = net_pkt_get_len(pkt) - len;
+
+	net_stats_update_tc_rx_time(net_pkt_iface(pkt),
+				    net_pkt_priority(pkt),
+				    net_pkt_timestamp(pkt)->nanosecond,
+				    k_cycle_get_32());
+
+	/* Take the buffers over and drop the IP and UDP headers */
+	buf = pkt->buffer;
+	pkt->buffer = NULL;
+	net_pkt_unref(pkt);
+
+	while (buf && hdr_len >= buf->len) {
+		hdr_len -= buf->len;
+		buf = net_buf_frag_del(NULL, buf);
+	}
+
+	if (buf) {
+		net_buf_pull(buf, hdr_len);
+	}
+
+	*frags = buf;
+
+	return len;
+}
+#endif /* CONFIG_NET_SOCKETS_RECV_ZEROCOPY */
+
 ssize_t z_impl_zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
 			     struct sockaddr *src_addr, socklen_t *addrlen)
 {
@@ -960,6 +1187,151 @@ ssize_t z_vrfy_zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
 #include <syscalls/zsock_recvfrom_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
+ssize_t z_impl_zsock_recvmsg(int sock, struct msghdr *msg, int flags)
+{
+	VTABLE_CALL(recvmsg, sock, msg, flags);
+}
+
+int z_impl_zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+			  unsigned int vlen, int flags)
+{
+	unsigned int i;
+
+	for (i = 0U; i < vlen; i++) {
+		ssize_t len;
+
+		len = z_impl_zsock_recvmsg(sock, &msgvec[i].msg_hdr,
+					   i ? flags | ZSOCK_MSG_DONTWAIT :
+					       flags);
+		if (len < 0) {
+			break;
+		}
+
+		msgvec[i].msg_len = len;
+	}
+
+	return (i == 0U && vlen) ? -1 : i;
+}
+
+int z_impl_zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+			  unsigned int vlen, int flags)
+{
+	unsigned int i;
+
+	for (i = 0U; i < vlen; i++) {
+		ssize_t len;
+
+		len = z_impl_zsock_sendmsg(sock, &msgvec[i].msg_hdr, flags);
+		if (len < 0) {
+			break;
+		}
+
+		msgvec[i].msg_len = len;
+	}
+
+	return (i == 0U && vlen) ? -1 : i;
+}
+
+#ifdef CONFIG_USERSPACE
+/* Receives a message into the buffers of a user message header. The
+ * header and its iovec array are copied in, the results copied out.
+ */
+static ssize_t recvmsg_user(int sock, struct msghdr *umsg, int flags)
+{
+	struct iovec iov[CONFIG_NET_SOCKETS_MSG_IOV_MAX];
+	struct msghdr msg;
+	ssize_t ret;
+
+	Z_OOPS(z_user_from_copy(&msg, umsg, sizeof(msg)));
+
+	if (msg.msg_iovlen > ARRAY_SIZE(iov)) {
+		errno = EMSGSIZE;
+		return -1;
+	}
+
+	Z_OOPS(z_user_from_copy(iov, msg.msg_iov,
+				msg.msg_iovlen * sizeof(struct iovec)));
+
+	for (size_t i = 0; i < msg.msg_iovlen; i++) {
+		Z_OOPS(Z_SYSCALL_MEMORY_WRITE(iov[i].iov_base,
+					      iov[i].iov_len));
+	}
+
+	Z_OOPS(msg.msg_name && Z_SYSCALL_MEMORY_WRITE(msg.msg_name,
+						      msg.msg_namelen));
+
+	msg.msg_iov = iov;
+
+	ret = z_impl_zsock_recvmsg(sock, &msg, flags);
+	if (ret < 0) {
+		return ret;
+	}
+
+	Z_OOPS(z_user_to_copy(&umsg->msg_namelen, &msg.msg_namelen,
+			      sizeof(msg.msg_namelen)));
+	Z_OOPS(z_user_to_copy(&umsg->msg_controllen, &msg.msg_controllen,
+			      sizeof(msg.msg_controllen)));
+	Z_OOPS(z_user_to_copy(&umsg->msg_flags, &msg.msg_flags,
+			      sizeof(msg.msg_flags)));
+
+	return ret;
+}
+
+static inline ssize_t z_vrfy_zsock_recvmsg(int sock, struct msghdr *msg,
+					   int flags)
+{
+	return recvmsg_user(sock, msg, flags);
+}
+#include <syscalls/zsock_recvmsg_mrsh.c>
+
+static inline int z_vrfy_zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+					unsigned int vlen, int flags)
+{
+	unsigned int i;
+
+	Z_OOPS(Z_SYSCALL_MEMORY_ARRAY_WRITE(msgvec, vlen,
+					    sizeof(struct mmsghdr)));
+
+	for (i = 0U; i < vlen; i++) {
+		ssize_t len;
+
+		len = recvmsg_user(sock, &msgvec[i].msg_hdr,
+				   i ? flags | ZSOCK_MSG_DONTWAIT : flags);
+		if (len < 0) {
+			break;
+		}
+
+		msgvec[i].msg_len = len;
+	}
+
+	return (i == 0U && vlen) ? -1 : i;
+}
+#include <syscalls/zsock_recvmmsg_mrsh.c>
+
+static inline int z_vrfy_zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+					unsigned int vlen, int flags)
+{
+	unsigned int i;
+
+	Z_OOPS(Z_SYSCALL_MEMORY_ARRAY_WRITE(msgvec, vlen,
+					    sizeof(struct mmsghdr)));
+
+	for (i = 0U; i < vlen; i++) {
+		ssize_t len;
+
+		len = sendmsg_user(sock, &msgvec[i].msg_hdr, flags);
+		if (len < 0) {
+			break;
+		}
+
+		msgvec[i].msg_len = len;
+	}
+
+	return (i == 0U && vlen) ? -1 : i;
+}
+#include <syscalls/zsock_sendmmsg_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
 /* As this is limited function, we don't follow POSIX signature, with
  * "..." instead of last arg.
  */
@@ -1036,6 +1408,20 @@ static int zsock_poll_update_ctx(struct net_context *ctx,
 	return 0;
 }
 
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+u32_t zsock_epoll_ready_ctx(struct net_context *ctx)
+{
+	/* As for poll(), assume that socket is always writable */
+	u32_t events = ZSOCK_EPOLLOUT;
+
+	if (!k_fifo_is_empty(&ctx->recv_q) || sock_is_eof(ctx)) {
+		events |= ZSOCK_EPOLLIN;
+	}
+
+	return events;
+}
+#endif /* CONFIG_NET_SOCKETS_EPOLL */
+
 static inline int time_left(u32_t start, u32_t timeout)
 {
 	u32_t elapsed = k_uptime_get_32() - start;
@@ -1645,6 +2031,11 @@ static ssize_t sock_recvfrom_vmeth(void *obj, void *buf, size_t max_len,
 				  src_addr, addrlen);
 }
 
+static ssize_t sock_recvmsg_vmeth(void *obj, struct msghdr *msg, int flags)
+{
+	return zsock_recvmsg_ctx(obj, msg, flags);
+}
+
 static int sock_getsockopt_vmeth(void *obj, int level, int optname,
 				 void *optval, socklen_t *optlen)
 {
@@ -1673,4 +2064,5 @@ const struct socket_op_vtable sock_fd_op_vtable = {
 	.recvfrom = sock_recvfrom_vmeth,
 	.getsockopt = sock_getsockopt_vmeth,
 	.setsockopt = sock_setsockopt_vmeth,
+	.recvmsg = sock_recvmsg_vmeth,
 };
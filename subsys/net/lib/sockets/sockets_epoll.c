@@ -0,0 +1,522 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* epoll() style readiness notification for native sockets.
+ *
+ * A socket is registered with an epoll instance once, as an item linked
+ * both on the instance and on the socket's net_context.  The receive
+ * callbacks in sockets.c push the items of a socket that got data onto
+ * the ready list of their instances, so zsock_epoll_wait() only ever
+ * looks at sockets that are (or were recently) ready.
+ *
+ * Level-triggered items stay on the ready list for as long as their
+ * socket is ready, which is rechecked on every wait; edge-triggered and
+ * one-shot items are taken off the list when reported.
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_sock_epoll, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <kernel.h>
+#include <net/net_context.h>
+#include <net/socket.h>
+#include <syscall_handler.h>
+#include <sys/fdtable.h>
+#include <sys/math_extras.h>
+
+#include "sockets_internal.h"
+
+/* Events always reported, whether watched for or not */
+#define EPOLL_ALWAYS (ZSOCK_EPOLLERR | ZSOCK_EPOLLHUP)
+
+struct zsock_epoll {
+	/** Items of sockets that may be ready */
+	sys_dlist_t ready;
+	/** All items of this instance */
+	sys_slist_t items;
+	/** Given when an item is queued on the ready list */
+	struct k_sem sem;
+	bool in_use;
+};
+
+struct zsock_epitem {
+	/** Link in the net_context's list of items */
+	sys_snode_t ctx_node;
+	/** Link in the instance's list of items */
+	sys_snode_t ep_node;
+	/** Link in the instance's ready list, when queued */
+	sys_dnode_t ready_node;
+	struct zsock_epoll *ep;
+	struct net_context *ctx;
+	u32_t events;
+	union zsock_epoll_data data;
+};
+
+extern const struct socket_op_vtable sock_fd_op_vtable;
+static const struct fd_op_vtable epoll_fd_op_vtable;
+
+static struct zsock_epoll epolls[CONFIG_NET_SOCKETS_EPOLL_MAX];
+
+/* Items are only ever allocated with K_NO_WAIT, so nothing pends on the
+ * slab and freeing an item under epoll_lock never reschedules.
+ */
+K_MEM_SLAB_DEFINE(epitem_slab, sizeof(struct zsock_epitem),
+		  CONFIG_NET_SOCKETS_EPOLL_MAX_ITEMS, 4);
+
+/* Protects all instances and items, and the epoll_items list of every
+ * net_context
+ */
+static struct k_spinlock epoll_lock;
+
+/* Queue an item on its instance's ready list if its socket has any of
+ * the events it is watched for.  Returns the instance bit to signal
+ * once the lock is dropped, or 0.
+ */
+static u32_t epitem_queue(struct zsock_epitem *item, u32_t events)
+{
+	if ((item->events & events) == 0U) {
+		return 0U;
+	}
+
+	if (!sys_dnode_is_linked(&item->ready_node)) {
+		sys_dlist_append(&item->ep->ready, &item->ready_node);
+	}
+
+	return BIT(item->ep - epolls);
+}
+
+static void epoll_signal(u32_t mask)
+{
+	while (mask != 0U) {
+		int i = u32_count_trailing_zeros(mask);
+
+		k_sem_give(&epolls[i].sem);
+		mask &= mask - 1;
+	}
+}
+
+static void epitem_unlink(struct zsock_epitem *item)
+{
+	(void)sys_slist_find_and_remove(&item->ctx->epoll_items,
+					&item->ctx_node);
+	(void)sys_slist_find_and_remove(&item->ep->items, &item->ep_node);
+	if (sys_dnode_is_linked(&item->ready_node)) {
+		sys_dlist_remove(&item->ready_node);
+	}
+}
+
+void zsock_epoll_notify(struct net_context *ctx, u32_t events)
+{
+	struct zsock_epitem *item;
+	k_spinlock_key_t key;
+	u32_t mask = 0U;
+
+	/* Sockets nobody watches pay just for this check */
+	if (sys_slist_is_empty(&ctx->epoll_items)) {
+		return;
+	}
+
+	key = k_spin_lock(&epoll_lock);
+	SYS_SLIST_FOR_EACH_CONTAINER(&ctx->epoll_items, item, ctx_node) {
+		mask |= epitem_queue(item, events);
+	}
+	k_spin_unlock(&epoll_lock, key);
+
+	epoll_signal(mask);
+}
+
+void zsock_epoll_close_ctx(struct net_context *ctx)
+{
+	struct zsock_epitem *item;
+	k_spinlock_key_t key;
+	sys_snode_t *node;
+
+	if (sys_slist_is_empty(&ctx->epoll_items)) {
+		return;
+	}
+
+	key = k_spin_lock(&epoll_lock);
+	while ((node = sys_slist_peek_head(&ctx->epoll_items)) != NULL) {
+		item = CONTAINER_OF(node, struct zsock_epitem, ctx_node);
+		epitem_unlink(item);
+		k_mem_slab_free(&epitem_slab, (void **)&item);
+	}
+	k_spin_unlock(&epoll_lock, key);
+}
+
+static int epoll_close(struct zsock_epoll *ep)
+{
+	struct zsock_epitem *item;
+	k_spinlock_key_t key;
+	sys_snode_t *node;
+
+	key = k_spin_lock(&epoll_lock);
+	while ((node = sys_slist_peek_head(&ep->items)) != NULL) {
+		item = CONTAINER_OF(node, struct zsock_epitem, ep_node);
+		epitem_unlink(item);
+		k_mem_slab_free(&epitem_slab, (void **)&item);
+	}
+	ep->in_use = false;
+	k_spin_unlock(&epoll_lock, key);
+
+	/* Let a waiter notice that the instance is gone */
+	k_sem_give(&ep->sem);
+
+	return 0;
+}
+
+int z_impl_zsock_epoll_create(int flags)
+{
+	struct zsock_epoll *ep = NULL;
+	k_spinlock_key_t key;
+	int fd;
+
+	if (flags != 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	fd = z_reserve_fd();
+	if (fd < 0) {
+		return -1;
+	}
+
+	key = k_spin_lock(&epoll_lock);
+	for (int i = 0; i < ARRAY_SIZE(epolls); i++) {
+		if (!epolls[i].in_use) {
+			ep = &epolls[i];
+			ep->in_use = true;
+			break;
+		}
+	}
+	k_spin_unlock(&epoll_lock, key);
+
+	if (ep == NULL) {
+		z_free_fd(fd);
+		errno = ENFILE;
+		return -1;
+	}
+
+	sys_dlist_init(&ep->ready);
+	sys_slist_init(&ep->items);
+	k_sem_init(&ep->sem, 0, 1);
+
+	z_finalize_fd(fd, ep, &epoll_fd_op_vtable);
+
+	NET_DBG("epoll: ep=%p, fd=%d", ep, fd);
+
+	return fd;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_epoll_create(int flags)
+{
+	return z_impl_zsock_epoll_create(flags);
+}
+#include <syscalls/zsock_epoll_create_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+static struct zsock_epoll *get_epoll(int epfd)
+{
+	const struct fd_op_vtable *vtable;
+	void *obj = z_get_fd_obj_and_vtable(epfd, &vtable);
+
+	if (obj == NULL) {
+		return NULL;
+	}
+
+	if (vtable != &epoll_fd_op_vtable) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	return obj;
+}
+
+static struct zsock_epitem *epitem_find(struct zsock_epoll *ep,
+					struct net_context *ctx)
+{
+	struct zsock_epitem *item;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&ctx->epoll_items, item, ctx_node) {
+		if (item->ep == ep) {
+			return item;
+		}
+	}
+
+	return NULL;
+}
+
+int z_impl_zsock_epoll_ctl(int epfd, int op, int sock,
+			   struct zsock_epoll_event *event)
+{
+	const struct fd_op_vtable *vtable;
+	struct zsock_epoll *ep = get_epoll(epfd);
+	struct zsock_epitem *item, *new_item = NULL;
+	struct net_context *ctx;
+	k_spinlock_key_t key;
+	u32_t mask = 0U;
+	int ret = 0;
+
+	if (ep == NULL) {
+		return -1;
+	}
+
+	ctx = z_get_fd_obj_and_vtable(sock, &vtable);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	/* Only native sockets feed zsock_epoll_notify() */
+	if (vtable != &sock_fd_op_vtable.fd_vtable) {
+		errno = EPERM;
+		return -1;
+	}
+
+	if (op != ZSOCK_EPOLL_CTL_DEL && event == NULL) {
+		errno = EFAULT;
+		return -1;
+	}
+
+	/* Allocate outside the lock, k_mem_slab_alloc() may reschedule */
+	if (op == ZSOCK_EPOLL_CTL_ADD &&
+	    k_mem_slab_alloc(&epitem_slab, (void **)&new_item,
+			     K_NO_WAIT) != 0) {
+		errno = ENOMEM;
+		return -1;
+	}
+
+	key = k_spin_lock(&epoll_lock);
+	item = epitem_find(ep, ctx);
+
+	switch (op) {
+	case ZSOCK_EPOLL_CTL_ADD:
+		if (item != NULL) {
+			ret = -EEXIST;
+			break;
+		}
+
+		item = new_item;
+		new_item = NULL;
+		item->ep = ep;
+		item->ctx = ctx;
+		sys_dnode_init(&item->ready_node);
+		sys_slist_append(&ctx->epoll_items, &item->ctx_node);
+		sys_slist_append(&ep->items, &item->ep_node);
+		/* fall through */
+	case ZSOCK_EPOLL_CTL_MOD:
+		if (item == NULL) {
+			ret = -ENOENT;
+			break;
+		}
+
+		item->events = event->events;
+		item->data = event->data;
+
+		/* Data may have arrived before the socket was watched */
+		if (sys_dnode_is_linked(&item->ready_node)) {
+			sys_dlist_remove(&item->ready_node);
+		}
+		mask = epitem_queue(item, zsock_epoll_ready_ctx(ctx));
+		break;
+	case ZSOCK_EPOLL_CTL_DEL:
+		if (item == NULL) {
+			ret = -ENOENT;
+			break;
+		}
+
+		epitem_unlink(item);
+		new_item = item;
+		break;
+	default:
+		ret = -EINVAL;
+		break;
+	}
+
+	k_spin_unlock(&epoll_lock, key);
+
+	if (new_item != NULL) {
+		k_mem_slab_free(&epitem_slab, (void **)&new_item);
+	}
+
+	epoll_signal(mask);
+
+	if (ret < 0) {
+		errno = -ret;
+		return -1;
+	}
+
+	return 0;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_epoll_ctl(int epfd, int op, int sock,
+					 struct zsock_epoll_event *event)
+{
+	struct zsock_epoll_event event_copy;
+
+	if (event == NULL) {
+		return z_impl_zsock_epoll_ctl(epfd, op, sock, NULL);
+	}
+
+	Z_OOPS(z_user_from_copy(&event_copy, (void *)event,
+				sizeof(event_copy)));
+
+	return z_impl_zsock_epoll_ctl(epfd, op, sock, &event_copy);
+}
+#include <syscalls/zsock_epoll_ctl_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+/* Report up to maxevents ready items, and take those that are no
+ * longer ready, or edge-triggered, off the ready list.  Level-triggered
+ * items that are reported move to the back of the list, so that a busy
+ * socket cannot starve the others when maxevents is small.
+ */
+static int epoll_harvest(struct zsock_epoll *ep,
+			 struct zsock_epoll_event *events, int maxevents)
+{
+	struct zsock_epitem *item, *next;
+	sys_dlist_t requeue;
+	k_spinlock_key_t key;
+	int count = 0;
+
+	sys_dlist_init(&requeue);
+
+	key = k_spin_lock(&epoll_lock);
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&ep->ready, item, next, ready_node) {
+		u32_t revents;
+
+		if (count == maxevents) {
+			break;
+		}
+
+		sys_dlist_remove(&item->ready_node);
+
+		revents = zsock_epoll_ready_ctx(item->ctx) &
+			  (item->events | EPOLL_ALWAYS);
+		if (revents == 0U) {
+			continue;
+		}
+
+		events[count].events = revents;
+		events[count].data = item->data;
+		count++;
+
+		if ((item->events & ZSOCK_EPOLLONESHOT) != 0U) {
+			/* Disabled until re-armed with EPOLL_CTL_MOD */
+			item->events = 0U;
+		} else if ((item->events & ZSOCK_EPOLLET) == 0U) {
+			sys_dlist_append(&requeue, &item->ready_node);
+		}
+	}
+
+	while ((item = SYS_DLIST_PEEK_HEAD_CONTAINER(&requeue, item,
+						     ready_node)) != NULL) {
+		sys_dlist_remove(&item->ready_node);
+		sys_dlist_append(&ep->ready, &item->ready_node);
+	}
+	k_spin_unlock(&epoll_lock, key);
+
+	return count;
+}
+
+static inline int time_left(u32_t start, u32_t timeout)
+{
+	u32_t elapsed = k_uptime_get_32() - start;
+
+	return timeout - elapsed;
+}
+
+int z_impl_zsock_epoll_wait(int epfd, struct zsock_epoll_event *events,
+			    int maxevents, int timeout)
+{
+	struct zsock_epoll *ep = get_epoll(epfd);
+	u32_t entry_time = k_uptime_get_32();
+	int remaining_time;
+	int count;
+
+	if (ep == NULL) {
+		return -1;
+	}
+
+	if (maxevents <= 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (timeout < 0) {
+		timeout = K_FOREVER;
+	}
+
+	remaining_time = timeout;
+
+	while (true) {
+		count = epoll_harvest(ep, events, maxevents);
+		if (count > 0 || timeout == K_NO_WAIT) {
+			break;
+		}
+
+		if (timeout != K_FOREVER) {
+			remaining_time = time_left(entry_time, timeout);
+			if (remaining_time <= 0) {
+				break;
+			}
+		}
+
+		/* The semaphore may be stale, harvesting decides */
+		(void)k_sem_take(&ep->sem, remaining_time);
+
+		if (!ep->in_use) {
+			errno = EBADF;
+			return -1;
+		}
+	}
+
+	return count;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_epoll_wait(int epfd,
+					  struct zsock_epoll_event *events,
+					  int maxevents, int timeout)
+{
+	if (maxevents > 0) {
+		Z_OOPS(Z_SYSCALL_MEMORY_ARRAY_WRITE(events, maxevents,
+					sizeof(struct zsock_epoll_event)));
+	}
+
+	return z_impl_zsock_epoll_wait(epfd, events, maxevents, timeout);
+}
+#include <syscalls/zsock_epoll_wait_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+static ssize_t epoll_read_vmeth(void *obj, void *buffer, size_t count)
+{
+	errno = EINVAL;
+	return -1;
+}
+
+static ssize_t epoll_write_vmeth(void *obj, const void *buffer, size_t count)
+{
+	errno = EINVAL;
+	return -1;
+}
+
+static int epoll_ioctl_vmeth(void *obj, unsigned int request, va_list args)
+{
+	switch (request) {
+	case ZFD_IOCTL_CLOSE:
+		return epoll_close(obj);
+
+	default:
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+}
+
+static const struct fd_op_vtable epoll_fd_op_vtable = {
+	.read = epoll_read_vmeth,
+	.write = epoll_write_vmeth,
+	.ioctl = epoll_ioctl_vmeth,
+};
@@ -46,6 +46,21 @@ struct socket_op_vtable {
 	int (*setsockopt)(void *obj, int level, int optname,
 			  const void *optval, socklen_t optlen);
 	ssize_t (*sendmsg)(void *obj, const struct msghdr *msg, int flags);
+	ssize_t (*recvmsg)(void *obj, struct msghdr *msg, int flags);
 };
 
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+u32_t zsock_epoll_ready_ctx(struct net_context *ctx);
+void zsock_epoll_notify(struct net_context *ctx, u32_t events);
+void zsock_epoll_close_ctx(struct net_context *ctx);
+#else
+static inline void zsock_epoll_notify(struct net_context *ctx, u32_t events)
+{
+}
+
+static inline void zsock_epoll_close_ctx(struct net_context *ctx)
+{
+}
+#endif /* CONFIG_NET_SOCKETS_EPOLL */
+
 #endif /* _SOCKETS_INTERNAL_H_ */
@@ -179,11 +179,8 @@ ssize_t zpacket_sendto_ctx(struct net_context *ctx, const void *buf, size_t len,
 	return status;
 }
 
-ssize_t zpacket_recvfrom_ctx(struct net_context *ctx, void *buf, size_t max_len,
-			     int flags, struct sockaddr *src_addr,
-			     socklen_t *addrlen)
+static struct net_pkt *packet_recv_get(struct net_context *ctx, int flags)
 {
-	size_t recv_len = 0;
 	s32_t timeout = K_FOREVER;
 	struct net_pkt *pkt;
 
@@ -198,7 +195,7 @@ ssize_t zpacket_recvfrom_ctx(struct net_context *ctx, void *buf, size_t max_len,
 		/* EAGAIN when timeout expired, EINTR when cancelled */
 		if (res && res != -EAGAIN && res != -EINTR) {
 			errno = -res;
-			return -1;
+			return NULL;
 		}
 
 		pkt = k_fifo_peek_head(&ctx->recv_q);
@@ -208,6 +205,34 @@ ssize_t zpacket_recvfrom_ctx(struct net_context *ctx, void *buf, size_t max_len,
 
 	if (!pkt) {
 		errno = EAGAIN;
+	}
+
+	return pkt;
+}
+
+static void packet_recv_done(struct net_pkt *pkt, int flags)
+{
+	net_stats_update_tc_rx_time(net_pkt_iface(pkt),
+				    net_pkt_priority(pkt),
+				    net_pkt_timestamp(pkt)->nanosecond,
+				    k_cycle_get_32());
+
+	if (!(flags & ZSOCK_MSG_PEEK)) {
+		net_pkt_unref(pkt);
+	} else {
+		net_pkt_cursor_init(pkt);
+	}
+}
+
+ssize_t zpacket_recvfrom_ctx(struct net_context *ctx, void *buf, size_t max_len,
+			     int flags, struct sockaddr *src_addr,
+			     socklen_t *addrlen)
+{
+	size_t recv_len = 0;
+	struct net_pkt *pkt;
+
+	pkt = packet_recv_get(ctx, flags);
+	if (!pkt) {
 		return -1;
 	}
 
@@ -224,17 +249,45 @@ ssize_t zpacket_recvfrom_ctx(struct net_context *ctx, void *buf, size_t max_len,
 		return -1;
 	}
 
-	net_stats_update_tc_rx_time(net_pkt_iface(pkt),
-				    net_pkt_priority(pkt),
-				    net_pkt_timestamp(pkt)->nanosecond,
-				    k_cycle_get_32());
+	packet_recv_done(pkt, flags);
 
-	if (!(flags & ZSOCK_MSG_PEEK)) {
-		net_pkt_unref(pkt);
-	} else {
-		net_pkt_cursor_init(pkt);
+	return recv_len;
+}
+
+ssize_t zpacket_recvmsg_ctx(struct net_context *ctx, struct msghdr *msg,
+			    int flags)
+{
+	size_t recv_len = 0;
+	size_t left, len;
+	struct net_pkt *pkt;
+	int i;
+
+	pkt = packet_recv_get(ctx, flags);
+	if (!pkt) {
+		return -1;
+	}
+
+	/* The whole packet is scattered over the buffers */
+	left = net_pkt_get_len(pkt);
+
+	for (i = 0; i < msg->msg_iovlen && left > 0; i++) {
+		len = MIN(left, msg->msg_iov[i].iov_len);
+
+		if (net_pkt_read(pkt, msg->msg_iov[i].iov_base, len)) {
+			errno = ENOBUFS;
+			return -1;
+		}
+
+		recv_len += len;
+		left -= len;
 	}
 
+	msg->msg_namelen = 0;
+	msg->msg_controllen = 0;
+	msg->msg_flags = left ? ZSOCK_MSG_TRUNC : 0;
+
+	packet_recv_done(pkt, flags);
+
 	return recv_len;
 }
 
@@ -322,6 +375,12 @@ static ssize_t packet_sock_recvfrom_vmeth(void *obj, void *buf, size_t max_len,
 				    src_addr, addrlen);
 }
 
+static ssize_t packet_sock_recvmsg_vmeth(void *obj, struct msghdr *msg,
+					 int flags)
+{
+	return zpacket_recvmsg_ctx(obj, msg, flags);
+}
+
 static int packet_sock_getsockopt_vmeth(void *obj, int level, int optname,
 					void *optval, socklen_t *optlen)
 {
@@ -346,6 +405,7 @@ static const struct socket_op_vtable packet_sock_fd_op_vtable = {
 	.accept = packet_sock_accept_vmeth,
 	.sendto = packet_sock_sendto_vmeth,
 	.recvfrom = packet_sock_recvfrom_vmeth,
+	.recvmsg = packet_sock_recvmsg_vmeth,
 	.getsockopt = packet_sock_getsockopt_vmeth,
 	.setsockopt = packet_sock_setsockopt_vmeth,
 };
@@ -1687,6 +1687,43 @@ ssize_t ztls_recvfrom_ctx(struct net_context *ctx, void *buf, size_t max_len,
 #endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
 }
 
+ssize_t ztls_recvmsg_ctx(struct net_context *ctx, struct msghdr *msg,
+			 int flags)
+{
+	ssize_t len;
+	ssize_t ret;
+	int i;
+
+	len = 0;
+	for (i = 0; i < msg->msg_iovlen; i++) {
+		/* Only the first read may block, and only the first one
+		 * reports the source address
+		 */
+		ret = ztls_recvfrom_ctx(ctx, msg->msg_iov[i].iov_base,
+					msg->msg_iov[i].iov_len,
+					len ? flags | ZSOCK_MSG_DONTWAIT : flags,
+					len ? NULL : msg->msg_name,
+					len ? NULL : &msg->msg_namelen);
+		if (ret < 0) {
+			if (len) {
+				break;
+			}
+			return ret;
+		}
+
+		len += ret;
+
+		if ((size_t)ret < msg->msg_iov[i].iov_len) {
+			break;
+		}
+	}
+
+	msg->msg_controllen = 0;
+	msg->msg_flags = 0;
+
+	return len;
+}
+
 static int ztls_poll_prepare_ctx(struct net_context *ctx,
 				 struct zsock_pollfd *pfd,
 				 struct k_poll_event **pev,
@@ -2024,6 +2061,12 @@ static ssize_t tls_sock_recvfrom_vmeth(void *obj, void *buf, size_t max_len,
 				 src_addr, addrlen);
 }
 
+static ssize_t tls_sock_recvmsg_vmeth(void *obj, struct msghdr *msg,
+				      int flags)
+{
+	return ztls_recvmsg_ctx(obj, msg, flags);
+}
+
 static int tls_sock_getsockopt_vmeth(void *obj, int level, int optname,
 				     void *optval, socklen_t *optlen)
 {
@@ -2050,6 +2093,7 @@ static const struct socket_op_vtable tls_sock_fd_op_vtable = {
 	.sendto = tls_sock_sendto_vmeth,
 	.sendmsg = tls_sock_sendmsg_vmeth,
 	.recvfrom = tls_sock_recvfrom_vmeth,
+	.recvmsg = tls_sock_recvmsg_vmeth,
 	.getsockopt = tls_sock_getsockopt_vmeth,
 	.setsockopt = tls_sock_setsockopt_vmeth,
 };
@@ -33,11 +33,27 @@ extern "C" {
 #define NVS_NAMECNT_ID 0x8000
 #define NVS_NAME_ID_OFFSET 0x4000
 
+#if defined(CONFIG_SETTINGS_NVS_NAME_INDEX)
+/* RAM index entry mapping a hash of a setting's name to its name ID */
+struct settings_nvs_index_entry {
+	u32_t name_hash;
+	u16_t name_id;
+};
+#endif
+
 struct settings_nvs {
 	struct settings_store cf_store;
 	struct nvs_fs cf_nvs;
 	u16_t last_name_id;
 	const char *flash_dev_name;
+#if defined(CONFIG_SETTINGS_NVS_NAME_INDEX)
+	/* Name IDs in use, sorted by ID. Built by loading the settings and
+	 * only used by saves while index_state is valid.
+	 */
+	struct settings_nvs_index_entry index[CONFIG_SETTINGS_NVS_NAME_INDEX_SIZE];
+	u16_t index_count;
+	u8_t index_state;
+#endif
 };
 
 /* register nvs to be a source of settings */
@@ -24,6 +24,153 @@ sys_slist_t settings_handlers;
 
 K_MUTEX_DEFINE(settings_lock);
 
+#if defined(CONFIG_SETTINGS_HANDLER_LOOKUP_TABLE)
+/* Handlers by a hash of their whole name, with linear probing */
+struct settings_lookup_slot {
+	u32_t name_hash;
+	struct settings_handler_static *ch;
+};
+
+static struct settings_lookup_slot
+	settings_lookup[CONFIG_SETTINGS_HANDLER_LOOKUP_TABLE_SIZE];
+
+/* Set once every handler is in the table */
+static bool settings_lookup_ready;
+
+static inline u32_t settings_lookup_hash_step(u32_t hash, char c)
+{
+	/* 32-bit FNV-1a */
+	return (hash ^ (u8_t)c) * 16777619U;
+}
+
+#define SETTINGS_LOOKUP_HASH_INIT 2166136261U
+
+static int settings_lookup_add(struct settings_handler_static *ch)
+{
+	const char *p;
+	u32_t hash = SETTINGS_LOOKUP_HASH_INIT;
+	int depth = 1;
+	int i, n;
+
+	for (p = ch->name; *p != '\0'; p++) {
+		if (*p == SETTINGS_NAME_SEPARATOR) {
+			depth++;
+		}
+		hash = settings_lookup_hash_step(hash, *p);
+	}
+
+	/* Lookups only hash the first SETTINGS_MAX_DIR_DEPTH prefixes */
+	if (depth > SETTINGS_MAX_DIR_DEPTH) {
+		return -ENAMETOOLONG;
+	}
+
+	i = hash % ARRAY_SIZE(settings_lookup);
+
+	for (n = 0; n < ARRAY_SIZE(settings_lookup); n++) {
+		if (!settings_lookup[i].ch ||
+		    (settings_lookup[i].name_hash == hash &&
+		     !strcmp(settings_lookup[i].ch->name, ch->name))) {
+			/* The last handler of a name wins, as in a scan */
+			settings_lookup[i].name_hash = hash;
+			settings_lookup[i].ch = ch;
+			return 0;
+		}
+
+		i = (i + 1) % ARRAY_SIZE(settings_lookup);
+	}
+
+	return -ENOMEM;
+}
+
+static void settings_lookup_init(void)
+{
+	(void)memset(settings_lookup, 0, sizeof(settings_lookup));
+	settings_lookup_ready = false;
+
+	Z_STRUCT_SECTION_FOREACH(settings_handler_static, ch) {
+		if (settings_lookup_add(ch)) {
+			LOG_WRN("Handler lookup table not used");
+			return;
+		}
+	}
+
+	settings_lookup_ready = true;
+}
+
+static struct settings_handler_static *
+settings_lookup_find(u32_t name_hash, const char *name, size_t len)
+{
+	struct settings_handler_static *ch;
+	int i, n;
+
+	i = name_hash % ARRAY_SIZE(settings_lookup);
+
+	for (n = 0; n < ARRAY_SIZE(settings_lookup); n++) {
+		ch = settings_lookup[i].ch;
+		if (!ch) {
+			break;
+		}
+
+		if (settings_lookup[i].name_hash == name_hash &&
+		    !strncmp(ch->name, name, len) && ch->name[len] == '\0') {
+			return ch;
+		}
+
+		i = (i + 1) % ARRAY_SIZE(settings_lookup);
+	}
+
+	return NULL;
+}
+
+/* Best match is the handler of the longest prefix of name ending at a
+ * separator or at its end, so hash every such prefix in one pass and try
+ * them from the longest down.
+ */
+static struct settings_handler_static *
+settings_lookup_parse(const char *name, const char **next)
+{
+	u32_t hash[SETTINGS_MAX_DIR_DEPTH];
+	size_t len[SETTINGS_MAX_DIR_DEPTH];
+	struct settings_handler_static *ch;
+	u32_t h = SETTINGS_LOOKUP_HASH_INIT;
+	const char *p;
+	int depth = 0;
+
+	if (!name) {
+		return NULL;
+	}
+
+	for (p = name; depth < SETTINGS_MAX_DIR_DEPTH; p++) {
+		if (*p == SETTINGS_NAME_SEPARATOR || *p == SETTINGS_NAME_END ||
+		    *p == '\0') {
+			hash[depth] = h;
+			len[depth] = p - name;
+			depth++;
+		}
+
+		if (*p == SETTINGS_NAME_END || *p == '\0') {
+			break;
+		}
+
+		h = settings_lookup_hash_step(h, *p);
+	}
+
+	while (depth--) {
+		ch = settings_lookup_find(hash[depth], name, len[depth]);
+		if (!ch) {
+			continue;
+		}
+
+		if (next && name[len[depth]] == SETTINGS_NAME_SEPARATOR) {
+			*next = &name[len[depth] + 1];
+		}
+
+		return ch;
+	}
+
+	return NULL;
+}
+#endif /* CONFIG_SETTINGS_HANDLER_LOOKUP_TABLE */
 
 void settings_store_init(void);
 
@@ -32,6 +179,9 @@ void settings_init(void)
 #if defined(CONFIG_SETTINGS_DYNAMIC_HANDLERS)
 	sys_slist_init(&settings_handlers);
 #endif /* CONFIG_SETTINGS_DYNAMIC_HANDLERS */
+#if defined(CONFIG_SETTINGS_HANDLER_LOOKUP_TABLE)
+	settings_lookup_init();
+#endif
 	settings_store_init();
 }
 
@@ -57,6 +207,14 @@ int settings_register(struct settings_handler *handler)
 	}
 	sys_slist_append(&settings_handlers, &handler->node);
 
+#if defined(CONFIG_SETTINGS_HANDLER_LOOKUP_TABLE)
+	if (settings_lookup_ready &&
+	    settings_lookup_add((struct settings_handler_static *)handler)) {
+		LOG_WRN("Handler lookup table not used");
+		settings_lookup_ready = false;
+	}
+#endif
+
 end:
 	k_mutex_unlock(&settings_lock);
 	return rc;
@@ -145,6 +303,12 @@ struct settings_handler_static *settings_parse_and_lookup(const char *name,
 		*next = NULL;
 	}
 
+#if defined(CONFIG_SETTINGS_HANDLER_LOOKUP_TABLE)
+	if (settings_lookup_ready) {
+		return settings_lookup_parse(name, next);
+	}
+#endif
+
 	Z_STRUCT_SECTION_FOREACH(settings_handler_static, ch) {
 		if (!settings_name_steq(name, ch->name, &tmpnext)) {
 			continue;
@@ -48,6 +48,128 @@ static ssize_t settings_nvs_read_fn(void *back_end, void *data, size_t len)
 	return rc;
 }
 
+#if defined(CONFIG_SETTINGS_NVS_NAME_INDEX)
+enum {
+	SETTINGS_NVS_INDEX_INVALID,
+	SETTINGS_NVS_INDEX_BUILDING,
+	SETTINGS_NVS_INDEX_VALID,
+};
+
+/* 32-bit FNV-1a, so that a hash match is almost always the name looked for */
+static u32_t settings_nvs_name_hash(const char *name)
+{
+	u32_t hash = 2166136261U;
+
+	while (*name) {
+		hash = (hash ^ (u8_t)*name++) * 16777619U;
+	}
+
+	return hash;
+}
+
+/* Loading reads the names from the largest ID down, so entries are
+ * appended in reverse order and the index is flipped once complete.
+ */
+static void settings_nvs_index_append(struct settings_nvs *cf,
+				      const char *name, u16_t name_id)
+{
+	if (cf->index_state != SETTINGS_NVS_INDEX_BUILDING) {
+		return;
+	}
+
+	if (cf->index_count == ARRAY_SIZE(cf->index)) {
+		LOG_DBG("Name index full, saves will read all names");
+		cf->index_state = SETTINGS_NVS_INDEX_INVALID;
+		return;
+	}
+
+	cf->index[cf->index_count].name_hash = settings_nvs_name_hash(name);
+	cf->index[cf->index_count].name_id = name_id;
+	cf->index_count++;
+}
+
+static void settings_nvs_index_loaded(struct settings_nvs *cf, int ret)
+{
+	struct settings_nvs_index_entry entry;
+	int i;
+
+	if (cf->index_state != SETTINGS_NVS_INDEX_BUILDING || ret) {
+		cf->index_state = SETTINGS_NVS_INDEX_INVALID;
+		return;
+	}
+
+	for (i = 0; i < cf->index_count / 2; i++) {
+		entry = cf->index[i];
+		cf->index[i] = cf->index[cf->index_count - 1 - i];
+		cf->index[cf->index_count - 1 - i] = entry;
+	}
+
+	cf->index_state = SETTINGS_NVS_INDEX_VALID;
+}
+
+/* Position of name_id in the index, or where it is to be inserted */
+static int settings_nvs_index_pos(struct settings_nvs *cf, u16_t name_id)
+{
+	int lo = 0, hi = cf->index_count, mid;
+
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+
+		if (cf->index[mid].name_id < name_id) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+
+static void settings_nvs_index_add(struct settings_nvs *cf, u32_t name_hash,
+				   u16_t name_id)
+{
+	int pos;
+
+	if (cf->index_state != SETTINGS_NVS_INDEX_VALID) {
+		return;
+	}
+
+	if (cf->index_count == ARRAY_SIZE(cf->index)) {
+		LOG_DBG("Name index full, saves will read all names");
+		cf->index_state = SETTINGS_NVS_INDEX_INVALID;
+		return;
+	}
+
+	pos = settings_nvs_index_pos(cf, name_id);
+
+	memmove(&cf->index[pos + 1], &cf->index[pos],
+		(cf->index_count - pos) * sizeof(cf->index[0]));
+
+	cf->index[pos].name_hash = name_hash;
+	cf->index[pos].name_id = name_id;
+	cf->index_count++;
+}
+
+static void settings_nvs_index_remove(struct settings_nvs *cf, u16_t name_id)
+{
+	int pos;
+
+	if (cf->index_state != SETTINGS_NVS_INDEX_VALID) {
+		return;
+	}
+
+	pos = settings_nvs_index_pos(cf, name_id);
+	if (pos == cf->index_count || cf->index[pos].name_id != name_id) {
+		return;
+	}
+
+	cf->index_count--;
+
+	memmove(&cf->index[pos], &cf->index[pos + 1],
+		(cf->index_count - pos) * sizeof(cf->index[0]));
+}
+#endif /* CONFIG_SETTINGS_NVS_NAME_INDEX */
+
 int settings_nvs_src(struct settings_nvs *cf)
 {
 	cf->cf_store.cs_itf = &settings_nvs_itf;
@@ -77,6 +199,11 @@ static int settings_nvs_load(struct settings_store *cs,
 
 	name_id = cf->last_name_id + 1;
 
+#if defined(CONFIG_SETTINGS_NVS_NAME_INDEX)
+	cf->index_count = 0U;
+	cf->index_state = SETTINGS_NVS_INDEX_BUILDING;
+#endif
+
 	while (1) {
 
 		name_id--;
@@ -114,6 +241,11 @@ static int settings_nvs_load(struct settings_store *cs,
 
 		/* Found a name, this might not include a trailing \0 */
 		name[rc1] = '\0';
+
+#if defined(CONFIG_SETTINGS_NVS_NAME_INDEX)
+		settings_nvs_index_append(cf, name, name_id);
+#endif
+
 		read_fn_arg.fs = &cf->cf_nvs;
 		read_fn_arg.id = name_id + NVS_NAME_ID_OFFSET;
 
@@ -125,17 +257,115 @@ static int settings_nvs_load(struct settings_store *cs,
 			break;
 		}
 	}
+
+#if defined(CONFIG_SETTINGS_NVS_NAME_INDEX)
+	settings_nvs_index_loaded(cf, ret);
+#endif
+
 	return ret;
 }
 
+/* Read the name stored at name_id and compare it with name. Returns 0 if
+ * they are equal, 1 if not or the nvs_read error.
+ */
+static int settings_nvs_name_cmp(struct settings_nvs *cf, u16_t name_id,
+				 const char *name)
+{
+	char rdname[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	ssize_t rc;
+
+	rc = nvs_read(&cf->cf_nvs, name_id, &rdname, sizeof(rdname));
+	if (rc < 0) {
+		return rc;
+	}
+
+	rdname[rc] = '\0';
+
+	return strcmp(name, rdname) ? 1 : 0;
+}
+
+/* Find the name ID of a setting by reading every name stored. If it is not
+ * found, name_id is set to the lowest free name ID.
+ */
+static int settings_nvs_scan_find(struct settings_nvs *cf, const char *name,
+				  u16_t *name_id)
+{
+	u16_t id;
+	int rc;
+
+	id = cf->last_name_id + 1;
+	*name_id = cf->last_name_id + 1;
+
+	while (1) {
+		id--;
+		if (id == NVS_NAMECNT_ID) {
+			break;
+		}
+
+		rc = settings_nvs_name_cmp(cf, id, name);
+		if (rc == -ENOENT) {
+			*name_id = id;
+		} else if (rc == 0) {
+			*name_id = id;
+			return 0;
+		}
+	}
+
+	return -ENOENT;
+}
+
+#if defined(CONFIG_SETTINGS_NVS_NAME_INDEX)
+/* Find the name ID of a setting by reading only the names whose hash
+ * matches. If it is not found, name_id is set to the lowest free name ID.
+ */
+static int settings_nvs_index_find(struct settings_nvs *cf, const char *name,
+				   u32_t name_hash, u16_t *name_id)
+{
+	int i, lo, hi;
+
+	for (i = cf->index_count - 1; i >= 0; i--) {
+		if (cf->index[i].name_hash != name_hash) {
+			continue;
+		}
+
+		if (!settings_nvs_name_cmp(cf, cf->index[i].name_id, name)) {
+			*name_id = cf->index[i].name_id;
+			return 0;
+		}
+	}
+
+	/* Name IDs are unique and sorted, so the first entry with an ID
+	 * larger than its position allows is right after the lowest gap.
+	 */
+	lo = 0;
+	hi = cf->index_count;
+
+	while (lo < hi) {
+		i = (lo + hi) / 2;
+
+		if (cf->index[i].name_id > NVS_NAMECNT_ID + 1 + i) {
+			hi = i;
+		} else {
+			lo = i + 1;
+		}
+	}
+
+	*name_id = NVS_NAMECNT_ID + 1 + lo;
+
+	return -ENOENT;
+}
+#endif
+
 static int settings_nvs_save(struct settings_store *cs, const char *name,
 			     const char *value, size_t val_len)
 {
 	struct settings_nvs *cf = (struct settings_nvs *)cs;
-	char rdname[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
-	u16_t name_id, write_name_id;
+	u16_t name_id;
 	bool delete, write_name;
 	int rc = 0;
+#if defined(CONFIG_SETTINGS_NVS_NAME_INDEX)
+	u32_t name_hash;
+#endif
 
 	if (!name) {
 		return -EINVAL;
@@ -144,33 +374,28 @@ static int settings_nvs_save(struct settings_store *cs, const char *name,
 	/* Find out if we are doing a delete */
 	delete = ((value == NULL) || (val_len == 0));
 
-	name_id = cf->last_name_id + 1;
-	write_name_id = cf->last_name_id + 1;
-	write_name = true;
-
-	while (1) {
-		name_id--;
-		if (name_id == NVS_NAMECNT_ID) {
-			break;
-		}
-
-		rc = nvs_read(&cf->cf_nvs, name_id, &rdname, sizeof(rdname));
+#if defined(CONFIG_SETTINGS_NVS_NAME_INDEX)
+	name_hash = settings_nvs_name_hash(name);
 
-		if (rc < 0) {
-			/* Error or entry not found */
-			if (rc == -ENOENT) {
-				write_name_id = name_id;
-			}
-			continue;
-		}
+	if (cf->index_state == SETTINGS_NVS_INDEX_VALID) {
+		rc = settings_nvs_index_find(cf, name, name_hash, &name_id);
+	} else {
+		/* An index being built would miss this save */
+		cf->index_state = SETTINGS_NVS_INDEX_INVALID;
+		rc = settings_nvs_scan_find(cf, name, &name_id);
+	}
+#else
+	rc = settings_nvs_scan_find(cf, name, &name_id);
+#endif
 
-		rdname[rc] = '\0';
+	write_name = (rc == -ENOENT);
 
-		if (strcmp(name, rdname)) {
-			continue;
+	if (delete) {
+		if (write_name) {
+			return 0;
 		}
 
-		if ((delete) && (name_id == cf->last_name_id)) {
+		if (name_id == cf->last_name_id) {
 			cf->last_name_id--;
 			rc = nvs_write(&cf->cf_nvs, NVS_NAMECNT_ID,
 				       &cf->last_name_id, sizeof(u16_t));
@@ -182,49 +407,50 @@ static int settings_nvs_save(struct settings_store *cs, const char *name,
 			}
 		}
 
-		if (delete) {
-			rc = nvs_delete(&cf->cf_nvs, name_id);
-
-			if (rc >= 0) {
-				rc = nvs_delete(&cf->cf_nvs, name_id +
-					NVS_NAME_ID_OFFSET);
-			}
+		rc = nvs_delete(&cf->cf_nvs, name_id);
 
-			if (rc < 0) {
-				return rc;
-			}
+		if (rc >= 0) {
+#if defined(CONFIG_SETTINGS_NVS_NAME_INDEX)
+			settings_nvs_index_remove(cf, name_id);
+#endif
+			rc = nvs_delete(&cf->cf_nvs, name_id +
+				NVS_NAME_ID_OFFSET);
+		}
 
-			return 0;
+		if (rc < 0) {
+			return rc;
 		}
-		write_name_id = name_id;
-		write_name = false;
-		break;
-	}
 
-	if (delete) {
 		return 0;
 	}
 
 	/* No free IDs left. */
-	if (write_name_id == NVS_NAMECNT_ID + NVS_NAME_ID_OFFSET) {
+	if (name_id == NVS_NAMECNT_ID + NVS_NAME_ID_OFFSET) {
 		return -ENOMEM;
 	}
 
 	/* write the value */
-	rc = nvs_write(&cf->cf_nvs, write_name_id + NVS_NAME_ID_OFFSET,
+	rc = nvs_write(&cf->cf_nvs, name_id + NVS_NAME_ID_OFFSET,
 		       value, val_len);
+	if (rc < 0) {
+		return rc;
+	}
 
 	/* write the name if required */
 	if (write_name) {
-		rc = nvs_write(&cf->cf_nvs, write_name_id, name, strlen(name));
+		rc = nvs_write(&cf->cf_nvs, name_id, name, strlen(name));
 		if (rc < 0) {
 			return rc;
 		}
+
+#if defined(CONFIG_SETTINGS_NVS_NAME_INDEX)
+		settings_nvs_index_add(cf, name_hash, name_id);
+#endif
 	}
 
 	/* update the last_name_id and write to flash if required*/
-	if (write_name_id > cf->last_name_id) {
-		cf->last_name_id = write_name_id;
+	if (name_id > cf->last_name_id) {
+		cf->last_name_id = name_id;
 		rc = nvs_write(&cf->cf_nvs, NVS_NAMECNT_ID, &cf->last_name_id,
 			       sizeof(u16_t));
 	}
@@ -247,6 +473,12 @@ int settings_nvs_backend_init(struct settings_nvs *cf)
 		return rc;
 	}
 
+#if defined(CONFIG_SETTINGS_NVS_NAME_INDEX)
+	/* Built by the next load */
+	cf->index_count = 0U;
+	cf->index_state = SETTINGS_NVS_INDEX_INVALID;
+#endif
+
 	rc = nvs_read(&cf->cf_nvs, NVS_NAMECNT_ID, &last_name_id,
 		      sizeof(last_name_id));
 	if (rc < 0) {
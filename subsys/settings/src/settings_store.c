@@ -24,6 +24,203 @@ sys_slist_t settings_load_srcs;
 struct settings_store *settings_save_dst;
 extern struct k_mutex settings_lock;
 
+#if defined(CONFIG_SETTINGS_SAVE_BUFFER)
+/* Values saved in a batch, in the order their keys were first saved */
+struct settings_save_entry {
+	char name[SETTINGS_MAX_NAME_LEN + 1];
+	u8_t val[CONFIG_SETTINGS_SAVE_BUFFER_VAL_LEN];
+	u16_t val_len;
+};
+
+static struct settings_save_entry
+	settings_save_buf[CONFIG_SETTINGS_SAVE_BUFFER_ENTRIES];
+static int settings_save_count;
+static int settings_save_nesting;
+
+#if defined(CONFIG_SETTINGS_SAVE_DEFERRED)
+static struct k_delayed_work settings_save_work;
+#endif
+
+/* Called with settings_lock held */
+static int settings_save_flush_locked(struct settings_store *cs)
+{
+	struct settings_save_entry *entry;
+	int kept = 0;
+	int rc = 0;
+	int rc2;
+	int i;
+
+	if (!settings_save_count) {
+		return 0;
+	}
+
+	if (cs->cs_itf->csi_save_start) {
+		cs->cs_itf->csi_save_start(cs);
+	}
+
+	for (i = 0; i < settings_save_count; i++) {
+		entry = &settings_save_buf[i];
+
+		rc2 = cs->cs_itf->csi_save(cs, entry->name,
+					   entry->val_len ?
+					   (char *)entry->val : NULL,
+					   entry->val_len);
+		if (!rc2) {
+			continue;
+		}
+
+		LOG_ERR("Cannot save %s (%d)", log_strdup(entry->name), rc2);
+
+		if (!rc) {
+			rc = rc2;
+		}
+
+		/* Kept, in order, for the next flush to retry */
+		if (kept != i) {
+			settings_save_buf[kept] = *entry;
+		}
+		kept++;
+	}
+
+	if (cs->cs_itf->csi_save_end) {
+		cs->cs_itf->csi_save_end(cs);
+	}
+
+	settings_save_count = kept;
+
+#if defined(CONFIG_SETTINGS_SAVE_DEFERRED)
+	/* Nothing else would write the failed values out */
+	if (settings_save_count && !settings_save_nesting) {
+		k_delayed_work_submit(&settings_save_work,
+			K_MSEC(CONFIG_SETTINGS_SAVE_DEFERRED_DELAY));
+	}
+#endif
+
+	return rc;
+}
+
+/* Called with settings_lock held */
+static int settings_save_stage(struct settings_store *cs, const char *name,
+			       const void *value, size_t val_len)
+{
+	struct settings_save_entry *entry = NULL;
+	int rc;
+	int i;
+
+	if (strlen(name) > SETTINGS_MAX_NAME_LEN ||
+	    val_len > CONFIG_SETTINGS_SAVE_BUFFER_VAL_LEN) {
+		/* Written through, after anything saved before it */
+		rc = settings_save_flush_locked(cs);
+		if (rc) {
+			return rc;
+		}
+
+		return cs->cs_itf->csi_save(cs, name, (char *)value, val_len);
+	}
+
+	for (i = 0; i < settings_save_count; i++) {
+		if (!strcmp(settings_save_buf[i].name, name)) {
+			entry = &settings_save_buf[i];
+			break;
+		}
+	}
+
+	if (!entry) {
+		if (settings_save_count == ARRAY_SIZE(settings_save_buf)) {
+			rc = settings_save_flush_locked(cs);
+			if (rc) {
+				return rc;
+			}
+		}
+
+#if defined(CONFIG_SETTINGS_SAVE_DEFERRED)
+		/* The delay runs from the first value kept, so that a key
+		 * saved continuously is still written out.
+		 */
+		if (!settings_save_count && !settings_save_nesting) {
+			k_delayed_work_submit(&settings_save_work,
+				K_MSEC(CONFIG_SETTINGS_SAVE_DEFERRED_DELAY));
+		}
+#endif
+
+		entry = &settings_save_buf[settings_save_count++];
+		strcpy(entry->name, name);
+	}
+
+	if (val_len) {
+		memcpy(entry->val, value, val_len);
+	}
+	entry->val_len = val_len;
+
+	return 0;
+}
+
+#if defined(CONFIG_SETTINGS_SAVE_DEFERRED)
+static void settings_save_work_handler(struct k_work *work)
+{
+	int rc;
+
+	k_mutex_lock(&settings_lock, K_FOREVER);
+
+	/* A batch in progress writes everything when committed */
+	if (settings_save_dst && !settings_save_nesting) {
+		rc = settings_save_flush_locked(settings_save_dst);
+		if (rc) {
+			LOG_WRN("Deferred save failed (%d), retrying in %d ms",
+				rc, CONFIG_SETTINGS_SAVE_DEFERRED_DELAY);
+		}
+	}
+
+	k_mutex_unlock(&settings_lock);
+}
+#endif
+
+int settings_save_begin(void)
+{
+	if (!settings_save_dst) {
+		return -ENOENT;
+	}
+
+	k_mutex_lock(&settings_lock, K_FOREVER);
+	settings_save_nesting++;
+	k_mutex_unlock(&settings_lock);
+
+	return 0;
+}
+
+int settings_save_commit(void)
+{
+	int rc = 0;
+
+	k_mutex_lock(&settings_lock, K_FOREVER);
+
+	if (!settings_save_nesting) {
+		rc = -EINVAL;
+	} else if (!--settings_save_nesting) {
+		rc = settings_save_flush_locked(settings_save_dst);
+	}
+
+	k_mutex_unlock(&settings_lock);
+
+	return rc;
+}
+
+int settings_save_flush(void)
+{
+	int rc;
+
+	if (!settings_save_dst) {
+		return -ENOENT;
+	}
+
+	k_mutex_lock(&settings_lock, K_FOREVER);
+	rc = settings_save_flush_locked(settings_save_dst);
+	k_mutex_unlock(&settings_lock);
+
+	return rc;
+}
+#endif /* CONFIG_SETTINGS_SAVE_BUFFER */
+
 void settings_src_register(struct settings_store *cs)
 {
 	sys_slist_append(&settings_load_srcs, &cs->cs_next);
@@ -54,6 +251,12 @@ int settings_load_subtree(const char *subtree)
 	 *    commit all
 	 */
 	k_mutex_lock(&settings_lock, K_FOREVER);
+#if defined(CONFIG_SETTINGS_SAVE_BUFFER)
+	/* Load what was saved, not what was last written */
+	if (settings_save_dst) {
+		(void)settings_save_flush_locked(settings_save_dst);
+	}
+#endif
 	SYS_SLIST_FOR_EACH_CONTAINER(&settings_load_srcs, cs, cs_next) {
 		cs->cs_itf->csi_load(cs, &arg);
 	}
@@ -81,6 +284,12 @@ int settings_load_subtree_direct(
 	 *    commit all
 	 */
 	k_mutex_lock(&settings_lock, K_FOREVER);
+#if defined(CONFIG_SETTINGS_SAVE_BUFFER)
+	/* Load what was saved, not what was last written */
+	if (settings_save_dst) {
+		(void)settings_save_flush_locked(settings_save_dst);
+	}
+#endif
 	SYS_SLIST_FOR_EACH_CONTAINER(&settings_load_srcs, cs, cs_next) {
 		cs->cs_itf->csi_load(cs, &arg);
 	}
@@ -103,7 +312,16 @@ int settings_save_one(const char *name, const void *value, size_t val_len)
 
 	k_mutex_lock(&settings_lock, K_FOREVER);
 
+#if defined(CONFIG_SETTINGS_SAVE_BUFFER)
+	if (settings_save_nesting ||
+	    IS_ENABLED(CONFIG_SETTINGS_SAVE_DEFERRED)) {
+		rc = settings_save_stage(cs, name, value, val_len);
+	} else {
+		rc = cs->cs_itf->csi_save(cs, name, (char *)value, val_len);
+	}
+#else
 	rc = cs->cs_itf->csi_save(cs, name, (char *)value, val_len);
+#endif
 
 	k_mutex_unlock(&settings_lock);
 
@@ -126,9 +344,14 @@ int settings_save(void)
 		return -ENOENT;
 	}
 
+#if defined(CONFIG_SETTINGS_SAVE_BUFFER)
+	/* Written out as one batch, by settings_save_commit() */
+	(void)settings_save_begin();
+#else
 	if (cs->cs_itf->csi_save_start) {
 		cs->cs_itf->csi_save_start(cs);
 	}
+#endif
 	rc = 0;
 
 	Z_STRUCT_SECTION_FOREACH(settings_handler_static, ch) {
@@ -152,13 +375,23 @@ int settings_save(void)
 	}
 #endif /* CONFIG_SETTINGS_DYNAMIC_HANDLERS */
 
+#if defined(CONFIG_SETTINGS_SAVE_BUFFER)
+	rc2 = settings_save_commit();
+	if (!rc) {
+		rc = rc2;
+	}
+#else
 	if (cs->cs_itf->csi_save_end) {
 		cs->cs_itf->csi_save_end(cs);
 	}
+#endif
 	return rc;
 }
 
 void settings_store_init(void)
 {
 	sys_slist_init(&settings_load_srcs);
+#if defined(CONFIG_SETTINGS_SAVE_DEFERRED)
+	k_delayed_work_init(&settings_save_work, settings_save_work_handler);
+#endif
 }
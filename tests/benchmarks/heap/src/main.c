@@ -0,0 +1,229 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/mempool.h>
+#include <sys/sys_heap.h>
+
+#define ARENA_SZ 32768
+#define N_LIVE 64
+#define N_OPS 4000
+#define N_SLOTS 1024
+
+SYS_MEM_POOL_DEFINE(pool, NULL, 16, ARENA_SZ, 1, 8, .data);
+
+static char __aligned(8) heap_mem[ARENA_SZ];
+static struct sys_heap heap;
+
+static void *slots[N_SLOTS];
+static size_t slot_sz[N_SLOTS];
+
+struct allocator {
+	const char *name;
+	void (*reset)(void);
+	void *(*alloc)(size_t bytes);
+	void (*free)(void *mem);
+	/* Consistency check of the allocator, NULL if there is none */
+	bool (*validate)(void);
+};
+
+static void pool_reset(void)
+{
+	sys_mem_pool_init(&pool);
+}
+
+static void *pool_alloc(size_t bytes)
+{
+	return sys_mem_pool_alloc(&pool, bytes);
+}
+
+static void pool_free(void *mem)
+{
+	sys_mem_pool_free(mem);
+}
+
+static void heap_reset(void)
+{
+	sys_heap_init(&heap, heap_mem, sizeof(heap_mem));
+}
+
+static void *heap_alloc(size_t bytes)
+{
+	return sys_heap_alloc(&heap, bytes);
+}
+
+static void heap_free(void *mem)
+{
+	sys_heap_free(&heap, mem);
+}
+
+static bool heap_validate(void)
+{
+	return sys_heap_validate(&heap);
+}
+
+static const struct allocator allocators[] = {
+	{ "mempool", pool_reset, pool_alloc, pool_free, NULL },
+	{ "sys_heap", heap_reset, heap_alloc, heap_free, heap_validate },
+};
+
+static u32_t rand_state;
+
+static u32_t rand32(void)
+{
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+	return rand_state;
+}
+
+/* Mostly small, odd-sized requests with the occasional large one */
+static size_t rand_size(void)
+{
+	u32_t r = rand32() % 100;
+
+	if (r < 60) {
+		return 8 + rand32() % 56;
+	} else if (r < 90) {
+		return 64 + rand32() % 448;
+	}
+	return 512 + rand32() % 1536;
+}
+
+static inline u32_t stamp(void)
+{
+	u32_t t;
+
+#ifdef CONFIG_X86
+	__asm__ volatile("rdtsc" : "=a"(t) : : "edx");
+#else
+	t = k_cycle_get_32();
+#endif
+	return t;
+}
+
+static bool validate(const struct allocator *a, const char *phase)
+{
+	if (a->validate != NULL && !a->validate()) {
+		printk("%s: heap corrupted after %s\n", a->name, phase);
+		return false;
+	}
+
+	return true;
+}
+
+/* Check the allocator with the blocks of a phase still allocated, then
+ * free them and check it again.
+ */
+static bool free_slots(const struct allocator *a, const char *phase)
+{
+	if (!validate(a, phase)) {
+		return false;
+	}
+
+	for (int i = 0; i < N_SLOTS; i++) {
+		if (slots[i] != NULL) {
+			a->free(slots[i]);
+			slots[i] = NULL;
+		}
+	}
+
+	return validate(a, phase);
+}
+
+static int run(const struct allocator *a)
+{
+	u64_t t_alloc = 0U, t_free = 0U;
+	u32_t n_alloc = 0U, n_free = 0U, t0, t1;
+	size_t live, fill, churn = 0;
+
+	/* Throughput over a steady working set */
+	a->reset();
+	rand_state = 2463534242U;
+	for (int n = 0; n < N_OPS; n++) {
+		int i = rand32() % N_LIVE;
+
+		if (slots[i] == NULL) {
+			size_t sz = rand_size();
+
+			t0 = stamp();
+			slots[i] = a->alloc(sz);
+			t1 = stamp();
+			t_alloc += t1 - t0;
+			n_alloc++;
+		} else {
+			t0 = stamp();
+			a->free(slots[i]);
+			t1 = stamp();
+			slots[i] = NULL;
+			t_free += t1 - t0;
+			n_free++;
+		}
+	}
+	if (!free_slots(a, "throughput")) {
+		return -1;
+	}
+
+	/* Fill until the first failure */
+	a->reset();
+	rand_state = 2463534242U;
+	fill = 0;
+	for (int i = 0; i < N_SLOTS; i++) {
+		size_t sz = rand_size();
+
+		slots[i] = a->alloc(sz);
+		if (slots[i] == NULL) {
+			break;
+		}
+		fill += sz;
+	}
+	if (!free_slots(a, "fill")) {
+		return -1;
+	}
+
+	/* Random churn with a growing working set, until first failure */
+	a->reset();
+	rand_state = 2463534242U;
+	live = 0;
+	for (int n = 0; n < N_SLOTS * 8 && churn == 0; n++) {
+		int i = rand32() % MIN(N_SLOTS, 16 + n / 8);
+
+		if (slots[i] == NULL) {
+			slot_sz[i] = rand_size();
+			slots[i] = a->alloc(slot_sz[i]);
+			if (slots[i] == NULL) {
+				churn = live;
+			} else {
+				live += slot_sz[i];
+			}
+		} else {
+			a->free(slots[i]);
+			slots[i] = NULL;
+			live -= slot_sz[i];
+		}
+	}
+	if (!free_slots(a, "churn")) {
+		return -1;
+	}
+
+	printk("%-8s alloc %5u free %5u fill %3u%% churn %3u%%\n", a->name,
+	       (u32_t)(t_alloc / MAX(n_alloc, 1)),
+	       (u32_t)(t_free / MAX(n_free, 1)),
+	       (u32_t)(fill * 100 / ARENA_SZ),
+	       (u32_t)(churn * 100 / ARENA_SZ));
+
+	return 0;
+}
+
+void main(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(allocators); i++) {
+		if (run(&allocators[i]) < 0) {
+			return;
+		}
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,132 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file measure time to wake a thread waiting on any of several conditions
+ *
+ * A higher priority thread waits for any of N_CONDITIONS conditions and the
+ * test thread satisfies one of them, so the measured time covers the
+ * signalling call, the wakeup and the switch to the waiter.  This is done
+ * once with a single k_event and once with an array of k_poll signals,
+ * which the waiter has to re-register on every k_poll() call.
+ */
+
+#include <zephyr.h>
+
+#include "timestamp.h"
+#include "utils.h"
+
+#include <arch/cpu.h>
+
+/* the number of wakeups measured */
+#define N_TEST_WAKE 1000
+
+/* the number of conditions the waiter waits on */
+#define N_CONDITIONS 4
+
+#define WAITER_STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define WAITER_PRIO 9
+
+static K_THREAD_STACK_DEFINE(waiter_stack, WAITER_STACK_SIZE);
+static struct k_thread waiter_thread;
+
+static volatile u32_t wake_stamp;
+static u32_t wake_total;
+
+K_EVENT_DEFINE(wake_event);
+
+static struct k_poll_signal wake_signals[N_CONDITIONS];
+static struct k_poll_event wake_poll_events[N_CONDITIONS];
+
+static void event_waiter(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (int i = 0; i < N_TEST_WAKE; i++) {
+		(void)k_event_wait(&wake_event, BIT_MASK(N_CONDITIONS),
+				   K_EVENT_WAIT_ANY | K_EVENT_WAIT_CLEAR,
+				   K_FOREVER);
+		wake_total += TIME_STAMP_DELTA_GET(wake_stamp);
+	}
+}
+
+static void poll_waiter(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (int i = 0; i < N_TEST_WAKE; i++) {
+		(void)k_poll(wake_poll_events, N_CONDITIONS, K_FOREVER);
+		wake_total += TIME_STAMP_DELTA_GET(wake_stamp);
+
+		for (int j = 0; j < N_CONDITIONS; j++) {
+			wake_poll_events[j].state = K_POLL_STATE_NOT_READY;
+			k_poll_signal_reset(&wake_signals[j]);
+		}
+	}
+}
+
+static void run(const char *name, k_thread_entry_t waiter,
+		void (*wake)(int cond))
+{
+	wake_total = 0U;
+
+	bench_test_start();
+	k_thread_create(&waiter_thread, waiter_stack, WAITER_STACK_SIZE,
+			waiter, NULL, NULL, NULL, WAITER_PRIO, 0, K_NO_WAIT);
+
+	for (int i = 0; i < N_TEST_WAKE; i++) {
+		wake_stamp = TIME_STAMP_DELTA_GET(0);
+		wake(i % N_CONDITIONS);
+	}
+
+	if (bench_test_end() == 0) {
+		PRINT_FORMAT(" Average %s wakeup time %u tcs = %u nsec", name,
+			     wake_total / N_TEST_WAKE,
+			     SYS_CLOCK_HW_CYCLES_TO_NS_AVG(wake_total,
+							   N_TEST_WAKE));
+	} else {
+		error_count++;
+		PRINT_OVERFLOW_ERROR();
+	}
+
+	k_thread_abort(&waiter_thread);
+}
+
+static void event_wake(int cond)
+{
+	(void)k_event_post(&wake_event, BIT(cond));
+}
+
+static void poll_wake(int cond)
+{
+	(void)k_poll_signal_raise(&wake_signals[cond], 0);
+}
+
+/**
+ *
+ * @brief Measure the wakeup latency of k_event against k_poll
+ *
+ * @return 0 on success
+ */
+int event_wake_latency(void)
+{
+	PRINT_FORMAT(" 7 - Measure average time to wake a thread waiting on"
+		     " any of %d conditions", N_CONDITIONS);
+
+	run("k_event", event_waiter, event_wake);
+
+	for (int j = 0; j < N_CONDITIONS; j++) {
+		k_poll_signal_init(&wake_signals[j]);
+		k_poll_event_init(&wake_poll_events[j], K_POLL_TYPE_SIGNAL,
+				  K_POLL_MODE_NOTIFY_ONLY, &wake_signals[j]);
+	}
+
+	run("k_poll", poll_waiter, poll_wake);
+
+	return 0;
+}
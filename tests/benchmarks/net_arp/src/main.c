@@ -0,0 +1,187 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/net_if.h>
+#include <net/net_pkt.h>
+#include <net/ethernet.h>
+
+#include "arp.h"
+
+#define MAX_ENTRIES CONFIG_NET_ARP_TABLE_SIZE
+#define ROUNDS 8
+
+/* Neighbors are 10.0.1.1 onwards, on a /16 */
+#define MY_ADDR 0x0a000001
+#define NETMASK 0xffff0000
+#define PEER_ADDR(i) (0x0a000101 + (i))
+
+static const int n_entries[] = { 16, 128, 512 };
+
+static u8_t mac_addr[sizeof(struct net_eth_addr)] = {
+	0x00, 0x00, 0x5e, 0x00, 0x53, 0x01
+};
+
+static void bench_iface_init(struct net_if *iface)
+{
+	net_if_set_link_addr(iface, mac_addr, sizeof(mac_addr),
+			     NET_LINK_ETHERNET);
+}
+
+static int bench_dev_init(struct device *dev)
+{
+	return 0;
+}
+
+static int bench_send(struct device *dev, struct net_pkt *pkt)
+{
+	/* ARP replies to the neighbors are dropped */
+	return 0;
+}
+
+static const struct ethernet_api bench_if_api = {
+	.iface_api.init = bench_iface_init,
+	.send = bench_send,
+};
+
+NET_DEVICE_INIT(net_arp_bench, "net_arp_bench", bench_dev_init, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &bench_if_api,
+		ETHERNET_L2, NET_L2_GET_CTX_TYPE(ETHERNET_L2), NET_ETH_MTU);
+
+static int learn(struct net_if *iface, int i)
+{
+	struct net_eth_hdr *eth_hdr;
+	struct net_arp_hdr *hdr;
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_alloc_with_buffer(iface, sizeof(struct net_eth_hdr) +
+					sizeof(struct net_arp_hdr),
+					AF_UNSPEC, 0, K_FOREVER);
+	if (!pkt) {
+		printk("cannot allocate ARP request %d\n", i);
+		return -1;
+	}
+
+	eth_hdr = (struct net_eth_hdr *)net_pkt_data(pkt);
+	net_buf_add(pkt->buffer, sizeof(struct net_eth_hdr));
+	net_buf_pull(pkt->buffer, sizeof(struct net_eth_hdr));
+
+	(void)memset(&eth_hdr->dst, 0xff, sizeof(struct net_eth_addr));
+	(void)memset(&eth_hdr->src, 0, sizeof(struct net_eth_addr));
+	eth_hdr->src.addr[0] = 0x02;
+	eth_hdr->src.addr[4] = i >> 8;
+	eth_hdr->src.addr[5] = i;
+	eth_hdr->type = htons(NET_ETH_PTYPE_ARP);
+
+	hdr = NET_ARP_HDR(pkt);
+	hdr->hwtype = htons(NET_ARP_HTYPE_ETH);
+	hdr->protocol = htons(NET_ETH_PTYPE_IP);
+	hdr->hwlen = sizeof(struct net_eth_addr);
+	hdr->protolen = sizeof(struct in_addr);
+	hdr->opcode = htons(NET_ARP_REQUEST);
+
+	/* A request for our address, with the sender to be cached */
+	memcpy(&hdr->src_hwaddr, &eth_hdr->src, sizeof(struct net_eth_addr));
+	(void)memset(&hdr->dst_hwaddr, 0, sizeof(struct net_eth_addr));
+	UNALIGNED_PUT(htonl(PEER_ADDR(i)), &hdr->src_ipaddr.s_addr);
+	UNALIGNED_PUT(htonl(MY_ADDR), &hdr->dst_ipaddr.s_addr);
+
+	net_buf_add(pkt->buffer, sizeof(struct net_arp_hdr));
+
+	if (net_arp_input(pkt, eth_hdr) == NET_DROP) {
+		net_pkt_unref(pkt);
+	}
+
+	return 0;
+}
+
+static void count_cb(struct arp_entry *entry, void *user_data)
+{
+}
+
+static int run(struct net_if *iface, int count)
+{
+	struct in_addr dst;
+	struct net_pkt *pkt;
+	u32_t cycles = 0U;
+	int cached;
+
+	for (int i = 0; i < count; i++) {
+		if (learn(iface, i) < 0) {
+			net_arp_clear_cache(iface);
+			return -1;
+		}
+	}
+
+	cached = net_arp_foreach(count_cb, NULL);
+	if (cached != count) {
+		printk("%d of %d neighbors cached\n", cached, count);
+		net_arp_clear_cache(iface);
+		return -1;
+	}
+
+	pkt = net_pkt_alloc_with_buffer(iface, sizeof(struct net_ipv4_hdr),
+					AF_INET, 0, K_FOREVER);
+	if (!pkt) {
+		printk("cannot allocate packet\n");
+		net_arp_clear_cache(iface);
+		return -1;
+	}
+
+	for (int round = 0; round < ROUNDS; round++) {
+		for (int i = 0; i < count; i++) {
+			struct net_pkt *ret;
+			u32_t t0;
+
+			dst.s_addr = htonl(PEER_ADDR(i));
+
+			t0 = k_cycle_get_32();
+			ret = net_arp_prepare(pkt, &dst, NULL);
+			cycles += k_cycle_get_32() - t0;
+
+			if (ret != pkt) {
+				printk("neighbor %d not found\n", i);
+				net_pkt_unref(pkt);
+				net_arp_clear_cache(iface);
+				return -1;
+			}
+		}
+	}
+
+	net_pkt_unref(pkt);
+
+	net_arp_clear_cache(iface);
+
+	printk("arp entries %3d %6u cycles/packet\n", count,
+	       cycles / (count * ROUNDS));
+
+	return 0;
+}
+
+void main(void)
+{
+	struct net_if *iface = net_if_get_default();
+	struct in_addr addr = { .s_addr = htonl(MY_ADDR) };
+	struct in_addr netmask = { .s_addr = htonl(NETMASK) };
+
+	(void)net_if_ipv4_addr_add(iface, &addr, NET_ADDR_MANUAL, 0);
+	net_if_ipv4_set_netmask(iface, &netmask);
+
+	printk("net_arp hash buckets %d\n", CONFIG_NET_ARP_HASH_BUCKETS);
+
+	for (int i = 0; i < ARRAY_SIZE(n_entries); i++) {
+		if (n_entries[i] > MAX_ENTRIES) {
+			printk("arp table too small for %d entries\n",
+			       n_entries[i]);
+			return;
+		}
+
+		if (run(iface, n_entries[i]) < 0) {
+			return;
+		}
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,182 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/net_if.h>
+#include <net/net_pkt.h>
+#include <net/dummy.h>
+
+#define ROUNDS 50
+#define BATCH 8
+
+/* Frame lengths of a traffic mix, repeated in this order */
+struct traffic_mix {
+	const char *name;
+	const u16_t *len;
+	int count;
+};
+
+/* TCP ACKs with an occasional full frame */
+static const u16_t ack_len[] = { 54, 54, 54, 54, 54, 54, 54, 54, 54, 1514 };
+
+static const u16_t bulk_len[] = { 1514 };
+
+/* Simple IMIX, 7:4:1 */
+static const u16_t imix_len[] = { 60, 590, 60, 60, 590, 60, 1514, 60, 590,
+				  60, 60, 590 };
+
+static const struct traffic_mix mixes[] = {
+	{ "ack", ack_len, ARRAY_SIZE(ack_len) },
+	{ "bulk", bulk_len, ARRAY_SIZE(bulk_len) },
+	{ "imix", imix_len, ARRAY_SIZE(imix_len) },
+};
+
+static u8_t frame[1514];
+static u8_t mac_addr[] = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x01 };
+
+static void bench_iface_init(struct net_if *iface)
+{
+	net_if_set_link_addr(iface, mac_addr, sizeof(mac_addr),
+			     NET_LINK_ETHERNET);
+}
+
+static int bench_dev_init(struct device *dev)
+{
+	return 0;
+}
+
+static int bench_send(struct device *dev, struct net_pkt *pkt)
+{
+	return 0;
+}
+
+static struct dummy_api bench_if_api = {
+	.iface_api.init = bench_iface_init,
+	.send = bench_send,
+};
+
+NET_DEVICE_INIT(net_buf_class_bench, "net_buf_class_bench", bench_dev_init,
+		NULL, NULL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &bench_if_api,
+		DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), 1500);
+
+static u32_t frags_count(struct net_pkt *pkt)
+{
+	struct net_buf *buf;
+	u32_t count = 0U;
+
+	for (buf = pkt->buffer; buf; buf = buf->frags) {
+		count++;
+	}
+
+	return count;
+}
+
+/* Data memory held by the buffers currently allocated from the pool */
+static u32_t data_in_use(struct net_buf_pool *pool)
+{
+#if defined(CONFIG_NET_BUF_CLASS_DATA_SIZE)
+	const struct net_buf_pool_class *pc = net_buf_pool_classes(pool);
+	u32_t bytes = 0U;
+	int i;
+
+	for (i = 0; i < pc->count; i++) {
+		bytes += k_mem_slab_num_used_get(pc->classes[i]->slab) *
+			 pc->classes[i]->size;
+	}
+
+	return bytes;
+#else
+	return (pool->buf_count - pool->avail_count) *
+		CONFIG_NET_BUF_DATA_SIZE;
+#endif
+}
+
+static void unref_pkts(struct net_pkt **pkts, int count)
+{
+	for (int i = 0; i < count; i++) {
+		net_pkt_unref(pkts[i]);
+	}
+}
+
+static int run_mix(struct net_if *iface, const struct traffic_mix *mix)
+{
+	struct net_buf_pool *tx_data;
+	struct net_pkt *pkts[BATCH];
+	u32_t frags = 0U, bytes = 0U, reserved = 0U, cycles = 0U;
+	int n = 0, i;
+
+	net_pkt_get_info(NULL, NULL, NULL, &tx_data);
+
+	for (int round = 0; round < ROUNDS; round++) {
+		for (i = 0; i < BATCH; i++, n++) {
+			u16_t len = mix->len[n % mix->count];
+			u32_t t0 = k_cycle_get_32();
+
+			pkts[i] = net_pkt_alloc_with_buffer(iface, len,
+							    AF_UNSPEC, 0,
+							    K_NO_WAIT);
+			if (!pkts[i]) {
+				printk("%s: cannot allocate %u byte packet\n",
+				       mix->name, len);
+				unref_pkts(pkts, i);
+				return -1;
+			}
+
+			/* The cost of the cursor depends on the chain */
+			if (net_pkt_write(pkts[i], frame, len) < 0) {
+				printk("%s: cannot write %u byte packet\n",
+				       mix->name, len);
+				unref_pkts(pkts, i + 1);
+				return -1;
+			}
+
+			net_pkt_cursor_init(pkts[i]);
+
+			if (net_pkt_read(pkts[i], frame, len) < 0) {
+				printk("%s: cannot read %u byte packet\n",
+				       mix->name, len);
+				unref_pkts(pkts, i + 1);
+				return -1;
+			}
+
+			cycles += k_cycle_get_32() - t0;
+
+			frags += frags_count(pkts[i]);
+			bytes += len;
+		}
+
+		reserved += data_in_use(tx_data);
+
+		unref_pkts(pkts, BATCH);
+	}
+
+	printk("%-5s %u.%02u frags/pkt %3u%% efficiency %6u cycles/pkt\n",
+	       mix->name, frags / n, frags * 100U / n % 100U,
+	       (u32_t)((u64_t)bytes * 100U / reserved), cycles / n);
+
+	return 0;
+}
+
+void main(void)
+{
+	struct net_if *iface = net_if_get_default();
+	int i;
+
+#if defined(CONFIG_NET_BUF_CLASS_DATA_SIZE)
+	printk("net_buf_class %d/%d/%d byte data classes\n",
+	       CONFIG_NET_BUF_DATA_SIZE, CONFIG_NET_BUF_DATA_CLASS_MEDIUM_SIZE,
+	       CONFIG_NET_BUF_DATA_CLASS_LARGE_SIZE);
+#else
+	printk("net_buf_class %d byte fixed data\n", CONFIG_NET_BUF_DATA_SIZE);
+#endif
+
+	for (i = 0; i < ARRAY_SIZE(mixes); i++) {
+		if (run_mix(iface, &mixes[i]) < 0) {
+			return;
+		}
+	}
+
+	printk("fin\n");
+}
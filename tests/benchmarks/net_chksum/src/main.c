@@ -0,0 +1,158 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <random/rand32.h>
+#include <net/net_pkt.h>
+
+#include "net_private.h"
+
+#define ROUNDS 64
+
+static const size_t lengths[] = { 64, 576, 1500 };
+
+static u8_t payload[1500];
+
+/* The previous implementation, 16 bits at a time with a carry per word */
+static u16_t ref_calc_chksum(u16_t sum, const u8_t *data, size_t len)
+{
+	const u8_t *end;
+	u16_t tmp;
+
+	end = data + len - 1;
+
+	while (data < end) {
+		tmp = (data[0] << 8) + data[1];
+		sum += tmp;
+		if (sum < tmp) {
+			sum++;
+		}
+
+		data += 2;
+	}
+
+	if (data == end) {
+		tmp = data[0] << 8;
+		sum += tmp;
+		if (sum < tmp) {
+			sum++;
+		}
+	}
+
+	return sum;
+}
+
+static u16_t ref_chksum(struct net_pkt *pkt)
+{
+	struct net_buf *buf = pkt->frags;
+	const u8_t *pos = buf->data;
+	size_t len = buf->len;
+	u16_t sum = 0U;
+
+	while (buf) {
+		sum = ref_calc_chksum(sum, pos, len);
+
+		buf = buf->frags;
+		if (!buf || !buf->len) {
+			break;
+		}
+
+		pos = buf->data;
+
+		if (len % 2) {
+			sum += *pos;
+			if (sum < *pos) {
+				sum++;
+			}
+
+			pos++;
+			len = buf->len - 1;
+		} else {
+			len = buf->len;
+		}
+	}
+
+	sum = (sum == 0U) ? 0xffff : htons(sum);
+
+	return ~sum;
+}
+
+/* No IP header, so that the ICMPv4 checksum covers the whole packet */
+static struct net_pkt *build(size_t len, size_t frag_len)
+{
+	struct net_pkt *pkt = net_pkt_alloc(K_FOREVER);
+	struct net_buf *frag;
+	size_t pos, flen;
+
+	net_pkt_set_family(pkt, AF_INET);
+	net_pkt_set_ip_hdr_len(pkt, 0);
+
+	for (pos = 0; pos < len; pos += flen) {
+		flen = MIN(frag_len, len - pos);
+
+		frag = net_pkt_get_frag(pkt, K_FOREVER);
+		net_buf_add_mem(frag, payload + pos, flen);
+		net_pkt_frag_add(pkt, frag);
+	}
+
+	return pkt;
+}
+
+static int run(const char *layout, size_t len, size_t frag_len)
+{
+	struct net_pkt *pkt = build(len, frag_len);
+	u32_t ref_cycles = 0U;
+	u32_t cycles = 0U;
+	u16_t ref_sum = 0U;
+	u16_t sum = 0U;
+
+	for (int round = 0; round < ROUNDS; round++) {
+		u32_t t0;
+
+		t0 = k_cycle_get_32();
+		ref_sum = ref_chksum(pkt);
+		ref_cycles += k_cycle_get_32() - t0;
+
+		t0 = k_cycle_get_32();
+		sum = net_calc_chksum_icmpv4(pkt);
+		cycles += k_cycle_get_32() - t0;
+	}
+
+	net_pkt_unref(pkt);
+
+	if (sum != ref_sum) {
+		printk("%s %zu bytes: checksum 0x%04x, expected 0x%04x\n",
+		       layout, len, sum, ref_sum);
+		return -1;
+	}
+
+	printk("%-4s reference %4zu bytes %6u cycles/packet\n", layout, len,
+	       ref_cycles / ROUNDS);
+	printk("%-4s engine    %4zu bytes %6u cycles/packet\n", layout, len,
+	       cycles / ROUNDS);
+
+	return 0;
+}
+
+void main(void)
+{
+	for (int i = 0; i < sizeof(payload); i++) {
+		payload[i] = sys_rand32_get();
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(lengths); i++) {
+		if (run("even", lengths[i], 128) < 0) {
+			return;
+		}
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(lengths); i++) {
+		if (run("odd", lengths[i], 127) < 0) {
+			return;
+		}
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,140 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/net_if.h>
+#include <net/net_pkt.h>
+#include <net/udp.h>
+
+#include "connection.h"
+
+#define MAX_CONNS 128
+#define ROUNDS 8
+
+#define BASE_PORT 1000
+#define SERVER_PORT 80
+#define CLIENT_PORT 40000
+
+static const int n_conns[] = { 4, 32, MAX_CONNS };
+
+static struct net_conn_handle *handles[MAX_CONNS];
+static u32_t delivered;
+
+static struct in6_addr my_addr = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+				       0, 0, 0, 0, 0, 0, 0, 0x1 } } };
+static struct in6_addr peer_addr = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+					 0, 0, 0, 0, 0, 0, 0, 0x2 } } };
+
+static struct net_ipv6_hdr ipv6_hdr;
+static struct net_udp_hdr udp_hdr;
+
+static enum net_verdict conn_cb(struct net_conn *conn, struct net_pkt *pkt,
+				union net_ip_header *ip_hdr,
+				union net_proto_header *proto_hdr,
+				void *user_data)
+{
+	/* The packet is reused, so do not take it */
+	delivered++;
+
+	return NET_CONTINUE;
+}
+
+static int run(const char *name, int count, bool connected)
+{
+	union net_ip_header ip_hdr = { .ipv6 = &ipv6_hdr };
+	union net_proto_header proto_hdr = { .udp = &udp_hdr };
+	struct sockaddr_in6 local = {
+		.sin6_family = AF_INET6,
+	};
+	struct sockaddr_in6 remote = {
+		.sin6_family = AF_INET6,
+		.sin6_addr = peer_addr,
+	};
+	struct net_pkt *pkt;
+	u32_t cycles = 0U;
+	int ret = 0;
+
+	for (int i = 0; i < count; i++) {
+		if (connected) {
+			ret = net_conn_register(IPPROTO_UDP, AF_INET6,
+						(struct sockaddr *)&remote,
+						(struct sockaddr *)&local,
+						CLIENT_PORT + i, SERVER_PORT,
+						conn_cb, NULL, &handles[i]);
+		} else {
+			ret = net_conn_register(IPPROTO_UDP, AF_INET6, NULL,
+						(struct sockaddr *)&local,
+						0, BASE_PORT + i,
+						conn_cb, NULL, &handles[i]);
+		}
+		if (ret < 0) {
+			printk("cannot register connection %d (%d)\n", i, ret);
+			count = i;
+			goto out;
+		}
+	}
+
+	pkt = net_pkt_alloc_on_iface(net_if_get_default(), K_FOREVER);
+	net_pkt_set_family(pkt, AF_INET6);
+	net_ipaddr_copy(&ipv6_hdr.src, &peer_addr);
+	net_ipaddr_copy(&ipv6_hdr.dst, &my_addr);
+
+	delivered = 0U;
+
+	for (int round = 0; round < ROUNDS; round++) {
+		for (int i = 0; i < count; i++) {
+			u32_t t0;
+
+			if (connected) {
+				udp_hdr.src_port = htons(CLIENT_PORT + i);
+				udp_hdr.dst_port = htons(SERVER_PORT);
+			} else {
+				udp_hdr.src_port = htons(CLIENT_PORT);
+				udp_hdr.dst_port = htons(BASE_PORT + i);
+			}
+
+			t0 = k_cycle_get_32();
+			(void)net_conn_input(pkt, &ip_hdr, IPPROTO_UDP,
+					     &proto_hdr);
+			cycles += k_cycle_get_32() - t0;
+		}
+	}
+
+	net_pkt_unref(pkt);
+
+	if (delivered != count * ROUNDS) {
+		printk("%u packets lost\n", count * ROUNDS - delivered);
+		ret = -1;
+	} else {
+		printk("%-9s conns %3d %6u cycles/packet\n", name, count,
+		       cycles / (count * ROUNDS));
+	}
+
+out:
+	for (int i = 0; i < count; i++) {
+		(void)net_conn_unregister(handles[i]);
+	}
+
+	return ret;
+}
+
+void main(void)
+{
+	printk("net_conn hash buckets %d\n", CONFIG_NET_CONN_HASH_BUCKETS);
+
+	for (int i = 0; i < ARRAY_SIZE(n_conns); i++) {
+		if (run("listen", n_conns[i], false) < 0) {
+			return;
+		}
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(n_conns); i++) {
+		if (run("connected", n_conns[i], true) < 0) {
+			return;
+		}
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,164 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/net_if.h>
+#include <net/net_pkt.h>
+#include <net/dummy.h>
+
+#include "ipv6.h"
+#include "route.h"
+
+#define MAX_ROUTES CONFIG_NET_MAX_ROUTES
+#define NEXTHOPS 8
+#define ROUNDS 8
+
+static const int n_routes[] = { 10, 100, 1000 };
+
+static struct net_route_entry *routes[MAX_ROUTES];
+
+/* Mesh nodes are fd00::1:0 onwards, behind link local next hops */
+static struct in6_addr node_addr = { { { 0xfd, 0, 0, 0, 0, 0, 0, 0,
+					 0, 0, 0, 0, 0, 0x1, 0, 0 } } };
+static struct in6_addr nexthop_addr = { { { 0xfe, 0x80, 0, 0, 0, 0, 0, 0,
+					    0, 0, 0, 0, 0, 0, 0, 0 } } };
+
+static u8_t mac_addr[] = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x01 };
+
+static void bench_iface_init(struct net_if *iface)
+{
+	net_if_set_link_addr(iface, mac_addr, sizeof(mac_addr),
+			     NET_LINK_ETHERNET);
+}
+
+static int bench_dev_init(struct device *dev)
+{
+	return 0;
+}
+
+static int bench_send(struct device *dev, struct net_pkt *pkt)
+{
+	return 0;
+}
+
+static struct dummy_api bench_if_api = {
+	.iface_api.init = bench_iface_init,
+	.send = bench_send,
+};
+
+NET_DEVICE_INIT(net_route_bench, "net_route_bench", bench_dev_init, NULL,
+		NULL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &bench_if_api,
+		DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), 1280);
+
+static void set_index(struct in6_addr *addr, int i)
+{
+	addr->s6_addr[14] = i >> 8;
+	addr->s6_addr[15] = i;
+}
+
+static int add_nexthops(struct net_if *iface)
+{
+	static u8_t lladdr[NEXTHOPS][sizeof(mac_addr)];
+
+	for (int i = 0; i < NEXTHOPS; i++) {
+		struct net_linkaddr ll = {
+			.addr = lladdr[i],
+			.len = sizeof(mac_addr),
+			.type = NET_LINK_ETHERNET,
+		};
+		struct in6_addr addr = nexthop_addr;
+		struct net_nbr *nbr;
+
+		memcpy(lladdr[i], mac_addr, sizeof(mac_addr));
+		lladdr[i][5] = 0x10 + i;
+		addr.s6_addr[15] = 0x10 + i;
+
+		nbr = net_ipv6_nbr_add(iface, &addr, &ll, true,
+				       NET_IPV6_NBR_STATE_STATIC);
+		if (!nbr) {
+			printk("cannot add next hop %d\n", i);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int run(struct net_if *iface, int count)
+{
+	struct in6_addr dst = node_addr;
+	u32_t cycles = 0U;
+	int ret = 0;
+
+	for (int i = 0; i < count; i++) {
+		struct in6_addr nexthop = nexthop_addr;
+
+		nexthop.s6_addr[15] = 0x10 + i % NEXTHOPS;
+		set_index(&dst, i);
+
+		routes[i] = net_route_add(iface, &dst, 128, &nexthop);
+		if (!routes[i]) {
+			printk("cannot add route %d\n", i);
+			count = i;
+			ret = -1;
+			goto out;
+		}
+	}
+
+	for (int round = 0; round < ROUNDS; round++) {
+		for (int i = 0; i < count; i++) {
+			struct net_route_entry *route;
+			u32_t t0;
+
+			set_index(&dst, i);
+
+			t0 = k_cycle_get_32();
+			route = net_route_lookup(NULL, &dst);
+			cycles += k_cycle_get_32() - t0;
+
+			if (route != routes[i]) {
+				printk("route %d not found\n", i);
+				ret = -1;
+				goto out;
+			}
+		}
+	}
+
+	printk("routes %4d %6u cycles/packet\n", count,
+	       cycles / (count * ROUNDS));
+
+out:
+	for (int i = 0; i < count; i++) {
+		(void)net_route_del(routes[i]);
+	}
+
+	return ret;
+}
+
+void main(void)
+{
+	struct net_if *iface = net_if_get_default();
+
+	if (add_nexthops(iface) < 0) {
+		return;
+	}
+
+	printk("net_route trie %s\n",
+	       IS_ENABLED(CONFIG_NET_ROUTE_TRIE) ? "enabled" : "disabled");
+
+	for (int i = 0; i < ARRAY_SIZE(n_routes); i++) {
+		if (n_routes[i] > MAX_ROUTES) {
+			printk("route table too small for %d routes\n",
+			       n_routes[i]);
+			return;
+		}
+
+		if (run(iface, n_routes[i]) < 0) {
+			return;
+		}
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,192 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/net_if.h>
+#include <net/net_pkt.h>
+#include <net/udp.h>
+
+#include "connection.h"
+
+#define BURST CONFIG_NET_RX_POLL_BUDGET
+#define ROUNDS 64
+#define PAYLOAD_LEN 64
+#define BURST_TIMEOUT K_MSEC(1000)
+
+#define SERVER_PORT 4242
+#define CLIENT_PORT 9898
+
+static struct in6_addr my_addr = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+				       0, 0, 0, 0, 0, 0, 0, 0x1 } } };
+static struct in6_addr peer_addr = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+					 0, 0, 0, 0, 0, 0, 0, 0x2 } } };
+
+static struct net_if *iface;
+static u32_t delivered;
+static K_SEM_DEFINE(burst_done, 0, 1);
+
+static enum net_verdict conn_cb(struct net_conn *conn, struct net_pkt *pkt,
+				union net_ip_header *ip_hdr,
+				union net_proto_header *proto_hdr,
+				void *user_data)
+{
+	net_pkt_unref(pkt);
+
+	if (++delivered == BURST) {
+		k_sem_give(&burst_done);
+	}
+
+	return NET_OK;
+}
+
+static struct net_pkt *build_pkt(void)
+{
+	u16_t len = sizeof(struct net_udp_hdr) + PAYLOAD_LEN;
+	struct net_ipv6_hdr ipv6_hdr = {
+		.vtc = 0x60,
+		.len = htons(len),
+		.nexthdr = IPPROTO_UDP,
+		.hop_limit = 64,
+	};
+	struct net_udp_hdr udp_hdr = {
+		.src_port = htons(CLIENT_PORT),
+		.dst_port = htons(SERVER_PORT),
+		.len = htons(len),
+	};
+	u8_t payload[PAYLOAD_LEN] = { 0 };
+	struct net_pkt *pkt;
+
+	net_ipaddr_copy(&ipv6_hdr.src, &peer_addr);
+	net_ipaddr_copy(&ipv6_hdr.dst, &my_addr);
+
+	pkt = net_pkt_rx_alloc_with_buffer(iface, sizeof(ipv6_hdr) + len,
+					   AF_UNSPEC, 0, K_FOREVER);
+	if (!pkt) {
+		return NULL;
+	}
+
+	if (net_pkt_write(pkt, &ipv6_hdr, sizeof(ipv6_hdr)) ||
+	    net_pkt_write(pkt, &udp_hdr, sizeof(udp_hdr)) ||
+	    net_pkt_write(pkt, payload, sizeof(payload))) {
+		net_pkt_unref(pkt);
+		return NULL;
+	}
+
+	return pkt;
+}
+
+/* Both return the number of packets handed to the stack, the others
+ * are dropped
+ */
+static int recv_single(struct net_pkt **pkts)
+{
+	int count = 0;
+
+	for (int i = 0; i < BURST; i++) {
+		if (net_recv_data(iface, pkts[i]) < 0) {
+			net_pkt_unref(pkts[i]);
+			continue;
+		}
+
+		count++;
+	}
+
+	return count;
+}
+
+static int recv_batch(struct net_pkt **pkts)
+{
+	sys_slist_t batch;
+
+	sys_slist_init(&batch);
+
+	for (int i = 0; i < BURST; i++) {
+		net_pkt_rx_batch_add(&batch, pkts[i]);
+	}
+
+	return net_recv_data_batch(&batch);
+}
+
+static int run(const char *name, int (*recv)(struct net_pkt **pkts))
+{
+	struct net_pkt *pkts[BURST];
+	u64_t cycles = 0U;
+	u32_t per_pkt;
+
+	for (int round = 0; round < ROUNDS; round++) {
+		u32_t t0;
+		int queued;
+
+		for (int i = 0; i < BURST; i++) {
+			pkts[i] = build_pkt();
+			if (!pkts[i]) {
+				printk("cannot build packet %d\n", i);
+
+				while (i-- > 0) {
+					net_pkt_unref(pkts[i]);
+				}
+
+				return -1;
+			}
+		}
+
+		delivered = 0U;
+
+		t0 = k_cycle_get_32();
+		queued = recv(pkts);
+		if (queued != BURST) {
+			printk("%s: %d of %d packets received\n", name,
+			       queued, BURST);
+			return -1;
+		}
+
+		if (k_sem_take(&burst_done, BURST_TIMEOUT)) {
+			printk("%s: %u of %d packets delivered\n", name,
+			       delivered, BURST);
+			return -1;
+		}
+
+		cycles += k_cycle_get_32() - t0;
+	}
+
+	per_pkt = cycles / (BURST * ROUNDS);
+
+	printk("%-6s %6u cycles/packet %8u packets/s\n", name, per_pkt,
+	       sys_clock_hw_cycles_per_sec() / per_pkt);
+
+	return 0;
+}
+
+void main(void)
+{
+	struct sockaddr_in6 local = {
+		.sin6_family = AF_INET6,
+	};
+	struct net_conn_handle *handle;
+	int ret;
+
+	iface = net_if_get_default();
+
+	(void)net_if_ipv6_addr_add(iface, &my_addr, NET_ADDR_MANUAL, 0);
+
+	ret = net_conn_register(IPPROTO_UDP, AF_INET6, NULL,
+				(struct sockaddr *)&local, 0, SERVER_PORT,
+				conn_cb, NULL, &handle);
+	if (ret < 0) {
+		printk("cannot register connection (%d)\n", ret);
+		return;
+	}
+
+	printk("net_rx_batch burst of %d packets\n", BURST);
+
+	if (run("single", recv_single) < 0 || run("batch", recv_batch) < 0) {
+		(void)net_conn_unregister(handle);
+		return;
+	}
+
+	(void)net_conn_unregister(handle);
+
+	printk("fin\n");
+}
@@ -0,0 +1,204 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/socket.h>
+#include <net/loopback.h>
+
+#define PORT 4242
+#define TRANSFER (64 * 1024)
+#define CHUNK 512
+#define RUN_TIMEOUT K_SECONDS(60)
+
+/* Byte n of the stream is n % PATTERN.  Being prime, the period never
+ * lines up with chunks or segments, so data delivered out of order or
+ * twice does not match.
+ */
+#define PATTERN 251
+
+#define STACK_SIZE 2048
+
+/* Drop rates, in packets per thousand */
+static const unsigned int loss[] = { 0, 10, 20, 50, 100 };
+
+static K_THREAD_STACK_DEFINE(server_stack, STACK_SIZE);
+static struct k_thread server_thread;
+static K_THREAD_STACK_DEFINE(client_stack, STACK_SIZE);
+static struct k_thread client_thread;
+
+static K_SEM_DEFINE(received, 0, 1);
+
+/* Set by the server or client thread when it gives up */
+static volatile bool failed;
+
+static u8_t buf[CHUNK + PATTERN];
+static size_t tx_offset;
+
+static void fail(void)
+{
+	failed = true;
+	k_sem_give(&received);
+}
+
+static void server(void *p1, void *p2, void *p3)
+{
+	static u8_t rx_buf[CHUNK];
+	int s_sock = POINTER_TO_INT(p1);
+	size_t offset = 0, total = 0;
+	int sock;
+
+	sock = accept(s_sock, NULL, NULL);
+	if (sock < 0) {
+		printk("accept failed (%d)\n", errno);
+		fail();
+		return;
+	}
+
+	while (true) {
+		ssize_t len = recv(sock, rx_buf, sizeof(rx_buf), 0);
+
+		if (len <= 0) {
+			printk("recv failed (%d)\n", len < 0 ? errno : 0);
+			fail();
+			return;
+		}
+
+		for (int i = 0; i < len; i++) {
+			if (rx_buf[i] != (offset + i) % PATTERN) {
+				printk("wrong data at offset %zu\n", offset + i);
+				fail();
+				return;
+			}
+		}
+
+		offset += len;
+
+		for (total += len; total >= TRANSFER; total -= TRANSFER) {
+			k_sem_give(&received);
+		}
+	}
+}
+
+static void client(void *p1, void *p2, void *p3)
+{
+	int sock = POINTER_TO_INT(p1);
+	size_t sent = 0;
+
+	while (sent < TRANSFER) {
+		ssize_t len = send(sock, &buf[tx_offset % PATTERN],
+				   MIN(CHUNK, TRANSFER - sent), 0);
+
+		if (len < 0) {
+			printk("send failed (%d)\n", errno);
+			fail();
+			return;
+		}
+
+		sent += len;
+		tx_offset += len;
+	}
+}
+
+/* The transfer is sent from its own thread, so that a stalled
+ * connection times out here instead of blocking in send()
+ */
+static int run(int sock, unsigned int per_mille)
+{
+	u32_t dropped = loopback_get_num_dropped_packets();
+	u32_t start, elapsed, goodput;
+	int ret;
+
+	(void)loopback_set_packet_drop_rate(per_mille);
+
+	start = k_uptime_get_32();
+
+	k_thread_create(&client_thread, client_stack, STACK_SIZE, client,
+			INT_TO_POINTER(sock), NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+
+	ret = k_sem_take(&received, RUN_TIMEOUT);
+
+	elapsed = MAX(k_uptime_get_32() - start, 1U);
+	goodput = (u64_t)TRANSFER * MSEC_PER_SEC / elapsed;
+
+	(void)loopback_set_packet_drop_rate(0);
+
+	if (ret < 0 || failed) {
+		printk("loss %2u.%u%% transfer %s\n", per_mille / 10,
+		       per_mille % 10, failed ? "failed" : "timed out");
+		return -1;
+	}
+
+	/* It is done sending, but may not have returned yet */
+	k_thread_abort(&client_thread);
+
+	printk("loss %2u.%u%% %7u bytes/s %4u dropped\n", per_mille / 10,
+	       per_mille % 10, goodput,
+	       loopback_get_num_dropped_packets() - dropped);
+
+	return 0;
+}
+
+void main(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(PORT),
+	};
+	int s_sock, c_sock, ret;
+
+	(void)inet_pton(AF_INET, CONFIG_NET_CONFIG_MY_IPV4_ADDR,
+			&addr.sin_addr);
+
+	for (int i = 0; i < sizeof(buf); i++) {
+		buf[i] = i % PATTERN;
+	}
+
+	s_sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (s_sock < 0) {
+		printk("socket failed (%d)\n", errno);
+		return;
+	}
+
+	ret = bind(s_sock, (struct sockaddr *)&addr, sizeof(addr));
+	if (ret < 0) {
+		printk("bind failed (%d)\n", errno);
+		return;
+	}
+
+	ret = listen(s_sock, 1);
+	if (ret < 0) {
+		printk("listen failed (%d)\n", errno);
+		return;
+	}
+
+	k_thread_create(&server_thread, server_stack, STACK_SIZE, server,
+			INT_TO_POINTER(s_sock), NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+
+	c_sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (c_sock < 0) {
+		printk("socket failed (%d)\n", errno);
+		return;
+	}
+
+	/* The first run, without loss, completes the handshake */
+	ret = connect(c_sock, (struct sockaddr *)&addr, sizeof(addr));
+	if (ret < 0) {
+		printk("connect failed (%d)\n", errno);
+		return;
+	}
+
+	printk("net_tcp_loss sack %s\n",
+	       IS_ENABLED(CONFIG_NET_TCP_SACK) ? "enabled" : "disabled");
+
+	for (int i = 0; i < ARRAY_SIZE(loss); i++) {
+		if (run(c_sock, loss[i]) < 0) {
+			return;
+		}
+	}
+
+	printk("fin\n");
+}
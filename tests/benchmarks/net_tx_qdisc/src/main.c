@@ -0,0 +1,296 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/net_if.h>
+#include <net/net_pkt.h>
+#include <net/dummy.h>
+
+#define SENDERS 3
+#define PKTS 2000
+#define STACK_SIZE 1024
+#define SENT_TIMEOUT K_MSEC(1000)
+
+/* Cooperative priority of the TX thread of the lowest traffic class */
+#define TX_THREAD_PRIO 8
+
+K_THREAD_STACK_ARRAY_DEFINE(sender_stacks, SENDERS, STACK_SIZE);
+static struct k_thread senders[SENDERS];
+
+static K_SEM_DEFINE(sent_sem, 0, UINT_MAX);
+static u32_t sent[NET_TC_TX_COUNT];
+static u64_t waited[NET_TC_TX_COUNT];
+static u32_t bad_pkts;
+static volatile bool send_failed;
+
+static u8_t mac_addr[] = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x01 };
+
+static void bench_iface_init(struct net_if *iface)
+{
+	net_if_set_link_addr(iface, mac_addr, sizeof(mac_addr),
+			     NET_LINK_ETHERNET);
+}
+
+static int bench_dev_init(struct device *dev)
+{
+	return 0;
+}
+
+/* Called from the TX threads or the cooperative sender, which do not
+ * preempt each other.
+ */
+static int bench_send(struct device *dev, struct net_pkt *pkt)
+{
+	int tc = net_tx_priority2tc(net_pkt_priority(pkt));
+	u32_t t0;
+
+	net_pkt_cursor_init(pkt);
+	if (net_pkt_read(pkt, &t0, sizeof(t0)) < 0) {
+		bad_pkts++;
+		k_sem_give(&sent_sem);
+		return 0;
+	}
+
+	waited[tc] += k_cycle_get_32() - t0;
+	sent[tc]++;
+
+	k_sem_give(&sent_sem);
+
+	return 0;
+}
+
+static struct dummy_api bench_if_api = {
+	.iface_api.init = bench_iface_init,
+	.send = bench_send,
+};
+
+NET_DEVICE_INIT(net_tx_qdisc_bench, "net_tx_qdisc_bench", bench_dev_init,
+		NULL, NULL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &bench_if_api,
+		DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), 1280);
+
+static int send_one(struct net_if *iface, enum net_priority prio)
+{
+	struct net_pkt *pkt;
+	u32_t t0;
+
+	pkt = net_pkt_alloc_with_buffer(iface, sizeof(t0), AF_UNSPEC, 0,
+					K_FOREVER);
+	if (!pkt) {
+		printk("cannot allocate packet\n");
+		return -1;
+	}
+
+	net_pkt_set_priority(pkt, prio);
+
+	t0 = k_cycle_get_32();
+	if (net_pkt_write(pkt, &t0, sizeof(t0)) < 0) {
+		printk("cannot write packet\n");
+		net_pkt_unref(pkt);
+		return -1;
+	}
+
+	net_if_queue_tx(iface, pkt);
+
+	return 0;
+}
+
+static void sender(void *p1, void *p2, void *p3)
+{
+	struct net_if *iface = p1;
+	enum net_priority prio = POINTER_TO_INT(p2);
+
+	for (int i = 0; i < PKTS; i++) {
+		if (send_one(iface, prio) < 0) {
+			send_failed = true;
+			return;
+		}
+	}
+}
+
+static int wait_sent(int count)
+{
+	for (int i = 0; i < count; i++) {
+		if (send_failed || k_sem_take(&sent_sem, SENT_TIMEOUT)) {
+			printk("%d of %d packets sent\n", i, count);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static void reset_counts(void)
+{
+	(void)memset(sent, 0, sizeof(sent));
+	(void)memset(waited, 0, sizeof(waited));
+	bad_pkts = 0U;
+	send_failed = false;
+	k_sem_reset(&sent_sem);
+}
+
+struct qdisc_counts {
+	/* Packets queued, dropped or passed to the driver directly */
+	u32_t handled;
+	u32_t dropped;
+};
+
+static void qdisc_counts_get(struct net_if *iface, struct qdisc_counts *c)
+{
+	c->handled = 0U;
+	c->dropped = 0U;
+
+#if defined(CONFIG_NET_TX_QDISC)
+	struct net_if_qdisc *q = &iface->qdisc;
+
+	c->handled = atomic_get(&q->bypassed);
+
+	for (int tc = 0; tc < NET_TC_TX_COUNT; tc++) {
+		c->handled += atomic_get(&q->classes[tc].queued) +
+			atomic_get(&q->classes[tc].dropped);
+		c->dropped += atomic_get(&q->classes[tc].dropped);
+	}
+#endif
+}
+
+/* Every packet went to the driver in the traffic class of its priority,
+ * and the qdisc accounted for each of them exactly once.
+ */
+static int check_sent(struct net_if *iface, const u32_t *expected,
+		      const struct qdisc_counts *before)
+{
+	struct qdisc_counts after;
+	u32_t total = 0U;
+
+	if (bad_pkts) {
+		printk("%u packets without a timestamp\n", bad_pkts);
+		return -1;
+	}
+
+	for (int tc = 0; tc < NET_TC_TX_COUNT; tc++) {
+		if (sent[tc] != expected[tc]) {
+			printk("tc %d sent %u packets, expected %u\n", tc,
+			       sent[tc], expected[tc]);
+			return -1;
+		}
+
+		total += expected[tc];
+	}
+
+	qdisc_counts_get(iface, &after);
+
+	if (IS_ENABLED(CONFIG_NET_TX_QDISC) &&
+	    (after.handled - before->handled != total ||
+	     after.dropped != before->dropped)) {
+		printk("qdisc handled %u of %u packets, %u dropped\n",
+		       after.handled - before->handled, total,
+		       after.dropped - before->dropped);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int run_senders(struct net_if *iface)
+{
+	u32_t expected[NET_TC_TX_COUNT] = { 0 };
+	struct qdisc_counts before;
+	u32_t cycles;
+
+	reset_counts();
+	qdisc_counts_get(iface, &before);
+
+	cycles = k_cycle_get_32();
+
+	for (int i = 0; i < SENDERS; i++) {
+		enum net_priority prio = i ? NET_PRIORITY_BE : NET_PRIORITY_VO;
+
+		expected[net_tx_priority2tc(prio)] += PKTS;
+
+		k_thread_create(&senders[i], sender_stacks[i], STACK_SIZE,
+				sender, iface, INT_TO_POINTER(prio), NULL,
+				K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+	}
+
+	if (wait_sent(SENDERS * PKTS) < 0) {
+		for (int i = 0; i < SENDERS; i++) {
+			k_thread_abort(&senders[i]);
+		}
+
+		return -1;
+	}
+
+	cycles = k_cycle_get_32() - cycles;
+
+	if (check_sent(iface, expected, &before) < 0) {
+		return -1;
+	}
+
+	printk("senders %d %8u packets/s\n", SENDERS,
+	       (u32_t)((u64_t)SENDERS * PKTS *
+		       sys_clock_hw_cycles_per_sec() / cycles));
+
+	for (int tc = 0; tc < NET_TC_TX_COUNT; tc++) {
+		if (sent[tc]) {
+			printk("tc %d %5u packets %8u cycles waited\n", tc,
+			       sent[tc], (u32_t)(waited[tc] / sent[tc]));
+		}
+	}
+
+	return 0;
+}
+
+static int run_coop(struct net_if *iface)
+{
+	int prio = k_thread_priority_get(k_current_get());
+	u32_t expected[NET_TC_TX_COUNT] = { 0 };
+	struct qdisc_counts before;
+	u32_t cycles;
+	int ret = 0;
+
+	expected[net_tx_priority2tc(NET_PRIORITY_BE)] = PKTS;
+
+	reset_counts();
+	qdisc_counts_get(iface, &before);
+
+	k_thread_priority_set(k_current_get(), K_PRIO_COOP(TX_THREAD_PRIO));
+
+	cycles = k_cycle_get_32();
+
+	for (int i = 0; i < PKTS && !ret; i++) {
+		ret = send_one(iface, NET_PRIORITY_BE);
+	}
+
+	if (!ret) {
+		ret = wait_sent(PKTS);
+	}
+
+	cycles = k_cycle_get_32() - cycles;
+
+	k_thread_priority_set(k_current_get(), prio);
+
+	if (ret < 0 || check_sent(iface, expected, &before) < 0) {
+		return -1;
+	}
+
+	printk("coop sender %6u cycles/packet\n", cycles / PKTS);
+
+	return 0;
+}
+
+void main(void)
+{
+	struct net_if *iface = net_if_get_default();
+
+	printk("net_tx_qdisc %s\n",
+	       !IS_ENABLED(CONFIG_NET_TX_QDISC) ? "disabled" :
+	       IS_ENABLED(CONFIG_NET_TX_QDISC_WFQ) ? "weighted fair" :
+	       "strict priority");
+
+	if (run_senders(iface) < 0 || run_coop(iface) < 0) {
+		return;
+	}
+
+	printk("fin\n");
+}
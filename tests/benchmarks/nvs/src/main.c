@@ -0,0 +1,145 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/printk.h>
+#include <drivers/flash.h>
+#include <storage/flash_map.h>
+#include <stats/stats.h>
+#include <fs/nvs.h>
+
+#define SECTOR_COUNT 4U
+#define ENTRY_LEN 8
+
+static struct nvs_fs fs;
+static u32_t *flash_read_calls;
+
+static const int n_ids[] = { 1, 8, 32 };
+static const int n_history[] = { 1, 4, 16 };
+
+static int read_calls_find(struct stats_hdr *hdr, void *arg,
+			   const char *name, uint16_t off)
+{
+	if (!strcmp(name, "flash_read_calls")) {
+		flash_read_calls = (u32_t *)((u8_t *)hdr + off);
+	}
+
+	return 0;
+}
+
+static int fs_setup(void)
+{
+	const struct flash_area *fa;
+	struct flash_pages_info info;
+	int rc;
+
+	rc = flash_area_open(DT_FLASH_AREA_STORAGE_ID, &fa);
+	if (rc) {
+		printk("flash_area_open() fail: %d\n", rc);
+		return rc;
+	}
+
+	fs.offset = DT_FLASH_AREA_STORAGE_OFFSET;
+	rc = flash_get_page_info_by_offs(flash_area_get_device(fa), fs.offset,
+					 &info);
+	if (rc) {
+		printk("Unable to get page info: %d\n", rc);
+		return rc;
+	}
+
+	fs.sector_size = info.size;
+	fs.sector_count = SECTOR_COUNT;
+
+	rc = nvs_init(&fs, DT_FLASH_DEV_NAME);
+	if (rc) {
+		printk("nvs_init failure: %d\n", rc);
+		return rc;
+	}
+
+	rc = nvs_clear(&fs);
+	if (rc) {
+		printk("nvs_clear failure: %d\n", rc);
+		return rc;
+	}
+
+	/* Start from empty flash, as on a freshly erased device */
+	rc = nvs_init(&fs, DT_FLASH_DEV_NAME);
+	if (rc) {
+		printk("nvs_init failure: %d\n", rc);
+	}
+
+	return rc;
+}
+
+static int run(int ids, int history)
+{
+	u8_t buf[ENTRY_LEN];
+	u32_t cycles = 0U, reads = 0U;
+	ssize_t len;
+	int rc;
+
+	rc = fs_setup();
+	if (rc) {
+		return rc;
+	}
+
+	/* Interleave the writes so that every id has its history
+	 * spread over the whole allocation table
+	 */
+	for (int h = 0; h < history; h++) {
+		for (int id = 0; id < ids; id++) {
+			(void)memset(buf, h, sizeof(buf));
+			len = nvs_write(&fs, id, buf, sizeof(buf));
+			if (len < 0) {
+				printk("nvs_write failure: %d\n", (int)len);
+				return len;
+			}
+		}
+	}
+
+	for (int id = 0; id < ids; id++) {
+		u32_t calls = *flash_read_calls;
+		u32_t t0 = k_cycle_get_32();
+
+		len = nvs_read(&fs, id, buf, sizeof(buf));
+
+		cycles += k_cycle_get_32() - t0;
+		reads += *flash_read_calls - calls;
+
+		if (len != sizeof(buf) || buf[0] != history - 1) {
+			printk("bad read of id %d: %d\n", id, (int)len);
+			return -EIO;
+		}
+	}
+
+	printk("ids %3d history %3d read %6u cycles %3u flash reads\n",
+	       ids, history, cycles / ids, reads / ids);
+
+	return 0;
+}
+
+void main(void)
+{
+	stats_walk(stats_group_find("flash_sim_stats"), read_calls_find,
+		   NULL);
+	if (flash_read_calls == NULL) {
+		printk("flash simulator stats missing\n");
+		return;
+	}
+
+	printk("NVS lookup cache %s\n",
+	       IS_ENABLED(CONFIG_NVS_LOOKUP_CACHE) ? "enabled" : "disabled");
+
+	for (int i = 0; i < ARRAY_SIZE(n_ids); i++) {
+		for (int j = 0; j < ARRAY_SIZE(n_history); j++) {
+			if (run(n_ids[i], n_history[j])) {
+				return;
+			}
+		}
+	}
+
+	printk("fin\n");
+}
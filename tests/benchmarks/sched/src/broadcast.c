@@ -0,0 +1,149 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <wait_q.h>
+#include <ksched.h>
+#include <posix/pthread.h>
+
+/* Broadcast wakeup half of the benchmark.  N waiters at a lower
+ * priority than the main thread block on the same object, and the
+ * main thread measures how long the call that wakes all of them
+ * takes, before any of them gets to run.  This is done for a raw wait
+ * queue (z_unpend_all()), a POSIX condition variable
+ * (pthread_cond_broadcast()) and a poll signal
+ * (k_poll_signal_raise()).  With batched wakeups the cost should grow
+ * by a run queue insertion per waiter, not a full scheduling decision.
+ */
+
+#define N_MAX_WAITERS 64
+#define N_ROUNDS 16
+#define PRIO 5
+
+#define STACK_SIZE 512
+
+enum {
+	WAITQ,
+	COND,
+	POLL,
+};
+
+static const char *const mode_names[] = { "waitq", "cond", "poll" };
+static const int n_waiters[] = { 1, 4, 16, 64 };
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, N_MAX_WAITERS, STACK_SIZE);
+static struct k_thread threads[N_MAX_WAITERS];
+
+static _wait_q_t bcast_waitq;
+static PTHREAD_MUTEX_DEFINE(bcast_mutex);
+static PTHREAD_COND_DEFINE(bcast_cond);
+static struct k_poll_signal bcast_signal;
+
+static struct k_sem woken;
+static struct k_sem rearm;
+
+static void waiter(void *arg1, void *arg2, void *arg3)
+{
+	int mode = POINTER_TO_INT(arg1);
+	struct k_poll_event event;
+
+	ARG_UNUSED(arg2);
+	ARG_UNUSED(arg3);
+
+	k_poll_event_init(&event, K_POLL_TYPE_SIGNAL,
+			  K_POLL_MODE_NOTIFY_ONLY, &bcast_signal);
+
+	while (true) {
+		switch (mode) {
+		case WAITQ:
+			(void)z_pend_curr_irqlock(arch_irq_lock(),
+						  &bcast_waitq, K_FOREVER);
+			break;
+		case COND:
+			pthread_mutex_lock(&bcast_mutex);
+			pthread_cond_wait(&bcast_cond, &bcast_mutex);
+			pthread_mutex_unlock(&bcast_mutex);
+			break;
+		default:
+			(void)k_poll(&event, 1, K_FOREVER);
+			event.state = K_POLL_STATE_NOT_READY;
+			break;
+		}
+
+		k_sem_give(&woken);
+		k_sem_take(&rearm, K_FOREVER);
+	}
+}
+
+static u32_t broadcast(int mode)
+{
+	u32_t start = k_cycle_get_32();
+
+	switch (mode) {
+	case WAITQ: {
+		int key = arch_irq_lock();
+
+		(void)z_unpend_all(&bcast_waitq);
+		z_reschedule_irqlock(key);
+		break;
+	}
+	case COND:
+		pthread_cond_broadcast(&bcast_cond);
+		break;
+	default:
+		(void)k_poll_signal_raise(&bcast_signal, 0);
+		break;
+	}
+
+	return k_cycle_get_32() - start;
+}
+
+static void run(int mode, int count)
+{
+	u32_t total = 0U;
+
+	for (int i = 0; i < count; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE, waiter,
+				INT_TO_POINTER(mode), NULL, NULL, PRIO, 0,
+				K_NO_WAIT);
+	}
+
+	for (int round = 0; round < N_ROUNDS; round++) {
+		/* Let every waiter get back to sleep */
+		k_sleep(K_MSEC(10));
+
+		total += broadcast(mode);
+
+		for (int i = 0; i < count; i++) {
+			k_sem_take(&woken, K_FOREVER);
+		}
+
+		k_poll_signal_reset(&bcast_signal);
+		for (int i = 0; i < count; i++) {
+			k_sem_give(&rearm);
+		}
+	}
+
+	for (int i = 0; i < count; i++) {
+		k_thread_abort(&threads[i]);
+	}
+
+	printk("broadcast %-5s waiters %2d %6u cycles\n", mode_names[mode],
+	       count, total / N_ROUNDS);
+}
+
+void broadcast_bench(void)
+{
+	z_waitq_init(&bcast_waitq);
+	k_poll_signal_init(&bcast_signal);
+	k_sem_init(&woken, 0, N_MAX_WAITERS);
+	k_sem_init(&rearm, 0, N_MAX_WAITERS);
+
+	for (int mode = WAITQ; mode <= POLL; mode++) {
+		for (int i = 0; i < ARRAY_SIZE(n_waiters); i++) {
+			run(mode, n_waiters[i]);
+		}
+	}
+}
@@ -41,6 +41,12 @@
 #define N_RUNS 1000
 #define N_SETTLE 10
 
+extern void broadcast_bench(void);
+
+#if defined(CONFIG_SMP) && defined(CONFIG_SCHED_CPU_MASK)
+extern void smp_bench(void);
+#endif
+
 
 static K_THREAD_STACK_DEFINE(partner_stack, 1024);
 static struct k_thread partner_thread;
@@ -157,5 +163,11 @@ void main(void)
 		       stamps[4] - stamps[3],
 		       whole, avg);
 	}
+
+	broadcast_bench();
+
+#if defined(CONFIG_SMP) && defined(CONFIG_SCHED_CPU_MASK)
+	smp_bench();
+#endif
 	printk("fin\n");
 }
@@ -0,0 +1,174 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <ksched.h>
+
+/* SMP scaling half of the benchmark.  For each CPU count N, N pairs
+ * of threads are pinned one pair per CPU and ping-pong through a
+ * pair of semaphores, so every round trip is two wakeups and two
+ * context switches that never leave their CPU.  With a single global
+ * run queue the pairs still fight over its cache lines, so the cost
+ * per round trip grows with N; with per-CPU run queues it should
+ * stay close to flat.  Finally, a thread on CPU 0 wakes one pinned
+ * to CPU 1 to measure cross-CPU wakeup (IPI) latency.
+ *
+ * With CONFIG_SPIN_STATS, each ping-pong run also reports how often
+ * sched_spinlock was found held by another CPU.
+ */
+
+#define N_PINGPONG 1000
+#define N_WAKEUP 100
+#define PRIO 2
+
+#define STACK_SIZE 1024
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, 2 * CONFIG_MP_NUM_CPUS,
+				   STACK_SIZE);
+static struct k_thread threads[2 * CONFIG_MP_NUM_CPUS];
+
+static struct pair {
+	struct k_sem ping;
+	struct k_sem pong;
+	u32_t cycles;
+} pairs[CONFIG_MP_NUM_CPUS];
+
+static struct k_sem done;
+
+static volatile u32_t wake_stamp;
+static u32_t wake_total;
+
+static void pinger(void *arg1, void *arg2, void *arg3)
+{
+	struct pair *p = arg1;
+	u32_t start = k_cycle_get_32();
+
+	ARG_UNUSED(arg2);
+	ARG_UNUSED(arg3);
+
+	for (int i = 0; i < N_PINGPONG; i++) {
+		k_sem_give(&p->ping);
+		k_sem_take(&p->pong, K_FOREVER);
+	}
+
+	p->cycles = k_cycle_get_32() - start;
+	k_sem_give(&done);
+}
+
+static void ponger(void *arg1, void *arg2, void *arg3)
+{
+	struct pair *p = arg1;
+
+	ARG_UNUSED(arg2);
+	ARG_UNUSED(arg3);
+
+	for (int i = 0; i < N_PINGPONG; i++) {
+		k_sem_take(&p->ping, K_FOREVER);
+		k_sem_give(&p->pong);
+	}
+}
+
+static void waker(void *arg1, void *arg2, void *arg3)
+{
+	struct pair *p = arg1;
+
+	ARG_UNUSED(arg2);
+	ARG_UNUSED(arg3);
+
+	for (int i = 0; i < N_WAKEUP; i++) {
+		/* Let the wakee get back to sleep first */
+		k_busy_wait(100);
+		wake_stamp = k_cycle_get_32();
+		k_sem_give(&p->ping);
+	}
+}
+
+static void wakee(void *arg1, void *arg2, void *arg3)
+{
+	struct pair *p = arg1;
+
+	ARG_UNUSED(arg2);
+	ARG_UNUSED(arg3);
+
+	wake_total = 0U;
+	for (int i = 0; i < N_WAKEUP; i++) {
+		k_sem_take(&p->ping, K_FOREVER);
+		wake_total += k_cycle_get_32() - wake_stamp;
+	}
+	k_sem_give(&done);
+}
+
+static k_tid_t spawn(int idx, k_thread_entry_t fn, struct pair *p, int cpu)
+{
+	k_tid_t th = k_thread_create(&threads[idx], stacks[idx], STACK_SIZE,
+				     fn, p, NULL, NULL, PRIO, 0, K_FOREVER);
+
+	k_thread_cpu_mask_clear(th);
+	k_thread_cpu_mask_enable(th, cpu);
+	return th;
+}
+
+void smp_bench(void)
+{
+	k_sem_init(&done, 0, CONFIG_MP_NUM_CPUS);
+
+	for (int ncpus = 1; ncpus <= CONFIG_MP_NUM_CPUS; ncpus++) {
+		k_tid_t tids[2 * CONFIG_MP_NUM_CPUS];
+		u32_t worst = 0U;
+#ifdef CONFIG_SPIN_STATS
+		u32_t acquired0, contended0, acquired, contended;
+#endif
+
+		for (int i = 0; i < ncpus; i++) {
+			k_sem_init(&pairs[i].ping, 0, 1);
+			k_sem_init(&pairs[i].pong, 0, 1);
+			tids[2 * i] = spawn(2 * i, pinger, &pairs[i], i);
+			tids[2 * i + 1] = spawn(2 * i + 1, ponger,
+						&pairs[i], i);
+		}
+
+#ifdef CONFIG_SPIN_STATS
+		z_sched_lock_stats_get(&acquired0, &contended0);
+#endif
+		for (int i = 0; i < 2 * ncpus; i++) {
+			k_thread_start(tids[i]);
+		}
+
+		for (int i = 0; i < ncpus; i++) {
+			k_sem_take(&done, K_FOREVER);
+		}
+#ifdef CONFIG_SPIN_STATS
+		z_sched_lock_stats_get(&acquired, &contended);
+#endif
+
+		for (int i = 0; i < ncpus; i++) {
+			worst = MAX(worst, pairs[i].cycles / N_PINGPONG);
+			k_thread_abort(tids[2 * i]);
+			k_thread_abort(tids[2 * i + 1]);
+		}
+
+		printk("cpus %d pingpong %u cycles/roundtrip\n", ncpus, worst);
+#ifdef CONFIG_SPIN_STATS
+		printk("cpus %d sched_spinlock contended %u of %u\n", ncpus,
+		       contended - contended0, acquired - acquired0);
+#endif
+	}
+
+	if (CONFIG_MP_NUM_CPUS > 1) {
+		k_tid_t wt, ee;
+
+		k_sem_init(&pairs[0].ping, 0, 1);
+		ee = spawn(1, wakee, &pairs[0], 1);
+		wt = spawn(0, waker, &pairs[0], 0);
+		k_thread_start(ee);
+		k_thread_start(wt);
+
+		k_sem_take(&done, K_FOREVER);
+		k_thread_abort(wt);
+		k_thread_abort(ee);
+
+		printk("cross-cpu wakeup %u cycles\n", wake_total / N_WAKEUP);
+	}
+}
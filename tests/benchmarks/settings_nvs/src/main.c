@@ -0,0 +1,157 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/printk.h>
+#include <storage/flash_map.h>
+#include <stats/stats.h>
+#include <settings/settings.h>
+
+static u32_t *flash_read_calls;
+
+static const int n_keys[] = { 1, 100, 500 };
+
+struct save_cost {
+	u32_t cycles;
+	u32_t reads;
+};
+
+static int bench_set(const char *name, size_t len, settings_read_cb read_cb,
+		     void *cb_arg)
+{
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(bench, "bench", NULL, bench_set, NULL, NULL);
+
+static int read_calls_find(struct stats_hdr *hdr, void *arg,
+			   const char *name, uint16_t off)
+{
+	if (!strcmp(name, "flash_read_calls")) {
+		flash_read_calls = (u32_t *)((u8_t *)hdr + off);
+	}
+
+	return 0;
+}
+
+static int storage_clear(void)
+{
+	const struct flash_area *fa;
+	int rc;
+
+	rc = flash_area_open(DT_FLASH_AREA_STORAGE_ID, &fa);
+	if (rc) {
+		printk("flash_area_open() fail: %d\n", rc);
+		return rc;
+	}
+
+	rc = flash_area_erase(fa, 0, fa->fa_size);
+	if (rc) {
+		printk("flash_area_erase() fail: %d\n", rc);
+	}
+
+	flash_area_close(fa);
+
+	return rc;
+}
+
+static int save(int key, u32_t value, struct save_cost *cost)
+{
+	char name[SETTINGS_MAX_NAME_LEN + 1];
+	u32_t calls = *flash_read_calls;
+	u32_t t0;
+	int rc;
+
+	snprintf(name, sizeof(name), "bench/%d", key);
+
+	t0 = k_cycle_get_32();
+	rc = settings_save_one(name, value ? &value : NULL,
+			       value ? sizeof(value) : 0);
+	cost->cycles += k_cycle_get_32() - t0;
+	cost->reads += *flash_read_calls - calls;
+
+	if (rc) {
+		printk("cannot save key %d: %d\n", key, rc);
+	}
+
+	return rc;
+}
+
+static int run(int keys)
+{
+	struct save_cost create = { 0 }, update = { 0 }, cleanup = { 0 };
+	int key, rc;
+
+	for (key = 0; key < keys; key++) {
+		rc = save(key, 1U, &create);
+		if (rc) {
+			return rc;
+		}
+	}
+
+	for (key = 0; key < keys; key++) {
+		rc = save(key, 2U, &update);
+		if (rc) {
+			return rc;
+		}
+	}
+
+	printk("keys %3d create %7u cycles %5u flash reads "
+	       "update %7u cycles %5u flash reads\n", keys,
+	       create.cycles / keys, create.reads / keys,
+	       update.cycles / keys, update.reads / keys);
+
+	/* Delete from the largest name ID down to free all IDs again */
+	for (key = keys - 1; key >= 0; key--) {
+		rc = save(key, 0U, &cleanup);
+		if (rc) {
+			return rc;
+		}
+	}
+
+	return 0;
+}
+
+void main(void)
+{
+	int i, rc;
+
+	stats_walk(stats_group_find("flash_sim_stats"), read_calls_find,
+		   NULL);
+	if (flash_read_calls == NULL) {
+		printk("flash simulator stats missing\n");
+		return;
+	}
+
+	if (storage_clear()) {
+		return;
+	}
+
+	rc = settings_subsys_init();
+	if (rc) {
+		printk("settings_subsys_init failure: %d\n", rc);
+		return;
+	}
+
+	/* Loading the settings builds the name index */
+	rc = settings_load();
+	if (rc) {
+		printk("settings_load failure: %d\n", rc);
+		return;
+	}
+
+	printk("settings NVS name index %s\n",
+	       IS_ENABLED(CONFIG_SETTINGS_NVS_NAME_INDEX) ?
+	       "enabled" : "disabled");
+
+	for (i = 0; i < ARRAY_SIZE(n_keys); i++) {
+		if (run(n_keys[i])) {
+			return;
+		}
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,180 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/printk.h>
+#include <storage/flash_map.h>
+#include <stats/stats.h>
+#include <settings/settings.h>
+
+static u32_t *flash_write_calls;
+
+/* Keys saved in turn, each one a number of times */
+struct save_pattern {
+	const char *name;
+	int keys;
+	int rounds;
+};
+
+static const struct save_pattern patterns[] = {
+	{ "rpl", 8, 16 },
+	{ "ccc", 16, 1 },
+};
+
+static u32_t value;
+
+static int write_calls_find(struct stats_hdr *hdr, void *arg,
+			    const char *name, uint16_t off)
+{
+	if (!strcmp(name, "flash_write_calls")) {
+		flash_write_calls = (u32_t *)((u8_t *)hdr + off);
+	}
+
+	return 0;
+}
+
+static int storage_clear(void)
+{
+	const struct flash_area *fa;
+	int rc;
+
+	rc = flash_area_open(DT_FLASH_AREA_STORAGE_ID, &fa);
+	if (rc) {
+		printk("flash_area_open() fail: %d\n", rc);
+		return rc;
+	}
+
+	rc = flash_area_erase(fa, 0, fa->fa_size);
+	if (rc) {
+		printk("flash_area_erase() fail: %d\n", rc);
+	}
+
+	flash_area_close(fa);
+
+	return rc;
+}
+
+static int save_all(const struct save_pattern *pattern, u32_t *cycles)
+{
+	char name[SETTINGS_MAX_NAME_LEN + 1];
+	int round, key, rc;
+	u32_t t0;
+
+	for (round = 0; round < pattern->rounds; round++) {
+		for (key = 0; key < pattern->keys; key++) {
+			snprintf(name, sizeof(name), "bench/%s/%d",
+				 pattern->name, key);
+
+			/* NVS skips writing a value that did not change */
+			value++;
+
+			t0 = k_cycle_get_32();
+			rc = settings_save_one(name, &value, sizeof(value));
+			*cycles += k_cycle_get_32() - t0;
+
+			if (rc) {
+				printk("cannot save %s: %d\n", name, rc);
+				return rc;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static int run(const struct save_pattern *pattern, bool batch)
+{
+	int saves = pattern->keys * pattern->rounds;
+	u32_t writes = *flash_write_calls;
+	u32_t cycles = 0U, t0;
+	const char *mode;
+	int rc;
+
+	if (batch) {
+		mode = "batch";
+
+		t0 = k_cycle_get_32();
+		rc = settings_save_begin();
+		cycles += k_cycle_get_32() - t0;
+		if (rc) {
+			printk("settings_save_begin failure: %d\n", rc);
+			return rc;
+		}
+
+		rc = save_all(pattern, &cycles);
+		if (rc) {
+			(void)settings_save_commit();
+			return rc;
+		}
+
+		t0 = k_cycle_get_32();
+		rc = settings_save_commit();
+		cycles += k_cycle_get_32() - t0;
+		if (rc) {
+			printk("settings_save_commit failure: %d\n", rc);
+			return rc;
+		}
+	} else {
+#if defined(CONFIG_SETTINGS_SAVE_DEFERRED)
+		mode = "deferred";
+
+		rc = save_all(pattern, &cycles);
+		if (rc) {
+			return rc;
+		}
+
+		/* Let the delayed write happen before counting */
+		k_sleep(K_MSEC(CONFIG_SETTINGS_SAVE_DEFERRED_DELAY + 100));
+#else
+		mode = "direct";
+
+		rc = save_all(pattern, &cycles);
+		if (rc) {
+			return rc;
+		}
+#endif
+	}
+
+	printk("%-4s %-8s %4d saves %4u flash writes %7u cycles/save\n",
+	       pattern->name, mode, saves, *flash_write_calls - writes,
+	       cycles / saves);
+
+	return 0;
+}
+
+void main(void)
+{
+	int i, rc;
+
+	stats_walk(stats_group_find("flash_sim_stats"), write_calls_find,
+		   NULL);
+	if (flash_write_calls == NULL) {
+		printk("flash simulator stats missing\n");
+		return;
+	}
+
+	if (storage_clear()) {
+		return;
+	}
+
+	rc = settings_subsys_init();
+	if (rc) {
+		printk("settings_subsys_init failure: %d\n", rc);
+		return;
+	}
+
+	printk("settings deferred saves %s\n",
+	       IS_ENABLED(CONFIG_SETTINGS_SAVE_DEFERRED) ?
+	       "enabled" : "disabled");
+
+	for (i = 0; i < ARRAY_SIZE(patterns); i++) {
+		if (run(&patterns[i], false) || run(&patterns[i], true)) {
+			return;
+		}
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,173 @@
+/* mem_slab.c */
+
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "syskernel.h"
+
+#define N_BLOCKS 64
+#define BLOCK_SIZE 32
+/* Blocks each thread holds at once */
+#define BURST 4
+
+K_MEM_SLAB_DEFINE(bench_slab, BLOCK_SIZE, N_BLOCKS, 4);
+
+static struct k_sem single_done;
+
+/**
+ *
+ * @brief Memory slab test thread
+ *
+ * @param par1   Address of the counter.
+ * @param par2   Number of test loops.
+ * @param par3   Semaphore to give when done, or NULL
+ *
+ * @return N/A
+ *
+ */
+void mem_slab_thread(void *par1, void *par2, void *par3)
+{
+	int *pcounter = par1;
+	int num_loops = POINTER_TO_INT(par2);
+	struct k_sem *done = par3;
+	void *blocks[BURST];
+	int i, j;
+
+	for (i = 0; i < num_loops; i++) {
+		for (j = 0; j < BURST; j++) {
+			if (k_mem_slab_alloc(&bench_slab, &blocks[j],
+					     K_FOREVER) != 0) {
+				break;
+			}
+		}
+		if (j != BURST) {
+			break;
+		}
+		for (j = 0; j < BURST; j++) {
+			k_mem_slab_free(&bench_slab, &blocks[j]);
+		}
+		(*pcounter)++;
+	}
+
+	if (done != NULL) {
+		k_sem_give(done);
+	}
+}
+
+#if defined(CONFIG_SMP) && defined(CONFIG_SCHED_CPU_MASK)
+static K_THREAD_STACK_ARRAY_DEFINE(smp_stacks, CONFIG_MP_NUM_CPUS, 1024);
+static struct k_thread smp_threads[CONFIG_MP_NUM_CPUS];
+static int smp_counters[CONFIG_MP_NUM_CPUS];
+static struct k_sem smp_done;
+
+/**
+ *
+ * @brief Run the alloc/free loop on 1 to CONFIG_MP_NUM_CPUS CPUs at once
+ *
+ * With a single shared free list the cost of an iteration grows with
+ * the number of CPUs; with CONFIG_MEM_SLAB_MAGAZINES it should stay
+ * close to flat.
+ *
+ * @return N/A
+ *
+ */
+static void mem_slab_smp_test(void)
+{
+	for (int ncpus = 1; ncpus <= CONFIG_MP_NUM_CPUS; ncpus++) {
+		k_tid_t tids[CONFIG_MP_NUM_CPUS];
+		u32_t t;
+
+		k_sem_init(&smp_done, 0, CONFIG_MP_NUM_CPUS);
+
+		for (int c = 0; c < ncpus; c++) {
+			smp_counters[c] = 0;
+			tids[c] = k_thread_create(&smp_threads[c], smp_stacks[c],
+						  K_THREAD_STACK_SIZEOF(smp_stacks[c]),
+						  mem_slab_thread,
+						  &smp_counters[c],
+						  INT_TO_POINTER(number_of_loops),
+						  &smp_done, K_PRIO_COOP(3), 0,
+						  K_FOREVER);
+			k_thread_cpu_mask_clear(tids[c]);
+			k_thread_cpu_mask_enable(tids[c], c);
+		}
+
+		t = k_cycle_get_32();
+		for (int c = 0; c < ncpus; c++) {
+			k_thread_start(tids[c]);
+		}
+		for (int c = 0; c < ncpus; c++) {
+			k_sem_take(&smp_done, K_FOREVER);
+		}
+		t = k_cycle_get_32() - t;
+
+		fprintf(output_file, "\ncpus %d: %u nSec per alloc/free of %d",
+			ncpus, SYS_CLOCK_HW_CYCLES_TO_NS_AVG(t, number_of_loops),
+			BURST);
+	}
+
+#ifdef CONFIG_MEM_SLAB_MAGAZINES
+	struct k_mem_slab_magazine_stats stats;
+
+	k_mem_slab_magazine_stats_get(&bench_slab, &stats);
+	fprintf(output_file, "\nmagazine hits %u misses %u (%u%% hit rate)",
+		stats.hits, stats.misses,
+		(u32_t)((u64_t)stats.hits * 100U /
+			MAX(stats.hits + stats.misses, 1U)));
+#endif
+}
+#endif
+
+/**
+ *
+ * @brief The main test entry
+ *
+ * @return 1 if success and 0 on failure
+ *
+ */
+int mem_slab_test(void)
+{
+	u32_t t;
+	int i = 0;
+	int return_value = 0;
+
+	/* test alloc & free from a single thread */
+	fprintf(output_file, sz_test_case_fmt,
+			"Memory slab #1");
+	fprintf(output_file, sz_description,
+			"\n\tk_mem_slab_alloc(K_FOREVER)"
+			"\n\tk_mem_slab_free");
+	printf(sz_test_start_fmt);
+
+	k_sem_init(&single_done, 0, 1);
+
+	t = BENCH_START();
+
+	k_thread_create(&thread_data1, thread_stack1, STACK_SIZE,
+			mem_slab_thread, (void *) &i,
+			INT_TO_POINTER(number_of_loops), &single_done,
+			K_PRIO_COOP(3), 0, K_NO_WAIT);
+	/* On SMP the thread may have been started on another CPU */
+	k_sem_take(&single_done, K_FOREVER);
+
+	t = TIME_STAMP_DELTA_GET(t);
+
+	return_value += check_result(i, t);
+
+#if defined(CONFIG_SMP) && defined(CONFIG_SCHED_CPU_MASK)
+	/* test scaling of alloc & free across CPUs */
+	fprintf(output_file, sz_test_case_fmt,
+			"Memory slab #2");
+	fprintf(output_file, sz_description,
+			"\n\tk_mem_slab_alloc(K_FOREVER) on 1 to N CPUs"
+			"\n\tk_mem_slab_free");
+	printf(sz_test_start_fmt);
+
+	mem_slab_smp_test();
+
+	fprintf(output_file, sz_case_end_fmt);
+#endif
+
+	return return_value;
+}
@@ -0,0 +1,147 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <timeout_q.h>
+#include <drivers/timer/system_timer.h>
+
+/* Timeout queue microbenchmark.  For a growing number of pending
+ * background timeouts, measure the average cost of adding, aborting
+ * and querying one more timeout, and of announcing the tick on which
+ * a timeout expires.  See README.rst for the caveats of calling
+ * z_clock_announce() from a thread.
+ */
+
+#define N_RUNS 100
+#define MAX_TIMEOUTS 1024
+
+/* Background timeouts start this far out so that the (at most
+ * N_RUNS * ARRAY_SIZE(counts)) ticks announced by the benchmark
+ * never reach them.
+ */
+#define BG_BASE_TICKS 100000
+#define BG_SPREAD_TICKS 1000000
+
+static const int counts[] = { 1, 16, 64, 256, 1024 };
+
+static struct _timeout bg[MAX_TIMEOUTS];
+static struct _timeout probe;
+static volatile int expired;
+static volatile bool bg_expired;
+
+static inline u32_t stamp(void)
+{
+	u32_t t;
+
+	/* See tests/benchmarks/sched for why rdtsc isn't trusted */
+#ifdef CONFIG_X86
+	__asm__ volatile("rdtsc" : "=a"(t) : : "edx");
+#else
+	t = k_cycle_get_32();
+#endif
+	return t;
+}
+
+static u32_t xorshift32(void)
+{
+	static u32_t state = 2463534242U;
+
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+static void bg_fn(struct _timeout *t)
+{
+	ARG_UNUSED(t);
+
+	bg_expired = true;
+}
+
+static void probe_fn(struct _timeout *t)
+{
+	ARG_UNUSED(t);
+
+	expired++;
+}
+
+static int run(int n)
+{
+	u32_t t0, t1, t2, t3;
+	u64_t add = 0U, abort = 0U, rem = 0U, announce = 0U;
+	unsigned int key;
+
+	for (int i = 0; i < n; i++) {
+		z_add_timeout(&bg[i], bg_fn,
+			      BG_BASE_TICKS + xorshift32() % BG_SPREAD_TICKS);
+	}
+
+	for (int i = 0; i < N_RUNS; i++) {
+		s32_t ticks = BG_BASE_TICKS + xorshift32() % BG_SPREAD_TICKS;
+		struct _timeout *t = &bg[xorshift32() % n];
+
+		key = irq_lock();
+		t0 = stamp();
+		z_add_timeout(&probe, probe_fn, ticks);
+		t1 = stamp();
+		z_abort_timeout(&probe);
+		t2 = stamp();
+		(void)z_timeout_remaining(t);
+		t3 = stamp();
+		irq_unlock(key);
+
+		add += t1 - t0;
+		abort += t2 - t1;
+		rem += t3 - t2;
+	}
+
+	expired = 0;
+	for (int i = 0; i < N_RUNS; i++) {
+		key = irq_lock();
+		z_add_timeout(&probe, probe_fn, 1);
+		t0 = stamp();
+		z_clock_announce(z_clock_elapsed() + 1);
+		t1 = stamp();
+		irq_unlock(key);
+
+		announce += t1 - t0;
+	}
+
+	for (int i = 0; i < n; i++) {
+		z_abort_timeout(&bg[i]);
+	}
+
+	if (bg_expired) {
+		printk("background timeout expired, results are invalid\n");
+		return -1;
+	}
+
+	if (expired != N_RUNS) {
+		printk("only %d of %d probe timeouts expired\n",
+		       expired, N_RUNS);
+		return -1;
+	}
+
+	printk("timeouts %4d insert %5u abort %5u remaining %5u announce %5u\n",
+	       n, (u32_t)(add / N_RUNS), (u32_t)(abort / N_RUNS),
+	       (u32_t)(rem / N_RUNS), (u32_t)(announce / N_RUNS));
+
+	return 0;
+}
+
+void main(void)
+{
+	printk("Timeout queue backend: %s\n",
+	       IS_ENABLED(CONFIG_TIMEOUT_WHEEL) ? "wheel" : "dlist");
+
+	for (int i = 0; i < ARRAY_SIZE(counts); i++) {
+		if (run(counts[i]) < 0) {
+			return;
+		}
+	}
+
+	printk("fin\n");
+}
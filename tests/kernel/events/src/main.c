@@ -0,0 +1,248 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <irq_offload.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define EVENT_TIMEOUT K_MSEC(100)
+#define SETTLE_TIME K_MSEC(10)
+
+/* Waiters run below the (cooperative) test thread, which has to sleep to
+ * let them pend and to let them finish once woken.
+ */
+#define HIGH_PRIO 1
+#define LOW_PRIO 2
+
+#define EV_A BIT(0)
+#define EV_B BIT(1)
+#define EV_C BIT(2)
+
+struct waiter_args {
+	u32_t events;
+	u32_t options;
+	s32_t timeout;
+	/* Return value of k_event_wait(), ~0 until it returns */
+	volatile u32_t result;
+};
+
+K_EVENT_DEFINE(kevent);
+struct k_event event;
+
+static K_THREAD_STACK_DEFINE(stack_1, STACK_SIZE);
+static K_THREAD_STACK_DEFINE(stack_2, STACK_SIZE);
+static struct k_thread tdata_1, tdata_2;
+
+static void waiter_thread(void *p1, void *p2, void *p3)
+{
+	struct k_event *ev = p1;
+	struct waiter_args *args = p2;
+
+	ARG_UNUSED(p3);
+
+	args->result = k_event_wait(ev, args->events, args->options,
+				    args->timeout);
+}
+
+static void spawn_waiter(struct k_thread *thread, k_thread_stack_t *stack,
+			 struct waiter_args *args, int prio)
+{
+	args->result = ~0U;
+	k_thread_create(thread, stack, STACK_SIZE, waiter_thread,
+			&event, args, NULL, prio, 0, K_NO_WAIT);
+}
+
+static void isr_event_post(void *ev)
+{
+	(void)k_event_post((struct k_event *)ev, EV_B);
+}
+
+/**
+ * @brief Test the return values of post, set and clear
+ */
+void test_event_post_set_clear(void)
+{
+	k_event_init(&event);
+
+	zassert_equal(k_event_get(&event), 0, NULL);
+	zassert_equal(k_event_post(&event, EV_A), 0, NULL);
+	zassert_equal(k_event_post(&event, EV_B | EV_C), EV_A, NULL);
+	zassert_equal(k_event_get(&event), EV_A | EV_B | EV_C, NULL);
+
+	/* Set replaces all events */
+	zassert_equal(k_event_set(&event, EV_B), EV_A | EV_B | EV_C, NULL);
+	zassert_equal(k_event_get(&event), EV_B, NULL);
+
+	/* Clear returns the events before clearing */
+	zassert_equal(k_event_clear(&event, EV_A | EV_B), EV_B, NULL);
+	zassert_equal(k_event_get(&event), 0, NULL);
+
+	/* Statically defined objects start out cleared */
+	zassert_equal(k_event_get(&kevent), 0, NULL);
+}
+
+/**
+ * @brief Test waiting for events that are already posted
+ */
+void test_event_wait_no_wait(void)
+{
+	k_event_init(&event);
+	(void)k_event_post(&event, EV_A | EV_B);
+
+	/* All current events are returned, not just the ones waited for */
+	zassert_equal(k_event_wait(&event, EV_A | EV_C, K_EVENT_WAIT_ANY,
+				   K_NO_WAIT), EV_A | EV_B, NULL);
+	zassert_equal(k_event_wait(&event, EV_A | EV_C, K_EVENT_WAIT_ALL,
+				   K_NO_WAIT), 0, NULL);
+	zassert_equal(k_event_wait(&event, EV_C, K_EVENT_WAIT_ANY,
+				   K_NO_WAIT), 0, NULL);
+
+	/* Waiting for nothing never succeeds */
+	zassert_equal(k_event_wait(&event, 0, K_EVENT_WAIT_ANY, K_NO_WAIT),
+		      0, NULL);
+
+	/* Only the events waited for are cleared */
+	zassert_equal(k_event_wait(&event, EV_A, K_EVENT_WAIT_ANY |
+				   K_EVENT_WAIT_CLEAR, K_NO_WAIT),
+		      EV_A | EV_B, NULL);
+	zassert_equal(k_event_get(&event), EV_B, NULL);
+}
+
+/**
+ * @brief Test that waiting times out when the events are not posted
+ */
+void test_event_wait_timeout(void)
+{
+	k_event_init(&event);
+	(void)k_event_post(&event, EV_A);
+
+	zassert_equal(k_event_wait(&event, EV_A | EV_B, K_EVENT_WAIT_ALL,
+				   EVENT_TIMEOUT), 0, NULL);
+	zassert_equal(k_event_get(&event), EV_A, NULL);
+}
+
+/**
+ * @brief Test that a wait for all events needs every one of them
+ */
+void test_event_wait_all(void)
+{
+	struct waiter_args args = {
+		.events = EV_A | EV_B,
+		.options = K_EVENT_WAIT_ALL | K_EVENT_WAIT_CLEAR,
+		.timeout = K_FOREVER,
+	};
+
+	k_event_init(&event);
+	spawn_waiter(&tdata_1, stack_1, &args, HIGH_PRIO);
+	k_sleep(SETTLE_TIME);
+
+	(void)k_event_post(&event, EV_A | EV_C);
+	k_sleep(SETTLE_TIME);
+	zassert_equal(args.result, ~0U, "woken before all events posted");
+
+	(void)k_event_post(&event, EV_B);
+	k_sleep(SETTLE_TIME);
+	zassert_equal(args.result, EV_A | EV_B | EV_C, NULL);
+	zassert_equal(k_event_get(&event), EV_C, NULL);
+
+	k_thread_abort(&tdata_1);
+}
+
+/**
+ * @brief Test that one post wakes every waiter that does not clear
+ */
+void test_event_wait_any_broadcast(void)
+{
+	struct waiter_args args_1 = {
+		.events = EV_A | EV_B,
+		.options = K_EVENT_WAIT_ANY,
+		.timeout = K_FOREVER,
+	};
+	struct waiter_args args_2 = args_1;
+
+	k_event_init(&event);
+	spawn_waiter(&tdata_1, stack_1, &args_1, HIGH_PRIO);
+	spawn_waiter(&tdata_2, stack_2, &args_2, LOW_PRIO);
+	k_sleep(SETTLE_TIME);
+
+	(void)k_event_post(&event, EV_B);
+	k_sleep(SETTLE_TIME);
+	zassert_equal(args_1.result, EV_B, NULL);
+	zassert_equal(args_2.result, EV_B, NULL);
+	zassert_equal(k_event_get(&event), EV_B, NULL);
+
+	k_thread_abort(&tdata_1);
+	k_thread_abort(&tdata_2);
+}
+
+/**
+ * @brief Test that clearing waiters consume events in priority order
+ */
+void test_event_wait_clear_priority(void)
+{
+	struct waiter_args args_low = {
+		.events = EV_A,
+		.options = K_EVENT_WAIT_ANY | K_EVENT_WAIT_CLEAR,
+		.timeout = K_FOREVER,
+	};
+	struct waiter_args args_high = args_low;
+
+	k_event_init(&event);
+	/* Pend the low priority waiter first */
+	spawn_waiter(&tdata_2, stack_2, &args_low, LOW_PRIO);
+	k_sleep(SETTLE_TIME);
+	spawn_waiter(&tdata_1, stack_1, &args_high, HIGH_PRIO);
+	k_sleep(SETTLE_TIME);
+
+	(void)k_event_post(&event, EV_A);
+	k_sleep(SETTLE_TIME);
+	zassert_equal(args_high.result, EV_A, NULL);
+	zassert_equal(args_low.result, ~0U, "event consumed twice");
+	zassert_equal(k_event_get(&event), 0, NULL);
+
+	(void)k_event_post(&event, EV_A);
+	k_sleep(SETTLE_TIME);
+	zassert_equal(args_low.result, EV_A, NULL);
+	zassert_equal(k_event_get(&event), 0, NULL);
+
+	k_thread_abort(&tdata_1);
+	k_thread_abort(&tdata_2);
+}
+
+/**
+ * @brief Test posting events from an ISR
+ */
+void test_event_post_from_isr(void)
+{
+	struct waiter_args args = {
+		.events = EV_B,
+		.options = K_EVENT_WAIT_ANY,
+		.timeout = EVENT_TIMEOUT,
+	};
+
+	k_event_init(&event);
+	spawn_waiter(&tdata_1, stack_1, &args, HIGH_PRIO);
+	k_sleep(SETTLE_TIME);
+
+	irq_offload(isr_event_post, &event);
+	k_sleep(SETTLE_TIME);
+	zassert_equal(args.result, EV_B, NULL);
+
+	k_thread_abort(&tdata_1);
+}
+
+void test_main(void)
+{
+	k_thread_access_grant(k_current_get(), &kevent, &event);
+
+	ztest_test_suite(test_events,
+			 ztest_user_unit_test(test_event_post_set_clear),
+			 ztest_user_unit_test(test_event_wait_no_wait),
+			 ztest_user_unit_test(test_event_wait_timeout),
+			 ztest_unit_test(test_event_wait_all),
+			 ztest_unit_test(test_event_wait_any_broadcast),
+			 ztest_1cpu_unit_test(test_event_wait_clear_priority),
+			 ztest_unit_test(test_event_post_from_isr));
+	ztest_run_test_suite(test_events);
+}
@@ -617,6 +617,61 @@ void test_poll_threadstate(void)
 	k_thread_priority_set(k_current_get(), old_prio);
 }
 
+static struct k_poll_signal broadcast_signal;
+static struct k_sem broadcast_sem;
+
+static void broadcast_poller(void *p1, void *p2, void *p3)
+{
+	(void)p1; (void)p2; (void)p3;
+
+	struct k_poll_event event;
+
+	k_poll_event_init(&event, K_POLL_TYPE_SIGNAL,
+			  K_POLL_MODE_NOTIFY_ONLY, &broadcast_signal);
+
+	if (k_poll(&event, 1, K_SECONDS(1)) == 0 &&
+	    event.state == K_POLL_STATE_SIGNALED) {
+		k_sem_give(&broadcast_sem);
+	}
+}
+
+/**
+ * @brief Test that raising a signal wakes every thread polling on it
+ *
+ * @ingroup kernel_poll_tests
+ *
+ * @see k_poll(), k_poll_signal_raise()
+ */
+void test_poll_signal_broadcast(void)
+{
+	int old_prio = k_thread_priority_get(k_current_get());
+	const int main_low_prio = 10;
+
+	k_poll_signal_init(&broadcast_signal);
+	k_sem_init(&broadcast_sem, 0, 2);
+
+	k_thread_priority_set(k_current_get(), main_low_prio);
+
+	k_thread_create(&test_thread, test_stack,
+			K_THREAD_STACK_SIZEOF(test_stack), broadcast_poller,
+			0, 0, 0, main_low_prio - 1, K_INHERIT_PERMS,
+			K_NO_WAIT);
+	k_thread_create(&test_loprio_thread, test_loprio_stack,
+			K_THREAD_STACK_SIZEOF(test_loprio_stack),
+			broadcast_poller, 0, 0, 0, main_low_prio - 1,
+			K_INHERIT_PERMS, K_NO_WAIT);
+
+	/* Both pollers are now waiting on the signal: one raise has to
+	 * release them both, well before their timeout
+	 */
+	zassert_equal(k_poll_signal_raise(&broadcast_signal, SIGNAL_RESULT),
+		      0, "");
+	zassert_equal(k_sem_take(&broadcast_sem, K_MSEC(100)), 0, "");
+	zassert_equal(k_sem_take(&broadcast_sem, K_MSEC(100)), 0, "");
+
+	k_thread_priority_set(k_current_get(), old_prio);
+}
+
 void test_poll_grant_access(void)
 {
 	k_thread_access_grant(k_current_get(), &no_wait_sem, &no_wait_fifo,
@@ -440,6 +440,215 @@ void test_wakeup_threads(void)
 	cleanup_resources();
 }
 
+#ifdef CONFIG_SCHED_CPU_MASK
+static volatile bool spin_release;
+static volatile int spin_count;
+
+static k_tid_t spawn_pinned(int idx, k_thread_entry_t entry, int prio,
+			    int cpu)
+{
+	tinfo[idx].tid = k_thread_create(&tthread[idx], tstack[idx],
+					 STACK_SIZE, entry,
+					 INT_TO_POINTER(idx), NULL, NULL,
+					 prio, 0, K_FOREVER);
+	tinfo[idx].priority = prio;
+
+	/* A negative CPU leaves the thread free to run anywhere */
+	if (cpu >= 0) {
+		k_thread_cpu_mask_clear(tinfo[idx].tid);
+		k_thread_cpu_mask_enable(tinfo[idx].tid, cpu);
+	}
+
+	k_thread_start(tinfo[idx].tid);
+	return tinfo[idx].tid;
+}
+
+static void record_cpu_entry(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+	int thread_num = POINTER_TO_INT(p1);
+
+	tinfo[thread_num].cpu_id = curr_cpu();
+	tinfo[thread_num].executed = 1;
+}
+
+static void spin_entry(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+	int thread_num = POINTER_TO_INT(p1);
+
+	tinfo[thread_num].cpu_id = curr_cpu();
+	tinfo[thread_num].executed = 1;
+
+	while (!spin_release) {
+		spin_count++;
+	}
+}
+
+/* Spin, without giving up this CPU, until the thread has run or
+ * TIMEOUT milliseconds have passed
+ */
+static bool wait_executed(int thread_num)
+{
+	for (int i = 0; i < TIMEOUT && tinfo[thread_num].executed == 0; i++) {
+		k_busy_wait(1000);
+	}
+
+	return tinfo[thread_num].executed == 1;
+}
+
+/**
+ * @brief Test CPU affinity of pinned threads
+ *
+ * @ingroup kernel_smp_tests
+ *
+ * @details Pin a thread to each CPU in turn and check that
+ * it runs on that CPU and no other
+ */
+void test_cpu_mask_threads(void)
+{
+	for (int cpu = 0; cpu < CONFIG_MP_NUM_CPUS; cpu++) {
+		spawn_pinned(0, record_cpu_entry, K_PRIO_PREEMPT(2), cpu);
+
+		/* Sleep so that the thread can also run on this CPU */
+		k_sleep(K_MSEC(100));
+
+		zassert_true(tinfo[0].executed == 1,
+			     "thread pinned to CPU %d didn't run", cpu);
+		zassert_equal(tinfo[0].cpu_id, cpu,
+			      "thread pinned to CPU %d ran on CPU %d", cpu,
+			      tinfo[0].cpu_id);
+
+		k_thread_abort(tinfo[0].tid);
+		cleanup_resources();
+	}
+}
+
+/**
+ * @brief Test that an idle CPU takes work queued elsewhere
+ *
+ * @ingroup kernel_smp_tests
+ *
+ * @details Keep every CPU busy with a cooperative thread so that
+ * a new preemptive thread can only be queued, then let all CPUs
+ * but this one go idle.  The queued thread must run on one of them
+ * while this CPU stays busy, even if it was queued on this CPU.
+ */
+void test_steal_threads(void)
+{
+	int cpu = curr_cpu();
+	int i, n = 0;
+
+	spin_release = false;
+	for (i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		if (i != cpu) {
+			spawn_pinned(n, spin_entry, K_PRIO_COOP(2), i);
+			zassert_true(wait_executed(n),
+				     "thread pinned to CPU %d didn't run", i);
+			n++;
+		}
+	}
+
+	spawn_pinned(n, record_cpu_entry, K_PRIO_PREEMPT(2), -1);
+	k_busy_wait(DELAY_US);
+	zassert_true(tinfo[n].executed == 0,
+		     "cooperative thread is preempted");
+
+	spin_release = true;
+	zassert_true(wait_executed(n), "queued thread didn't run");
+	zassert_not_equal(tinfo[n].cpu_id, cpu,
+			  "queued thread ran on the busy CPU");
+
+	abort_threads(n + 1);
+	cleanup_resources();
+}
+
+/**
+ * @brief Test aborting a thread running on another CPU
+ *
+ * @ingroup kernel_smp_tests
+ *
+ * @details Abort a thread spinning on another CPU and check
+ * that it is dead and no longer runs once k_thread_abort()
+ * returns
+ */
+void test_abort_remote_threads(void)
+{
+	int other = (curr_cpu() + 1) % CONFIG_MP_NUM_CPUS;
+	k_tid_t tid;
+	int count;
+
+	spin_release = false;
+	tid = spawn_pinned(0, spin_entry, K_PRIO_PREEMPT(2), other);
+	zassert_true(wait_executed(0), "thread didn't run");
+
+	k_thread_abort(tid);
+	zassert_true((tid->base.thread_state & _THREAD_DEAD) != 0U,
+		     "aborted thread isn't dead");
+
+	count = spin_count;
+	k_busy_wait(DELAY_US);
+	zassert_equal(count, spin_count, "aborted thread still runs");
+
+	cleanup_resources();
+}
+
+/**
+ * @brief Test raising the priority of a thread queued on another CPU
+ *
+ * @ingroup kernel_smp_tests
+ *
+ * @details Queue a thread behind a higher priority spinning thread
+ * on another CPU, then raise its priority above the spinning one.
+ * The other CPU must switch to it without this CPU yielding.
+ */
+void test_priority_remote_threads(void)
+{
+	int other = (curr_cpu() + 1) % CONFIG_MP_NUM_CPUS;
+	k_tid_t tid;
+
+	spin_release = false;
+	spawn_pinned(0, spin_entry, K_PRIO_PREEMPT(10), other);
+	zassert_true(wait_executed(0), "thread didn't run");
+
+	tid = spawn_pinned(1, record_cpu_entry, K_PRIO_PREEMPT(12), other);
+	k_busy_wait(DELAY_US);
+	zassert_true(tinfo[1].executed == 0,
+		     "lower priority thread preempted");
+
+	k_thread_priority_set(tid, K_PRIO_PREEMPT(8));
+	zassert_true(wait_executed(1), "raised thread didn't preempt");
+	zassert_equal(tinfo[1].cpu_id, other, "raised thread ran on CPU %d",
+		      tinfo[1].cpu_id);
+
+	spin_release = true;
+	abort_threads(2);
+	cleanup_resources();
+}
+#else
+void test_cpu_mask_threads(void)
+{
+	ztest_test_skip();
+}
+
+void test_steal_threads(void)
+{
+	ztest_test_skip();
+}
+
+void test_abort_remote_threads(void)
+{
+	ztest_test_skip();
+}
+
+void test_priority_remote_threads(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_SCHED_CPU_MASK */
+
 void test_main(void)
 {
 	/* Sleep a bit to guarantee that both CPUs enter an idle
@@ -455,7 +664,11 @@ void test_main(void)
 			 ztest_unit_test(test_preempt_resched_threads),
 			 ztest_unit_test(test_yield_threads),
 			 ztest_unit_test(test_sleep_threads),
-			 ztest_unit_test(test_wakeup_threads)
+			 ztest_unit_test(test_wakeup_threads),
+			 ztest_unit_test(test_cpu_mask_threads),
+			 ztest_unit_test(test_steal_threads),
+			 ztest_unit_test(test_abort_remote_threads),
+			 ztest_unit_test(test_priority_remote_threads)
 			 );
 	ztest_run_test_suite(smp);
 }
@@ -0,0 +1,211 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <sys/sys_heap.h>
+#include <string.h>
+
+#define HEAP_SZ 8192
+#define N_BLOCKS 64
+#define N_ITERS 20000
+
+static char __aligned(8) heap_mem[HEAP_SZ];
+static struct sys_heap heap;
+
+static void *blocks[N_BLOCKS];
+static size_t sizes[N_BLOCKS];
+
+static u32_t rand_state = 2463534242U;
+
+static u32_t rand32(void)
+{
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+	return rand_state;
+}
+
+static void fill(int i)
+{
+	(void)memset(blocks[i], i, sizes[i]);
+}
+
+static void check(int i)
+{
+	u8_t *p = blocks[i];
+
+	for (size_t j = 0; j < sizes[i]; j++) {
+		zassert_equal(p[j], (u8_t)i, "block %d corrupted", i);
+	}
+}
+
+static void free_all(void)
+{
+	for (int i = 0; i < N_BLOCKS; i++) {
+		if (blocks[i] != NULL) {
+			check(i);
+			sys_heap_free(&heap, blocks[i]);
+			blocks[i] = NULL;
+		}
+	}
+}
+
+static void test_heap_empty(void)
+{
+	struct sys_heap_runtime_stats stats;
+	void *p;
+
+	sys_heap_init(&heap, heap_mem, sizeof(heap_mem));
+	zassert_true(sys_heap_validate(&heap), "fresh heap invalid");
+
+	sys_heap_runtime_stats_get(&heap, &stats);
+	zassert_equal(stats.allocated_bytes, 0, "");
+	zassert_true(stats.free_bytes > HEAP_SZ / 2, "");
+	zassert_true(stats.largest_free_bytes < stats.free_bytes, "");
+
+	zassert_is_null(sys_heap_alloc(&heap, 0), "zero size allocated");
+	zassert_is_null(sys_heap_alloc(&heap, HEAP_SZ), "oversize allocated");
+
+	/* The whole heap is available as one block */
+	p = sys_heap_alloc(&heap, stats.largest_free_bytes);
+	zassert_not_null(p, "largest block not available");
+	zassert_is_null(sys_heap_alloc(&heap, 1), "full heap allocated");
+	sys_heap_free(&heap, p);
+
+	sys_heap_free(&heap, NULL);
+	zassert_true(sys_heap_validate(&heap), "");
+}
+
+static void test_heap_stress(void)
+{
+	struct sys_heap_runtime_stats stats;
+	size_t capacity;
+
+	sys_heap_init(&heap, heap_mem, sizeof(heap_mem));
+	sys_heap_runtime_stats_get(&heap, &stats);
+	capacity = stats.free_bytes;
+
+	for (int n = 0; n < N_ITERS; n++) {
+		int i = rand32() % N_BLOCKS;
+
+		if (blocks[i] == NULL) {
+			sizes[i] = rand32() % (HEAP_SZ / 16);
+			blocks[i] = sys_heap_alloc(&heap, sizes[i]);
+			if (blocks[i] != NULL) {
+				fill(i);
+			}
+		} else {
+			check(i);
+			sys_heap_free(&heap, blocks[i]);
+			blocks[i] = NULL;
+		}
+
+		if ((n % 64) == 0) {
+			zassert_true(sys_heap_validate(&heap),
+				     "heap invalid after %d ops", n);
+		}
+	}
+
+	sys_heap_runtime_stats_get(&heap, &stats);
+	zassert_true(stats.max_allocated_bytes >= stats.allocated_bytes, "");
+	zassert_equal(stats.allocated_bytes + stats.free_bytes, capacity, "");
+
+	free_all();
+	zassert_true(sys_heap_validate(&heap), "");
+
+	/* Everything coalesced back into one block */
+	sys_heap_runtime_stats_get(&heap, &stats);
+	zassert_equal(stats.allocated_bytes, 0, "leaked memory");
+	zassert_not_null(sys_heap_alloc(&heap, stats.largest_free_bytes),
+			 "heap did not coalesce");
+}
+
+static void test_heap_aligned(void)
+{
+	sys_heap_init(&heap, heap_mem, sizeof(heap_mem));
+
+	for (int i = 0; i < N_BLOCKS; i++) {
+		size_t align = 1 << (rand32() % 8);
+
+		sizes[i] = rand32() % 64;
+		blocks[i] = sys_heap_aligned_alloc(&heap, align, sizes[i]);
+		if (blocks[i] == NULL) {
+			continue;
+		}
+
+		zassert_equal((uintptr_t)blocks[i] & (align - 1), 0,
+			      "misaligned block %p (%u)", blocks[i], align);
+		fill(i);
+		zassert_true(sys_heap_validate(&heap), "");
+	}
+
+	free_all();
+	zassert_true(sys_heap_validate(&heap), "");
+}
+
+static void test_heap_realloc(void)
+{
+	void *p, *q, *r;
+	u8_t *b;
+
+	sys_heap_init(&heap, heap_mem, sizeof(heap_mem));
+
+	p = sys_heap_alloc(&heap, 64);
+	(void)memset(p, 0xa5, 64);
+
+	/* Shrinking and growing back into the freed tail stay in place */
+	zassert_equal(sys_heap_realloc(&heap, p, 16), p, "shrink moved");
+	zassert_equal(sys_heap_realloc(&heap, p, 256), p, "grow moved");
+
+	/* A used neighbour forces a move, which keeps the contents */
+	q = sys_heap_alloc(&heap, 32);
+	zassert_not_null(q, "");
+	r = sys_heap_realloc(&heap, p, 1024);
+	zassert_not_null(r, "");
+	zassert_not_equal(r, p, "grew over a used block");
+
+	b = r;
+	for (int i = 0; i < 16; i++) {
+		zassert_equal(b[i], 0xa5, "contents lost");
+	}
+
+	zassert_is_null(sys_heap_realloc(&heap, r, HEAP_SZ), "");
+	zassert_true(sys_heap_validate(&heap), "failed realloc broke heap");
+
+	zassert_is_null(sys_heap_realloc(&heap, r, 0), "");
+	sys_heap_free(&heap, q);
+	zassert_true(sys_heap_validate(&heap), "");
+}
+
+static void test_k_malloc_heap(void)
+{
+	struct sys_heap_runtime_stats stats;
+	extern struct k_heap _system_heap;
+	void *p = k_malloc(100);
+	void *q = k_calloc(10, 10);
+
+	zassert_not_null(p, "");
+	zassert_not_null(q, "");
+
+	k_heap_runtime_stats_get(&_system_heap, &stats);
+	zassert_true(stats.allocated_bytes >= 200, "");
+
+	k_free(p);
+	k_free(q);
+
+	k_heap_runtime_stats_get(&_system_heap, &stats);
+	zassert_equal(stats.allocated_bytes, 0, "");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_heap,
+			 ztest_unit_test(test_heap_empty),
+			 ztest_unit_test(test_heap_stress),
+			 ztest_unit_test(test_heap_aligned),
+			 ztest_unit_test(test_heap_realloc),
+			 ztest_unit_test(test_k_malloc_heap)
+			 );
+	ztest_run_test_suite(test_heap);
+}
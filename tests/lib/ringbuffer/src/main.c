@@ -443,6 +443,137 @@ void test_reset(void)
 	zassert_true(granted == RINGBUFFER_SIZE - 1, NULL);
 }
 
+#define SEGS_SIZE 16
+
+RING_BUF_DECLARE(ringbuf_segs, SEGS_SIZE);
+
+void test_claim_segs(void)
+{
+	struct ring_buf_seg seg[2];
+	u8_t indata[SEGS_SIZE];
+	u8_t outdata[SEGS_SIZE];
+	u32_t granted;
+
+	for (int i = 0; i < sizeof(indata); i++) {
+		indata[i] = i;
+	}
+
+	ring_buf_init(&ringbuf_segs, SEGS_SIZE, ringbuf_segs.buf.buf8);
+
+	/* Move the indexes close to the end of the buffer */
+	granted = ring_buf_put(&ringbuf_segs, indata, SEGS_SIZE - 3);
+	zassert_equal(granted, SEGS_SIZE - 3, NULL);
+	granted = ring_buf_get(&ringbuf_segs, outdata, SEGS_SIZE - 3);
+	zassert_equal(granted, SEGS_SIZE - 3, NULL);
+
+	/**TESTPOINT: a claim across the end returns both segments */
+	granted = ring_buf_put_claim_segs(&ringbuf_segs, seg, 10);
+	zassert_equal(granted, 10, NULL);
+	zassert_equal(seg[0].size, 3, NULL);
+	zassert_equal(seg[1].size, 7, NULL);
+	zassert_equal(seg[1].data, ringbuf_segs.buf.buf8, NULL);
+	memcpy(seg[0].data, indata, seg[0].size);
+	memcpy(seg[1].data, indata + seg[0].size, seg[1].size);
+	zassert_equal(ring_buf_put_finish(&ringbuf_segs, granted), 0, NULL);
+
+	granted = ring_buf_get_claim_segs(&ringbuf_segs, seg, SEGS_SIZE);
+	zassert_equal(granted, 10, NULL);
+	zassert_equal(seg[0].size, 3, NULL);
+	zassert_equal(seg[1].size, 7, NULL);
+	zassert_equal(memcmp(seg[0].data, indata, seg[0].size), 0, NULL);
+	zassert_equal(memcmp(seg[1].data, indata + seg[0].size, seg[1].size),
+		      0, NULL);
+	zassert_equal(ring_buf_get_finish(&ringbuf_segs, granted), 0, NULL);
+	zassert_true(ring_buf_is_empty(&ringbuf_segs), NULL);
+
+	/**TESTPOINT: a claim that does not wrap leaves the second empty */
+	granted = ring_buf_put_claim_segs(&ringbuf_segs, seg, 4);
+	zassert_equal(granted, 4, NULL);
+	zassert_equal(seg[0].size, 4, NULL);
+	zassert_equal(seg[1].size, 0, NULL);
+}
+
+RING_BUF_MPSC_DECLARE(ringbuf_mpsc, SEGS_SIZE);
+
+static void tringbuf_mpsc_put(void *p)
+{
+	u8_t rec[4];
+
+	(void)memset(rec, POINTER_TO_INT(p), sizeof(rec));
+	zassert_equal(ring_buf_mpsc_put(&ringbuf_mpsc, rec, sizeof(rec)),
+		      sizeof(rec), NULL);
+}
+
+void test_mpsc(void)
+{
+	struct ring_buf_seg seg[2];
+	u8_t outdata[SEGS_SIZE];
+	u8_t rec[4] = { 1, 1, 1, 1 };
+	u32_t granted;
+
+	/**TESTPOINT: reservations are all or nothing */
+	granted = ring_buf_mpsc_put(&ringbuf_mpsc, outdata, SEGS_SIZE);
+	zassert_equal(granted, 0, NULL);
+	zassert_true(ring_buf_is_empty(&ringbuf_mpsc), NULL);
+
+	/**TESTPOINT: data is only visible once every claim is finished */
+	granted = ring_buf_mpsc_put_claim(&ringbuf_mpsc, seg, sizeof(rec));
+	zassert_equal(granted, sizeof(rec), NULL);
+	memcpy(seg[0].data, rec, seg[0].size);
+	memcpy(seg[1].data, rec + seg[0].size, seg[1].size);
+
+	/* A producer in interrupt context overtakes the open claim */
+	irq_offload(tringbuf_mpsc_put, (void *)2);
+	zassert_true(ring_buf_is_empty(&ringbuf_mpsc), NULL);
+
+	ring_buf_mpsc_put_finish(&ringbuf_mpsc);
+	zassert_false(ring_buf_is_empty(&ringbuf_mpsc), NULL);
+
+	granted = ring_buf_get(&ringbuf_mpsc, outdata, sizeof(outdata));
+	zassert_equal(granted, 2 * sizeof(rec), NULL);
+	for (int i = 0; i < granted; i++) {
+		zassert_equal(outdata[i], i < sizeof(rec) ? 1 : 2, NULL);
+	}
+
+	/**TESTPOINT: records wrap around the end of the buffer */
+	for (int i = 0; i < 3 * SEGS_SIZE / sizeof(rec); i++) {
+		irq_offload(tringbuf_mpsc_put, INT_TO_POINTER(i));
+		granted = ring_buf_get(&ringbuf_mpsc, outdata, sizeof(outdata));
+		zassert_equal(granted, sizeof(rec), NULL);
+		zassert_equal(outdata[sizeof(rec) - 1], (u8_t)i, NULL);
+	}
+}
+
+static void tringbuf_spsc_get(void *p)
+{
+	u32_t *got = p;
+	u8_t outdata[8];
+	u32_t n;
+
+	n = ring_buf_get(&ringbuf_segs, outdata, sizeof(outdata));
+	for (int i = 0; i < n; i++) {
+		zassert_equal(outdata[i], (u8_t)(*got + i), NULL);
+	}
+	*got += n;
+}
+
+void test_spsc_thread_isr(void)
+{
+	u8_t indata[5];
+	u32_t put = 0U, got = 0U;
+
+	ring_buf_init(&ringbuf_segs, SEGS_SIZE, ringbuf_segs.buf.buf8);
+
+	/**TESTPOINT: a thread producer and an ISR consumer need no lock */
+	while (got < 4 * SEGS_SIZE) {
+		for (int i = 0; i < sizeof(indata); i++) {
+			indata[i] = put + i;
+		}
+		put += ring_buf_put(&ringbuf_segs, indata, sizeof(indata));
+		irq_offload(tringbuf_spsc_get, &got);
+	}
+}
+
 /*test case main entry*/
 void test_main(void)
 {
@@ -461,7 +592,10 @@ void test_main(void)
 			 ztest_unit_test(test_byte_put_free),
 			 ztest_unit_test(test_byte_put_free),
 			 ztest_unit_test(test_capacity),
-			 ztest_unit_test(test_reset)
+			 ztest_unit_test(test_reset),
+			 ztest_unit_test(test_claim_segs),
+			 ztest_unit_test(test_mpsc),
+			 ztest_unit_test(test_spsc_thread_isr)
 			 );
 	ztest_run_test_suite(test_ringbuffer_api);
 }
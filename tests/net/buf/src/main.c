@@ -62,10 +62,15 @@ static int destroy_called;
 static void buf_destroy(struct net_buf *buf);
 static void fixed_destroy(struct net_buf *buf);
 static void var_destroy(struct net_buf *buf);
+static void class_destroy(struct net_buf *buf);
 
 NET_BUF_POOL_HEAP_DEFINE(bufs_pool, 10, buf_destroy);
 NET_BUF_POOL_FIXED_DEFINE(fixed_pool, 10, 128, fixed_destroy);
 NET_BUF_POOL_VAR_DEFINE(var_pool, 10, 1024, var_destroy);
+NET_BUF_DATA_CLASS_DEFINE(small_class, 64, 2);
+NET_BUF_DATA_CLASS_DEFINE(large_class, 512, 2);
+NET_BUF_POOL_CLASS_DEFINE(class_pool, 10, class_destroy,
+			  &small_class, &large_class);
 
 static void buf_destroy(struct net_buf *buf)
 {
@@ -94,6 +99,15 @@ static void var_destroy(struct net_buf *buf)
 	net_buf_destroy(buf);
 }
 
+static void class_destroy(struct net_buf *buf)
+{
+	struct net_buf_pool *pool = net_buf_pool_get(buf->pool_id);
+
+	destroy_called++;
+	zassert_equal(pool, &class_pool, "Invalid free pointer in buffer");
+	net_buf_destroy(buf);
+}
+
 static const char example_data[] = "0123456789"
 				   "abcdefghijklmnopqrstuvxyz"
 				   "!#¤%&/()=?";
@@ -457,6 +471,66 @@ static void net_buf_test_var_pool(void)
 	zassert_equal(destroy_called, 3, "Incorrect destroy callback count");
 }
 
+static void net_buf_test_class_pool(void)
+{
+	struct net_buf *buf1, *buf2, *buf3, *buf4, *buf5;
+
+	destroy_called = 0;
+
+	buf1 = net_buf_alloc_len(&class_pool, 20, K_NO_WAIT);
+	zassert_not_null(buf1, "Failed to get buffer");
+	zassert_equal(buf1->size, 20, "Invalid buffer size");
+
+	buf2 = net_buf_alloc_len(&class_pool, 200, K_NO_WAIT);
+	zassert_not_null(buf2, "Failed to get buffer");
+	zassert_equal(buf2->size, 200, "Invalid buffer size");
+
+	zassert_equal(atomic_get(&small_class.allocs), 1,
+		      "Invalid small class allocations");
+	zassert_equal(atomic_get(&large_class.allocs), 1,
+		      "Invalid large class allocations");
+
+	buf3 = net_buf_alloc_len(&class_pool, 1000, K_NO_WAIT);
+	zassert_is_null(buf3, "Got buffer larger than the classes");
+
+	buf3 = net_buf_alloc_len(&class_pool, 512, K_NO_WAIT);
+	zassert_not_null(buf3, "Failed to get buffer");
+
+	/* The small class is taken from once it is empty */
+	buf4 = net_buf_alloc_len(&class_pool, 60, K_NO_WAIT);
+	zassert_not_null(buf4, "Failed to get buffer");
+
+	buf5 = net_buf_alloc_len(&class_pool, 60, K_NO_WAIT);
+	zassert_is_null(buf5, "Got buffer without data");
+
+	zassert_equal(atomic_get(&large_class.fallbacks), 0,
+		      "Invalid fallback count");
+	zassert_equal(atomic_get(&small_class.failures), 1,
+		      "Invalid failure count");
+
+	net_buf_unref(buf4);
+
+	buf4 = net_buf_clone(buf2, K_NO_WAIT);
+	zassert_not_null(buf4, "Failed to clone buffer");
+	zassert_equal(buf4->data, buf2->data, "Cloned data doesn't match");
+
+	net_buf_unref(buf1);
+	net_buf_unref(buf2);
+	net_buf_unref(buf3);
+	net_buf_unref(buf4);
+
+	/* The data of the clone is back, both large blocks are free */
+	buf1 = net_buf_alloc_len(&class_pool, 500, K_NO_WAIT);
+	zassert_not_null(buf1, "Failed to get buffer");
+	buf2 = net_buf_alloc_len(&class_pool, 500, K_NO_WAIT);
+	zassert_not_null(buf2, "Failed to get buffer");
+
+	net_buf_unref(buf1);
+	net_buf_unref(buf2);
+
+	zassert_equal(destroy_called, 7, "Incorrect destroy callback count");
+}
+
 static void net_buf_test_byte_order(void)
 {
 	struct net_buf *buf;
@@ -585,6 +659,7 @@ void test_main(void)
 			 ztest_unit_test(net_buf_test_clone),
 			 ztest_unit_test(net_buf_test_fixed_pool),
 			 ztest_unit_test(net_buf_test_var_pool),
+			 ztest_unit_test(net_buf_test_class_pool),
 			 ztest_unit_test(net_buf_test_byte_order)
 			 );
 
@@ -0,0 +1,340 @@
+/* main.c - Application main entry point */
+
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_IPV4_LOG_LEVEL);
+
+#include <zephyr/types.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/printk.h>
+#include <linker/sections.h>
+
+#include <ztest.h>
+
+#include <net/dummy.h>
+#include <net/buf.h>
+#include <net/net_ip.h>
+#include <net/net_if.h>
+#include <net/net_context.h>
+
+#define NET_LOG_ENABLED 1
+#include "net_private.h"
+
+#include "ipv4.h"
+
+#define TEST_MTU 576
+#define TEST_PORT 4242
+#define TEST_DATA_LEN 3000
+#define TEST_FRAGMENTS 6
+
+#define WAIT_TIME K_MSEC(250)
+#define EXPIRE_TIME (K_SECONDS(CONFIG_NET_IPV4_FRAGMENT_TIMEOUT) + WAIT_TIME)
+
+static struct in_addr my_addr = { { { 192, 0, 2, 1 } } };
+static struct in_addr peer_addr = { { { 192, 0, 2, 2 } } };
+static struct in_addr netmask = { { { 255, 255, 255, 0 } } };
+
+static u8_t mac_addr[] = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x01 };
+
+static struct net_if *iface;
+static struct net_context *udp_ctx;
+
+static u8_t test_data[TEST_DATA_LEN];
+
+/* Clones of the fragments sent by the interface */
+static struct net_pkt *sent[TEST_FRAGMENTS];
+static int sent_count;
+
+static struct k_sem wait_data;
+static bool data_ok;
+
+struct frag_stats {
+	u32_t reassembled;
+	u32_t timeouts;
+	u32_t dropped;
+};
+
+static int net_iface_dev_init(struct device *dev)
+{
+	return 0;
+}
+
+static void net_iface_init(struct net_if *iface)
+{
+	net_if_set_link_addr(iface, mac_addr, sizeof(mac_addr),
+			     NET_LINK_ETHERNET);
+}
+
+static int sender_iface(struct device *dev, struct net_pkt *pkt)
+{
+	if (sent_count < TEST_FRAGMENTS) {
+		sent[sent_count] = net_pkt_clone(pkt, K_NO_WAIT);
+	}
+
+	sent_count++;
+
+	net_pkt_unref(pkt);
+
+	return 0;
+}
+
+static struct dummy_api net_iface_api = {
+	.iface_api.init = net_iface_init,
+	.send = sender_iface,
+};
+
+NET_DEVICE_INIT(net_ipv4_frag_test, "net_ipv4_frag_test",
+		net_iface_dev_init, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &net_iface_api,
+		DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), TEST_MTU);
+
+static void frag_stats_cb(struct net_ipv4_reassembly *reass,
+			  void *user_data)
+{
+	struct frag_stats *stats = user_data;
+
+	stats->reassembled += reass->reassembled;
+	stats->timeouts += reass->timeouts;
+	stats->dropped += reass->dropped;
+}
+
+static struct frag_stats get_frag_stats(void)
+{
+	struct frag_stats stats = { 0 };
+
+	net_ipv4_frag_foreach(frag_stats_cb, &stats);
+
+	return stats;
+}
+
+static void recv_cb(struct net_context *context, struct net_pkt *pkt,
+		    union net_ip_header *ip_hdr,
+		    union net_proto_header *proto_hdr,
+		    int status, void *user_data)
+{
+	static u8_t buf[TEST_DATA_LEN];
+	size_t len;
+
+	if (!pkt) {
+		return;
+	}
+
+	len = net_pkt_remaining_data(pkt);
+
+	data_ok = len == sizeof(buf) && !net_pkt_read(pkt, buf, len) &&
+		  !memcmp(buf, test_data, len);
+
+	net_pkt_unref(pkt);
+
+	k_sem_give(&wait_data);
+}
+
+static void test_setup(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(TEST_PORT),
+	};
+	struct net_if_addr *ifaddr;
+	int i, ret;
+
+	k_sem_init(&wait_data, 0, UINT_MAX);
+
+	for (i = 0; i < sizeof(test_data); i++) {
+		test_data[i] = i;
+	}
+
+	iface = net_if_get_default();
+	zassert_not_null(iface, "Interface");
+
+	ifaddr = net_if_ipv4_addr_add(iface, &my_addr, NET_ADDR_MANUAL, 0);
+	zassert_not_null(ifaddr, "Cannot add IPv4 address");
+
+	net_if_ipv4_set_netmask(iface, &netmask);
+
+	ret = net_context_get(AF_INET, SOCK_DGRAM, IPPROTO_UDP, &udp_ctx);
+	zassert_equal(ret, 0, "Cannot get UDP context");
+
+	net_ipaddr_copy(&addr.sin_addr, &my_addr);
+
+	ret = net_context_bind(udp_ctx, (struct sockaddr *)&addr,
+			       sizeof(addr));
+	zassert_equal(ret, 0, "Cannot bind UDP context");
+
+	ret = net_context_recv(udp_ctx, recv_cb, K_NO_WAIT, NULL);
+	zassert_equal(ret, 0, "Cannot set receive callback");
+}
+
+/* Send the test data to the peer and check how it was fragmented */
+static void send_fragmented(void)
+{
+	NET_PKT_DATA_ACCESS_CONTIGUOUS_DEFINE(ipv4_access, struct net_ipv4_hdr);
+	struct sockaddr_in dst = {
+		.sin_family = AF_INET,
+		.sin_port = htons(TEST_PORT),
+	};
+	u16_t id = 0U, expected = 0U;
+	int i, ret;
+
+	sent_count = 0;
+
+	net_ipaddr_copy(&dst.sin_addr, &peer_addr);
+
+	ret = net_context_sendto(udp_ctx, test_data, sizeof(test_data),
+				 (struct sockaddr *)&dst, sizeof(dst),
+				 NULL, K_NO_WAIT, NULL);
+	zassert_equal(ret, sizeof(test_data), "Send failed (%d)", ret);
+
+	k_sleep(WAIT_TIME);
+
+	zassert_equal(sent_count, TEST_FRAGMENTS,
+		      "Invalid fragment count %d", sent_count);
+
+	for (i = 0; i < TEST_FRAGMENTS; i++) {
+		struct net_ipv4_hdr *hdr;
+		u16_t offset;
+
+		zassert_not_null(sent[i], "Cannot clone fragment %d", i);
+		zassert_true(net_pkt_get_len(sent[i]) <= TEST_MTU,
+			     "Fragment %d too long", i);
+
+		net_pkt_cursor_init(sent[i]);
+
+		hdr = (struct net_ipv4_hdr *)net_pkt_get_data(sent[i],
+							      &ipv4_access);
+		zassert_not_null(hdr, "Cannot access fragment %d header", i);
+
+		zassert_equal(ntohs(hdr->len), net_pkt_get_len(sent[i]),
+			      "Invalid length of fragment %d", i);
+
+		if (!i) {
+			id = sys_get_be16(hdr->id);
+		}
+
+		zassert_equal(sys_get_be16(hdr->id), id,
+			      "Invalid id of fragment %d", i);
+
+		offset = sys_get_be16(hdr->offset);
+
+		zassert_equal((offset & NET_IPV4_FRAGH_OFFSET_MASK) * 8U,
+			      expected, "Invalid offset of fragment %d", i);
+		zassert_equal(!!(offset & NET_IPV4_MF),
+			      i < TEST_FRAGMENTS - 1,
+			      "Invalid MF flag in fragment %d", i);
+
+		expected += ntohs(hdr->len) - sizeof(struct net_ipv4_hdr);
+
+		/* Swapping the addresses changes neither the IPv4 nor the
+		 * UDP checksum, so the fragments can be fed back as if the
+		 * peer had sent them.
+		 */
+		net_ipaddr_copy(&hdr->src, &peer_addr);
+		net_ipaddr_copy(&hdr->dst, &my_addr);
+
+		net_pkt_set_data(sent[i], &ipv4_access);
+	}
+
+	zassert_equal(expected, NET_UDPH_LEN + sizeof(test_data),
+		      "Invalid datagram length %u", expected);
+}
+
+static void recv_fragment(int i)
+{
+	net_pkt_cursor_init(sent[i]);
+
+	if (net_recv_data(iface, sent[i]) < 0) {
+		net_pkt_unref(sent[i]);
+	}
+
+	sent[i] = NULL;
+}
+
+static void test_send_recv_ipv4_fragment(void)
+{
+	struct frag_stats stats = get_frag_stats();
+	int i;
+
+	send_fragmented();
+
+	data_ok = false;
+
+	for (i = TEST_FRAGMENTS - 1; i >= 0; i--) {
+		recv_fragment(i);
+	}
+
+	zassert_equal(k_sem_take(&wait_data, WAIT_TIME), 0,
+		      "Datagram not reassembled");
+	zassert_true(data_ok, "Invalid reassembled data");
+
+	zassert_equal(get_frag_stats().reassembled, stats.reassembled + 1,
+		      "Invalid reassembled count");
+}
+
+static void test_recv_ipv4_fragment_timeout(void)
+{
+	struct frag_stats stats = get_frag_stats();
+	int i;
+
+	send_fragmented();
+
+	for (i = 0; i < TEST_FRAGMENTS - 1; i++) {
+		recv_fragment(i);
+	}
+
+	net_pkt_unref(sent[TEST_FRAGMENTS - 1]);
+
+	zassert_not_equal(k_sem_take(&wait_data, EXPIRE_TIME), 0,
+			  "Incomplete datagram received");
+
+	zassert_equal(get_frag_stats().timeouts, stats.timeouts + 1,
+		      "Invalid timeout count");
+}
+
+static void test_recv_ipv4_fragment_overlap(void)
+{
+	struct frag_stats stats = get_frag_stats();
+	struct net_pkt *dup;
+	int i;
+
+	send_fragmented();
+
+	dup = net_pkt_clone(sent[1], K_NO_WAIT);
+	zassert_not_null(dup, "Cannot clone fragment");
+
+	recv_fragment(0);
+	recv_fragment(1);
+
+	sent[1] = dup;
+	recv_fragment(1);
+
+	for (i = 2; i < TEST_FRAGMENTS; i++) {
+		recv_fragment(i);
+	}
+
+	zassert_not_equal(k_sem_take(&wait_data, WAIT_TIME), 0,
+			  "Overlapping datagram received");
+
+	zassert_equal(get_frag_stats().dropped, stats.dropped + 1,
+		      "Invalid dropped count");
+
+	/* Let the slot taken by the trailing fragments expire */
+	k_sleep(EXPIRE_TIME);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(net_ipv4_fragment_test,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_send_recv_ipv4_fragment),
+			 ztest_unit_test(test_recv_ipv4_fragment_timeout),
+			 ztest_unit_test(test_recv_ipv4_fragment_overlap)
+			 );
+
+	ztest_run_test_suite(net_ipv4_fragment_test);
+}
@@ -468,6 +468,53 @@ static void route_del_many(void)
 	}
 }
 
+static void route_lookup_longest_prefix(void)
+{
+	struct in6_addr prefix = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+				       0, 0, 0, 0, 0, 0, 0, 0 } } };
+	struct in6_addr outside = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 1, 0, 0,
+					0, 0, 0, 0, 0, 0, 0, 0x1 } } };
+	struct in6_addr inside = generic_addr;
+	struct net_route_entry *host, *subnet, *net;
+
+	inside.s6_addr[15] = 0x42;
+
+	/* Adding a route looks up its address first, so add the more
+	 * specific routes before the ones covering them.
+	 */
+	host = net_route_add(my_iface, &dest_addr, 128, &peer_addr);
+	zassert_not_null(host, "Route add failed");
+
+	subnet = net_route_add(my_iface, &generic_addr, 112, &peer_addr);
+	zassert_not_null(subnet, "Route add failed");
+
+	net = net_route_add(my_iface, &prefix, 64, &peer_addr);
+	zassert_not_null(net, "Route add failed");
+
+	zassert_equal_ptr(net_route_lookup(my_iface, &dest_addr), host,
+			  "Host route not found");
+	zassert_equal_ptr(net_route_lookup(NULL, &inside), subnet,
+			  "Subnet route not found");
+	zassert_equal_ptr(net_route_lookup(my_iface, &peer_addr), net,
+			  "Network route not found");
+	zassert_is_null(net_route_lookup(my_iface, &outside),
+			"Route found outside of prefix");
+	zassert_is_null(net_route_lookup(peer_iface, &dest_addr),
+			"Route found for other interface");
+
+	zassert_false(net_route_del(subnet), "Route del failed");
+	zassert_equal_ptr(net_route_lookup(my_iface, &inside), net,
+			  "Covering route not found");
+
+	zassert_false(net_route_del(host), "Route del failed");
+	zassert_equal_ptr(net_route_lookup(my_iface, &dest_addr), net,
+			  "Covering route not found");
+
+	zassert_false(net_route_del(net), "Route del failed");
+	zassert_is_null(net_route_lookup(my_iface, &dest_addr),
+			"Deleted route found");
+}
+
 /*test case main entry*/
 void test_main(void)
 {
@@ -487,6 +534,7 @@ void test_main(void)
 			ztest_unit_test(route_del_nexthop_again),
 			ztest_unit_test(populate_nbr_cache),
 			ztest_unit_test(route_add_many),
-			ztest_unit_test(route_del_many));
+			ztest_unit_test(route_del_many),
+			ztest_unit_test(route_lookup_longest_prefix));
 	ztest_run_test_suite(test_route);
 }
@@ -0,0 +1,261 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <stdio.h>
+#include <ztest_assert.h>
+
+#include <net/socket.h>
+#include <sys/fdtable.h>
+
+#include "../../socket_helpers.h"
+
+#define BUF_AND_SIZE(buf) buf, sizeof(buf) - 1
+#define STRLEN(buf) (sizeof(buf) - 1)
+
+#define TEST_STR_SMALL "test"
+
+#define SERVER_PORT 4242
+#define CLIENT_PORT 9898
+
+/* On QEMU, a wait takes +10ms from the requested time. */
+#define FUZZ 10
+
+static int c_sock;
+static int s_sock;
+static int ep;
+static struct sockaddr_in6 c_addr;
+static struct sockaddr_in6 s_addr;
+
+static void setup(void)
+{
+	int res;
+
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, CLIENT_PORT,
+			    &c_sock, &c_addr);
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, SERVER_PORT,
+			    &s_sock, &s_addr);
+
+	res = bind(s_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "bind failed");
+
+	res = connect(c_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "connect failed");
+
+	ep = epoll_create1(0);
+	zassert_true(ep >= 0, "epoll_create1 failed");
+}
+
+static void teardown(void)
+{
+	zassert_equal(close(ep), 0, "close failed");
+	zassert_equal(close(c_sock), 0, "close failed");
+	zassert_equal(close(s_sock), 0, "close failed");
+}
+
+static void watch(int sock, int op, u32_t events)
+{
+	struct epoll_event ev = {
+		.events = events,
+		.data.fd = sock,
+	};
+
+	zassert_equal(epoll_ctl(ep, op, sock, &ev), 0, "epoll_ctl failed");
+}
+
+static void send_small(void)
+{
+	ssize_t len = send(c_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0);
+
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid send len");
+}
+
+static void recv_small(void)
+{
+	char buf[10];
+	ssize_t len = recv(s_sock, BUF_AND_SIZE(buf), 0);
+
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid recv len");
+}
+
+void test_epoll_ctl(void)
+{
+	struct epoll_event ev = { .events = EPOLLIN };
+
+	setup();
+
+	watch(s_sock, EPOLL_CTL_ADD, EPOLLIN);
+
+	zassert_equal(epoll_ctl(ep, EPOLL_CTL_ADD, s_sock, &ev), -1, "");
+	zassert_equal(errno, EEXIST, "");
+
+	zassert_equal(epoll_ctl(ep, EPOLL_CTL_MOD, c_sock, &ev), -1, "");
+	zassert_equal(errno, ENOENT, "");
+
+	/* An epoll instance cannot watch itself */
+	zassert_equal(epoll_ctl(ep, EPOLL_CTL_ADD, ep, &ev), -1, "");
+	zassert_equal(errno, EPERM, "");
+
+	zassert_equal(epoll_ctl(s_sock, EPOLL_CTL_ADD, c_sock, &ev), -1, "");
+	zassert_equal(errno, EINVAL, "");
+
+	zassert_equal(epoll_ctl(ep, EPOLL_CTL_DEL, s_sock, NULL), 0, "");
+	zassert_equal(epoll_ctl(ep, EPOLL_CTL_DEL, s_sock, NULL), -1, "");
+	zassert_equal(errno, ENOENT, "");
+
+	zassert_equal(epoll_wait(ep, &ev, 0, 0), -1, "");
+	zassert_equal(errno, EINVAL, "");
+
+	teardown();
+}
+
+void test_epoll_level_triggered(void)
+{
+	struct epoll_event evs[2];
+	u32_t tstamp;
+	int res;
+
+	setup();
+
+	watch(c_sock, EPOLL_CTL_ADD, EPOLLIN);
+	watch(s_sock, EPOLL_CTL_ADD, EPOLLIN);
+
+	/* Wait on non-ready sockets with timeout of 0 */
+	tstamp = k_uptime_get_32();
+	res = epoll_wait(ep, evs, ARRAY_SIZE(evs), 0);
+	zassert_true(k_uptime_get_32() - tstamp <= FUZZ, "");
+	zassert_equal(res, 0, "");
+
+	/* Wait on non-ready sockets with timeout of 30 */
+	tstamp = k_uptime_get_32();
+	res = epoll_wait(ep, evs, ARRAY_SIZE(evs), 30);
+	tstamp = k_uptime_get_32() - tstamp;
+	zassert_true(tstamp >= 30U && tstamp <= 30 + FUZZ * 2, "tstamp %d",
+		     tstamp);
+	zassert_equal(res, 0, "");
+
+	/* The packet is delivered while waiting */
+	send_small();
+
+	tstamp = k_uptime_get_32();
+	res = epoll_wait(ep, evs, ARRAY_SIZE(evs), 30);
+	zassert_true(k_uptime_get_32() - tstamp <= FUZZ, "");
+	zassert_equal(res, 1, "");
+	zassert_equal(evs[0].events, EPOLLIN, "");
+	zassert_equal(evs[0].data.fd, s_sock, "");
+
+	/* Still ready until the data is read */
+	res = epoll_wait(ep, evs, ARRAY_SIZE(evs), 0);
+	zassert_equal(res, 1, "");
+	zassert_equal(evs[0].data.fd, s_sock, "");
+
+	recv_small();
+
+	res = epoll_wait(ep, evs, ARRAY_SIZE(evs), 0);
+	zassert_equal(res, 0, "");
+
+	/* Sockets are always writable */
+	watch(c_sock, EPOLL_CTL_MOD, EPOLLOUT);
+	res = epoll_wait(ep, evs, ARRAY_SIZE(evs), 0);
+	zassert_equal(res, 1, "");
+	zassert_equal(evs[0].events, EPOLLOUT, "");
+	zassert_equal(evs[0].data.fd, c_sock, "");
+
+	teardown();
+}
+
+void test_epoll_edge_triggered(void)
+{
+	struct epoll_event ev;
+	int res;
+
+	setup();
+
+	watch(s_sock, EPOLL_CTL_ADD, EPOLLIN | EPOLLET);
+
+	send_small();
+
+	res = epoll_wait(ep, &ev, 1, 30);
+	zassert_equal(res, 1, "");
+	zassert_equal(ev.data.fd, s_sock, "");
+
+	/* Reported once, although still readable */
+	res = epoll_wait(ep, &ev, 1, 0);
+	zassert_equal(res, 0, "");
+
+	/* A new packet is a new edge */
+	send_small();
+	res = epoll_wait(ep, &ev, 1, 30);
+	zassert_equal(res, 1, "");
+
+	recv_small();
+	recv_small();
+
+	/* One-shot items are disabled until re-armed */
+	watch(s_sock, EPOLL_CTL_MOD, EPOLLIN | EPOLLONESHOT);
+	send_small();
+	res = epoll_wait(ep, &ev, 1, 30);
+	zassert_equal(res, 1, "");
+
+	send_small();
+	res = epoll_wait(ep, &ev, 1, 30);
+	zassert_equal(res, 0, "");
+
+	/* Re-arming finds the data that is already there */
+	watch(s_sock, EPOLL_CTL_MOD, EPOLLIN | EPOLLONESHOT);
+	res = epoll_wait(ep, &ev, 1, 0);
+	zassert_equal(res, 1, "");
+
+	recv_small();
+	recv_small();
+
+	teardown();
+}
+
+void test_epoll_close(void)
+{
+	struct epoll_event ev;
+	int res;
+
+	setup();
+
+	watch(s_sock, EPOLL_CTL_ADD, EPOLLIN);
+	send_small();
+
+	res = epoll_wait(ep, &ev, 1, 30);
+	zassert_equal(res, 1, "");
+
+	/* Closing a socket removes it from the instance */
+	res = close(s_sock);
+	zassert_equal(res, 0, "close failed");
+
+	res = epoll_wait(ep, &ev, 1, 0);
+	zassert_equal(res, 0, "");
+
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, SERVER_PORT,
+			    &s_sock, &s_addr);
+
+	teardown();
+
+	/* Closing the instance releases it and all its items */
+	for (int i = 0; i < CONFIG_NET_SOCKETS_EPOLL_MAX_ITEMS + 1; i++) {
+		setup();
+		watch(c_sock, EPOLL_CTL_ADD, EPOLLIN);
+		watch(s_sock, EPOLL_CTL_ADD, EPOLLIN);
+		teardown();
+	}
+}
+
+void test_main(void)
+{
+	ztest_test_suite(socket_epoll,
+			 ztest_unit_test(test_epoll_ctl),
+			 ztest_unit_test(test_epoll_level_triggered),
+			 ztest_unit_test(test_epoll_edge_triggered),
+			 ztest_unit_test(test_epoll_close));
+
+	ztest_run_test_suite(socket_epoll);
+}
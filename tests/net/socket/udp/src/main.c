@@ -655,6 +655,175 @@ void test_v6_sendmsg_recvfrom_connected(void)
 	zassert_equal(rv, 0, "close failed");
 }
 
+static void prepare_pair_udp_v6(int *client_sock, int *server_sock,
+				struct sockaddr_in6 *server_addr)
+{
+	struct sockaddr_in6 client_addr;
+	int rv;
+
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, ANY_PORT,
+			    client_sock, &client_addr);
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, SERVER_PORT,
+			    server_sock, server_addr);
+
+	rv = bind(*server_sock, (struct sockaddr *)server_addr,
+		  sizeof(*server_addr));
+	zassert_equal(rv, 0, "server bind failed");
+}
+
+void test_v6_recvmsg(void)
+{
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in6 server_addr;
+	struct sockaddr_in6 addr;
+	static ZTEST_BMEM char buf[STRLEN(TEST_STR2)];
+	struct iovec iov[3] = {
+		{ .iov_base = buf, .iov_len = 10 },
+		{ .iov_base = buf + 10, .iov_len = 20 },
+		{ .iov_base = buf + 30, .iov_len = sizeof(buf) - 30 },
+	};
+	struct msghdr msg = {
+		.msg_name = &addr,
+		.msg_iov = iov,
+		.msg_iovlen = ARRAY_SIZE(iov),
+	};
+	ssize_t sent, recved;
+
+	prepare_pair_udp_v6(&client_sock, &server_sock, &server_addr);
+
+	sent = sendto(client_sock, BUF_AND_SIZE(TEST_STR2), 0,
+		      (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(sent, STRLEN(TEST_STR2), "sendto failed");
+
+	/* The datagram is scattered over the buffers */
+	msg.msg_namelen = sizeof(addr);
+	recved = recvmsg(server_sock, &msg, 0);
+	zassert_equal(recved, STRLEN(TEST_STR2), "recvmsg failed");
+	zassert_equal(msg.msg_namelen, sizeof(addr), "unexpected addrlen");
+	zassert_equal(msg.msg_flags, 0, "unexpected flags");
+	zassert_mem_equal(buf, TEST_STR2, STRLEN(TEST_STR2), "wrong data");
+
+	/* The rest of a datagram that does not fit is discarded */
+	sent = sendto(client_sock, BUF_AND_SIZE(TEST_STR2), 0,
+		      (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(sent, STRLEN(TEST_STR2), "sendto failed");
+
+	msg.msg_iovlen = 2;
+	recved = recvmsg(server_sock, &msg, 0);
+	zassert_equal(recved, 30, "recvmsg failed");
+	zassert_equal(msg.msg_flags, MSG_TRUNC, "datagram not truncated");
+
+	recved = recvmsg(server_sock, &msg, MSG_DONTWAIT);
+	zassert_equal(recved, -1, "unexpected datagram");
+	zassert_equal(errno, EAGAIN, "unexpected errno");
+
+	zassert_equal(close(client_sock), 0, "close failed");
+	zassert_equal(close(server_sock), 0, "close failed");
+}
+
+#define MMSG_COUNT 3
+
+void test_v6_sendmmsg_recvmmsg(void)
+{
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in6 server_addr;
+	struct mmsghdr msgs[MMSG_COUNT + 1];
+	struct iovec iov[MMSG_COUNT + 1];
+	char buf[MMSG_COUNT + 1][16];
+	int ret;
+
+	prepare_pair_udp_v6(&client_sock, &server_sock, &server_addr);
+
+	memset(msgs, 0, sizeof(msgs));
+
+	for (int i = 0; i < MMSG_COUNT; i++) {
+		snprintk(buf[i], sizeof(buf[i]), "message %d", i);
+		iov[i].iov_base = buf[i];
+		iov[i].iov_len = strlen(buf[i]);
+		msgs[i].msg_hdr.msg_name = &server_addr;
+		msgs[i].msg_hdr.msg_namelen = sizeof(server_addr);
+		msgs[i].msg_hdr.msg_iov = &iov[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	ret = sendmmsg(client_sock, msgs, MMSG_COUNT, 0);
+	zassert_equal(ret, MMSG_COUNT, "sendmmsg failed");
+
+	for (int i = 0; i < MMSG_COUNT; i++) {
+		zassert_equal(msgs[i].msg_len, iov[i].iov_len,
+			      "unexpected sent length");
+	}
+
+	memset(msgs, 0, sizeof(msgs));
+	memset(buf, 0, sizeof(buf));
+
+	for (int i = 0; i < MMSG_COUNT + 1; i++) {
+		iov[i].iov_base = buf[i];
+		iov[i].iov_len = sizeof(buf[i]);
+		msgs[i].msg_hdr.msg_iov = &iov[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	/* Only the queued datagrams are returned, without waiting */
+	ret = recvmmsg(server_sock, msgs, MMSG_COUNT + 1, 0);
+	zassert_equal(ret, MMSG_COUNT, "recvmmsg failed");
+
+	for (int i = 0; i < MMSG_COUNT; i++) {
+		char expected[16];
+
+		snprintk(expected, sizeof(expected), "message %d", i);
+		zassert_equal(msgs[i].msg_len, strlen(expected),
+			      "unexpected received length");
+		zassert_mem_equal(buf[i], expected, strlen(expected),
+				  "wrong data");
+	}
+
+	ret = recvmmsg(server_sock, msgs, MMSG_COUNT, MSG_DONTWAIT);
+	zassert_equal(ret, -1, "unexpected datagram");
+	zassert_equal(errno, EAGAIN, "unexpected errno");
+
+	zassert_equal(close(client_sock), 0, "close failed");
+	zassert_equal(close(server_sock), 0, "close failed");
+}
+
+void test_v6_recv_zerocopy(void)
+{
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in6 server_addr;
+	struct sockaddr_in6 addr;
+	socklen_t addrlen = sizeof(addr);
+	struct net_buf *frags, *frag;
+	size_t offset = 0;
+	ssize_t sent, recved;
+
+	prepare_pair_udp_v6(&client_sock, &server_sock, &server_addr);
+
+	sent = sendto(client_sock, BUF_AND_SIZE(TEST_STR2), 0,
+		      (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(sent, STRLEN(TEST_STR2), "sendto failed");
+
+	recved = zsock_recv_zerocopy(server_sock, &frags, 0,
+				     (struct sockaddr *)&addr, &addrlen);
+	zassert_equal(recved, STRLEN(TEST_STR2), "recv failed");
+	zassert_equal(addrlen, sizeof(addr), "unexpected addrlen");
+	zassert_equal(net_buf_frags_len(frags), recved, "wrong length");
+
+	/* The payload spans several buffers, without the headers */
+	for (frag = frags; frag; frag = frag->frags) {
+		zassert_mem_equal(frag->data, TEST_STR2 + offset, frag->len,
+				  "wrong data");
+		offset += frag->len;
+	}
+
+	net_buf_unref(frags);
+
+	zassert_equal(close(client_sock), 0, "close failed");
+	zassert_equal(close(server_sock), 0, "close failed");
+}
+
 void test_so_txtime(void)
 {
 	struct sockaddr_in bind_addr4;
@@ -922,6 +1091,11 @@ void test_main(void)
 			 ztest_unit_test(test_v6_sendmsg_recvfrom),
 			 ztest_unit_test(test_v4_sendmsg_recvfrom_connected),
 			 ztest_unit_test(test_v6_sendmsg_recvfrom_connected),
+			 ztest_unit_test(test_v6_recvmsg),
+			 ztest_user_unit_test(test_v6_recvmsg),
+			 ztest_unit_test(test_v6_sendmmsg_recvmmsg),
+			 ztest_user_unit_test(test_v6_sendmmsg_recvmmsg),
+			 ztest_unit_test(test_v6_recv_zerocopy),
 			 ztest_unit_test(setup_eth),
 			 ztest_unit_test(test_v6_sendmsg_with_txtime),
 			 ztest_user_unit_test(test_v6_sendmsg_with_txtime)
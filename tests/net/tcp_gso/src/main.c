@@ -0,0 +1,315 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define NET_LOG_LEVEL CONFIG_NET_TCP_LOG_LEVEL
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, NET_LOG_LEVEL);
+
+#include <zephyr/types.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/byteorder.h>
+
+#include <ztest.h>
+
+#include <net/ethernet.h>
+#include <net/net_ip.h>
+#include <net/net_if.h>
+#include <net/net_pkt.h>
+
+#include "ipv4.h"
+#include "tcp_internal.h"
+
+#define MSS 536
+#define DATA_LEN (3 * MSS + 100)
+#define SEGMENTS ceiling_fraction(DATA_LEN, MSS)
+#define HDR_LEN (sizeof(struct net_ipv4_hdr) + sizeof(struct net_tcp_hdr))
+
+/* Wraps around during the packet */
+#define SEQ 0xfffffd00U
+#define IP_ID 0x1234U
+
+static struct in_addr src_addr = { { { 192, 0, 2, 1 } } };
+static struct in_addr dst_addr = { { { 192, 0, 2, 2 } } };
+
+static u8_t data[DATA_LEN];
+static u8_t frame[NET_ETH_MTU];
+static int segments;
+static bool capture;
+
+struct eth_context {
+	u8_t mac_addr[6];
+};
+
+static struct eth_context eth_context;
+
+/* One's complement sum of the buffer, not complemented */
+static u16_t chksum(u16_t sum, const u8_t *buf, size_t len)
+{
+	u32_t acc = sum;
+	size_t i;
+
+	for (i = 0; i + 1 < len; i += 2) {
+		acc += (buf[i] << 8) | buf[i + 1];
+	}
+
+	if (len & 1) {
+		acc += buf[len - 1] << 8;
+	}
+
+	while (acc >> 16) {
+		acc = (acc & 0xffff) + (acc >> 16);
+	}
+
+	return acc;
+}
+
+static void check_segment(const u8_t *seg, size_t len, int i)
+{
+	const struct net_ipv4_hdr *ip_hdr = (const struct net_ipv4_hdr *)seg;
+	const struct net_tcp_hdr *tcp_hdr =
+		(const struct net_tcp_hdr *)(seg + sizeof(*ip_hdr));
+	size_t seg_len = MIN(MSS, DATA_LEN - i * MSS);
+	bool last = (i == SEGMENTS - 1);
+	u8_t pseudo[12];
+	u16_t sum;
+
+	zassert_true(i < SEGMENTS, "Too many segments");
+	zassert_equal(len, HDR_LEN + seg_len, "Segment %d length %zu", i, len);
+
+	zassert_equal(ntohs(ip_hdr->len), len, "Segment %d IP length", i);
+	zassert_equal(sys_get_be16(ip_hdr->id), IP_ID, "Segment %d IP id", i);
+	zassert_equal(chksum(0, seg, sizeof(*ip_hdr)), 0xffff,
+		      "Segment %d IPv4 checksum", i);
+
+	zassert_equal(sys_get_be32(tcp_hdr->seq), SEQ + i * MSS,
+		      "Segment %d sequence number", i);
+	zassert_equal(sys_get_be32(tcp_hdr->ack), 1, "Segment %d ack", i);
+	zassert_equal(tcp_hdr->flags,
+		      last ? (NET_TCP_PSH | NET_TCP_ACK | NET_TCP_FIN) :
+			     NET_TCP_ACK,
+		      "Segment %d flags 0x%02x", i, tcp_hdr->flags);
+
+	memcpy(&pseudo[0], &ip_hdr->src, sizeof(struct in_addr));
+	memcpy(&pseudo[4], &ip_hdr->dst, sizeof(struct in_addr));
+	pseudo[8] = 0U;
+	pseudo[9] = IPPROTO_TCP;
+	sys_put_be16(len - sizeof(*ip_hdr), &pseudo[10]);
+
+	sum = chksum(0, pseudo, sizeof(pseudo));
+	sum = chksum(sum, (const u8_t *)tcp_hdr, len - sizeof(*ip_hdr));
+	zassert_equal(sum, 0xffff, "Segment %d TCP checksum", i);
+
+	zassert_mem_equal(seg + HDR_LEN, data + i * MSS, seg_len,
+			  "Segment %d payload", i);
+}
+
+/* Checks the segment which follows a link layer header of ll_len bytes */
+static void check_pkt(struct net_pkt *pkt, size_t ll_len)
+{
+	size_t len = net_pkt_get_len(pkt) - ll_len;
+	bool ow = net_pkt_is_being_overwritten(pkt);
+
+	zassert_true(len <= sizeof(frame), "Segment larger than the MTU");
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+	zassert_equal(net_pkt_skip(pkt, ll_len), 0, "Cannot skip header");
+	zassert_equal(net_pkt_read(pkt, frame, len), 0, "Cannot read");
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, ow);
+
+	check_segment(frame, len, segments++);
+}
+
+static void eth_iface_init(struct net_if *iface)
+{
+	struct device *dev = net_if_get_device(iface);
+	struct eth_context *context = dev->driver_data;
+
+	net_if_set_link_addr(iface, context->mac_addr,
+			     sizeof(context->mac_addr),
+			     NET_LINK_ETHERNET);
+
+	ethernet_init(iface);
+}
+
+static int eth_tx(struct device *dev, struct net_pkt *pkt)
+{
+	if (capture) {
+		zassert_equal(ntohs(NET_ETH_HDR(pkt)->type), NET_ETH_PTYPE_IP,
+			      "Not an IPv4 frame");
+		check_pkt(pkt, sizeof(struct net_eth_hdr));
+	}
+
+	return 0;
+}
+
+/* No TCP segmentation offload, the L2 splits the packets */
+static enum ethernet_hw_caps eth_capabilities(struct device *dev)
+{
+	return 0;
+}
+
+static struct ethernet_api api_funcs = {
+	.iface_api.init = eth_iface_init,
+
+	.get_capabilities = eth_capabilities,
+	.send = eth_tx,
+};
+
+static int eth_init(struct device *dev)
+{
+	struct eth_context *context = dev->driver_data;
+
+	/* 00-00-5E-00-53-xx Documentation RFC 7042 */
+	context->mac_addr[0] = 0x00;
+	context->mac_addr[1] = 0x00;
+	context->mac_addr[2] = 0x5E;
+	context->mac_addr[3] = 0x00;
+	context->mac_addr[4] = 0x53;
+	context->mac_addr[5] = 0x01;
+
+	return 0;
+}
+
+ETH_NET_DEVICE_INIT(eth_gso_test, "eth_gso_test", eth_init, &eth_context,
+		    NULL, CONFIG_ETH_INIT_PRIORITY, &api_funcs, NET_ETH_MTU);
+
+static struct net_if *test_iface(void)
+{
+	struct net_if *iface = net_if_lookup_by_dev(DEVICE_GET(eth_gso_test));
+
+	zassert_not_null(iface, "No test interface");
+
+	return iface;
+}
+
+/* A finalized packet of DATA_LEN bytes of payload, larger than the MTU */
+static struct net_pkt *build_pkt(void)
+{
+	struct net_tcp_hdr tcp_hdr = { 0 };
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_alloc_with_buffer(test_iface(), DATA_LEN, AF_INET,
+					IPPROTO_TCP, K_NO_WAIT);
+	zassert_not_null(pkt, "Cannot allocate packet");
+
+	zassert_equal(net_ipv4_create(pkt, &src_addr, &dst_addr), 0,
+		      "Cannot create IPv4 header");
+	sys_put_be16(IP_ID, NET_IPV4_HDR(pkt)->id);
+
+	tcp_hdr.src_port = htons(4242);
+	tcp_hdr.dst_port = htons(4243);
+	sys_put_be32(SEQ, tcp_hdr.seq);
+	sys_put_be32(1, tcp_hdr.ack);
+	tcp_hdr.offset = (sizeof(tcp_hdr) / 4) << 4;
+	tcp_hdr.flags = NET_TCP_PSH | NET_TCP_ACK | NET_TCP_FIN;
+	sys_put_be16(1024, tcp_hdr.wnd);
+
+	zassert_equal(net_pkt_write(pkt, &tcp_hdr, sizeof(tcp_hdr)), 0,
+		      "Cannot write TCP header");
+	zassert_equal(net_pkt_write(pkt, data, sizeof(data)), 0,
+		      "Cannot write payload");
+
+	net_pkt_set_gso_size(pkt, MSS);
+
+	net_pkt_cursor_init(pkt);
+	zassert_equal(net_ipv4_finalize(pkt, IPPROTO_TCP), 0,
+		      "Cannot finalize packet");
+
+	zassert_equal(net_pkt_get_len(pkt), HDR_LEN + DATA_LEN,
+		      "Unexpected packet length");
+
+	return pkt;
+}
+
+static void test_setup(void)
+{
+	for (int i = 0; i < sizeof(data); i++) {
+		data[i] = i * 7;
+	}
+
+	zassert_true(net_if_is_gso_capable(test_iface()),
+		     "Ethernet interface cannot take GSO packets");
+}
+
+static int segment_cb(struct net_pkt *seg, void *user_data)
+{
+	check_pkt(seg, 0);
+	net_pkt_unref(seg);
+
+	return 0;
+}
+
+static void test_gso_segment(void)
+{
+	struct net_pkt *pkt = build_pkt();
+
+	segments = 0;
+
+	zassert_equal(net_tcp_gso_segment(pkt, segment_cb, NULL), 0,
+		      "Segmentation failed");
+	zassert_equal(segments, SEGMENTS, "%d segments", segments);
+
+	/* The packet itself is left as it was */
+	zassert_equal(net_pkt_get_len(pkt), HDR_LEN + DATA_LEN,
+		      "Packet modified");
+
+	net_pkt_unref(pkt);
+}
+
+/* Fails on the second segment, which is then freed by the caller */
+static int failing_cb(struct net_pkt *seg, void *user_data)
+{
+	if (segments++ == 1) {
+		return -EIO;
+	}
+
+	net_pkt_unref(seg);
+
+	return 0;
+}
+
+static void test_gso_segment_fail(void)
+{
+	struct net_pkt *pkt = build_pkt();
+
+	segments = 0;
+
+	zassert_equal(net_tcp_gso_segment(pkt, failing_cb, NULL), -EIO,
+		      "Callback error not returned");
+	zassert_equal(segments, 2, "Segmentation not stopped");
+
+	net_pkt_unref(pkt);
+}
+
+static void test_ethernet_send_gso(void)
+{
+	struct net_pkt *pkt = build_pkt();
+
+	segments = 0;
+	capture = true;
+
+	zassert_equal(net_if_send_data(test_iface(), pkt), NET_OK,
+		      "Send failed");
+
+	capture = false;
+
+	zassert_equal(segments, SEGMENTS, "%d segments sent", segments);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(net_tcp_gso_test,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_gso_segment),
+			 ztest_unit_test(test_gso_segment_fail),
+			 ztest_unit_test(test_ethernet_send_gso));
+
+	ztest_run_test_suite(net_tcp_gso_test);
+}
@@ -0,0 +1,322 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+#include <stdlib.h>
+
+#include <net/net_if.h>
+#include <net/net_pkt.h>
+#include <net/dummy.h>
+
+#define QDISC_LEN CONFIG_NET_TX_QDISC_LEN
+#define WAIT_TIME K_MSEC(500)
+#define ROUNDS 3
+
+#if defined(CONFIG_NET_TX_QDISC_WFQ)
+/* Each packet uses up one quantum, so the classes send packets in
+ * proportion to their weights.
+ */
+#define PKT_LEN CONFIG_NET_TX_QDISC_QUANTUM
+#else
+#define PKT_LEN 64
+#endif
+
+struct test_hdr {
+	u8_t tc;
+	u16_t seq;
+};
+
+static K_SEM_DEFINE(sent_sem, 0, UINT_MAX);
+static struct test_hdr sent_log[ROUNDS * QDISC_LEN];
+static int sent_count;
+
+static u8_t mac_addr[] = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x01 };
+
+static void tx_iface_init(struct net_if *iface)
+{
+	net_if_set_link_addr(iface, mac_addr, sizeof(mac_addr),
+			     NET_LINK_ETHERNET);
+}
+
+static int tx_dev_init(struct device *dev)
+{
+	return 0;
+}
+
+static int tx_send(struct device *dev, struct net_pkt *pkt)
+{
+	struct test_hdr hdr;
+
+	/* Not one of ours */
+	if (net_pkt_get_len(pkt) != PKT_LEN) {
+		return 0;
+	}
+
+	net_pkt_cursor_init(pkt);
+	zassert_equal(net_pkt_read(pkt, &hdr, sizeof(hdr)), 0,
+		      "cannot read packet");
+	zassert_true(sent_count < ARRAY_SIZE(sent_log), "too many packets");
+
+	sent_log[sent_count++] = hdr;
+	k_sem_give(&sent_sem);
+
+	return 0;
+}
+
+static struct dummy_api tx_if_api = {
+	.iface_api.init = tx_iface_init,
+	.send = tx_send,
+};
+
+NET_DEVICE_INIT(net_tx_qdisc_test, "net_tx_qdisc_test", tx_dev_init,
+		NULL, NULL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &tx_if_api,
+		DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), 1280);
+
+static struct net_if_qdisc *qdisc(void)
+{
+	return &net_if_get_default()->qdisc;
+}
+
+static enum net_priority tc2priority(int tc)
+{
+	enum net_priority prio;
+
+	for (prio = NET_PRIORITY_BK; prio <= NET_PRIORITY_NC; prio++) {
+		if (net_tx_priority2tc(prio) == tc) {
+			break;
+		}
+	}
+
+	zassert_true(prio <= NET_PRIORITY_NC, "no priority for TC %d", tc);
+
+	return prio;
+}
+
+static void send_pkt(int tc, u16_t seq)
+{
+	struct test_hdr hdr = { .tc = tc, .seq = seq };
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_alloc_with_buffer(net_if_get_default(), PKT_LEN,
+					AF_UNSPEC, 0, K_NO_WAIT);
+	zassert_not_null(pkt, "cannot allocate packet");
+
+	zassert_equal(net_pkt_write(pkt, &hdr, sizeof(hdr)), 0,
+		      "cannot write packet");
+	zassert_equal(net_pkt_memset(pkt, 0, PKT_LEN - sizeof(hdr)), 0,
+		      "cannot write packet");
+
+	net_pkt_set_priority(pkt, tc2priority(tc));
+	net_if_queue_tx(net_if_get_default(), pkt);
+}
+
+static void reset_log(void)
+{
+	sent_count = 0;
+	k_sem_reset(&sent_sem);
+}
+
+static void wait_sent(int count)
+{
+	int i;
+
+	for (i = 0; i < count; i++) {
+		zassert_equal(k_sem_take(&sent_sem, WAIT_TIME), 0,
+			      "%d of %d packets sent", i, count);
+	}
+}
+
+/* Run below the TX threads and keep them from running, so that packets
+ * are queued instead of passed to the driver directly, and stay queued
+ * until unlock_tx().
+ */
+static void lock_tx(void)
+{
+	k_thread_priority_set(k_current_get(), K_PRIO_PREEMPT(1));
+	k_sched_lock();
+}
+
+static void unlock_tx(void)
+{
+	k_sched_unlock();
+}
+
+void test_qdisc_bypass(void)
+{
+	struct net_if_qdisc *q = qdisc();
+	u32_t bypassed = atomic_get(&q->bypassed);
+	u32_t queued = atomic_get(&q->classes[0].queued);
+
+	reset_log();
+
+	/* The queues are empty and the TX threads cannot preempt us */
+	k_thread_priority_set(k_current_get(), K_PRIO_COOP(0));
+	send_pkt(0, 0);
+
+	zassert_equal(sent_count, 1, "packet not sent directly");
+	zassert_equal(atomic_get(&q->bypassed), bypassed + 1,
+		      "bypass not counted");
+	zassert_equal(atomic_get(&q->classes[0].queued), queued,
+		      "packet queued");
+}
+
+void test_qdisc_wrap(void)
+{
+	struct net_if_qdisc *q = qdisc();
+	u32_t bypassed = atomic_get(&q->bypassed);
+	u32_t queued = atomic_get(&q->classes[0].queued);
+	u32_t dropped = atomic_get(&q->classes[0].dropped);
+	int round, i;
+
+	reset_log();
+
+	/* Fill the ring several times, with the tickets wrapping around */
+	for (round = 0; round < ROUNDS; round++) {
+		lock_tx();
+
+		for (i = 0; i < QDISC_LEN; i++) {
+			send_pkt(0, round * QDISC_LEN + i);
+		}
+
+		zassert_equal(sent_count, round * QDISC_LEN,
+			      "packets sent while locked");
+		unlock_tx();
+
+		wait_sent(QDISC_LEN);
+	}
+
+	for (i = 0; i < ROUNDS * QDISC_LEN; i++) {
+		zassert_equal(sent_log[i].seq, i, "packet %d sent as %d", i,
+			      sent_log[i].seq);
+	}
+
+	zassert_equal(atomic_get(&q->classes[0].queued),
+		      queued + ROUNDS * QDISC_LEN, "wrong queued count");
+	zassert_equal(atomic_get(&q->classes[0].dropped), dropped,
+		      "packets dropped");
+	zassert_equal(atomic_get(&q->bypassed), bypassed, "packets bypassed");
+}
+
+void test_qdisc_full(void)
+{
+	struct net_if_qdisc *q = qdisc();
+	u32_t queued = atomic_get(&q->classes[0].queued);
+	u32_t dropped = atomic_get(&q->classes[0].dropped);
+	int i;
+
+	reset_log();
+
+	lock_tx();
+
+	for (i = 0; i < QDISC_LEN + 2; i++) {
+		send_pkt(0, i);
+	}
+
+	zassert_equal(atomic_get(&q->classes[0].queued), queued + QDISC_LEN,
+		      "wrong queued count");
+	zassert_equal(atomic_get(&q->classes[0].dropped), dropped + 2,
+		      "wrong dropped count");
+
+	unlock_tx();
+
+	wait_sent(QDISC_LEN);
+	zassert_equal(k_sem_take(&sent_sem, K_MSEC(100)), -EAGAIN,
+		      "dropped packet sent");
+
+	for (i = 0; i < QDISC_LEN; i++) {
+		zassert_equal(sent_log[i].seq, i, "packet %d sent as %d", i,
+			      sent_log[i].seq);
+	}
+}
+
+#if defined(CONFIG_NET_TX_QDISC_STRICT)
+void test_qdisc_strict(void)
+{
+	int i;
+
+	reset_log();
+
+	lock_tx();
+
+	for (i = 0; i < QDISC_LEN; i++) {
+		send_pkt(0, i);
+		send_pkt(1, i);
+	}
+
+	unlock_tx();
+
+	wait_sent(2 * QDISC_LEN);
+
+	/* Every packet of the higher class goes first */
+	for (i = 0; i < 2 * QDISC_LEN; i++) {
+		zassert_equal(sent_log[i].tc, i < QDISC_LEN ? 1 : 0,
+			      "packet %d sent from TC %d", i, sent_log[i].tc);
+		zassert_equal(sent_log[i].seq, i % QDISC_LEN,
+			      "packet %d sent as %d", i, sent_log[i].seq);
+	}
+}
+#else
+void test_qdisc_strict(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_NET_TX_QDISC_STRICT */
+
+#if defined(CONFIG_NET_TX_QDISC_WFQ)
+void test_qdisc_drr(void)
+{
+	int count[2] = { 0 };
+	int i;
+
+	reset_log();
+
+	lock_tx();
+
+	for (i = 0; i < QDISC_LEN; i++) {
+		send_pkt(0, i);
+		send_pkt(1, i);
+	}
+
+	unlock_tx();
+
+	wait_sent(2 * QDISC_LEN);
+
+	for (i = 0; i < 2 * QDISC_LEN; i++) {
+		int tc = sent_log[i].tc;
+
+		zassert_equal(sent_log[i].seq, count[tc],
+			      "TC %d sent packet %d as %d", tc, count[tc],
+			      sent_log[i].seq);
+		count[tc]++;
+
+		/* While both classes are backlogged, TC 1 sends two packets
+		 * for each one of TC 0, give or take the deficit left over
+		 * from the previous test.
+		 */
+		if (count[0] < QDISC_LEN && count[1] < QDISC_LEN) {
+			zassert_true(abs(count[1] - 2 * count[0]) <= 2,
+				     "TC 1 sent %d and TC 0 %d packets",
+				     count[1], count[0]);
+		}
+	}
+}
+#else
+void test_qdisc_drr(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_NET_TX_QDISC_WFQ */
+
+void test_main(void)
+{
+	ztest_test_suite(net_tx_qdisc_test,
+			 ztest_unit_test(test_qdisc_bypass),
+			 ztest_unit_test(test_qdisc_wrap),
+			 ztest_unit_test(test_qdisc_full),
+			 ztest_unit_test(test_qdisc_strict),
+			 ztest_unit_test(test_qdisc_drr));
+
+	ztest_run_test_suite(net_tx_qdisc_test);
+}
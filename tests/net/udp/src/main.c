@@ -226,6 +226,60 @@ u8_t ipv6_hop_by_hop_ext_hdr[] = {
 
 #define TIMEOUT 200
 
+#if defined(CONFIG_NET_RX_BATCH)
+/* Packets waiting to be polled, standing in for the receive ring of
+ * the device
+ */
+static struct net_rx_poll rx_poll;
+static struct k_spinlock rx_lock;
+static sys_slist_t rx_pending;
+static int rx_polls;
+
+static int rx_poll_cb(struct net_rx_poll *poll, sys_slist_t *pkts,
+		      int budget)
+{
+	k_spinlock_key_t key = k_spin_lock(&rx_lock);
+	struct net_pkt *pkt;
+	int count = 0;
+
+	rx_polls++;
+
+	while (count < budget && (pkt = net_pkt_rx_batch_get(&rx_pending))) {
+		net_pkt_rx_batch_add(pkts, pkt);
+		count++;
+	}
+
+	k_spin_unlock(&rx_lock, key);
+
+	return count;
+}
+
+static void rx_pending_add(struct net_pkt *pkt)
+{
+	k_spinlock_key_t key = k_spin_lock(&rx_lock);
+
+	net_pkt_rx_batch_add(&rx_pending, pkt);
+	k_spin_unlock(&rx_lock, key);
+}
+#endif
+
+/* With CONFIG_NET_RX_BATCH, packets go through the polled receive path
+ * and net_recv_data_batch() the way a batching driver passes them
+ */
+static int recv_data(struct net_if *iface, struct net_pkt *pkt)
+{
+#if defined(CONFIG_NET_RX_BATCH)
+	ARG_UNUSED(iface);
+
+	rx_pending_add(pkt);
+	net_rx_poll_schedule(&rx_poll);
+
+	return 0;
+#else
+	return net_recv_data(iface, pkt);
+#endif
+}
+
 static bool send_ipv6_udp_msg(struct net_if *iface,
 			      struct in6_addr *src,
 			      struct in6_addr *dst,
@@ -250,7 +304,7 @@ static bool send_ipv6_udp_msg(struct net_if *iface,
 	net_pkt_cursor_init(pkt);
 	net_ipv6_finalize(pkt, IPPROTO_UDP);
 
-	ret = net_recv_data(iface, pkt);
+	ret = recv_data(iface, pkt);
 	if (ret < 0) {
 		printk("Cannot recv pkt %p, ret %d\n", pkt, ret);
 		zassert_true(0, "exiting");
@@ -319,7 +373,7 @@ static bool send_ipv6_udp_long_msg(struct net_if *iface,
 	net_pkt_cursor_init(pkt);
 	net_ipv6_finalize(pkt, IPPROTO_UDP);
 
-	ret = net_recv_data(iface, pkt);
+	ret = recv_data(iface, pkt);
 	if (ret < 0) {
 		printk("Cannot recv pkt %p, ret %d\n", pkt, ret);
 		zassert_true(0, "exiting");
@@ -367,7 +421,7 @@ static bool send_ipv4_udp_msg(struct net_if *iface,
 	net_pkt_cursor_init(pkt);
 	net_ipv4_finalize(pkt, IPPROTO_UDP);
 
-	ret = net_recv_data(iface, pkt);
+	ret = recv_data(iface, pkt);
 	if (ret < 0) {
 		printk("Cannot recv pkt %p, ret %d\n", pkt, ret);
 		zassert_true(0, "exiting");
@@ -470,6 +524,10 @@ void test_udp(void)
 
 	k_sem_init(&recv_lock, 0, UINT_MAX);
 
+#if defined(CONFIG_NET_RX_BATCH)
+	net_rx_poll_init(&rx_poll, rx_poll_cb);
+#endif
+
 	ifaddr = net_if_ipv6_addr_add(iface, &in6addr_my, NET_ADDR_MANUAL, 0);
 	if (!ifaddr) {
 		printk("Cannot add %s to interface %p\n",
@@ -661,9 +719,106 @@ void test_udp(void)
 	zassert_false(test_failed, "udp tests failed");
 }
 
+#if defined(CONFIG_NET_RX_BATCH)
+#define RX_BATCH_PKTS 8
+#define RX_BATCH_PORT 4343
+#define RX_BATCH_SRC_PORT 2000
+
+static int rx_batch_next;
+static bool rx_batch_ordered;
+
+static enum net_verdict rx_batch_ok(struct net_conn *conn,
+				    struct net_pkt *pkt,
+				    union net_ip_header *ip_hdr,
+				    union net_proto_header *proto_hdr,
+				    void *user_data)
+{
+	if (ntohs(proto_hdr->udp->src_port) !=
+	    RX_BATCH_SRC_PORT + rx_batch_next) {
+		rx_batch_ordered = false;
+	}
+
+	rx_batch_next++;
+	net_pkt_unref(pkt);
+	k_sem_give(&recv_lock);
+
+	return NET_OK;
+}
+
+/* More packets than one poll may take are pending at once, so the stack
+ * has to poll again after each full batch, and must deliver them all
+ * in order.
+ */
+void test_udp_rx_batch(void)
+{
+	struct in6_addr in6addr_my = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+					   0, 0, 0, 0, 0, 0, 0, 0x1 } } };
+	struct in6_addr in6addr_peer = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+					  0, 0, 0, 0x4e, 0x11, 0, 0, 0x2 } } };
+	struct net_if *iface = net_if_get_default();
+	struct net_conn_handle *handle;
+	struct net_pkt *pkt;
+	int ret, i;
+
+	k_sem_init(&recv_lock, 0, UINT_MAX);
+	net_rx_poll_init(&rx_poll, rx_poll_cb);
+
+	zassert_not_null(net_if_ipv6_addr_add(iface, &in6addr_my,
+					      NET_ADDR_MANUAL, 0),
+			 "Cannot add address");
+
+	ret = net_udp_register(AF_INET6, NULL, NULL, 0, RX_BATCH_PORT,
+			       rx_batch_ok, NULL, &handle);
+	zassert_equal(ret, 0, "UDP register failed (%d)", ret);
+
+	rx_batch_next = 0;
+	rx_batch_ordered = true;
+	rx_polls = 0;
+
+	for (i = 0; i < RX_BATCH_PKTS; i++) {
+		pkt = net_pkt_alloc_with_buffer(iface, 0, AF_INET6,
+						IPPROTO_UDP, K_SECONDS(1));
+		zassert_not_null(pkt, "Out of mem");
+
+		if (net_ipv6_create(pkt, &in6addr_peer, &in6addr_my) ||
+		    net_udp_create(pkt, htons(RX_BATCH_SRC_PORT + i),
+				   htons(RX_BATCH_PORT))) {
+			zassert_true(0, "Cannot create IPv6 UDP pkt %p", pkt);
+		}
+
+		net_pkt_cursor_init(pkt);
+		net_ipv6_finalize(pkt, IPPROTO_UDP);
+
+		rx_pending_add(pkt);
+	}
+
+	net_rx_poll_schedule(&rx_poll);
+
+	for (i = 0; i < RX_BATCH_PKTS; i++) {
+		zassert_equal(k_sem_take(&recv_lock, TIMEOUT), 0,
+			      "Only %d of %d packets received", i,
+			      RX_BATCH_PKTS);
+	}
+
+	zassert_true(rx_batch_ordered, "Packets received out of order");
+	zassert_true(rx_polls >= ceiling_fraction(RX_BATCH_PKTS,
+						  CONFIG_NET_RX_POLL_BUDGET),
+		     "Only %d polls", rx_polls);
+
+	ret = net_udp_unregister(handle);
+	zassert_equal(ret, 0, "UDP unregister failed (%d)", ret);
+}
+#else
+void test_udp_rx_batch(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_NET_RX_BATCH */
+
 void test_main(void)
 {
 	ztest_test_suite(test_udp_fn,
-		ztest_unit_test(test_udp));
+		ztest_unit_test(test_udp),
+		ztest_unit_test(test_udp_rx_batch));
 	ztest_run_test_suite(test_udp_fn);
 }
@@ -21,6 +21,7 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_UTILS_LOG_LEVEL);
 #include <sys/printk.h>
 #include <net/net_core.h>
 #include <net/net_ip.h>
+#include <net/net_pkt.h>
 #include <net/ethernet.h>
 #include <linker/sections.h>
 
@@ -832,12 +833,126 @@ void test_addr_parse(void)
 #endif
 }
 
+#define CHKSUM_MAX_LEN 256
+#define CHKSUM_MAX_FRAGS 10
+
+static u8_t chksum_data[NET_IPV4H_LEN + CHKSUM_MAX_LEN];
+static u32_t chksum_seed = 0x2545f491;
+
+/* Fixed sequence, so that a failure can be reproduced */
+static u32_t chksum_rand(void)
+{
+	chksum_seed ^= chksum_seed << 13;
+	chksum_seed ^= chksum_seed >> 17;
+	chksum_seed ^= chksum_seed << 5;
+
+	return chksum_seed;
+}
+
+/* The original 16 bits at a time implementation */
+static u16_t chksum_ref(const u8_t *data, size_t len)
+{
+	const u8_t *end = data + len - 1;
+	u16_t sum = 0U;
+	u16_t tmp;
+
+	while (data < end) {
+		tmp = (data[0] << 8) + data[1];
+		sum += tmp;
+		if (sum < tmp) {
+			sum++;
+		}
+
+		data += 2;
+	}
+
+	if (data == end) {
+		tmp = data[0] << 8;
+		sum += tmp;
+		if (sum < tmp) {
+			sum++;
+		}
+	}
+
+	sum = (sum == 0U) ? 0xffff : htons(sum);
+
+	return ~sum;
+}
+
+/* Checksums len bytes of payload, scattered over fragments of random
+ * length whose data starts at random alignments.
+ */
+static void check_chksum(size_t len)
+{
+	size_t total = NET_IPV4H_LEN + len;
+	struct net_pkt *pkt;
+	struct net_buf *frag;
+	size_t pos = 0;
+	size_t skew, flen;
+	int frags = 0;
+
+	pkt = net_pkt_alloc(K_FOREVER);
+	zassert_not_null(pkt, "Cannot allocate pkt");
+
+	net_pkt_set_family(pkt, AF_INET);
+	net_pkt_set_ip_hdr_len(pkt, NET_IPV4H_LEN);
+
+	while (pos < total) {
+		frag = net_pkt_get_frag(pkt, K_FOREVER);
+		zassert_not_null(frag, "Cannot allocate frag");
+
+		skew = chksum_rand() % 4;
+		net_buf_add(frag, skew);
+		net_buf_pull(frag, skew);
+
+		flen = net_buf_tailroom(frag);
+		if (++frags < CHKSUM_MAX_FRAGS) {
+			flen = 1 + chksum_rand() % flen;
+		}
+
+		flen = MIN(flen, total - pos);
+		net_buf_add_mem(frag, chksum_data + pos, flen);
+		net_pkt_frag_add(pkt, frag);
+
+		pos += flen;
+	}
+
+	zassert_equal(net_calc_chksum_icmpv4(pkt),
+		      chksum_ref(chksum_data + NET_IPV4H_LEN, len),
+		      "Checksum mismatch, len %zu", len);
+
+	net_pkt_unref(pkt);
+}
+
+void test_net_chksum(void)
+{
+	size_t len;
+
+	for (len = 0; len <= CHKSUM_MAX_LEN; len++) {
+		for (int i = 0; i < sizeof(chksum_data); i++) {
+			chksum_data[i] = chksum_rand();
+		}
+
+		check_chksum(len);
+	}
+
+	/* Sums that wrap around or stay zero */
+	(void)memset(chksum_data, 0xff, sizeof(chksum_data));
+	check_chksum(CHKSUM_MAX_LEN);
+	check_chksum(CHKSUM_MAX_LEN - 1);
+
+	(void)memset(chksum_data, 0, sizeof(chksum_data));
+	check_chksum(CHKSUM_MAX_LEN);
+	check_chksum(1);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_utils_fn,
 			 ztest_unit_test(test_net_addr),
 			 ztest_user_unit_test(test_net_addr),
-			 ztest_unit_test(test_addr_parse));
+			 ztest_unit_test(test_addr_parse),
+			 ztest_unit_test(test_net_chksum));
 
 	ztest_run_test_suite(test_utils_fn);
 }
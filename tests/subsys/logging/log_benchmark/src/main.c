@@ -0,0 +1,207 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <logging/log.h>
+#include <logging/log_backend.h>
+#include <logging/log_ctrl.h>
+
+LOG_MODULE_REGISTER(bench, LOG_LEVEL_INF);
+
+#define BATCH 16
+#define THREADS 4
+#define THREAD_MSGS 256
+#define STACK_SIZE 1024
+
+static atomic_t put_cnt;
+static atomic_t drop_cnt;
+static atomic_t finished;
+static atomic_t timer_cnt;
+
+static const u8_t data[16];
+
+static void put(const struct log_backend *const backend, struct log_msg *msg)
+{
+	atomic_inc(&put_cnt);
+}
+
+static void dropped(const struct log_backend *const backend, u32_t cnt)
+{
+	atomic_add(&drop_cnt, cnt);
+}
+
+static void panic(const struct log_backend *const backend)
+{
+}
+
+static const struct log_backend_api bench_api = {
+	.put = put,
+	.dropped = dropped,
+	.panic = panic,
+};
+
+LOG_BACKEND_DEFINE(bench_backend, bench_api, true);
+
+static void bench_args0(int i)
+{
+	LOG_INF("message");
+}
+
+static void bench_args3(int i)
+{
+	LOG_INF("message %d %d %d", i, i + 1, i + 2);
+}
+
+static void bench_args6(int i)
+{
+	LOG_INF("message %d %d %d %d %d %d", i, i + 1, i + 2, i + 3, i + 4,
+		i + 5);
+}
+
+static void bench_hexdump(int i)
+{
+	LOG_HEXDUMP_INF(data, sizeof(data), "hexdump");
+}
+
+struct latency_case {
+	const char *name;
+	void (*log)(int i);
+};
+
+static const struct latency_case latency_cases[] = {
+	{ "args0", bench_args0 },
+	{ "args3", bench_args3 },
+	{ "args6", bench_args6 },
+	{ "hexdump", bench_hexdump },
+};
+
+static int latency(const struct latency_case *c)
+{
+	u32_t log_cycles, proc_cycles, t0;
+	int i;
+
+	atomic_set(&put_cnt, 0);
+	atomic_set(&drop_cnt, 0);
+
+	t0 = k_cycle_get_32();
+	for (i = 0; i < BATCH; i++) {
+		c->log(i);
+	}
+	log_cycles = k_cycle_get_32() - t0;
+
+	t0 = k_cycle_get_32();
+	while (log_process(false)) {
+	}
+	proc_cycles = k_cycle_get_32() - t0;
+
+	if (atomic_get(&put_cnt) != BATCH || atomic_get(&drop_cnt)) {
+		printk("%s: %u of %d messages processed, %u dropped\n",
+		       c->name, atomic_get(&put_cnt), BATCH,
+		       atomic_get(&drop_cnt));
+		return -1;
+	}
+
+	printk("%-8s %6u cycles/log %6u cycles/process\n", c->name,
+	       log_cycles / BATCH, proc_cycles / BATCH);
+
+	return 0;
+}
+
+K_THREAD_STACK_ARRAY_DEFINE(stacks, THREADS, STACK_SIZE);
+static struct k_thread threads[THREADS];
+
+static void producer(void *p1, void *p2, void *p3)
+{
+	int id = POINTER_TO_INT(p1);
+	int i;
+
+	for (i = 0; i < THREAD_MSGS; i++) {
+		LOG_INF("thread %d message %d", id, i);
+
+		if ((i % 8) == 7) {
+			k_yield();
+		}
+	}
+
+	atomic_inc(&finished);
+}
+
+static void timer_expiry(struct k_timer *timer)
+{
+	atomic_inc(&timer_cnt);
+	LOG_INF("timer");
+}
+
+K_TIMER_DEFINE(isr_timer, timer_expiry, NULL);
+
+static int throughput(void)
+{
+	u32_t cycles, t0, logged;
+	int i;
+
+	atomic_set(&put_cnt, 0);
+	atomic_set(&drop_cnt, 0);
+	atomic_set(&timer_cnt, 0);
+
+	t0 = k_cycle_get_32();
+
+	k_timer_start(&isr_timer, K_MSEC(1), K_MSEC(1));
+
+	for (i = 0; i < THREADS; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE, producer,
+				INT_TO_POINTER(i), NULL, NULL,
+				CONFIG_MAIN_THREAD_PRIORITY, 0, K_NO_WAIT);
+	}
+
+	/* Producers and the main thread have the same priority */
+	do {
+		while (log_process(false)) {
+		}
+		k_yield();
+	} while (atomic_get(&finished) < THREADS);
+
+	k_timer_stop(&isr_timer);
+
+	while (log_process(false)) {
+	}
+
+	cycles = k_cycle_get_32() - t0;
+
+	/* Each message is either passed to the backend or dropped */
+	logged = THREADS * THREAD_MSGS + atomic_get(&timer_cnt);
+	if (atomic_get(&put_cnt) + atomic_get(&drop_cnt) != logged) {
+		printk("%u messages and %u dropped of %u logged\n",
+		       atomic_get(&put_cnt), atomic_get(&drop_cnt), logged);
+		return -1;
+	}
+
+	printk("%d threads %6u messages %6u dropped %6u cycles/message\n",
+	       THREADS, atomic_get(&put_cnt), atomic_get(&drop_cnt),
+	       cycles / MAX(atomic_get(&put_cnt), 1));
+
+	return 0;
+}
+
+void main(void)
+{
+	int i;
+
+	printk("log buffer %s, %s\n",
+	       IS_ENABLED(CONFIG_LOG_MPSC_BUFFER) ? "mpsc" : "slab and list",
+	       IS_ENABLED(CONFIG_LOG_MODE_OVERFLOW) ?
+	       "oldest dropped" : "newest dropped");
+
+	for (i = 0; i < ARRAY_SIZE(latency_cases); i++) {
+		if (latency(&latency_cases[i]) < 0) {
+			return;
+		}
+	}
+
+	if (throughput() < 0) {
+		return;
+	}
+
+	printk("fin\n");
+}
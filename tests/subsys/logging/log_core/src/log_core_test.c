@@ -23,6 +23,16 @@
 #define LOG_MODULE_NAME test
 LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 
+/* Number of chunks in the log buffer. The packet buffer takes a descriptor
+ * for each chunk from it as well.
+ */
+#if defined(CONFIG_LOG_MPSC_BUFFER)
+#define BUF_CHUNKS (CONFIG_LOG_BUFFER_SIZE / \
+		    (sizeof(union log_msg_chunk) + sizeof(atomic_t)))
+#else
+#define BUF_CHUNKS (CONFIG_LOG_BUFFER_SIZE / sizeof(union log_msg_chunk))
+#endif
+
 typedef void (*custom_put_callback_t)(struct log_backend const *const backend,
 				      struct log_msg *msg, size_t counter);
 
@@ -155,6 +165,13 @@ static void log_setup(bool backend2_enable)
 
 	log_init();
 
+	/* Which messages are dropped for space in the packet buffer depends
+	 * on where records fall in the ring, start from an empty one.
+	 */
+	if (IS_ENABLED(CONFIG_LOG_MPSC_BUFFER)) {
+		log_msg_pool_init();
+	}
+
 	zassert_equal(0, log_set_timestamp_func(timestamp_get, 0),
 		      "Expects successful timestamp function setting.");
 
@@ -225,7 +242,7 @@ static void test_log_backend_runtime_filtering(void)
 u8_t data[CONFIG_LOG_BUFFER_SIZE];
 static void test_log_overflow(void)
 {
-	u32_t msgs_in_buf = CONFIG_LOG_BUFFER_SIZE/sizeof(union log_msg_chunk);
+	u32_t msgs_in_buf = BUF_CHUNKS;
 	u32_t max_hexdump_len = LOG_MSG_HEXDUMP_BYTES_HEAD_CHUNK +
 			    HEXDUMP_BYTES_CONT_MSG * (msgs_in_buf - 1);
 	u32_t hexdump_len = max_hexdump_len - HEXDUMP_BYTES_CONT_MSG;
@@ -238,9 +255,16 @@ static void test_log_overflow(void)
 	backend1_cb.check_timestamp = true;
 	backend2_cb.check_timestamp = true;
 
-	/* expect first message to be dropped */
-	backend1_cb.exp_timestamps[0] = 1U;
-	backend1_cb.exp_timestamps[1] = 2U;
+	if (IS_ENABLED(CONFIG_LOG_MPSC_BUFFER)) {
+		/* Records are contiguous, the hexdump fits in the ring only
+		 * once both messages before it are dropped.
+		 */
+		backend1_cb.exp_timestamps[0] = 2U;
+	} else {
+		/* expect first message to be dropped */
+		backend1_cb.exp_timestamps[0] = 1U;
+		backend1_cb.exp_timestamps[1] = 2U;
+	}
 
 	LOG_INF("test");
 	LOG_INF("test");
@@ -250,9 +274,15 @@ static void test_log_overflow(void)
 	}
 
 	/* Expect big message to be dropped because it does not fit in.
-	 * First message is also dropped in the process of finding free space.
+	 * First message is also dropped in the process of finding free space,
+	 * except in the packet buffer which drops a message longer than the
+	 * whole buffer right away.
 	 */
-	backend1_cb.exp_timestamps[2] = 3U;
+	if (IS_ENABLED(CONFIG_LOG_MPSC_BUFFER)) {
+		backend1_cb.exp_timestamps[1] = 3U;
+	} else {
+		backend1_cb.exp_timestamps[2] = 3U;
+	}
 
 	LOG_INF("test");
 	LOG_HEXDUMP_INF(data, max_hexdump_len+1, "test");
@@ -461,7 +491,7 @@ static void test_log_msg_dropped_notification(void)
 {
 	__ASSERT_NO_MSG(CONFIG_LOG_MODE_OVERFLOW);
 
-	u32_t capacity = CONFIG_LOG_BUFFER_SIZE/sizeof(struct log_msg);
+	u32_t capacity = BUF_CHUNKS;
 
 	log_setup(false);
 
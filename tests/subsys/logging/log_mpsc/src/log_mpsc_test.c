@@ -0,0 +1,160 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Test log packet buffer
+ *
+ */
+
+#include <../subsys/logging/log_mpsc.h>
+
+#include <tc_util.h>
+#include <stdbool.h>
+#include <zephyr.h>
+#include <ztest.h>
+
+#define CHUNKS 8
+
+static union log_msg_chunk chunks[CHUNKS];
+static atomic_t desc[CHUNKS];
+static struct log_mpsc_t buf;
+
+static union log_msg_chunk *alloc_commit(u32_t length)
+{
+	union log_msg_chunk *chunk = log_mpsc_alloc(&buf, length);
+
+	zassert_not_null(chunk, "Cannot allocate %d chunks.\n", length);
+	log_mpsc_commit(&buf, chunk);
+
+	return chunk;
+}
+
+static void claim_free(union log_msg_chunk *exp)
+{
+	union log_msg_chunk *chunk = log_mpsc_claim(&buf);
+
+	zassert_equal_ptr(chunk, exp, "Unexpected record.\n");
+	log_mpsc_free(&buf, chunk);
+}
+
+void test_log_mpsc_order(void)
+{
+	union log_msg_chunk *a, *b, *c;
+
+	log_mpsc_init(&buf, chunks, desc, CHUNKS);
+
+	zassert_false(log_mpsc_is_ready(&buf), "Expected empty buffer.\n");
+
+	a = log_mpsc_alloc(&buf, 1);
+	b = log_mpsc_alloc(&buf, 2);
+	c = log_mpsc_alloc(&buf, 1);
+	zassert_true(a && b && c, "Allocation failed.\n");
+	zassert_equal_ptr(b, a + 1, "Records not contiguous.\n");
+	zassert_equal_ptr(c, b + 2, "Records not contiguous.\n");
+
+	log_mpsc_commit(&buf, c);
+	log_mpsc_commit(&buf, b);
+
+	/* The oldest record is not committed yet */
+	zassert_false(log_mpsc_is_ready(&buf), "Unexpected ready record.\n");
+	zassert_is_null(log_mpsc_claim(&buf), "Unexpected claimed record.\n");
+
+	log_mpsc_commit(&buf, a);
+	zassert_true(log_mpsc_is_ready(&buf), "Expected ready record.\n");
+
+	claim_free(a);
+	claim_free(b);
+	claim_free(c);
+
+	zassert_is_null(log_mpsc_claim(&buf), "Expected empty buffer.\n");
+	zassert_false(log_mpsc_is_ready(&buf), "Expected empty buffer.\n");
+}
+
+void test_log_mpsc_full(void)
+{
+	union log_msg_chunk *a, *b, *c;
+
+	log_mpsc_init(&buf, chunks, desc, CHUNKS);
+
+	zassert_is_null(log_mpsc_alloc(&buf, CHUNKS + 1),
+			"Record longer than buffer allocated.\n");
+
+	a = alloc_commit(3);
+	b = alloc_commit(3);
+	zassert_is_null(log_mpsc_alloc(&buf, 3), "Expected full buffer.\n");
+	c = alloc_commit(2);
+	zassert_equal(log_mpsc_num_used_get(&buf), CHUNKS,
+		      "Unexpected number of chunks in use.\n");
+
+	zassert_equal_ptr(log_mpsc_claim(&buf), a, "Unexpected record.\n");
+	zassert_equal_ptr(log_mpsc_claim(&buf), b, "Unexpected record.\n");
+
+	/* Space is reclaimed only up to the oldest record in use */
+	log_mpsc_free(&buf, b);
+	zassert_is_null(log_mpsc_alloc(&buf, 1), "Expected full buffer.\n");
+
+	log_mpsc_free(&buf, a);
+	a = alloc_commit(6);
+	zassert_equal_ptr(a, &chunks[0], "Unexpected position.\n");
+
+	claim_free(c);
+	claim_free(a);
+
+	zassert_equal(log_mpsc_num_used_get(&buf), 0,
+		      "Unexpected number of chunks in use.\n");
+}
+
+void test_log_mpsc_wrap(void)
+{
+	union log_msg_chunk *a;
+
+	log_mpsc_init(&buf, chunks, desc, CHUNKS);
+
+	a = alloc_commit(5);
+	claim_free(a);
+
+	/* Does not fit at the end of the ring */
+	a = alloc_commit(4);
+	zassert_equal_ptr(a, &chunks[0], "Record not wrapped.\n");
+	zassert_equal(log_mpsc_num_used_get(&buf), CHUNKS - 5 + 4,
+		      "Padding not counted.\n");
+	claim_free(a);
+
+	/* Fits in the empty buffer only from its start */
+	a = alloc_commit(CHUNKS);
+	zassert_equal_ptr(a, &chunks[0], "Record not wrapped.\n");
+	claim_free(a);
+
+	zassert_false(log_mpsc_is_ready(&buf), "Expected empty buffer.\n");
+}
+
+void test_log_mpsc_free_uncommitted(void)
+{
+	union log_msg_chunk *a, *b;
+
+	log_mpsc_init(&buf, chunks, desc, CHUNKS);
+
+	a = log_mpsc_alloc(&buf, 2);
+	b = alloc_commit(2);
+
+	/* Released before it was committed, never claimed */
+	log_mpsc_free(&buf, a);
+
+	claim_free(b);
+
+	a = alloc_commit(CHUNKS);
+	claim_free(a);
+}
+
+/*test case main entry*/
+void test_main(void)
+{
+	ztest_test_suite(test_log_mpsc,
+			 ztest_unit_test(test_log_mpsc_order),
+			 ztest_unit_test(test_log_mpsc_full),
+			 ztest_unit_test(test_log_mpsc_wrap),
+			 ztest_unit_test(test_log_mpsc_free_uncommitted));
+	ztest_run_test_suite(test_log_mpsc);
+}
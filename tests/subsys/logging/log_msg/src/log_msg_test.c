@@ -16,15 +16,42 @@
 #include <zephyr.h>
 #include <ztest.h>
 
+#if defined(CONFIG_LOG_MPSC_BUFFER)
+#include <../subsys/logging/log_mpsc.h>
+#else
 extern struct k_mem_slab log_msg_pool;
+#endif
+
 static const char my_string[] = "test_string";
+
+/* Start from an empty buffer. Records in the packet buffer which do not fit
+ * at the end of the ring leave padding which would be counted as used.
+ */
+static void used_chunks_reset(void)
+{
+	if (IS_ENABLED(CONFIG_LOG_MPSC_BUFFER)) {
+		log_msg_pool_init();
+	}
+}
+
+static u32_t used_chunks(void)
+{
+#if defined(CONFIG_LOG_MPSC_BUFFER)
+	return log_mpsc_num_used_get(&log_msg_mpsc);
+#else
+	return k_mem_slab_num_used_get(&log_msg_pool);
+#endif
+}
+
 void test_log_std_msg(void)
 {
 	zassert_equal(LOG_MSG_NARGS_SINGLE_CHUNK,
 		      IS_ENABLED(CONFIG_64BIT) ? 4 : 3,
 		      "test assumes following setting");
 
-	u32_t used_slabs = k_mem_slab_num_used_get(&log_msg_pool);
+	used_chunks_reset();
+
+	u32_t used_slabs = used_chunks();
 	log_arg_t args[] = {1, 2, 3, 4, 5, 6};
 	struct log_msg *msg;
 
@@ -50,22 +77,23 @@ void test_log_std_msg(void)
 
 		used_slabs += (i > LOG_MSG_NARGS_SINGLE_CHUNK) ? 2 : 1;
 		zassert_equal(used_slabs,
-			      k_mem_slab_num_used_get(&log_msg_pool),
+			      used_chunks(),
 			      "Expected mem slab allocation.");
 
 		log_msg_put(msg);
 
 		used_slabs -= (i > LOG_MSG_NARGS_SINGLE_CHUNK) ? 2 : 1;
 		zassert_equal(used_slabs,
-			      k_mem_slab_num_used_get(&log_msg_pool),
+			      used_chunks(),
 			      "Expected mem slab allocation.");
 	}
 }
 
 void test_log_hexdump_msg(void)
 {
+	used_chunks_reset();
 
-	u32_t used_slabs = k_mem_slab_num_used_get(&log_msg_pool);
+	u32_t used_slabs = used_chunks();
 	struct log_msg *msg;
 	u8_t data[128];
 
@@ -78,14 +106,14 @@ void test_log_hexdump_msg(void)
 				     LOG_MSG_HEXDUMP_BYTES_SINGLE_CHUNK - 4);
 
 	zassert_equal((used_slabs + 1),
-		      k_mem_slab_num_used_get(&log_msg_pool),
+		      used_chunks(),
 		      "Expected mem slab allocation.");
 	used_slabs++;
 
 	log_msg_put(msg);
 
 	zassert_equal((used_slabs - 1),
-		      k_mem_slab_num_used_get(&log_msg_pool),
+		      used_chunks(),
 		      "Expected mem slab allocation.");
 	used_slabs--;
 
@@ -94,14 +122,14 @@ void test_log_hexdump_msg(void)
 				     LOG_MSG_HEXDUMP_BYTES_SINGLE_CHUNK);
 
 	zassert_equal((used_slabs + 1),
-		      k_mem_slab_num_used_get(&log_msg_pool),
+		      used_chunks(),
 		      "Expected mem slab allocation.");
 	used_slabs++;
 
 	log_msg_put(msg);
 
 	zassert_equal((used_slabs - 1),
-		      k_mem_slab_num_used_get(&log_msg_pool),
+		      used_chunks(),
 		      "Expected mem slab allocation.");
 	used_slabs--;
 
@@ -110,14 +138,14 @@ void test_log_hexdump_msg(void)
 				     LOG_MSG_HEXDUMP_BYTES_SINGLE_CHUNK + 1);
 
 	zassert_equal((used_slabs + 2U),
-		      k_mem_slab_num_used_get(&log_msg_pool),
+		      used_chunks(),
 		      "Expected mem slab allocation.");
 	used_slabs += 2U;
 
 	log_msg_put(msg);
 
 	zassert_equal((used_slabs - 2U),
-		      k_mem_slab_num_used_get(&log_msg_pool),
+		      used_chunks(),
 		      "Expected mem slab allocation.");
 	used_slabs -= 2U;
 
@@ -127,14 +155,14 @@ void test_log_hexdump_msg(void)
 				     HEXDUMP_BYTES_CONT_MSG + 1);
 
 	zassert_equal((used_slabs + 3U),
-		      k_mem_slab_num_used_get(&log_msg_pool),
+		      used_chunks(),
 		      "Expected mem slab allocation.");
 	used_slabs += 3U;
 
 	log_msg_put(msg);
 
 	zassert_equal((used_slabs - 3U),
-		      k_mem_slab_num_used_get(&log_msg_pool),
+		      used_chunks(),
 		      "Expected mem slab allocation.");
 	used_slabs -= 3U;
 }
@@ -0,0 +1,220 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Test dictionary format output
+ */
+
+#include <logging/log.h>
+#include <logging/log_output.h>
+
+#include <tc_util.h>
+#include <stdbool.h>
+#include <zephyr.h>
+#include <ztest.h>
+
+#define LOG_MODULE_NAME test
+LOG_MODULE_REGISTER(LOG_MODULE_NAME);
+
+/* Record types, see subsys/logging/log_output_dict.c */
+#define TYPE_STD	0xD1
+#define TYPE_HEXDUMP	0xD2
+#define TYPE_DROPPED	0xD3
+
+#define TEST_DOMAIN_ID	1
+#define TEST_TIMESTAMP	0x12345678
+
+static u8_t mock_buffer[512];
+static u8_t exp_buffer[512];
+/* Smaller than a record so that records span several flushes */
+static u8_t log_output_buf[8];
+static u32_t mock_len;
+static u32_t exp_len;
+
+static void reset_buffers(void)
+{
+	mock_len = 0U;
+	exp_len = 0U;
+	memset(mock_buffer, 0, sizeof(mock_buffer));
+	memset(exp_buffer, 0, sizeof(exp_buffer));
+}
+
+static int mock_output_func(u8_t *buf, size_t size, void *ctx)
+{
+	zassert_true(mock_len + size <= sizeof(mock_buffer),
+		     "Output too long");
+
+	memcpy(&mock_buffer[mock_len], buf, size);
+	mock_len += size;
+
+	return size;
+}
+
+LOG_OUTPUT_DEFINE(log_output, mock_output_func,
+		  log_output_buf, sizeof(log_output_buf));
+
+static void exp_put(const void *data, size_t len)
+{
+	memcpy(&exp_buffer[exp_len], data, len);
+	exp_len += len;
+}
+
+static void exp_put_u8(u8_t value)
+{
+	exp_put(&value, sizeof(value));
+}
+
+static void exp_put_u16(u16_t value)
+{
+	exp_put(&value, sizeof(value));
+}
+
+static void exp_put_u32(u32_t value)
+{
+	exp_put(&value, sizeof(value));
+}
+
+static void exp_put_ptr(const void *ptr)
+{
+	exp_put(&ptr, sizeof(ptr));
+}
+
+static u16_t test_source_id(void)
+{
+	return log_const_source_id(&LOG_ITEM_CONST_DATA(LOG_MODULE_NAME));
+}
+
+static void msg_ids_set(struct log_msg *msg)
+{
+	msg->hdr.ids.level = LOG_LEVEL_WRN;
+	msg->hdr.ids.domain_id = TEST_DOMAIN_ID;
+	msg->hdr.ids.source_id = test_source_id();
+	msg->hdr.timestamp = TEST_TIMESTAMP;
+}
+
+static void exp_put_hdr(u8_t type)
+{
+	exp_put_u8(type);
+	exp_put_u8(LOG_LEVEL_WRN | (TEST_DOMAIN_ID << 3));
+	exp_put_u16(test_source_id());
+	exp_put_u32(TEST_TIMESTAMP);
+}
+
+static void msg_process(struct log_msg *msg)
+{
+	msg_ids_set(msg);
+	log_output_msg_process(&log_output, msg, LOG_OUTPUT_FLAG_FORMAT_DICT);
+	log_msg_put(msg);
+}
+
+static void validate_output(void)
+{
+	zassert_equal(mock_len, exp_len, "Unexpected record length %d",
+		      mock_len);
+	zassert_mem_equal(mock_buffer, exp_buffer, exp_len,
+			  "Unexpected record");
+}
+
+void test_log_output_dict_std(void)
+{
+	static const char fmt[] = "abc %d %d";
+	log_arg_t args[] = { 1, -3 };
+	struct log_msg *msg;
+
+	reset_buffers();
+
+	msg = log_msg_create_2(fmt, args[0], args[1]);
+	zassert_not_null(msg, "Cannot allocate message");
+	msg_process(msg);
+
+	exp_put_hdr(TYPE_STD);
+	exp_put_ptr(fmt);
+	exp_put_u8(ARRAY_SIZE(args));
+	exp_put_u16(0U);
+	exp_put(args, sizeof(args));
+
+	validate_output();
+}
+
+void test_log_output_dict_strdup(void)
+{
+	static const char fmt[] = "%s %d %s";
+	static const char *const ro_str = "ro";
+	char str[] = "dup";
+	log_arg_t args[3];
+	struct log_msg *msg;
+
+	reset_buffers();
+
+	args[0] = (log_arg_t)log_strdup(str);
+	args[1] = 5;
+	args[2] = (log_arg_t)ro_str;
+	zassert_true(log_is_strdup((void *)args[0]), "String not duplicated");
+
+	msg = log_msg_create_3(fmt, args[0], args[1], args[2]);
+	zassert_not_null(msg, "Cannot allocate message");
+	msg_process(msg);
+
+	/* Only the duplicated string is sent inline, after the arguments */
+	exp_put_hdr(TYPE_STD);
+	exp_put_ptr(fmt);
+	exp_put_u8(ARRAY_SIZE(args));
+	exp_put_u16(BIT(0));
+	exp_put(args, sizeof(args));
+	exp_put_u8(strlen(str));
+	exp_put(str, strlen(str));
+
+	validate_output();
+}
+
+void test_log_output_dict_hexdump(void)
+{
+	static const char meta[] = "hexdump";
+	/* Longer than a message chunk */
+	u8_t data[40];
+	struct log_msg *msg;
+	int i;
+
+	reset_buffers();
+
+	for (i = 0; i < sizeof(data); i++) {
+		data[i] = i;
+	}
+
+	msg = log_msg_hexdump_create(meta, data, sizeof(data));
+	zassert_not_null(msg, "Cannot allocate message");
+	msg_process(msg);
+
+	exp_put_hdr(TYPE_HEXDUMP);
+	exp_put_ptr(meta);
+	exp_put_u16(sizeof(data));
+	exp_put(data, sizeof(data));
+
+	validate_output();
+}
+
+void test_log_output_dict_dropped(void)
+{
+	reset_buffers();
+
+	log_output_dict_dropped_process(&log_output, 123);
+
+	exp_put_u8(TYPE_DROPPED);
+	exp_put_u32(123);
+
+	validate_output();
+}
+
+/*test case main entry*/
+void test_main(void)
+{
+	ztest_test_suite(test_log_output_dict,
+		ztest_unit_test(test_log_output_dict_std),
+		ztest_unit_test(test_log_output_dict_strdup),
+		ztest_unit_test(test_log_output_dict_hexdump),
+		ztest_unit_test(test_log_output_dict_dropped)
+		);
+	ztest_run_test_suite(test_log_output_dict);
+}
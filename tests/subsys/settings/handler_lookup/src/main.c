@@ -0,0 +1,184 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <ztest.h>
+
+#include <zephyr.h>
+#include <settings/settings.h>
+
+#define DYNAMIC_HANDLERS 40
+#define LOAD_KEYS 2000
+
+static int static_set_called;
+static int dynamic_set_called;
+
+static int static_set(const char *name, size_t len, settings_read_cb read_cb,
+		      void *cb_arg)
+{
+	static_set_called++;
+	return 0;
+}
+
+static int dynamic_set(const char *name, size_t len, settings_read_cb read_cb,
+		       void *cb_arg)
+{
+	dynamic_set_called++;
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(lookup, "lookup", NULL, static_set, NULL,
+			       NULL);
+SETTINGS_STATIC_HANDLER_DEFINE(lookup_nested, "lookup/nested", NULL,
+			       static_set, NULL, NULL);
+
+static char dynamic_names[DYNAMIC_HANDLERS][sizeof("sub00/deep/er")];
+static struct settings_handler dynamic_handlers[DYNAMIC_HANDLERS];
+
+/* Backend feeding LOAD_KEYS generated keys to the handlers */
+static ssize_t gen_read(void *cb_arg, void *data, size_t len)
+{
+	return 0;
+}
+
+static int gen_load(struct settings_store *cs,
+		    const struct settings_load_arg *arg)
+{
+	char name[SETTINGS_MAX_NAME_LEN + 1];
+	int i;
+
+	for (i = 0; i < LOAD_KEYS; i++) {
+		if (i % 8 == 0) {
+			snprintf(name, sizeof(name), "lookup/nested/key%d", i);
+		} else {
+			snprintf(name, sizeof(name), "sub%02d/key%d",
+				 i % DYNAMIC_HANDLERS, i);
+		}
+
+		settings_call_set_handler(name, 0, gen_read, NULL, arg);
+	}
+
+	return 0;
+}
+
+static const struct settings_store_itf gen_itf = {
+	.csi_load = gen_load,
+};
+
+static struct settings_store gen_store = {
+	.cs_itf = &gen_itf,
+};
+
+int settings_backend_init(void)
+{
+	settings_src_register(&gen_store);
+	return 0;
+}
+
+static void test_register(void)
+{
+	int i, rc;
+
+	rc = settings_subsys_init();
+	zassert_equal(rc, 0, "settings_subsys_init failed (%d)", rc);
+
+	for (i = 0; i < DYNAMIC_HANDLERS; i++) {
+		/* The last one nests under the first one */
+		if (i == DYNAMIC_HANDLERS - 1) {
+			strcpy(dynamic_names[i], "sub00/deep/er");
+		} else {
+			snprintf(dynamic_names[i], sizeof(dynamic_names[i]),
+				 "sub%02d", i);
+		}
+
+		dynamic_handlers[i].name = dynamic_names[i];
+		dynamic_handlers[i].h_set = dynamic_set;
+
+		rc = settings_register(&dynamic_handlers[i]);
+		zassert_equal(rc, 0, "Cannot register %s (%d)",
+			      dynamic_names[i], rc);
+	}
+
+	rc = settings_register(&dynamic_handlers[0]);
+	zassert_equal(rc, -EEXIST, "Duplicate handler registered");
+}
+
+static void check_lookup(const char *name, const char *handler,
+			 const char *expected_next)
+{
+	struct settings_handler_static *ch;
+	const char *next = "";
+
+	ch = settings_parse_and_lookup(name, &next);
+
+	if (!handler) {
+		zassert_is_null(ch, "Handler found for %s", name);
+		return;
+	}
+
+	zassert_not_null(ch, "No handler for %s", name);
+	zassert_equal(strcmp(ch->name, handler), 0,
+		      "Handler %s instead of %s for %s", ch->name, handler,
+		      name);
+
+	if (!expected_next) {
+		zassert_is_null(next, "Unexpected next for %s", name);
+	} else {
+		zassert_not_null(next, "No next for %s", name);
+		zassert_equal(strcmp(next, expected_next), 0,
+			      "Invalid next %s for %s", next, name);
+	}
+}
+
+static void test_lookup(void)
+{
+	check_lookup("lookup", "lookup", NULL);
+	check_lookup("lookup=1", "lookup", NULL);
+	check_lookup("lookup/key", "lookup", "key");
+	check_lookup("lookup/nested", "lookup/nested", NULL);
+	check_lookup("lookup/nested/key", "lookup/nested", "key");
+	check_lookup("lookup/nestedkey", "lookup", "nestedkey");
+	check_lookup("lookupkey", NULL, NULL);
+	check_lookup("sub07/a/b", "sub07", "a/b");
+	check_lookup("sub00/deep", "sub00", "deep");
+	check_lookup("sub00/deep/er/x=1", "sub00/deep/er", "x=1");
+	check_lookup("sub99/key", NULL, NULL);
+	check_lookup("", NULL, NULL);
+}
+
+static void test_load_time(void)
+{
+	u32_t t0, cycles;
+	int rc;
+
+	static_set_called = 0;
+	dynamic_set_called = 0;
+
+	t0 = k_cycle_get_32();
+	rc = settings_load();
+	cycles = k_cycle_get_32() - t0;
+
+	zassert_equal(rc, 0, "settings_load failed (%d)", rc);
+	zassert_equal(static_set_called, LOAD_KEYS / 8,
+		      "Invalid static handler calls %d", static_set_called);
+	zassert_equal(dynamic_set_called, LOAD_KEYS - LOAD_KEYS / 8,
+		      "Invalid dynamic handler calls %d", dynamic_set_called);
+
+	printk("handler lookup table %s: %d keys %d handlers %u cycles/key\n",
+	       IS_ENABLED(CONFIG_SETTINGS_HANDLER_LOOKUP_TABLE) ?
+	       "enabled" : "disabled", LOAD_KEYS, DYNAMIC_HANDLERS + 2,
+	       cycles / LOAD_KEYS);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(settings_handler_lookup,
+			 ztest_unit_test(test_register),
+			 ztest_unit_test(test_lookup),
+			 ztest_unit_test(test_load_time)
+			 );
+
+	ztest_run_test_suite(settings_handler_lookup);
+}
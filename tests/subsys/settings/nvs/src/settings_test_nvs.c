@@ -296,6 +296,9 @@ void test_config_getset_unknown(void);
 void test_config_getset_int(void);
 void test_config_getset_int64(void);
 void test_config_commit(void);
+void test_settings_nvs_index_free_id(void);
+void test_settings_nvs_index_collision(void);
+void test_settings_nvs_index_overflow(void);
 
 void test_main(void)
 {
@@ -306,7 +309,11 @@ void test_main(void)
 			 ztest_unit_test(test_config_getset_unknown),
 			 ztest_unit_test(test_config_getset_int),
 			 ztest_unit_test(test_config_getset_int64),
-			 ztest_unit_test(test_config_commit)
+			 ztest_unit_test(test_config_commit),
+			 /* Name index tests */
+			 ztest_unit_test(test_settings_nvs_index_free_id),
+			 ztest_unit_test(test_settings_nvs_index_collision),
+			 ztest_unit_test(test_settings_nvs_index_overflow)
 			);
 
 	ztest_run_test_suite(test_config_nvs);
@@ -0,0 +1,252 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <storage/flash_map.h>
+
+#include "settings/settings_nvs.h"
+#include "settings_test.h"
+
+#if defined(CONFIG_SETTINGS_NVS_NAME_INDEX)
+
+/* Two names with the same 32-bit FNV-1a hash */
+#define COLLIDE_A "ix/a6vu"
+#define COLLIDE_B "ix/3yea"
+
+#define FIRST_ID (NVS_NAMECNT_ID + 1)
+
+static struct settings_nvs idx_nvs;
+
+/* Bring up the backend on the storage partition and load it, which builds
+ * the name index.
+ */
+static void idx_nvs_init(bool erase)
+{
+	const struct flash_area *fa;
+	struct flash_sector sector;
+	u32_t sector_cnt = 1;
+	int rc;
+
+	rc = flash_area_open(DT_FLASH_AREA_STORAGE_ID, &fa);
+	zassert_equal(rc, 0, "flash_area_open fail");
+
+	rc = flash_area_get_sectors(DT_FLASH_AREA_STORAGE_ID, &sector_cnt,
+				    &sector);
+	zassert_true(rc == 0 || rc == -ENOMEM, "flash_area_get_sectors fail");
+	zassert_true(SETTINGS_TEST_NVS_FLASH_CNT * sector.fs_size <=
+		     fa->fa_size, "storage partition too small");
+
+	if (erase) {
+		rc = flash_area_erase(fa, 0, fa->fa_size);
+		zassert_equal(rc, 0, "flash_area_erase fail");
+	}
+
+	idx_nvs.cf_nvs.sector_size = sector.fs_size;
+	idx_nvs.cf_nvs.sector_count = SETTINGS_TEST_NVS_FLASH_CNT;
+	idx_nvs.cf_nvs.offset = fa->fa_off;
+	idx_nvs.flash_dev_name = fa->fa_dev_name;
+
+	flash_area_close(fa);
+
+	rc = settings_nvs_backend_init(&idx_nvs);
+	zassert_equal(rc, 0, "settings_nvs_backend_init fail");
+
+	config_wipe_srcs();
+	settings_nvs_src(&idx_nvs);
+	settings_nvs_dst(&idx_nvs);
+
+	rc = settings_load();
+	zassert_equal(rc, 0, "settings_load fail");
+}
+
+static void idx_save(const char *name, u32_t value)
+{
+	int rc;
+
+	rc = settings_save_one(name, &value, sizeof(value));
+	zassert_equal(rc, 0, "can't save %s", name);
+}
+
+static void idx_delete(const char *name)
+{
+	int rc;
+
+	rc = settings_delete(name);
+	zassert_equal(rc, 0, "can't delete %s", name);
+}
+
+/* Check the setting stored with the given name ID */
+static void idx_check(u16_t name_id, const char *name, u32_t value)
+{
+	char rdname[SETTINGS_MAX_NAME_LEN + 1];
+	u32_t rdvalue;
+	ssize_t rc;
+
+	rc = nvs_read(&idx_nvs.cf_nvs, name_id, rdname, sizeof(rdname) - 1);
+	zassert_true(rc > 0, "name ID 0x%x not found", name_id);
+	rdname[rc] = '\0';
+	zassert_true(!strcmp(rdname, name), "name ID 0x%x is %s, not %s",
+		     name_id, rdname, name);
+
+	rc = nvs_read(&idx_nvs.cf_nvs, name_id + NVS_NAME_ID_OFFSET, &rdvalue,
+		      sizeof(rdvalue));
+	zassert_equal(rc, sizeof(rdvalue), "value of %s not found", name);
+	zassert_equal(rdvalue, value, "wrong value of %s", name);
+}
+
+static void idx_check_ids(const u16_t *ids, int count)
+{
+	int i;
+
+	zassert_equal(idx_nvs.index_count, count, "index has %d entries",
+		      idx_nvs.index_count);
+
+	for (i = 0; i < count; i++) {
+		zassert_equal(idx_nvs.index[i].name_id, ids[i],
+			      "index entry %d is 0x%x", i,
+			      idx_nvs.index[i].name_id);
+	}
+}
+
+void test_settings_nvs_index_free_id(void)
+{
+	const u16_t gap[] = { FIRST_ID, FIRST_ID + 2, FIRST_ID + 3 };
+	const u16_t all[] = { FIRST_ID, FIRST_ID + 1, FIRST_ID + 2,
+			      FIRST_ID + 3 };
+
+	idx_nvs_init(true);
+	idx_check_ids(NULL, 0);
+
+	idx_save("ix/0", 0U);
+	idx_save("ix/1", 1U);
+	idx_save("ix/2", 2U);
+	idx_save("ix/3", 3U);
+	idx_check_ids(all, ARRAY_SIZE(all));
+	zassert_equal(idx_nvs.last_name_id, FIRST_ID + 3, "wrong last ID");
+
+	/* Deleting in the middle leaves a gap in the name IDs */
+	idx_delete("ix/1");
+	idx_check_ids(gap, ARRAY_SIZE(gap));
+
+	/* The lowest free name ID is reused */
+	idx_save("ix/new", 4U);
+	idx_check(FIRST_ID + 1, "ix/new", 4U);
+	idx_check_ids(all, ARRAY_SIZE(all));
+	zassert_equal(idx_nvs.last_name_id, FIRST_ID + 3, "wrong last ID");
+
+	/* Updates keep the name ID */
+	idx_save("ix/2", 20U);
+	idx_check(FIRST_ID + 2, "ix/2", 20U);
+	idx_check_ids(all, ARRAY_SIZE(all));
+
+	/* Deleting the largest name ID in use frees it again */
+	idx_delete("ix/3");
+	zassert_equal(idx_nvs.last_name_id, FIRST_ID + 2, "wrong last ID");
+
+	/* Loading again builds the same index, sorted by ID */
+	idx_nvs_init(false);
+	idx_check_ids(all, ARRAY_SIZE(all) - 1);
+
+	idx_save("ix/3", 30U);
+	idx_check(FIRST_ID + 3, "ix/3", 30U);
+	idx_check_ids(all, ARRAY_SIZE(all));
+
+	idx_delete("ix/0");
+	idx_save("ix/new2", 5U);
+	idx_check(FIRST_ID, "ix/new2", 5U);
+	idx_check_ids(all, ARRAY_SIZE(all));
+}
+
+void test_settings_nvs_index_collision(void)
+{
+	idx_nvs_init(true);
+
+	idx_save(COLLIDE_A, 1U);
+	idx_save(COLLIDE_B, 2U);
+	zassert_equal(idx_nvs.index_count, 2, "names not indexed");
+	zassert_equal(idx_nvs.index[0].name_hash, idx_nvs.index[1].name_hash,
+		      "names do not collide");
+
+	/* Each name still resolves to its own name ID */
+	idx_save(COLLIDE_B, 3U);
+	idx_save(COLLIDE_A, 4U);
+	idx_check(FIRST_ID, COLLIDE_A, 4U);
+	idx_check(FIRST_ID + 1, COLLIDE_B, 3U);
+	zassert_equal(idx_nvs.index_count, 2, "duplicate name stored");
+	zassert_equal(idx_nvs.last_name_id, FIRST_ID + 1, "wrong last ID");
+
+	idx_delete(COLLIDE_A);
+	zassert_equal(idx_nvs.index_count, 1, "name not removed");
+	idx_save(COLLIDE_B, 5U);
+	idx_check(FIRST_ID + 1, COLLIDE_B, 5U);
+
+	/* The freed name ID goes to the colliding name again */
+	idx_save(COLLIDE_A, 6U);
+	idx_check(FIRST_ID, COLLIDE_A, 6U);
+	zassert_equal(idx_nvs.index_count, 2, "name not indexed");
+}
+
+void test_settings_nvs_index_overflow(void)
+{
+	char name[SETTINGS_MAX_NAME_LEN];
+	int i;
+
+	idx_nvs_init(true);
+
+	/* One name more than the index holds */
+	for (i = 0; i <= CONFIG_SETTINGS_NVS_NAME_INDEX_SIZE; i++) {
+		snprintf(name, sizeof(name), "ix/%d", i);
+		idx_save(name, i);
+		idx_check(FIRST_ID + i, name, i);
+	}
+
+	/* Saves read the names back from flash instead */
+	for (i = 0; i <= CONFIG_SETTINGS_NVS_NAME_INDEX_SIZE; i++) {
+		snprintf(name, sizeof(name), "ix/%d", i);
+		idx_save(name, i + 100U);
+		idx_check(FIRST_ID + i, name, i + 100U);
+	}
+
+	zassert_equal(idx_nvs.last_name_id,
+		      FIRST_ID + CONFIG_SETTINGS_NVS_NAME_INDEX_SIZE,
+		      "duplicate name stored");
+
+	idx_delete("ix/0");
+	idx_save("ix/new", 1U);
+	idx_check(FIRST_ID, "ix/new", 1U);
+
+	/* Too many names to build the index on load either */
+	idx_nvs_init(false);
+	snprintf(name, sizeof(name), "ix/%d",
+		 CONFIG_SETTINGS_NVS_NAME_INDEX_SIZE);
+	idx_save(name, 1U);
+	idx_check(FIRST_ID + CONFIG_SETTINGS_NVS_NAME_INDEX_SIZE, name, 1U);
+
+	idx_delete("ix/1");
+	idx_save("ix/new2", 2U);
+	idx_check(FIRST_ID + 1, "ix/new2", 2U);
+	zassert_equal(idx_nvs.last_name_id,
+		      FIRST_ID + CONFIG_SETTINGS_NVS_NAME_INDEX_SIZE,
+		      "duplicate name stored");
+
+	config_wipe_srcs();
+}
+
+#else
+
+void test_settings_nvs_index_free_id(void)
+{
+	ztest_test_skip();
+}
+
+void test_settings_nvs_index_collision(void)
+{
+	ztest_test_skip();
+}
+
+void test_settings_nvs_index_overflow(void)
+{
+	ztest_test_skip();
+}
+
+#endif /* CONFIG_SETTINGS_NVS_NAME_INDEX */
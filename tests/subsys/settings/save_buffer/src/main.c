@@ -0,0 +1,313 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <ztest.h>
+
+#include <zephyr.h>
+#include <settings/settings.h>
+
+#define ENTRIES CONFIG_SETTINGS_SAVE_BUFFER_ENTRIES
+#define LOG_SIZE (ENTRIES + 4)
+
+/* Saves received by the backend, in order */
+struct saved {
+	char name[SETTINGS_MAX_NAME_LEN + 1];
+	u32_t value;
+	size_t len;
+};
+
+static struct saved saved[LOG_SIZE];
+static int saved_count;
+static int batches;
+static int saved_before_load;
+/* Writes of this key fail */
+static const char *fail_name;
+
+static int log_load(struct settings_store *cs,
+		    const struct settings_load_arg *arg)
+{
+	saved_before_load = saved_count;
+	return 0;
+}
+
+static int log_save_start(struct settings_store *cs)
+{
+	batches++;
+	return 0;
+}
+
+static int log_save(struct settings_store *cs, const char *name,
+		    const char *value, size_t val_len)
+{
+	struct saved *s;
+
+	if (fail_name && !strcmp(name, fail_name)) {
+		return -EIO;
+	}
+
+	zassert_true(saved_count < LOG_SIZE, "Too many saves");
+
+	s = &saved[saved_count++];
+	strcpy(s->name, name);
+	s->len = val_len;
+	s->value = 0U;
+
+	if (value) {
+		memcpy(&s->value, value, MIN(val_len, sizeof(s->value)));
+	}
+
+	return 0;
+}
+
+static const struct settings_store_itf log_itf = {
+	.csi_load = log_load,
+	.csi_save_start = log_save_start,
+	.csi_save = log_save,
+};
+
+static struct settings_store log_store = {
+	.cs_itf = &log_itf,
+};
+
+int settings_backend_init(void)
+{
+	settings_src_register(&log_store);
+	settings_dst_register(&log_store);
+	return 0;
+}
+
+static void log_reset(void)
+{
+	fail_name = NULL;
+	(void)settings_save_flush();
+
+	saved_count = 0;
+	batches = 0;
+}
+
+static void check_saved(int i, const char *name, u32_t value, size_t len)
+{
+	zassert_true(i < saved_count, "Save %d missing", i);
+	zassert_equal(strcmp(saved[i].name, name), 0,
+		      "Save %d of %s instead of %s", i, saved[i].name, name);
+	zassert_equal(saved[i].len, len, "Invalid length of %s", name);
+	zassert_equal(saved[i].value, value, "Invalid value of %s", name);
+}
+
+static void save_u32(const char *name, u32_t value)
+{
+	int rc;
+
+	rc = settings_save_one(name, &value, sizeof(value));
+	zassert_equal(rc, 0, "Cannot save %s (%d)", name, rc);
+}
+
+static void test_init(void)
+{
+	int rc;
+
+	rc = settings_subsys_init();
+	zassert_equal(rc, 0, "settings_subsys_init failed (%d)", rc);
+}
+
+static void test_batch_coalesce(void)
+{
+	log_reset();
+
+	zassert_equal(settings_save_begin(), 0, "Cannot begin batch");
+
+	save_u32("t/a", 1U);
+	save_u32("t/b", 1U);
+	save_u32("t/a", 2U);
+	zassert_equal(settings_delete("t/c"), 0, "Cannot delete");
+	save_u32("t/a", 3U);
+
+	zassert_equal(saved_count, 0, "Saved before commit");
+
+	zassert_equal(settings_save_commit(), 0, "Cannot commit batch");
+
+	zassert_equal(saved_count, 3, "Invalid save count %d", saved_count);
+	zassert_equal(batches, 1, "Invalid batch count %d", batches);
+	check_saved(0, "t/a", 3U, sizeof(u32_t));
+	check_saved(1, "t/b", 1U, sizeof(u32_t));
+	check_saved(2, "t/c", 0U, 0);
+}
+
+static void test_batch_nested(void)
+{
+	log_reset();
+
+	zassert_equal(settings_save_begin(), 0, "Cannot begin batch");
+	zassert_equal(settings_save_begin(), 0, "Cannot begin nested batch");
+
+	save_u32("t/a", 1U);
+
+	zassert_equal(settings_save_commit(), 0, "Cannot commit batch");
+	zassert_equal(saved_count, 0, "Nested batch saved");
+
+	zassert_equal(settings_save_commit(), 0, "Cannot commit batch");
+	check_saved(0, "t/a", 1U, sizeof(u32_t));
+
+	zassert_equal(settings_save_commit(), -EINVAL,
+		      "Commit without a batch");
+}
+
+static void test_batch_full(void)
+{
+	char name[] = "t/0";
+	int i;
+
+	log_reset();
+
+	zassert_equal(settings_save_begin(), 0, "Cannot begin batch");
+
+	for (i = 0; i <= ENTRIES; i++) {
+		name[2] = '0' + i;
+		save_u32(name, i);
+	}
+
+	zassert_equal(saved_count, ENTRIES, "Full batch not saved");
+
+	zassert_equal(settings_save_commit(), 0, "Cannot commit batch");
+	zassert_equal(saved_count, ENTRIES + 1, "Batch not saved");
+	check_saved(ENTRIES, name, ENTRIES, sizeof(u32_t));
+}
+
+static void test_batch_long_value(void)
+{
+	u8_t value[CONFIG_SETTINGS_SAVE_BUFFER_VAL_LEN + 1] = { 7 };
+	int rc;
+
+	log_reset();
+
+	zassert_equal(settings_save_begin(), 0, "Cannot begin batch");
+
+	save_u32("t/a", 1U);
+
+	rc = settings_save_one("t/long", value, sizeof(value));
+	zassert_equal(rc, 0, "Cannot save long value (%d)", rc);
+
+	/* Written through, keeping the order of the saves */
+	zassert_equal(saved_count, 2, "Long value not written through");
+	check_saved(0, "t/a", 1U, sizeof(u32_t));
+	check_saved(1, "t/long", 7U, sizeof(value));
+
+	zassert_equal(settings_save_commit(), 0, "Cannot commit batch");
+	zassert_equal(saved_count, 2, "Invalid save count %d", saved_count);
+}
+
+static void test_load_flushes(void)
+{
+	log_reset();
+
+	zassert_equal(settings_save_begin(), 0, "Cannot begin batch");
+
+	save_u32("t/a", 1U);
+
+	saved_before_load = -1;
+	zassert_equal(settings_load(), 0, "Cannot load");
+	zassert_equal(saved_before_load, 1, "Loaded before saving");
+
+	zassert_equal(settings_save_commit(), 0, "Cannot commit batch");
+	zassert_equal(saved_count, 1, "Invalid save count %d", saved_count);
+}
+
+static void test_save_error(void)
+{
+	log_reset();
+
+	zassert_equal(settings_save_begin(), 0, "Cannot begin batch");
+
+	save_u32("t/a", 1U);
+	save_u32("t/b", 2U);
+	save_u32("t/c", 3U);
+
+	fail_name = "t/b";
+	zassert_equal(settings_save_commit(), -EIO, "Write error not returned");
+
+	zassert_equal(saved_count, 2, "Invalid save count %d", saved_count);
+	check_saved(0, "t/a", 1U, sizeof(u32_t));
+	check_saved(1, "t/c", 3U, sizeof(u32_t));
+
+	/* The failed value is still pending, and saving it again updates it */
+	zassert_equal(settings_save_flush(), -EIO, "Write error not returned");
+	zassert_equal(saved_count, 2, "Invalid save count %d", saved_count);
+
+	zassert_equal(settings_save_begin(), 0, "Cannot begin batch");
+	save_u32("t/b", 4U);
+	save_u32("t/d", 5U);
+
+	fail_name = NULL;
+	zassert_equal(settings_save_commit(), 0, "Cannot commit batch");
+
+	zassert_equal(saved_count, 4, "Invalid save count %d", saved_count);
+	check_saved(2, "t/b", 4U, sizeof(u32_t));
+	check_saved(3, "t/d", 5U, sizeof(u32_t));
+
+	zassert_equal(settings_save_flush(), 0, "Cannot flush");
+	zassert_equal(saved_count, 4, "Value saved twice");
+}
+
+static void test_deferred(void)
+{
+#if defined(CONFIG_SETTINGS_SAVE_DEFERRED)
+	log_reset();
+
+	save_u32("t/a", 1U);
+	save_u32("t/a", 2U);
+
+	zassert_equal(saved_count, 0, "Deferred save written");
+
+	k_sleep(K_MSEC(CONFIG_SETTINGS_SAVE_DEFERRED_DELAY * 2));
+
+	zassert_equal(saved_count, 1, "Deferred save not written");
+	check_saved(0, "t/a", 2U, sizeof(u32_t));
+
+	save_u32("t/b", 1U);
+	zassert_equal(settings_save_flush(), 0, "Cannot flush");
+	check_saved(1, "t/b", 1U, sizeof(u32_t));
+#else
+	ztest_test_skip();
+#endif
+}
+
+static void test_deferred_retry(void)
+{
+#if defined(CONFIG_SETTINGS_SAVE_DEFERRED)
+	log_reset();
+
+	fail_name = "t/a";
+	save_u32("t/a", 1U);
+
+	k_sleep(K_MSEC(CONFIG_SETTINGS_SAVE_DEFERRED_DELAY * 2));
+	zassert_equal(saved_count, 0, "Failed save recorded");
+
+	/* Retried after another delay */
+	fail_name = NULL;
+	k_sleep(K_MSEC(CONFIG_SETTINGS_SAVE_DEFERRED_DELAY * 2));
+
+	zassert_equal(saved_count, 1, "Failed save not retried");
+	check_saved(0, "t/a", 1U, sizeof(u32_t));
+#else
+	ztest_test_skip();
+#endif
+}
+
+void test_main(void)
+{
+	ztest_test_suite(settings_save_buffer,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_batch_coalesce),
+			 ztest_unit_test(test_batch_nested),
+			 ztest_unit_test(test_batch_full),
+			 ztest_unit_test(test_batch_long_value),
+			 ztest_unit_test(test_load_flushes),
+			 ztest_unit_test(test_save_error),
+			 ztest_unit_test(test_deferred),
+			 ztest_unit_test(test_deferred_retry)
+			 );
+
+	ztest_run_test_suite(settings_save_buffer);
+}